@@ -104,14 +104,21 @@ int8_t EpdFont::getKerning(const uint32_t leftCp, const uint32_t rightCp) const
   if (utf8IsCjkBreakable(leftCp) || utf8IsCjkBreakable(rightCp)) {
     return 0;
   }
-  if (!data->kernMatrix) {
+  if (!data->kernMatrix && !data->kernPairs) {
     return 0;
   }
   const uint8_t lc = lookupKernClass(data->kernLeftClasses, data->kernLeftEntryCount, leftCp);
   if (lc == 0) return 0;
   const uint8_t rc = lookupKernClass(data->kernRightClasses, data->kernRightEntryCount, rightCp);
   if (rc == 0) return 0;
-  return data->kernMatrix[(lc - 1) * data->kernRightClassCount + (rc - 1)];
+  if (data->kernMatrix) {
+    return data->kernMatrix[(lc - 1) * data->kernRightClassCount + (rc - 1)];
+  }
+
+  const auto* rowEnd = data->kernPairs + data->kernRowStarts[lc];
+  const auto it = std::lower_bound(data->kernPairs + data->kernRowStarts[lc - 1], rowEnd, rc,
+                                   [](const EpdKernPair& pair, uint8_t value) { return pair.rightClassId < value; });
+  return (it != rowEnd && it->rightClassId == rc) ? it->adjust : 0;
 }
 
 uint32_t EpdFont::getLigature(const uint32_t leftCp, const uint32_t rightCp) const {
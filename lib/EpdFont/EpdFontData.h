@@ -100,6 +100,13 @@ typedef struct {
   uint8_t classId;     ///< 1-based kerning class ID
 } __attribute__((packed)) EpdKernClassEntry;
 
+/// One non-zero cell of a sparse kern row (see EpdFontData::kernRowStarts), sorted by
+/// rightClassId within its row for binary search.
+typedef struct {
+  uint8_t rightClassId;  ///< 1-based right kerning class ID
+  int8_t adjust;         ///< 4.4 fixed-point in pixels
+} EpdKernPair;
+
 /// Ligature substitution for a specific glyph pair, sorted by `pair` for binary search.
 /// `pair` encodes (leftCodepoint << 16 | rightCodepoint) for single-key lookup.
 typedef struct {
@@ -141,4 +148,10 @@ typedef struct {
   /// Context pointer for glyphMissHandler (typically SdCardFont*).  Also used by
   /// GfxRenderer::getGlyphBitmap() to retrieve overflow bitmaps via SdCardFont.
   void* glyphMissCtx;
+
+  /// Sparse alternative to kernMatrix, used when kernMatrix is nullptr (SD card fonts keep
+  /// it resident this way). Left class L's non-zero cells are
+  /// kernPairs[kernRowStarts[L - 1]] .. kernPairs[kernRowStarts[L] - 1].
+  const uint16_t* kernRowStarts;  ///< kernLeftClassCount + 1 indices into kernPairs
+  const EpdKernPair* kernPairs;
 } EpdFontData;
@@ -128,16 +128,8 @@ void FontDecompressor::compactSingleGlyph(const uint8_t* alignedSrc, uint8_t* pa
 
 // --- getBitmap: page buffer → hot group → decompress ---
 
-const uint8_t* FontDecompressor::getBitmap(const EpdFontData* fontData, const EpdGlyph* glyph, uint32_t glyphIndex) {
-  const uint32_t tStart = micros();
-  stats.getBitmapCalls++;
-
-  if (!fontData->groups || fontData->groupCount == 0) {
-    stats.getBitmapTimeUs += micros() - tStart;
-    return &fontData->bitmap[glyph->dataOffset];
-  }
-
-  // Check page buffer slots (populated by prewarmCache — one slot per font style)
+const uint8_t* FontDecompressor::getPageBitmap(const EpdFontData* fontData, const uint32_t glyphIndex) const {
+  // Page buffer slots are populated by prewarmCache — one slot per font style
   for (uint8_t s = 0; s < pageSlotCount; s++) {
     const auto& slot = pageSlots[s];
     if (slot.fontData != fontData || slot.glyphCount == 0) continue;
@@ -147,18 +139,33 @@ const uint8_t* FontDecompressor::getBitmap(const EpdFontData* fontData, const Ep
       int mid = left + (right - left) / 2;
       if (slot.glyphs[mid].glyphIndex == glyphIndex) {
         if (slot.glyphs[mid].bufferOffset != UINT32_MAX) {
-          stats.cacheHits++;
-          stats.getBitmapTimeUs += micros() - tStart;
           return &slot.buffer[slot.glyphs[mid].bufferOffset];
         }
-        break;  // Not extracted during prewarm; fall through to hot-group path
+        return nullptr;  // Not extracted during prewarm
       }
       if (slot.glyphs[mid].glyphIndex < glyphIndex)
         left = mid + 1;
       else
         right = mid - 1;
     }
-    break;  // Found the right slot but glyph wasn't in it; don't check other slots
+    return nullptr;  // Found the right slot but glyph wasn't in it; don't check other slots
+  }
+  return nullptr;
+}
+
+const uint8_t* FontDecompressor::getBitmap(const EpdFontData* fontData, const EpdGlyph* glyph, uint32_t glyphIndex) {
+  const uint32_t tStart = micros();
+  stats.getBitmapCalls++;
+
+  if (!fontData->groups || fontData->groupCount == 0) {
+    stats.getBitmapTimeUs += micros() - tStart;
+    return &fontData->bitmap[glyph->dataOffset];
+  }
+
+  if (const uint8_t* pageBitmap = getPageBitmap(fontData, glyphIndex)) {
+    stats.cacheHits++;
+    stats.getBitmapTimeUs += micros() - tStart;
+    return pageBitmap;
   }
 
   // Fallback: hot group slot
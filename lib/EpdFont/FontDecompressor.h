@@ -21,6 +21,10 @@ class FontDecompressor {
   // Checks the page buffer (from prewarm) first, then falls back to the hot group slot.
   const uint8_t* getBitmap(const EpdFontData* fontData, const EpdGlyph* glyph, uint32_t glyphIndex);
 
+  // Returns the glyph's bitmap in the page buffer, or nullptr if prewarmCache() did not extract it.
+  // Unlike hot-group bitmaps, the pointer stays valid until clearCache().
+  const uint8_t* getPageBitmap(const EpdFontData* fontData, uint32_t glyphIndex) const;
+
   // Free all cached data (page buffer + hot group).
   void clearCache();
 
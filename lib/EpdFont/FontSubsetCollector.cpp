@@ -0,0 +1,30 @@
+#include "FontSubsetCollector.h"
+
+#include <Utf8.h>
+
+#include <algorithm>
+
+void FontSubsetCollector::add(const char* utf8Text, const uint8_t style) {
+  const auto* p = reinterpret_cast<const unsigned char*>(utf8Text);
+  while (*p) {
+    const uint32_t cp = utf8NextCodepoint(&p);
+    if (cp == 0) break;
+    add(cp, style);
+  }
+}
+
+void FontSubsetCollector::add(const uint32_t codepoint, const uint8_t style) {
+  if (codepoint > 0xFFFF) return;
+  const uint32_t key = entry(style & 0x03, codepoint);
+  const auto it = std::lower_bound(sorted_.begin(), sorted_.end(), key);
+  if (it != sorted_.end() && *it == key) return;
+  sorted_.insert(it, key);
+  firstUse_.push_back(key);
+}
+
+void FontSubsetCollector::clear() {
+  firstUse_.clear();
+  sorted_.clear();
+  firstUse_.shrink_to_fit();
+  sorted_.shrink_to_fit();
+}
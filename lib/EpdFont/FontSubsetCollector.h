@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Records which codepoints a book's text uses in each font style, in order of first use, for
+// SdCardFont::updateSubset(). Only BMP codepoints are kept; anything else is always read from the
+// full font.
+//
+// Entries are packed as (style << 16) | codepoint. A sorted copy answers "seen before?" with a
+// binary search, so each new entry costs one insertion and repeats cost nothing.
+class FontSubsetCollector {
+ public:
+  static uint32_t entry(const uint8_t style, const uint32_t codepoint) {
+    return static_cast<uint32_t>(style) << 16 | codepoint;
+  }
+  static uint8_t entryStyle(const uint32_t entry) { return static_cast<uint8_t>(entry >> 16); }
+  static uint16_t entryCodepoint(const uint32_t entry) { return static_cast<uint16_t>(entry); }
+
+  // style is an SdCardFont style index (0=regular, 1=bold, 2=italic, 3=bold italic)
+  void add(const char* utf8Text, uint8_t style);
+  void add(uint32_t codepoint, uint8_t style);
+  void clear();
+
+  bool empty() const { return firstUse_.empty(); }
+  // Entries in order of first use
+  const std::vector<uint32_t>& entries() const { return firstUse_; }
+
+ private:
+  std::vector<uint32_t> firstUse_;
+  std::vector<uint32_t> sorted_;
+};
@@ -79,11 +79,8 @@ void SdCardFont::freeStyleMiniData(PerStyle& s) {
   s.miniIntervals = nullptr;
   delete[] s.miniGlyphs;
   s.miniGlyphs = nullptr;
-  delete[] s.miniBitmap;
-  s.miniBitmap = nullptr;
   s.miniIntervalCount = 0;
   s.miniGlyphCount = 0;
-  freeStyleMiniKern(s);
   memset(&s.miniData, 0, sizeof(s.miniData));
   s.epdFont.data = &s.stubData;
 }
@@ -93,26 +90,30 @@ void SdCardFont::freeStyleKernLigatureData(PerStyle& s) {
   s.kernLeftClasses = nullptr;
   delete[] s.kernRightClasses;
   s.kernRightClasses = nullptr;
+  delete[] s.kernRowStarts;
+  s.kernRowStarts = nullptr;
+  delete[] s.kernPairs;
+  s.kernPairs = nullptr;
   delete[] s.ligaturePairs;
   s.ligaturePairs = nullptr;
   s.kernLigLoaded = false;
+  applyKernLigaturePointers(s, s.stubData);
 }
 
-void SdCardFont::freeStyleMiniKern(PerStyle& s) {
-  delete[] s.miniKernLeftClasses;
-  s.miniKernLeftClasses = nullptr;
-  delete[] s.miniKernRightClasses;
-  s.miniKernRightClasses = nullptr;
-  delete[] s.miniKernMatrix;
-  s.miniKernMatrix = nullptr;
-  s.miniKernLeftEntryCount = 0;
-  s.miniKernRightEntryCount = 0;
-  s.miniKernLeftClassCount = 0;
-  s.miniKernRightClassCount = 0;
+void SdCardFont::freeStyleGlyphStore(PerStyle& s) {
+  delete[] s.storeGlyphs;
+  s.storeGlyphs = nullptr;
+  s.storeGlyphCount = 0;
+  s.storeGlyphCapacity = 0;
+  delete[] s.storeBitmap;
+  s.storeBitmap = nullptr;
+  s.storeBitmapUsed = 0;
+  s.storeBitmapCapacity = 0;
 }
 
 void SdCardFont::freeStyleAll(PerStyle& s) {
   freeStyleMiniData(s);
+  freeStyleGlyphStore(s);
   delete[] s.fullIntervals;
   s.fullIntervals = nullptr;
   delete[] s.bmpIntervals;
@@ -127,6 +128,7 @@ void SdCardFont::freeStyleAll(PerStyle& s) {
 void SdCardFont::freeAll() {
   clearOverflow();
   clearPersistentCache();
+  detachSubset();
   for (uint8_t i = 0; i < MAX_STYLES; i++) {
     freeStyleAll(styles_[i]);
   }
@@ -148,23 +150,26 @@ void SdCardFont::clearOverflow() {
 // --- Per-style kern/ligature ---
 
 void SdCardFont::applyKernLigaturePointers(PerStyle& s, EpdFontData& data) const {
-  // Kern data uses the per-page mini tables (renumbered class IDs). The full
-  // kern matrix is never resident — see PerStyle::miniKernMatrix comment.
-  data.kernLeftClasses = s.miniKernLeftClasses;
-  data.kernRightClasses = s.miniKernRightClasses;
-  data.kernMatrix = s.miniKernMatrix;
-  data.kernLeftEntryCount = s.miniKernLeftEntryCount;
-  data.kernRightEntryCount = s.miniKernRightEntryCount;
-  data.kernLeftClassCount = s.miniKernLeftClassCount;
-  data.kernRightClassCount = s.miniKernRightClassCount;
+  // Kerning uses the resident sparse rows (see PerStyle::kernRowStarts), so
+  // every page and layout pass sees the whole table. All nullptr until loaded.
+  const bool hasKern = s.kernPairs != nullptr;
+  data.kernLeftClasses = hasKern ? s.kernLeftClasses : nullptr;
+  data.kernRightClasses = hasKern ? s.kernRightClasses : nullptr;
+  data.kernMatrix = nullptr;
+  data.kernRowStarts = hasKern ? s.kernRowStarts : nullptr;
+  data.kernPairs = hasKern ? s.kernPairs : nullptr;
+  data.kernLeftEntryCount = hasKern ? s.header.kernLeftEntryCount : 0;
+  data.kernRightEntryCount = hasKern ? s.header.kernRightEntryCount : 0;
+  data.kernLeftClassCount = hasKern ? s.header.kernLeftClassCount : 0;
+  data.kernRightClassCount = hasKern ? s.header.kernRightClassCount : 0;
   // Ligatures are small (typically < 1KB) so they stay resident.
   data.ligaturePairs = s.ligaturePairs;
-  data.ligaturePairCount = s.header.ligaturePairCount;
+  data.ligaturePairCount = s.ligaturePairs ? s.header.ligaturePairCount : 0;
 }
 
 bool SdCardFont::loadStyleKernLigatureData(PerStyle& s) {
   if (s.kernLigLoaded) return true;
-  bool hasKern = s.header.kernLeftEntryCount > 0;
+  bool hasKern = s.header.kernLeftEntryCount > 0 && s.header.kernRightEntryCount > 0 && s.header.kernPairCount > 0;
   bool hasLig = s.header.ligaturePairCount > 0;
   if (!hasKern && !hasLig) {
     s.kernLigLoaded = true;
@@ -178,15 +183,16 @@ bool SdCardFont::loadStyleKernLigatureData(PerStyle& s) {
   }
 
   if (hasKern) {
-    // Load only the small class-lookup tables (~3KB each). The full matrix
-    // (~36KB contiguous for Literata) is built per-page from SD in
-    // buildMiniKernMatrix().
+    // Class tables, row starts and pairs are contiguous on disk
+    const uint16_t leftClasses = s.header.kernLeftClassCount;
     s.kernLeftClasses = new (std::nothrow) EpdKernClassEntry[s.header.kernLeftEntryCount];
     s.kernRightClasses = new (std::nothrow) EpdKernClassEntry[s.header.kernRightEntryCount];
+    s.kernRowStarts = new (std::nothrow) uint16_t[leftClasses + 1];
+    s.kernPairs = new (std::nothrow) EpdKernPair[s.header.kernPairCount];
 
-    if (!s.kernLeftClasses || !s.kernRightClasses) {
-      LOG_ERR("SDCF", "Failed to allocate kern classes (%u+%u bytes)", s.header.kernLeftEntryCount * 3u,
-              s.header.kernRightEntryCount * 3u);
+    if (!s.kernLeftClasses || !s.kernRightClasses || !s.kernRowStarts || !s.kernPairs) {
+      LOG_ERR("SDCF", "Failed to allocate kern tables (%u+%u+%u+%u bytes)", s.header.kernLeftEntryCount * 3u,
+              s.header.kernRightEntryCount * 3u, (leftClasses + 1u) * 2u, s.header.kernPairCount * 2u);
       freeStyleKernLigatureData(s);
       return false;
     }
@@ -198,9 +204,38 @@ bool SdCardFont::loadStyleKernLigatureData(PerStyle& s) {
     }
     size_t leftSz = s.header.kernLeftEntryCount * sizeof(EpdKernClassEntry);
     size_t rightSz = s.header.kernRightEntryCount * sizeof(EpdKernClassEntry);
+    size_t rowStartsSz = (leftClasses + 1u) * sizeof(uint16_t);
+    size_t pairsSz = s.header.kernPairCount * sizeof(EpdKernPair);
     if (file.read(reinterpret_cast<uint8_t*>(s.kernLeftClasses), leftSz) != static_cast<int>(leftSz) ||
-        file.read(reinterpret_cast<uint8_t*>(s.kernRightClasses), rightSz) != static_cast<int>(rightSz)) {
-      LOG_ERR("SDCF", "Failed to read kern classes");
+        file.read(reinterpret_cast<uint8_t*>(s.kernRightClasses), rightSz) != static_cast<int>(rightSz) ||
+        file.read(reinterpret_cast<uint8_t*>(s.kernRowStarts), rowStartsSz) != static_cast<int>(rowStartsSz) ||
+        file.read(reinterpret_cast<uint8_t*>(s.kernPairs), pairsSz) != static_cast<int>(pairsSz)) {
+      LOG_ERR("SDCF", "Failed to read kern tables");
+      freeStyleKernLigatureData(s);
+      return false;
+    }
+
+    // getKerning indexes rows by class ID and binary-searches each row, so
+    // reject tables that would send it out of bounds
+    bool valid = s.kernRowStarts[0] == 0 && s.kernRowStarts[leftClasses] == s.header.kernPairCount;
+    for (uint16_t i = 0; i < s.header.kernLeftEntryCount && valid; i++) {
+      valid = s.kernLeftClasses[i].classId >= 1 && s.kernLeftClasses[i].classId <= leftClasses;
+    }
+    for (uint16_t i = 0; i < s.header.kernRightEntryCount && valid; i++) {
+      valid = s.kernRightClasses[i].classId >= 1 && s.kernRightClasses[i].classId <= s.header.kernRightClassCount;
+    }
+    for (uint16_t row = 0; row < leftClasses && valid; row++) {
+      valid = s.kernRowStarts[row] <= s.kernRowStarts[row + 1];
+    }
+    for (uint16_t row = 0; row < leftClasses && valid; row++) {
+      for (uint16_t i = s.kernRowStarts[row]; i < s.kernRowStarts[row + 1] && valid; i++) {
+        const uint8_t rc = s.kernPairs[i].rightClassId;
+        valid = rc >= 1 && rc <= s.header.kernRightClassCount &&
+                (i == s.kernRowStarts[row] || s.kernPairs[i - 1].rightClassId < rc);
+      }
+    }
+    if (!valid) {
+      LOG_ERR("SDCF", "Malformed kern tables");
       freeStyleKernLigatureData(s);
       return false;
     }
@@ -228,168 +263,11 @@ bool SdCardFont::loadStyleKernLigatureData(PerStyle& s) {
 
   s.kernLigLoaded = true;
 
-  // Make ligatures visible to the stub (used when no mini data built yet).
-  // Kern stays nullptr on the stub — it is only wired in miniData via
-  // applyKernLigaturePointers() after buildMiniKernMatrix() runs.
-  s.stubData.ligaturePairs = s.ligaturePairs;
-  s.stubData.ligaturePairCount = s.header.ligaturePairCount;
+  // Make kerning and ligatures visible to the stub (used when no mini data built yet)
+  applyKernLigaturePointers(s, s.stubData);
 
-  LOG_DBG("SDCF", "Kern classes + lig loaded: kernL=%u, kernR=%u, ligs=%u", s.header.kernLeftEntryCount,
-          s.header.kernRightEntryCount, s.header.ligaturePairCount);
-  return true;
-}
-
-// --- Per-page mini kern matrix ---
-
-// Local copy of EpdFont.cpp's lookupKernClass (that one is file-static there).
-// Returns the 1-based class ID for `cp`, or 0 if the codepoint has no kerning class.
-static uint8_t miniLookupKernClass(const EpdKernClassEntry* entries, uint16_t count, uint32_t cp) {
-  if (!entries || count == 0 || cp > 0xFFFF) return 0;
-  const auto target = static_cast<uint16_t>(cp);
-  const auto* end = entries + count;
-  const auto it =
-      std::lower_bound(entries, end, target, [](const EpdKernClassEntry& e, uint16_t v) { return e.codepoint < v; });
-  return (it != end && it->codepoint == target) ? it->classId : 0;
-}
-
-// Build a small per-page kern matrix containing ONLY the (leftClass, rightClass)
-// pairs reachable from codepoints in the current text. Class IDs are renumbered
-// to a dense 1..N range so the resulting matrix is usedLeft × usedRight (typical
-// Latin page: ~25×25 bytes) instead of the font's full ~180×200 (~36KB).
-//
-// Correctness: EpdFont::getKerning only touches `kernLeftClasses` /
-// `kernRightClasses` / `kernMatrix` / the count fields — we swap all of them to
-// the mini versions together in applyKernLigaturePointers, so a codepoint not
-// on this page simply returns class 0 (no kerning), which was the pre-existing
-// behavior for any codepoint outside the kern classes.
-bool SdCardFont::buildMiniKernMatrix(PerStyle& s, const uint32_t* codepoints, uint32_t cpCount) {
-  freeStyleMiniKern(s);
-  if (!s.kernLeftClasses || !s.kernRightClasses || s.header.kernLeftEntryCount == 0 ||
-      s.header.kernRightEntryCount == 0) {
-    return true;  // font has no kern classes — nothing to build
-  }
-
-  // Step 1: mark used left/right classes via a 256-wide bitmap (class IDs are uint8_t).
-  bool usedLeft[256] = {};
-  bool usedRight[256] = {};
-  for (uint32_t i = 0; i < cpCount; i++) {
-    uint8_t lc = miniLookupKernClass(s.kernLeftClasses, s.header.kernLeftEntryCount, codepoints[i]);
-    if (lc) usedLeft[lc] = true;
-    uint8_t rc = miniLookupKernClass(s.kernRightClasses, s.header.kernRightEntryCount, codepoints[i]);
-    if (rc) usedRight[rc] = true;
-  }
-
-  // Step 2: build renumber maps (oldClassId -> newClassId, 1-based) and
-  // reverse maps (newClassId -> oldClassId) for the SD read step.
-  uint8_t leftRenumber[256] = {};
-  uint8_t rightRenumber[256] = {};
-  uint8_t newToOldLeft[256] = {};
-  uint8_t newToOldRight[256] = {};
-  uint8_t numLeft = 0, numRight = 0;
-  for (int i = 1; i < 256; i++) {
-    if (usedLeft[i]) {
-      numLeft++;
-      leftRenumber[i] = numLeft;
-      newToOldLeft[numLeft] = static_cast<uint8_t>(i);
-    }
-    if (usedRight[i]) {
-      numRight++;
-      rightRenumber[i] = numRight;
-      newToOldRight[numRight] = static_cast<uint8_t>(i);
-    }
-  }
-  if (numLeft == 0 || numRight == 0) {
-    return true;  // no kern pairs applicable on this page
-  }
-
-  // Step 3: count how many codepoint→classId entries the mini class tables need.
-  // Each resident class table has one entry per kerned codepoint in the page.
-  uint16_t miniLeftCount = 0;
-  uint16_t miniRightCount = 0;
-  for (uint32_t i = 0; i < cpCount; i++) {
-    if (miniLookupKernClass(s.kernLeftClasses, s.header.kernLeftEntryCount, codepoints[i]) != 0) miniLeftCount++;
-    if (miniLookupKernClass(s.kernRightClasses, s.header.kernRightEntryCount, codepoints[i]) != 0) miniRightCount++;
-  }
-
-  // Step 4: allocate the three mini buffers. The matrix is <1KB in practice
-  // (<30 × <30 × 1 byte) so fragmentation is a non-issue.
-  const uint32_t matrixBytes = static_cast<uint32_t>(numLeft) * numRight;
-  s.miniKernLeftClasses = new (std::nothrow) EpdKernClassEntry[miniLeftCount];
-  s.miniKernRightClasses = new (std::nothrow) EpdKernClassEntry[miniRightCount];
-  s.miniKernMatrix = new (std::nothrow) int8_t[matrixBytes];
-  if (!s.miniKernLeftClasses || !s.miniKernRightClasses || !s.miniKernMatrix) {
-    LOG_ERR("SDCF", "Failed to allocate mini kern (%u+%u+%u bytes)", miniLeftCount * 3u, miniRightCount * 3u,
-            matrixBytes);
-    freeStyleMiniKern(s);
-    return false;
-  }
-
-  // Step 5: populate mini class tables. `codepoints` is already sorted (see
-  // prewarm()) so the output is sorted by codepoint — required for binary
-  // search in lookupKernClass during render.
-  uint16_t lIdx = 0, rIdx = 0;
-  for (uint32_t i = 0; i < cpCount; i++) {
-    uint32_t cp = codepoints[i];
-    if (cp > 0xFFFF) continue;  // kern class entries are uint16_t
-    uint8_t lc = miniLookupKernClass(s.kernLeftClasses, s.header.kernLeftEntryCount, cp);
-    if (lc) {
-      s.miniKernLeftClasses[lIdx].codepoint = static_cast<uint16_t>(cp);
-      s.miniKernLeftClasses[lIdx].classId = leftRenumber[lc];
-      lIdx++;
-    }
-    uint8_t rc = miniLookupKernClass(s.kernRightClasses, s.header.kernRightEntryCount, cp);
-    if (rc) {
-      s.miniKernRightClasses[rIdx].codepoint = static_cast<uint16_t>(cp);
-      s.miniKernRightClasses[rIdx].classId = rightRenumber[rc];
-      rIdx++;
-    }
-  }
-
-  // Step 6: read the full matrix's rows for each used left class, keep only
-  // columns for used right classes. One SD seek + one read per used left class;
-  // a row is kernRightClassCount bytes (~200 for Literata).
-  HalFile file;
-  if (!Storage.openFileForRead("SDCF", filePath_, file)) {
-    LOG_ERR("SDCF", "Failed to open .cpfont for mini kern: %s", filePath_);
-    freeStyleMiniKern(s);
-    return false;
-  }
-
-  std::unique_ptr<int8_t[]> rowBuf(new (std::nothrow) int8_t[s.header.kernRightClassCount]);
-  if (!rowBuf) {
-    LOG_ERR("SDCF", "Failed to allocate row buffer (%u bytes)", s.header.kernRightClassCount);
-    freeStyleMiniKern(s);
-    return false;
-  }
-
-  for (uint8_t newL = 1; newL <= numLeft; newL++) {
-    const uint8_t oldL = newToOldLeft[newL];
-    const uint32_t rowFileOff = s.kernMatrixFileOffset + (oldL - 1u) * s.header.kernRightClassCount;
-    if (!file.seekSet(rowFileOff)) {
-      LOG_ERR("SDCF", "Failed to seek to kern row %u", oldL);
-      freeStyleMiniKern(s);
-      return false;
-    }
-    if (file.read(reinterpret_cast<uint8_t*>(rowBuf.get()), s.header.kernRightClassCount) !=
-        static_cast<int>(s.header.kernRightClassCount)) {
-      LOG_ERR("SDCF", "Failed to read kern row %u", oldL);
-      freeStyleMiniKern(s);
-      return false;
-    }
-    int8_t* miniRow = s.miniKernMatrix + (newL - 1u) * numRight;
-    for (uint8_t newR = 1; newR <= numRight; newR++) {
-      miniRow[newR - 1] = rowBuf[newToOldRight[newR] - 1u];
-    }
-  }
-
-  s.miniKernLeftEntryCount = lIdx;
-  s.miniKernRightEntryCount = rIdx;
-  s.miniKernLeftClassCount = numLeft;
-  s.miniKernRightClassCount = numRight;
-
-  LOG_DBG("SDCF", "Built mini kern: %u×%u matrix (%u bytes, full was %u×%u = %u bytes)", numLeft, numRight, matrixBytes,
-          s.header.kernLeftClassCount, s.header.kernRightClassCount,
-          static_cast<uint32_t>(s.header.kernLeftClassCount) * s.header.kernRightClassCount);
+  LOG_DBG("SDCF", "Kern + lig loaded: kernL=%u, kernR=%u, pairs=%u, ligs=%u", s.header.kernLeftEntryCount,
+          s.header.kernRightEntryCount, s.header.kernPairCount, s.header.ligaturePairCount);
   return true;
 }
 
@@ -411,9 +289,13 @@ void SdCardFont::computeStyleFileOffsets(PerStyle& s, uint32_t baseOffset) {
   s.glyphsFileOffset = s.intervalsFileOffset + s.header.intervalCount * sizeof(EpdUnicodeInterval);
   s.kernLeftFileOffset = s.glyphsFileOffset + s.header.glyphCount * sizeof(EpdGlyph);
   s.kernRightFileOffset = s.kernLeftFileOffset + s.header.kernLeftEntryCount * sizeof(EpdKernClassEntry);
-  s.kernMatrixFileOffset = s.kernRightFileOffset + s.header.kernRightEntryCount * sizeof(EpdKernClassEntry);
-  s.ligatureFileOffset =
-      s.kernMatrixFileOffset + static_cast<uint32_t>(s.header.kernLeftClassCount) * s.header.kernRightClassCount;
+  s.kernRowsFileOffset = s.kernRightFileOffset + s.header.kernRightEntryCount * sizeof(EpdKernClassEntry);
+  // Sparse kern rows: kernLeftClassCount + 1 row starts, then the pairs. Absent without kerning.
+  const uint32_t kernRowsBytes =
+      s.header.kernLeftClassCount > 0
+          ? (s.header.kernLeftClassCount + 1u) * sizeof(uint16_t) + s.header.kernPairCount * sizeof(EpdKernPair)
+          : 0;
+  s.ligatureFileOffset = s.kernRowsFileOffset + kernRowsBytes;
   s.bitmapFileOffset = s.ligatureFileOffset + s.header.ligaturePairCount * sizeof(EpdLigaturePair);
 }
 
@@ -495,6 +377,7 @@ bool SdCardFont::load(const char* path) {
     s.header.kernLeftClassCount = tocBuf[21];
     s.header.kernRightClassCount = tocBuf[22];
     s.header.ligaturePairCount = tocBuf[23];
+    s.header.kernPairCount = readU16(tocBuf + 1);
     s.header.is2Bit = is2Bit;
 
     // Sanity-check counts to reject malformed files before allocating.
@@ -504,7 +387,8 @@ bool SdCardFont::load(const char* path) {
     static constexpr uint32_t MAX_GLYPHS = 65536;
     static constexpr uint32_t MAX_KERN_ENTRIES = 4096;
     if (s.header.intervalCount > MAX_INTERVALS || s.header.glyphCount > MAX_GLYPHS ||
-        s.header.kernLeftEntryCount > MAX_KERN_ENTRIES || s.header.kernRightEntryCount > MAX_KERN_ENTRIES) {
+        s.header.kernLeftEntryCount > MAX_KERN_ENTRIES || s.header.kernRightEntryCount > MAX_KERN_ENTRIES ||
+        s.header.kernPairCount > static_cast<uint32_t>(s.header.kernLeftClassCount) * s.header.kernRightClassCount) {
       LOG_ERR("SDCF", "Style %u: unreasonable counts (iv=%u, gl=%u, kL=%u, kR=%u)", styleId, s.header.intervalCount,
               s.header.glyphCount, s.header.kernLeftEntryCount, s.header.kernRightEntryCount);
       file.close();
@@ -655,6 +539,111 @@ int32_t SdCardFont::findGlobalGlyphIndex(const PerStyle& s, uint32_t codepoint)
   return -1;
 }
 
+// --- Cross-page glyph store ---
+
+const SdCardFont::PerStyle::StoredGlyph* SdCardFont::findStoredGlyph(const PerStyle& s, uint32_t codepoint) const {
+  const PerStyle::StoredGlyph* begin = s.storeGlyphs;
+  const PerStyle::StoredGlyph* end = begin + s.storeGlyphCount;
+  const auto* it = std::lower_bound(begin, end, codepoint,
+                                    [](const PerStyle::StoredGlyph& g, uint32_t cp) { return g.codepoint < cp; });
+  return (it != end && it->codepoint == codepoint) ? it : nullptr;
+}
+
+// Evict least recently used glyphs until the store fits maxBytes / maxGlyphs.
+// Among glyphs last used by the same prewarm the largest bitmaps go first, so
+// the store keeps as many glyphs as possible. Glyphs stamped keepSerial belong
+// to the page being prewarmed and are never evicted. Survivors are compacted to
+// the front of storeBitmap so the free space is one contiguous tail.
+void SdCardFont::evictGlyphStore(PerStyle& s, uint32_t maxBytes, uint32_t maxGlyphs, uint32_t keepSerial) {
+  if (s.storeBitmapUsed <= maxBytes && s.storeGlyphCount <= maxGlyphs) return;
+
+  std::unique_ptr<uint16_t[]> order(new (std::nothrow) uint16_t[s.storeGlyphCount]);
+  if (!order) {
+    LOG_ERR("SDCF", "Failed to allocate glyph store eviction order (%u entries)", s.storeGlyphCount);
+    return;
+  }
+  uint32_t candidates = 0;
+  for (uint32_t i = 0; i < s.storeGlyphCount; i++) {
+    if (s.storeGlyphs[i].lastUsed != keepSerial) order[candidates++] = static_cast<uint16_t>(i);
+  }
+  std::sort(order.get(), order.get() + candidates, [&](uint16_t a, uint16_t b) {
+    const auto& ga = s.storeGlyphs[a];
+    const auto& gb = s.storeGlyphs[b];
+    if (ga.lastUsed != gb.lastUsed) return ga.lastUsed < gb.lastUsed;
+    return ga.glyph.dataLength > gb.glyph.dataLength;
+  });
+
+  // lastUsed == 0 marks an evicted glyph; prewarmSerial_ starts stamping at 1.
+  uint32_t keptBytes = s.storeBitmapUsed;
+  uint32_t keptGlyphs = s.storeGlyphCount;
+  for (uint32_t i = 0; i < candidates && (keptBytes > maxBytes || keptGlyphs > maxGlyphs); i++) {
+    auto& g = s.storeGlyphs[order[i]];
+    keptBytes -= g.glyph.dataLength;
+    keptGlyphs--;
+    g.lastUsed = 0;
+  }
+  if (keptGlyphs == s.storeGlyphCount) return;
+
+  // Compact bitmaps in arena order so each memmove only moves data backwards.
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < s.storeGlyphCount; i++) {
+    if (s.storeGlyphs[i].lastUsed != 0) s.storeGlyphs[kept++] = s.storeGlyphs[i];
+  }
+  for (uint32_t i = 0; i < kept; i++) order[i] = static_cast<uint16_t>(i);
+  std::sort(order.get(), order.get() + kept, [&](uint16_t a, uint16_t b) {
+    return s.storeGlyphs[a].glyph.dataOffset < s.storeGlyphs[b].glyph.dataOffset;
+  });
+  uint32_t cursor = 0;
+  for (uint32_t i = 0; i < kept; i++) {
+    EpdGlyph& glyph = s.storeGlyphs[order[i]].glyph;
+    if (glyph.dataLength > 0 && glyph.dataOffset != cursor) {
+      memmove(s.storeBitmap + cursor, s.storeBitmap + glyph.dataOffset, glyph.dataLength);
+    }
+    glyph.dataOffset = cursor;
+    cursor += glyph.dataLength;
+  }
+
+  LOG_DBG("SDCF", "Glyph store: evicted %u glyphs (%u bytes)", s.storeGlyphCount - kept, s.storeBitmapUsed - cursor);
+  s.storeGlyphCount = kept;
+  s.storeBitmapUsed = cursor;
+}
+
+// Make room for addGlyphs more glyphs with addBytes of bitmap data, evicting
+// other pages' glyphs first and growing the store past GLYPH_STORE_BUDGET only
+// when the current page alone needs more.
+bool SdCardFont::reserveGlyphStore(PerStyle& s, uint32_t addGlyphs, uint32_t addBytes) {
+  const uint32_t byteBudget = GLYPH_STORE_BUDGET > addBytes ? GLYPH_STORE_BUDGET - addBytes : 0;
+  evictGlyphStore(s, byteBudget, MAX_PAGE_GLYPHS - addGlyphs, prewarmSerial_);
+
+  const uint32_t needGlyphs = s.storeGlyphCount + addGlyphs;
+  if (needGlyphs > s.storeGlyphCapacity) {
+    auto* grown = new (std::nothrow) PerStyle::StoredGlyph[needGlyphs];
+    if (!grown) {
+      LOG_ERR("SDCF", "Failed to grow glyph store to %u glyphs", needGlyphs);
+      return false;
+    }
+    if (s.storeGlyphCount > 0) memcpy(grown, s.storeGlyphs, s.storeGlyphCount * sizeof(PerStyle::StoredGlyph));
+    delete[] s.storeGlyphs;
+    s.storeGlyphs = grown;
+    s.storeGlyphCapacity = needGlyphs;
+  }
+
+  const uint32_t needBytes = s.storeBitmapUsed + addBytes;
+  if (needBytes > s.storeBitmapCapacity) {
+    const uint32_t capacity = std::max(needBytes, GLYPH_STORE_BUDGET);
+    auto* grown = new (std::nothrow) uint8_t[capacity];
+    if (!grown) {
+      LOG_ERR("SDCF", "Failed to grow glyph store bitmap to %u bytes", capacity);
+      return false;
+    }
+    if (s.storeBitmapUsed > 0) memcpy(grown, s.storeBitmap, s.storeBitmapUsed);
+    delete[] s.storeBitmap;
+    s.storeBitmap = grown;
+    s.storeBitmapCapacity = capacity;
+  }
+  return true;
+}
+
 // --- Prewarm ---
 
 int SdCardFont::prewarm(const char* utf8Text, uint8_t styleMask, bool metadataOnly) {
@@ -663,6 +652,7 @@ int SdCardFont::prewarm(const char* utf8Text, uint8_t styleMask, bool metadataOn
   if (styleMask == 0) return 0;
 
   unsigned long startMs = millis();
+  prewarmSerial_++;
 
   // Step 1: Extract unique codepoints from UTF-8 text (shared across all styles).
   // Dedup uses O(n^2) linear scan — worst case is MAX_PAGE_GLYPHS (512) unique codepoints
@@ -709,9 +699,8 @@ int SdCardFont::prewarm(const char* utf8Text, uint8_t styleMask, bool metadataOn
   }
 
   // Add ligature output codepoints from all styles being prewarmed.
-  // Skip during metadata-only prewarm (layout measurement) to avoid loading
-  // kern/lig data for all styles upfront (~22KB per style). Kern/lig is
-  // loaded per-style in prewarmStyle() during the full render prewarm instead.
+  // Skip during metadata-only prewarm (layout measurement): layout does not
+  // substitute ligatures, so their glyphs are only needed to render.
   if (!metadataOnly) {
     for (uint8_t si = 0; si < MAX_STYLES; si++) {
       if (!(styleMask & (1 << si)) || !styles_[si].present) continue;
@@ -761,6 +750,52 @@ int SdCardFont::prewarm(const char* utf8Text, uint8_t styleMask, bool metadataOn
   return totalMissed;
 }
 
+template <typename RangeAt>
+bool SdCardFont::readRanges(HalFile& file, const uint32_t begin, const uint32_t end, RangeAt rangeAt,
+                            uint32_t& seekCount) {
+  if (end - begin > 1 && !readBuffer_) readBuffer_ = new (std::nothrow) uint8_t[READ_BUFFER_SIZE];
+  // Without a bounce buffer every range is read on its own
+  const uint32_t maxSpan = readBuffer_ ? READ_BUFFER_SIZE : 0;
+  // The first read always seeks: the file position is wherever the last user left it
+  uint32_t filePos = UINT32_MAX;
+  uint32_t i = begin;
+  while (i < end) {
+    const ReadRange first = rangeAt(i);
+    if (first.length == 0) {
+      i++;
+      continue;
+    }
+    // Grow the span while the next range starts within the gap tolerance and the span still fits
+    uint32_t spanEnd = first.offset + first.length;
+    uint32_t j = i + 1;
+    for (; j < end; j++) {
+      const ReadRange next = rangeAt(j);
+      const uint32_t nextEnd = std::max(spanEnd, next.offset + next.length);
+      if (next.offset > spanEnd + readGapTolerance_ || nextEnd - first.offset > maxSpan) break;
+      spanEnd = nextEnd;
+    }
+
+    if (first.offset != filePos) {
+      if (!file.seekSet(first.offset)) return false;
+      seekCount++;
+    }
+    const uint32_t spanLength = spanEnd - first.offset;
+    if (j == i + 1) {
+      if (file.read(first.dest, first.length) != static_cast<int>(first.length)) return false;
+    } else {
+      if (file.read(readBuffer_, spanLength) != static_cast<int>(spanLength)) return false;
+      for (uint32_t k = i; k < j; k++) {
+        const ReadRange r = rangeAt(k);
+        memcpy(r.dest, readBuffer_ + (r.offset - first.offset), r.length);
+      }
+    }
+    stats_.bytesRead += spanLength;
+    filePos = spanEnd;
+    i = j;
+  }
+  return true;
+}
+
 int SdCardFont::prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint32_t cpCount, bool metadataOnly) {
   auto& s = styles_[styleIdx];
 
@@ -768,6 +803,8 @@ int SdCardFont::prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint3
   struct CpGlyphMapping {
     uint32_t codepoint;
     int32_t globalIndex;
+    int32_t subsetIndex;   // glyph index in the attached subset, or -1
+    uint32_t storeOffset;  // where a missed glyph's bitmap lands in the store
   };
   CpGlyphMapping* mappings = new (std::nothrow) CpGlyphMapping[cpCount];
   if (!mappings) {
@@ -781,6 +818,7 @@ int SdCardFont::prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint3
     if (idx >= 0) {
       mappings[validCount].codepoint = codepoints[i];
       mappings[validCount].globalIndex = idx;
+      mappings[validCount].subsetIndex = -1;
       validCount++;
     }
   }
@@ -826,7 +864,8 @@ int SdCardFont::prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint3
     return static_cast<int>(cpCount);
   }
 
-  // Build sorted read order for sequential I/O
+  // Serve glyphs the store already holds; only the misses are read from SD.
+  // Full prewarms stamp their hits so eviction keeps this page's glyphs.
   uint32_t* readOrder = new (std::nothrow) uint32_t[validCount];
   if (!readOrder) {
     LOG_ERR("SDCF", "Failed to allocate read order for style %u", styleIdx);
@@ -834,12 +873,43 @@ int SdCardFont::prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint3
     freeStyleMiniData(s);
     return static_cast<int>(cpCount);
   }
-  for (uint32_t i = 0; i < validCount; i++) readOrder[i] = i;
-  std::sort(readOrder, readOrder + validCount,
-            [&](uint32_t a, uint32_t b) { return mappings[a].globalIndex < mappings[b].globalIndex; });
+  uint32_t missCount = 0;
+  for (uint32_t i = 0; i < validCount; i++) {
+    auto* stored = const_cast<PerStyle::StoredGlyph*>(findStoredGlyph(s, mappings[i].codepoint));
+    if (stored) {
+      if (!metadataOnly) stored->lastUsed = prewarmSerial_;
+      s.miniGlyphs[i] = stored->glyph;
+    } else {
+      readOrder[missCount++] = i;
+    }
+  }
+
+  // Misses the attached subset holds are read from it, the rest from the full font
+  uint32_t subsetMisses = 0;
+  HalFile subsetFile;
+  if (missCount > 0 && s.subsetGlyphCount > 0) {
+    if (Storage.openFileForRead("SDCF", subsetPath_, subsetFile)) {
+      for (uint32_t i = 0; i < missCount; i++) {
+        CpGlyphMapping& m = mappings[readOrder[i]];
+        m.subsetIndex = findSubsetGlyphIndex(s, m.codepoint);
+        if (m.subsetIndex >= 0) subsetMisses++;
+      }
+    } else {
+      LOG_ERR("SDCF", "Subset unreadable, detaching: %s", subsetPath_);
+      detachSubset();
+    }
+  }
+  const auto fromSubset = [&](uint32_t mapIdx) { return mappings[mapIdx].subsetIndex >= 0; };
+
+  // Build sorted read order for sequential I/O: subset glyphs first, each source in file order
+  std::sort(readOrder, readOrder + missCount, [&](uint32_t a, uint32_t b) {
+    if (fromSubset(a) != fromSubset(b)) return fromSubset(a);
+    return fromSubset(a) ? mappings[a].subsetIndex < mappings[b].subsetIndex
+                         : mappings[a].globalIndex < mappings[b].globalIndex;
+  });
 
   HalFile file;
-  if (!Storage.openFileForRead("SDCF", filePath_, file)) {
+  if (missCount > subsetMisses && !Storage.openFileForRead("SDCF", filePath_, file)) {
     LOG_ERR("SDCF", "Failed to reopen .cpfont for prewarm (style %u)", styleIdx);
     delete[] readOrder;
     delete[] mappings;
@@ -850,116 +920,95 @@ int SdCardFont::prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint3
   unsigned long sdStart = millis();
   uint32_t seekCount = 0;
 
-  // Read glyph metadata. lastReadIndex tracks sequential reads to skip redundant
-  // seeks; INT32_MIN guarantees the first iteration always seeks to the correct
-  // offset (otherwise when gIdx == 0, the "gIdx != lastReadIndex + 1" check would
-  // be false and we'd read from the file's current position — the header — which
-  // decodes to a garbage EpdGlyph with a massive advanceX, inflating any word
-  // containing that codepoint beyond page width).
-  int32_t lastReadIndex = INT32_MIN;
-  for (uint32_t i = 0; i < validCount; i++) {
-    uint32_t mapIdx = readOrder[i];
-    int32_t gIdx = mappings[mapIdx].globalIndex;
+  // Read glyph metadata, one source at a time
+  const auto glyphRange = [&](uint32_t k) {
+    const uint32_t mapIdx = readOrder[k];
+    const CpGlyphMapping& m = mappings[mapIdx];
+    const uint32_t offset = m.subsetIndex >= 0 ? s.subsetGlyphsFileOffset + m.subsetIndex * sizeof(EpdGlyph)
+                                               : s.glyphsFileOffset + m.globalIndex * sizeof(EpdGlyph);
+    return ReadRange{offset, sizeof(EpdGlyph), reinterpret_cast<uint8_t*>(&s.miniGlyphs[mapIdx])};
+  };
+  if (!readRanges(subsetFile, 0, subsetMisses, glyphRange, seekCount) ||
+      !readRanges(file, subsetMisses, missCount, glyphRange, seekCount)) {
+    LOG_ERR("SDCF", "Prewarm: failed to read glyph metadata (style %u)", styleIdx);
+    delete[] readOrder;
+    delete[] mappings;
+    freeStyleMiniData(s);
+    return static_cast<int>(cpCount);
+  }
 
-    uint32_t fileOff = s.glyphsFileOffset + static_cast<uint32_t>(gIdx) * sizeof(EpdGlyph);
-    if (gIdx != lastReadIndex + 1) {
-      if (!file.seekSet(fileOff)) {
-        LOG_ERR("SDCF", "Prewarm: failed to seek to glyph %d (style %u)", gIdx, styleIdx);
-        file.close();
-        delete[] readOrder;
-        delete[] mappings;
-        freeStyleMiniData(s);
-        return static_cast<int>(cpCount);
-      }
-      seekCount++;
+  uint32_t missBitmapSize = 0;
+
+  if (!metadataOnly) {
+    for (uint32_t i = 0; i < missCount; i++) {
+      missBitmapSize += s.miniGlyphs[readOrder[i]].dataLength;
     }
-    if (file.read(reinterpret_cast<uint8_t*>(&s.miniGlyphs[mapIdx]), sizeof(EpdGlyph)) != sizeof(EpdGlyph)) {
-      LOG_ERR("SDCF", "Prewarm: short glyph read (style %u, glyph %d)", styleIdx, gIdx);
+
+    // May evict and compact older pages' glyphs, which moves their bitmaps;
+    // miniGlyphs is refreshed from the store below.
+    if (!reserveGlyphStore(s, missCount, missBitmapSize)) {
       delete[] readOrder;
       delete[] mappings;
       freeStyleMiniData(s);
       return static_cast<int>(cpCount);
     }
-    lastReadIndex = gIdx;
-  }
 
-  uint32_t totalBitmapSize = 0;
+    // Read missing bitmaps sorted by file offset onto the end of the store
+    std::sort(readOrder, readOrder + missCount, [&](uint32_t a, uint32_t b) {
+      if (fromSubset(a) != fromSubset(b)) return fromSubset(a);
+      return s.miniGlyphs[a].dataOffset < s.miniGlyphs[b].dataOffset;
+    });
 
-  if (!metadataOnly) {
-    // Compute total bitmap size
-    for (uint32_t i = 0; i < validCount; i++) {
-      totalBitmapSize += s.miniGlyphs[i].dataLength;
+    uint32_t storeOffset = s.storeBitmapUsed;
+    for (uint32_t i = 0; i < missCount; i++) {
+      mappings[readOrder[i]].storeOffset = storeOffset;
+      storeOffset += s.miniGlyphs[readOrder[i]].dataLength;
     }
-
-    s.miniBitmap = new (std::nothrow) uint8_t[totalBitmapSize > 0 ? totalBitmapSize : 1];
-    if (!s.miniBitmap) {
-      LOG_ERR("SDCF", "Failed to allocate mini bitmap (%u bytes) for style %u", totalBitmapSize, styleIdx);
+    const auto bitmapRange = [&](uint32_t k) {
+      const uint32_t mapIdx = readOrder[k];
+      const EpdGlyph& glyph = s.miniGlyphs[mapIdx];
+      const uint32_t base = fromSubset(mapIdx) ? s.subsetBitmapFileOffset : s.bitmapFileOffset;
+      return ReadRange{base + glyph.dataOffset, glyph.dataLength, s.storeBitmap + mappings[mapIdx].storeOffset};
+    };
+    if (!readRanges(subsetFile, 0, subsetMisses, bitmapRange, seekCount) ||
+        !readRanges(file, subsetMisses, missCount, bitmapRange, seekCount)) {
+      LOG_ERR("SDCF", "Prewarm: failed to read bitmaps (style %u)", styleIdx);
       delete[] readOrder;
       delete[] mappings;
       freeStyleMiniData(s);
       return static_cast<int>(cpCount);
     }
+    for (uint32_t i = 0; i < missCount; i++) {
+      s.miniGlyphs[readOrder[i]].dataOffset = mappings[readOrder[i]].storeOffset;
+    }
 
-    // Read bitmap data sorted by file offset
-    std::sort(readOrder, readOrder + validCount,
-              [&](uint32_t a, uint32_t b) { return s.miniGlyphs[a].dataOffset < s.miniGlyphs[b].dataOffset; });
-
-    uint32_t miniBitmapOffset = 0;
-    uint32_t lastBitmapEnd = UINT32_MAX;
+    // Commit the misses to the store only once every read succeeded
+    for (uint32_t i = 0; i < missCount; i++) {
+      const uint32_t mapIdx = readOrder[i];
+      s.storeGlyphs[s.storeGlyphCount++] = {mappings[mapIdx].codepoint, prewarmSerial_, s.miniGlyphs[mapIdx]};
+    }
+    s.storeBitmapUsed = storeOffset;
+    if (missCount > 0) {
+      std::sort(s.storeGlyphs, s.storeGlyphs + s.storeGlyphCount,
+                [](const PerStyle::StoredGlyph& a, const PerStyle::StoredGlyph& b) {
+                  return a.codepoint < b.codepoint;
+                });
+    }
     for (uint32_t i = 0; i < validCount; i++) {
-      uint32_t mapIdx = readOrder[i];
-      EpdGlyph& glyph = s.miniGlyphs[mapIdx];
-
-      if (glyph.dataLength == 0) {
-        glyph.dataOffset = miniBitmapOffset;
-        continue;
-      }
-
-      uint32_t fileOff = s.bitmapFileOffset + glyph.dataOffset;
-      if (fileOff != lastBitmapEnd) {
-        if (!file.seekSet(fileOff)) {
-          LOG_ERR("SDCF", "Prewarm: failed to seek to bitmap (style %u)", styleIdx);
-          file.close();
-          delete[] readOrder;
-          delete[] mappings;
-          freeStyleMiniData(s);
-          return static_cast<int>(cpCount);
-        }
-        seekCount++;
-      }
-      if (file.read(s.miniBitmap + miniBitmapOffset, glyph.dataLength) != static_cast<int>(glyph.dataLength)) {
-        LOG_ERR("SDCF", "Prewarm: short bitmap read (style %u)", styleIdx);
-        delete[] readOrder;
-        delete[] mappings;
-        freeStyleMiniData(s);
-        return static_cast<int>(cpCount);
-      }
-      lastBitmapEnd = fileOff + glyph.dataLength;
-
-      glyph.dataOffset = miniBitmapOffset;
-      miniBitmapOffset += glyph.dataLength;
+      s.miniGlyphs[i] = findStoredGlyph(s, mappings[i].codepoint)->glyph;
     }
   }
-
   uint32_t sdTime = millis() - sdStart;
   delete[] readOrder;
   delete[] mappings;
 
-  // Full render prewarm: load the persistent kern classes + ligatures (one-time
-  // per style, small — the big matrix is NOT loaded here) and then build the
-  // per-page mini kern matrix restricted to class pairs reachable from this
-  // page's codepoints. Skip during metadata-only prewarm — layout only needs
-  // advanceX and the mini kern would be thrown away before rendering.
-  bool kernLigOk = false;
-  if (!metadataOnly) {
-    if (loadStyleKernLigatureData(s)) {
-      kernLigOk = buildMiniKernMatrix(s, codepoints, cpCount);
-    }
-  }
+  // Kern + ligature tables are loaded once per style and stay resident, so
+  // layout (metadata-only) and render prewarms kern the same way.
+  const bool kernLigOk = loadStyleKernLigatureData(s);
 
   // Populate miniData and swap
   memset(&s.miniData, 0, sizeof(s.miniData));
-  s.miniData.bitmap = s.miniBitmap;
+  s.miniData.bitmap = metadataOnly ? nullptr : s.storeBitmap;
   s.miniData.glyph = s.miniGlyphs;
   s.miniData.intervals = s.miniIntervals;
   s.miniData.intervalCount = s.miniIntervalCount;
@@ -979,7 +1028,9 @@ int SdCardFont::prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint3
   stats_.sdReadTimeMs += sdTime;
   stats_.seekCount += seekCount;
   stats_.uniqueGlyphs += validCount;
-  stats_.bitmapBytes += totalBitmapSize;
+  stats_.bitmapBytes += missBitmapSize;
+  stats_.storeHits += validCount - missCount;
+  stats_.storeMisses += missCount;
 
   return missed;
 }
@@ -989,12 +1040,25 @@ int SdCardFont::prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint3
 void SdCardFont::clearCache() {
   clearOverflow();
   // Note: advance table is intentionally preserved here. It persists across
-  // layout passes so repeated section indexing amortizes SD reads. Use
-  // clearPersistentCache() to wipe it.
+  // layout passes so repeated section indexing amortizes SD reads. The glyph
+  // store likewise carries over to the next page and is only trimmed back to
+  // its budget. Use clearPersistentCache() to wipe them.
   for (uint8_t i = 0; i < MAX_STYLES; i++) {
-    if (!styles_[i].present) continue;
-    freeStyleMiniData(styles_[i]);
+    auto& s = styles_[i];
+    if (!s.present) continue;
+    freeStyleMiniData(s);
     applyGlyphMissCallback(i);
+
+    evictGlyphStore(s, GLYPH_STORE_BUDGET, MAX_PAGE_GLYPHS, 0);
+    if (s.storeBitmapCapacity > GLYPH_STORE_BUDGET) {
+      auto* trimmed = new (std::nothrow) uint8_t[GLYPH_STORE_BUDGET];
+      if (trimmed) {
+        if (s.storeBitmapUsed > 0) memcpy(trimmed, s.storeBitmap, s.storeBitmapUsed);
+        delete[] s.storeBitmap;
+        s.storeBitmap = trimmed;
+        s.storeBitmapCapacity = GLYPH_STORE_BUDGET;
+      }
+    }
   }
 }
 
@@ -1002,10 +1066,15 @@ void SdCardFont::clearCache() {
 
 void SdCardFont::clearPersistentCache() {
   for (uint8_t i = 0; i < MAX_STYLES; i++) {
+    // Mini data points into the glyph store, so it goes too
+    freeStyleMiniData(styles_[i]);
+    freeStyleGlyphStore(styles_[i]);
     delete[] advanceTable_[i];
     advanceTable_[i] = nullptr;
     advanceTableSize_[i] = 0;
   }
+  delete[] readBuffer_;
+  readBuffer_ = nullptr;
 }
 
 bool SdCardFont::advanceTableLookup(uint8_t styleIdx, uint32_t codepoint, uint16_t* outAdvance) const {
@@ -1228,6 +1297,11 @@ int SdCardFont::buildAdvanceTableRange(Iter begin, Iter end, bool includeSpace,
   std::sort(codepoints, codepoints + cpCount);
   int totalMissed = fetchAdvancesForCodepoints(codepoints, cpCount, styleMask);
   delete[] codepoints;
+
+  // Layout kerns with the same resident tables the renderer uses
+  for (uint8_t si = 0; si < MAX_STYLES; si++) {
+    if ((styleMask & (1 << si)) && styles_[si].present) loadStyleKernLigatureData(styles_[si]);
+  }
   stats_.prewarmTotalMs = millis() - startMs;
   return totalMissed;
 }
@@ -1243,8 +1317,9 @@ int SdCardFont::buildAdvanceTable(const std::vector<std::string>& words, bool in
 // --- Stats ---
 
 void SdCardFont::logStats(const char* label) {
-  LOG_DBG("SDCF", "[%s] total=%ums sd_read=%ums seeks=%u glyphs=%u bitmap=%u bytes", label, stats_.prewarmTotalMs,
-          stats_.sdReadTimeMs, stats_.seekCount, stats_.uniqueGlyphs, stats_.bitmapBytes);
+  LOG_DBG("SDCF", "[%s] total=%ums sd_read=%ums seeks=%u read=%u bytes glyphs=%u bitmap=%u bytes store hit=%u miss=%u",
+          label, stats_.prewarmTotalMs, stats_.sdReadTimeMs, stats_.seekCount, stats_.bytesRead, stats_.uniqueGlyphs,
+          stats_.bitmapBytes, stats_.storeHits, stats_.storeMisses);
 }
 
 void SdCardFont::resetStats() { stats_ = Stats{}; }
@@ -1316,15 +1391,24 @@ const EpdGlyph* SdCardFont::onGlyphMiss(void* ctx, uint32_t codepoint) {
   uint32_t slot = self->overflowNext_;
   bool wasAtCapacity = (self->overflowCount_ == OVERFLOW_CAPACITY);
 
-  // Read glyph metadata into temporary
+  // Read glyph metadata into temporary, from the attached subset if it holds the glyph
+  int32_t subsetIdx = self->findSubsetGlyphIndex(s, codepoint);
   HalFile file;
-  if (!Storage.openFileForRead("SDCF", self->filePath_, file)) {
+  if (subsetIdx >= 0 && !Storage.openFileForRead("SDCF", self->subsetPath_, file)) {
+    LOG_ERR("SDCF", "Overflow: subset unreadable, detaching: %s", self->subsetPath_);
+    self->detachSubset();
+    subsetIdx = -1;
+  }
+  if (subsetIdx < 0 && !Storage.openFileForRead("SDCF", self->filePath_, file)) {
     LOG_ERR("SDCF", "Overflow: failed to open .cpfont");
     return nullptr;
   }
+  const uint32_t glyphsFileOffset = subsetIdx >= 0 ? s.subsetGlyphsFileOffset : s.glyphsFileOffset;
+  const uint32_t bitmapFileOffset = subsetIdx >= 0 ? s.subsetBitmapFileOffset : s.bitmapFileOffset;
+  const int32_t glyphIdx = subsetIdx >= 0 ? subsetIdx : globalIdx;
 
   EpdGlyph tempGlyph = {};
-  uint32_t glyphFileOff = s.glyphsFileOffset + static_cast<uint32_t>(globalIdx) * sizeof(EpdGlyph);
+  uint32_t glyphFileOff = glyphsFileOffset + static_cast<uint32_t>(glyphIdx) * sizeof(EpdGlyph);
   if (!file.seekSet(glyphFileOff)) {
     LOG_ERR("SDCF", "Overflow: failed to seek to glyph for U+%04X style %u", codepoint, styleIdx);
     file.close();
@@ -1343,7 +1427,7 @@ const EpdGlyph* SdCardFont::onGlyphMiss(void* ctx, uint32_t codepoint) {
       LOG_ERR("SDCF", "Overflow: failed to allocate %u bytes for U+%04X bitmap", tempGlyph.dataLength, codepoint);
       return nullptr;
     }
-    if (!file.seekSet(s.bitmapFileOffset + tempGlyph.dataOffset)) {
+    if (!file.seekSet(bitmapFileOffset + tempGlyph.dataOffset)) {
       LOG_ERR("SDCF", "Overflow: failed to seek to bitmap for U+%04X", codepoint);
       delete[] tempBitmap;
       file.close();
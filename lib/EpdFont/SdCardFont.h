@@ -7,6 +7,8 @@
 #include "EpdFont.h"
 #include "EpdFontData.h"
 
+class HalFile;
+
 // On-disk binary format version for .cpfont files. Defined as a preprocessor
 // macro (rather than a constexpr) so it can be stringified into the SD-fonts
 // release URL — see FONT_MANIFEST_URL in FontDownloadActivity.h. No integer
@@ -16,12 +18,21 @@
 // lib/EpdFont/scripts/cpfont_version.py. This firmware-side copy must be
 // bumped manually when the firmware is updated to support a new format.
 // Reader enforcement: SdCardFont::load().
-#define CPFONT_VERSION 4
+#define CPFONT_VERSION 5
 
 class SdCardFont {
  public:
   static constexpr uint16_t MAX_PAGE_GLYPHS = 512;
   static constexpr uint8_t MAX_STYLES = 4;
+  // Glyph bitmap bytes each style keeps between pages in its glyph store (see PerStyle::storeGlyphs).
+  // A page that needs more grows the store for that page; clearCache() trims it back.
+  static constexpr uint32_t GLYPH_STORE_BUDGET = 16 * 1024;
+  // Prewarm merges reads of nearby glyph records and bitmaps into one SD read when at most
+  // setReadGapTolerance() bytes lie between them, staging the span in a READ_BUFFER_SIZE bounce
+  // buffer. Starting a read at a new address costs about as much as clocking three or four more
+  // sectors over SPI (see PageLayoutBench --sd-font-reads).
+  static constexpr uint32_t READ_BUFFER_SIZE = 4096;
+  static constexpr uint32_t DEFAULT_READ_GAP_TOLERANCE = 1536;
 
   SdCardFont() = default;
   ~SdCardFont();
@@ -33,7 +44,7 @@ class SdCardFont {
   SdCardFont& operator=(SdCardFont&&) = delete;
 
   // Load .cpfont file: reads header + intervals into RAM, records file layout offsets.
-  // Supports v4 (multi-style) format.
+  // Supports the v5 multi-style format.
   // Returns true on success.
   bool load(const char* path);
 
@@ -59,12 +70,13 @@ class SdCardFont {
   bool hasAdvanceTable() const;
 
   // Free mini data for all styles and restore stub EpdFontData.
-  // Preserves the persistent advance cache so repeated layout passes can reuse
-  // previously fetched metrics.
+  // Preserves the persistent advance cache and the glyph store (trimmed to
+  // GLYPH_STORE_BUDGET) so later pages and layout passes can reuse previously
+  // fetched metrics and bitmaps.
   void clearCache();
 
-  // Drop the persistent advance cache. Call when unloading the SD font or
-  // when font/size/family/glyph-table state changes.
+  // Drop the persistent advance cache and glyph store. Call when unloading the
+  // SD font or when font/size/family/glyph-table state changes.
   void clearPersistentCache();
 
   // Returns pointer to the managed EpdFont for a given style.
@@ -99,16 +111,45 @@ class SdCardFont {
     uint32_t sdReadTimeMs = 0;
     uint32_t seekCount = 0;
     uint32_t uniqueGlyphs = 0;
-    uint32_t bitmapBytes = 0;
+    uint32_t bitmapBytes = 0;  // read from SD; glyph store hits cost nothing
+    uint32_t storeHits = 0;    // page glyphs served from the glyph store
+    uint32_t storeMisses = 0;  // page glyphs read from SD
+    uint32_t bytesRead = 0;    // transferred by prewarm, including gaps skipped over by merged reads
   };
   void logStats(const char* label = "SDCF");
   void resetStats();
   const Stats& getStats() const { return stats_; }
 
+  // Largest gap prewarm reads across to merge two reads; 0 merges only reads that touch.
+  void setReadGapTolerance(uint32_t bytes) { readGapTolerance_ = bytes; }
+
   // Content hash of the file header + style TOC entries (computed during load).
   // Used to generate deterministic font IDs for section cache invalidation.
   uint32_t contentHash() const { return contentHash_; }
 
+  // --- Per-book subset overlay (SdCardFontSubset.cpp) ---
+  // A subset is a .cpfont in a book's cache dir holding only the BMP glyphs the
+  // book uses, with bitmaps in order of first use, so a page's glyphs sit close
+  // together in a small file. While one is attached, prewarm reads the glyphs
+  // it holds from it and everything else from the full font. It carries no
+  // kerning or ligatures: those and layout advances always come from the full
+  // font, so pages lay out the same with or without a subset.
+  static void setBookSubsetsEnabled(bool enabled);
+  static bool bookSubsetsEnabled();
+
+  // Attach the subset at path (no-op if already attached). Returns false and
+  // stays detached if the file is missing or was built from another font.
+  bool attachSubset(const std::string& path);
+  void detachSubset();
+  bool hasSubset() const { return subsetPath_[0] != '\0'; }
+
+  // Merge FontSubsetCollector entries into the subset at path, creating it if
+  // needed, and attach it. Glyphs already in the subset keep their place; new
+  // ones are appended in the given order. Merging rewrites the whole file, so
+  // glyphs that would grow an existing subset by less than a quarter are held
+  // back and merged by a later call for the same path.
+  bool updateSubset(const std::string& path, const std::vector<uint32_t>& entries);
+
  private:
   // Per-style metadata (parsed from file header/TOC)
   struct CpFontHeader {
@@ -123,6 +164,7 @@ class SdCardFont {
     uint8_t kernLeftClassCount = 0;
     uint8_t kernRightClassCount = 0;
     uint8_t ligaturePairCount = 0;
+    uint16_t kernPairCount = 0;
   };
 
   // All per-style data: file offsets, intervals, kern/lig, prewarm cache, EpdFont
@@ -134,7 +176,7 @@ class SdCardFont {
     uint32_t glyphsFileOffset = 0;
     uint32_t kernLeftFileOffset = 0;
     uint32_t kernRightFileOffset = 0;
-    uint32_t kernMatrixFileOffset = 0;
+    uint32_t kernRowsFileOffset = 0;
     uint32_t ligatureFileOffset = 0;
     uint32_t bitmapFileOffset = 0;
 
@@ -149,41 +191,53 @@ class SdCardFont {
     BmpInterval16* bmpIntervals = nullptr;
     bool intervalsAreBmp16 = false;
 
-    // Persistent kern-class + ligature tables (lazy-loaded on first prewarm).
-    // The full kern MATRIX is NOT resident — on Literata-class fonts a single
-    // style's matrix is ~36-42KB contiguous, and 4 styles' worth won't fit
-    // alongside bitmaps + framebuffer on a 380KB device. Only kernLeftClasses
-    // and kernRightClasses (small codepoint→classId tables, ~3KB each) stay
-    // resident; the matrix is reconstructed per-page as miniKernMatrix.
+    // Attached subset. A codepoint's position in the sorted subsetCodepoints
+    // is its glyph index in the subset file.
+    uint16_t* subsetCodepoints = nullptr;
+    uint32_t subsetGlyphCount = 0;
+    uint32_t subsetGlyphsFileOffset = 0;
+    uint32_t subsetBitmapFileOffset = 0;
+    uint32_t subsetBitmapBytes = 0;
+
+    // Persistent kern + ligature tables (lazy-loaded on first prewarm). A dense
+    // kern matrix would be ~36-42KB per style on Literata-class fonts, too much
+    // for 4 styles alongside bitmaps + framebuffer on a 380KB device, but only
+    // ~10-15% of its cells are non-zero. The file stores just those as sparse
+    // rows (kernRowStarts + kernPairs, 2 bytes per pair), a few KB per style,
+    // so the whole table stays resident and kerns any codepoint pair.
     EpdKernClassEntry* kernLeftClasses = nullptr;
     EpdKernClassEntry* kernRightClasses = nullptr;
+    uint16_t* kernRowStarts = nullptr;
+    EpdKernPair* kernPairs = nullptr;
     EpdLigaturePair* ligaturePairs = nullptr;
     bool kernLigLoaded = false;
 
     // Stub EpdFontData returned when not prewarmed
     EpdFontData stubData{};
 
-    // Mini EpdFontData built during prewarm
+    // Mini EpdFontData built during prewarm. Its bitmap is storeBitmap.
     EpdFontData miniData{};
     EpdUnicodeInterval* miniIntervals = nullptr;
     EpdGlyph* miniGlyphs = nullptr;
-    uint8_t* miniBitmap = nullptr;
     uint32_t miniIntervalCount = 0;
     uint32_t miniGlyphCount = 0;
 
-    // Per-page mini kern matrix (built by buildMiniKernMatrix on each full
-    // prewarm). miniKernLeftClasses/miniKernRightClasses map ONLY the codepoints
-    // used on the current page to renumbered class IDs (1..miniKern*ClassCount).
-    // miniKernMatrix is a small miniKernLeftClassCount × miniKernRightClassCount
-    // flat matrix. Typical Latin page: ~25×25 matrix = ~625 bytes per style vs
-    // ~36KB for the full Literata matrix — ~50× reduction.
-    EpdKernClassEntry* miniKernLeftClasses = nullptr;
-    EpdKernClassEntry* miniKernRightClasses = nullptr;
-    uint16_t miniKernLeftEntryCount = 0;
-    uint16_t miniKernRightEntryCount = 0;
-    uint8_t miniKernLeftClassCount = 0;
-    uint8_t miniKernRightClassCount = 0;
-    int8_t* miniKernMatrix = nullptr;
+    // Cross-page glyph store. Consecutive pages share nearly all their glyphs,
+    // so full prewarms keep each glyph's metrics and bitmap here and only read
+    // glyphs the store doesn't hold. storeGlyphs is sorted by codepoint; each
+    // glyph's dataOffset points into storeBitmap. Glyphs are evicted least
+    // recently used first, never while the page being prewarmed uses them.
+    struct StoredGlyph {
+      uint32_t codepoint;
+      uint32_t lastUsed;  // prewarmSerial_ of the last full prewarm that used it
+      EpdGlyph glyph;
+    };
+    StoredGlyph* storeGlyphs = nullptr;
+    uint32_t storeGlyphCount = 0;
+    uint32_t storeGlyphCapacity = 0;
+    uint8_t* storeBitmap = nullptr;
+    uint32_t storeBitmapUsed = 0;
+    uint32_t storeBitmapCapacity = 0;
 
     // The EpdFont whose data pointer we manage
     EpdFont epdFont{&stubData};
@@ -195,6 +249,9 @@ class SdCardFont {
   uint8_t styleCount_ = 0;
 
   char filePath_[128] = {};
+  char subsetPath_[128] = {};  // empty when no subset is attached
+  // Entries held back by updateSubset() for the attached subset; dropped on detach
+  std::vector<uint32_t> pendingSubsetEntries_;
 
   // Overflow context: glyphMissHandler needs to know which style it's serving
   struct OverflowContext {
@@ -235,22 +292,37 @@ class SdCardFont {
 
   Stats stats_;
   uint32_t contentHash_ = 0;
+  uint32_t prewarmSerial_ = 0;
+  uint32_t readGapTolerance_ = DEFAULT_READ_GAP_TOLERANCE;
+  uint8_t* readBuffer_ = nullptr;  // bounce buffer for merged reads, allocated on first use
   bool loaded_ = false;
 
   // Per-style helpers
   void freeStyleMiniData(PerStyle& s);
   void freeStyleAll(PerStyle& s);
   void freeStyleKernLigatureData(PerStyle& s);
-  void freeStyleMiniKern(PerStyle& s);
+  void freeStyleGlyphStore(PerStyle& s);
+  const PerStyle::StoredGlyph* findStoredGlyph(const PerStyle& s, uint32_t codepoint) const;
+  void evictGlyphStore(PerStyle& s, uint32_t maxBytes, uint32_t maxGlyphs, uint32_t keepSerial);
+  bool reserveGlyphStore(PerStyle& s, uint32_t addGlyphs, uint32_t addBytes);
   bool loadStyleKernLigatureData(PerStyle& s);
-  bool buildMiniKernMatrix(PerStyle& s, const uint32_t* codepoints, uint32_t cpCount);
   void applyKernLigaturePointers(PerStyle& s, EpdFontData& data) const;
   void applyGlyphMissCallback(uint8_t styleIdx);
   int32_t findGlobalGlyphIndex(const PerStyle& s, uint32_t codepoint) const;
+  int32_t findSubsetGlyphIndex(const PerStyle& s, uint32_t codepoint) const;
   int fetchAdvancesForCodepoints(uint32_t* codepoints, uint32_t cpCount, uint8_t styleMask);
   template <typename Iter>
   int buildAdvanceTableRange(Iter begin, Iter end, bool includeSpace, bool includeHyphen, uint8_t styleMask);
   int prewarmStyle(uint8_t styleIdx, const uint32_t* codepoints, uint32_t cpCount, bool metadataOnly);
+  // One planned read: length bytes at file offset into dest
+  struct ReadRange {
+    uint32_t offset;
+    uint32_t length;
+    uint8_t* dest;
+  };
+  // Reads rangeAt(begin) .. rangeAt(end - 1), sorted by offset, merging neighbours per readGapTolerance_.
+  template <typename RangeAt>
+  bool readRanges(HalFile& file, uint32_t begin, uint32_t end, RangeAt rangeAt, uint32_t& seekCount);
 
   // Global helpers
   void freeAll();
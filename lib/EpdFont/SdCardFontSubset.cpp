@@ -0,0 +1,372 @@
+#include <HalStorage.h>
+#include <Logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "FontSubsetCollector.h"
+#include "SdCardFont.h"
+
+// Per-book subset fonts. A subset is an ordinary .cpfont (loadable on its own)
+// with these conventions:
+//   - header flags bit 1 is set and header bytes 16..19 hold the content hash
+//     of the font it was cut from, so a subset never outlives a font update;
+//   - only BMP codepoints, no kern classes, kern rows or ligatures;
+//   - glyph records are in codepoint order as the format requires, but bitmaps
+//     are in order of first use, and TOC bytes 28..31 hold each style's total
+//     bitmap bytes so an update can append to them without re-reading them.
+
+namespace {
+
+constexpr char CPFONT_MAGIC[8] = {'C', 'P', 'F', 'O', 'N', 'T', '\0', '\0'};
+constexpr uint32_t HEADER_SIZE = 32;
+constexpr uint32_t STYLE_TOC_ENTRY_SIZE = 32;
+constexpr uint16_t FLAG_2BIT = 0x01;
+constexpr uint16_t FLAG_SUBSET = 0x02;
+constexpr uint32_t PARENT_HASH_OFFSET = 16;
+constexpr uint32_t TOC_BITMAP_BYTES_OFFSET = 28;
+// Copies go through one buffer of COPY_CHUNK bytes, or MIN_COPY_CHUNK when the heap is tight
+constexpr uint32_t COPY_CHUNK = 4096;
+constexpr uint32_t MIN_COPY_CHUNK = 512;
+// An existing subset is rewritten once the held-back glyphs reach a quarter of it (and at least
+// this many), so the bytes copied over a book stay proportional to the final subset size
+constexpr uint32_t MIN_SUBSET_BATCH = 32;
+
+bool subsetsEnabled = false;
+
+inline uint16_t readU16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+inline uint32_t readU32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24); }
+inline void writeU16(uint8_t* p, const uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+inline void writeU32(uint8_t* p, const uint32_t v) {
+  for (int i = 0; i < 4; i++) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+bool copyRange(HalFile& from, const uint32_t offset, uint32_t length, HalFile& to, uint8_t* buffer,
+               const uint32_t bufferSize) {
+  if (length == 0) return true;
+  if (!from.seekSet(offset)) return false;
+  while (length > 0) {
+    const uint32_t chunk = std::min(length, bufferSize);
+    if (from.read(buffer, chunk) != static_cast<int>(chunk) || to.write(buffer, chunk) != chunk) return false;
+    length -= chunk;
+  }
+  return true;
+}
+
+uint32_t countRuns(const std::vector<uint16_t>& codepoints) {
+  uint32_t runs = 0;
+  for (size_t i = 0; i < codepoints.size(); i++) {
+    if (i == 0 || codepoints[i] != codepoints[i - 1] + 1) runs++;
+  }
+  return runs;
+}
+
+}  // namespace
+
+void SdCardFont::setBookSubsetsEnabled(const bool enabled) { subsetsEnabled = enabled; }
+
+bool SdCardFont::bookSubsetsEnabled() { return subsetsEnabled; }
+
+int32_t SdCardFont::findSubsetGlyphIndex(const PerStyle& s, const uint32_t codepoint) const {
+  if (!s.subsetCodepoints || codepoint > 0xFFFF) return -1;
+  const uint16_t* begin = s.subsetCodepoints;
+  const uint16_t* end = begin + s.subsetGlyphCount;
+  const uint16_t* it = std::lower_bound(begin, end, static_cast<uint16_t>(codepoint));
+  return (it != end && *it == codepoint) ? static_cast<int32_t>(it - begin) : -1;
+}
+
+void SdCardFont::detachSubset() {
+  for (auto& s : styles_) {
+    delete[] s.subsetCodepoints;
+    s.subsetCodepoints = nullptr;
+    s.subsetGlyphCount = 0;
+    s.subsetGlyphsFileOffset = 0;
+    s.subsetBitmapFileOffset = 0;
+    s.subsetBitmapBytes = 0;
+  }
+  subsetPath_[0] = '\0';
+  pendingSubsetEntries_.clear();
+  pendingSubsetEntries_.shrink_to_fit();
+}
+
+bool SdCardFont::attachSubset(const std::string& path) {
+  if (!loaded_ || path.size() >= sizeof(subsetPath_)) return false;
+  if (path == subsetPath_) return true;
+  detachSubset();
+
+  HalFile file;
+  if (!Storage.exists(path.c_str()) || !Storage.openFileForRead("SDCF", path, file)) return false;
+
+  uint8_t header[HEADER_SIZE];
+  if (file.read(header, HEADER_SIZE) != HEADER_SIZE || memcmp(header, CPFONT_MAGIC, 8) != 0 ||
+      readU16(header + 8) != CPFONT_VERSION) {
+    LOG_ERR("SDCF", "Subset %s: bad header", path.c_str());
+    return false;
+  }
+  const uint16_t flags = readU16(header + 10);
+  const uint8_t styleCount = header[12];
+  if (!(flags & FLAG_SUBSET) || readU32(header + PARENT_HASH_OFFSET) != contentHash_ || styleCount > MAX_STYLES) {
+    LOG_DBG("SDCF", "Subset %s was built from another font, ignoring", path.c_str());
+    return false;
+  }
+
+  struct TocEntry {
+    uint8_t styleId;
+    uint32_t intervalCount;
+    uint32_t glyphCount;
+    uint32_t dataOffset;
+    uint32_t bitmapBytes;
+  };
+  TocEntry toc[MAX_STYLES] = {};
+  for (uint8_t i = 0; i < styleCount; i++) {
+    uint8_t buf[STYLE_TOC_ENTRY_SIZE];
+    if (file.read(buf, STYLE_TOC_ENTRY_SIZE) != STYLE_TOC_ENTRY_SIZE) {
+      LOG_ERR("SDCF", "Subset %s: short TOC", path.c_str());
+      return false;
+    }
+    toc[i] = {buf[0], readU32(buf + 4), readU32(buf + 8), readU32(buf + 24), readU32(buf + TOC_BITMAP_BYTES_OFFSET)};
+    if (toc[i].styleId >= MAX_STYLES || !styles_[toc[i].styleId].present || toc[i].glyphCount > 0x10000 ||
+        toc[i].intervalCount > toc[i].glyphCount) {
+      LOG_ERR("SDCF", "Subset %s: bad TOC entry %u", path.c_str(), i);
+      return false;
+    }
+  }
+
+  // Expand each style's intervals into its sorted codepoint table
+  for (uint8_t i = 0; i < styleCount; i++) {
+    auto& s = styles_[toc[i].styleId];
+    s.subsetCodepoints = new (std::nothrow) uint16_t[toc[i].glyphCount > 0 ? toc[i].glyphCount : 1];
+    if (!s.subsetCodepoints) {
+      LOG_ERR("SDCF", "Subset %s: failed to allocate %u codepoints", path.c_str(), toc[i].glyphCount);
+      detachSubset();
+      return false;
+    }
+    if (!file.seekSet(toc[i].dataOffset)) {
+      detachSubset();
+      return false;
+    }
+    uint32_t count = 0;
+    for (uint32_t j = 0; j < toc[i].intervalCount; j++) {
+      EpdUnicodeInterval iv{};
+      if (file.read(reinterpret_cast<uint8_t*>(&iv), sizeof(iv)) != sizeof(iv) || iv.first > iv.last ||
+          iv.last > 0xFFFF || iv.offset != count || iv.last - iv.first + 1 > toc[i].glyphCount - count ||
+          (count > 0 && iv.first <= s.subsetCodepoints[count - 1])) {
+        LOG_ERR("SDCF", "Subset %s: invalid interval %u (style %u)", path.c_str(), j, toc[i].styleId);
+        detachSubset();
+        return false;
+      }
+      for (uint32_t cp = iv.first; cp <= iv.last; cp++) s.subsetCodepoints[count++] = static_cast<uint16_t>(cp);
+    }
+    if (count != toc[i].glyphCount) {
+      LOG_ERR("SDCF", "Subset %s: interval/glyph count mismatch (style %u)", path.c_str(), toc[i].styleId);
+      detachSubset();
+      return false;
+    }
+    s.subsetGlyphCount = count;
+    s.subsetGlyphsFileOffset = toc[i].dataOffset + toc[i].intervalCount * sizeof(EpdUnicodeInterval);
+    s.subsetBitmapFileOffset = s.subsetGlyphsFileOffset + count * sizeof(EpdGlyph);
+    s.subsetBitmapBytes = toc[i].bitmapBytes;
+  }
+
+  strncpy(subsetPath_, path.c_str(), sizeof(subsetPath_) - 1);
+  subsetPath_[sizeof(subsetPath_) - 1] = '\0';
+  LOG_DBG("SDCF", "Attached subset %s (%u styles)", subsetPath_, styleCount);
+  return true;
+}
+
+bool SdCardFont::updateSubset(const std::string& path, const std::vector<uint32_t>& entries) {
+  if (!loaded_ || path.size() + 4 >= sizeof(subsetPath_)) return false;
+  // The current subset, if there is a valid one, is the starting point
+  attachSubset(path);
+  const bool hadSubset = hasSubset();
+
+  // Glyphs to add per style, in order of first use
+  struct NewGlyph {
+    uint16_t codepoint;
+    int32_t globalIndex;
+    uint32_t fileDataOffset;  // bitmap offset in the full font
+    EpdGlyph glyph;           // dataOffset rebased into the subset's bitmaps
+  };
+  std::vector<NewGlyph> added[MAX_STYLES];
+  std::vector<uint16_t> seen[MAX_STYLES];  // sorted; two requested styles can resolve to the same one
+  uint32_t addedTotal = 0;
+  const auto addEntry = [&](const uint32_t e) {
+    const uint8_t si = resolveStyle(FontSubsetCollector::entryStyle(e));
+    const uint16_t cp = FontSubsetCollector::entryCodepoint(e);
+    const auto& s = styles_[si];
+    if (!s.present || findSubsetGlyphIndex(s, cp) >= 0) return;
+    const int32_t globalIndex = findGlobalGlyphIndex(s, cp);
+    if (globalIndex < 0) return;
+    const auto it = std::lower_bound(seen[si].begin(), seen[si].end(), cp);
+    if (it != seen[si].end() && *it == cp) return;
+    seen[si].insert(it, cp);
+    added[si].push_back({cp, globalIndex, 0, {}});
+    addedTotal++;
+  };
+  // Glyphs held back by earlier calls were used first
+  for (const uint32_t e : pendingSubsetEntries_) addEntry(e);
+  for (const uint32_t e : entries) addEntry(e);
+  if (addedTotal == 0) return hadSubset;
+
+  if (hadSubset) {
+    uint32_t subsetGlyphs = 0;
+    for (const auto& s : styles_) subsetGlyphs += s.subsetGlyphCount;
+    if (addedTotal < std::max(MIN_SUBSET_BATCH, subsetGlyphs / 4)) {
+      pendingSubsetEntries_.clear();
+      pendingSubsetEntries_.reserve(addedTotal);
+      for (uint8_t si = 0; si < MAX_STYLES; si++) {
+        for (const auto& g : added[si]) pendingSubsetEntries_.push_back(FontSubsetCollector::entry(si, g.codepoint));
+      }
+      LOG_DBG("SDCF", "Subset %s: holding back %u glyphs", path.c_str(), addedTotal);
+      return true;
+    }
+  }
+
+  HalFile fontFile;
+  if (!Storage.openFileForRead("SDCF", filePath_, fontFile)) {
+    LOG_ERR("SDCF", "Subset: failed to open %s", filePath_);
+    return false;
+  }
+
+  // Read the new glyphs' metrics in file order and lay their bitmaps out after
+  // the ones the subset already has
+  std::vector<uint16_t> merged[MAX_STYLES];
+  uint32_t bitmapBytes[MAX_STYLES] = {};
+  uint8_t subsetStyles = 0;
+  for (uint8_t si = 0; si < MAX_STYLES; si++) {
+    auto& s = styles_[si];
+    if (!s.present) continue;
+    std::vector<NewGlyph>& glyphs = added[si];
+    std::vector<uint32_t> order(glyphs.size());
+    for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](uint32_t a, uint32_t b) { return glyphs[a].globalIndex < glyphs[b].globalIndex; });
+    for (const uint32_t i : order) {
+      const uint32_t fileOff = s.glyphsFileOffset + static_cast<uint32_t>(glyphs[i].globalIndex) * sizeof(EpdGlyph);
+      if (!fontFile.seekSet(fileOff) ||
+          fontFile.read(reinterpret_cast<uint8_t*>(&glyphs[i].glyph), sizeof(EpdGlyph)) != sizeof(EpdGlyph)) {
+        LOG_ERR("SDCF", "Subset: failed to read glyph %d (style %u)", glyphs[i].globalIndex, si);
+        return false;
+      }
+    }
+    bitmapBytes[si] = s.subsetBitmapBytes;
+    for (auto& g : glyphs) {
+      g.fileDataOffset = g.glyph.dataOffset;
+      g.glyph.dataOffset = bitmapBytes[si];
+      bitmapBytes[si] += g.glyph.dataLength;
+    }
+
+    merged[si].resize(s.subsetGlyphCount + seen[si].size());
+    std::merge(s.subsetCodepoints, s.subsetCodepoints + s.subsetGlyphCount, seen[si].begin(), seen[si].end(),
+               merged[si].begin());
+    seen[si] = std::vector<uint16_t>();
+    if (!merged[si].empty()) subsetStyles++;
+  }
+
+  const std::string tmpPath = path + ".tmp";
+  HalFile out;
+  HalFile oldFile;
+  if (!Storage.openFileForWrite("SDCF", tmpPath, out) ||
+      (hadSubset && !Storage.openFileForRead("SDCF", subsetPath_, oldFile))) {
+    LOG_ERR("SDCF", "Subset: failed to open files for %s", path.c_str());
+    out.close();
+    Storage.remove(tmpPath.c_str());
+    return false;
+  }
+  uint32_t bufferSize = COPY_CHUNK;
+  std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[bufferSize]);
+  if (!buffer) {
+    bufferSize = MIN_COPY_CHUNK;
+    buffer.reset(new (std::nothrow) uint8_t[bufferSize]);
+  }
+  bool ok = buffer != nullptr;
+
+  uint8_t header[HEADER_SIZE] = {};
+  memcpy(header, CPFONT_MAGIC, 8);
+  writeU16(header + 8, CPFONT_VERSION);
+  writeU16(header + 10, (styles_[resolveStyle(0)].header.is2Bit ? FLAG_2BIT : 0) | FLAG_SUBSET);
+  header[12] = subsetStyles;
+  writeU32(header + PARENT_HASH_OFFSET, contentHash_);
+  ok = ok && out.write(header, HEADER_SIZE) == HEADER_SIZE;
+
+  uint32_t dataOffset = HEADER_SIZE + subsetStyles * STYLE_TOC_ENTRY_SIZE;
+  for (uint8_t si = 0; si < MAX_STYLES && ok; si++) {
+    if (merged[si].empty()) continue;
+    const auto& h = styles_[si].header;
+    const uint32_t intervalCount = countRuns(merged[si]);
+    const auto glyphCount = static_cast<uint32_t>(merged[si].size());
+    uint8_t toc[STYLE_TOC_ENTRY_SIZE] = {};
+    toc[0] = si;
+    writeU32(toc + 4, intervalCount);
+    writeU32(toc + 8, glyphCount);
+    toc[12] = h.advanceY;
+    writeU16(toc + 13, static_cast<uint16_t>(h.ascender));
+    writeU16(toc + 15, static_cast<uint16_t>(h.descender));
+    writeU32(toc + 24, dataOffset);
+    writeU32(toc + TOC_BITMAP_BYTES_OFFSET, bitmapBytes[si]);
+    ok = out.write(toc, STYLE_TOC_ENTRY_SIZE) == STYLE_TOC_ENTRY_SIZE;
+    dataOffset += intervalCount * sizeof(EpdUnicodeInterval) + glyphCount * sizeof(EpdGlyph) + bitmapBytes[si];
+  }
+
+  for (uint8_t si = 0; si < MAX_STYLES && ok; si++) {
+    if (merged[si].empty()) continue;
+    const auto& s = styles_[si];
+    const std::vector<uint16_t>& cps = merged[si];
+
+    for (size_t start = 0, i = 1; i <= cps.size() && ok; i++) {
+      if (i < cps.size() && cps[i] == cps[i - 1] + 1) continue;
+      const EpdUnicodeInterval iv{cps[start], cps[i - 1], static_cast<uint32_t>(start)};
+      ok = out.write(reinterpret_cast<const uint8_t*>(&iv), sizeof(iv)) == sizeof(iv);
+      start = i;
+    }
+
+    // Glyph records: merge the old subset's (streamed in codepoint order) with the new ones
+    std::vector<const NewGlyph*> newByCp;
+    for (const auto& g : added[si]) newByCp.push_back(&g);
+    std::sort(newByCp.begin(), newByCp.end(),
+              [](const NewGlyph* a, const NewGlyph* b) { return a->codepoint < b->codepoint; });
+    if (s.subsetGlyphCount > 0) ok = ok && oldFile.seekSet(s.subsetGlyphsFileOffset);
+    uint32_t oldIdx = 0;
+    size_t newIdx = 0;
+    while (ok && (oldIdx < s.subsetGlyphCount || newIdx < newByCp.size())) {
+      EpdGlyph glyph;
+      if (newIdx == newByCp.size() ||
+          (oldIdx < s.subsetGlyphCount && s.subsetCodepoints[oldIdx] < newByCp[newIdx]->codepoint)) {
+        ok = oldFile.read(reinterpret_cast<uint8_t*>(&glyph), sizeof(glyph)) == sizeof(glyph);
+        oldIdx++;
+      } else {
+        glyph = newByCp[newIdx++]->glyph;
+      }
+      ok = ok && out.write(reinterpret_cast<const uint8_t*>(&glyph), sizeof(glyph)) == sizeof(glyph);
+    }
+
+    // Bitmaps: the old ones as they were, then the new ones in order of first use
+    ok = ok && copyRange(oldFile, s.subsetBitmapFileOffset, s.subsetBitmapBytes, out, buffer.get(), bufferSize);
+    for (const auto& g : added[si]) {
+      if (!ok) break;
+      ok = copyRange(fontFile, s.bitmapFileOffset + g.fileDataOffset, g.glyph.dataLength, out, buffer.get(),
+                     bufferSize);
+    }
+  }
+  out.close();
+  oldFile.close();
+
+  if (!ok) {
+    LOG_ERR("SDCF", "Subset: failed to write %s", tmpPath.c_str());
+    Storage.remove(tmpPath.c_str());
+    return false;
+  }
+  detachSubset();
+  if (Storage.exists(path.c_str())) Storage.remove(path.c_str());
+  if (!Storage.rename(tmpPath.c_str(), path.c_str())) {
+    LOG_ERR("SDCF", "Subset: failed to publish %s", path.c_str());
+    Storage.remove(tmpPath.c_str());
+    return false;
+  }
+  LOG_DBG("SDCF", "Subset %s: added %u glyphs", path.c_str(), addedTotal);
+  return attachSubset(path);
+}
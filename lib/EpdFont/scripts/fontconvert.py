@@ -1025,4 +1025,10 @@ if ligature_pairs:
 else:
     print(f"    nullptr,")
     print(f"    0,")
+# glyphMissHandler, glyphMissCtx (glyphs are loaded on demand only by SD card fonts)
+print("    nullptr,")
+print("    nullptr,")
+# kernRowStarts, kernPairs (sparse kerning is only used by SD card fonts)
+print("    nullptr,")
+print("    nullptr,")
 print("};")
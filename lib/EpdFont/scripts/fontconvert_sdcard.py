@@ -401,6 +401,26 @@ def derive_kern_classes(kern_map):
             kern_left_class_count, kern_right_class_count)
 
 
+def sparse_kern_rows(kern_matrix, kern_left_class_count, kern_right_class_count):
+    """Split a flat class matrix into the sparse rows stored in a .cpfont.
+
+    Returns (row_starts, pairs) where:
+    - row_starts: kern_left_class_count + 1 indices into pairs; row L (1-based)
+      is pairs[row_starts[L - 1]:row_starts[L]]
+    - pairs: (rightClassId, adjust) tuples for the non-zero cells, sorted by
+      rightClassId within each row
+    Only ~10-15% of a real font's class pairs kern, so this is a fraction of
+    the matrix and small enough for the firmware to keep resident.
+    """
+    row_starts = [0]
+    pairs = []
+    for lc in range(kern_left_class_count):
+        row = kern_matrix[lc * kern_right_class_count:(lc + 1) * kern_right_class_count]
+        pairs += [(rc + 1, adjust) for rc, adjust in enumerate(row) if adjust != 0]
+        row_starts.append(len(pairs))
+    return row_starts, pairs
+
+
 def extract_ligatures_fonttools(font_path, codepoints):
     """Extract ligature substitution pairs from a font file using fonttools.
 
@@ -688,10 +708,12 @@ def rasterize_font_style(fontfile, size, intervals, style_id=0, force_autohint=F
      kern_left_class_count, kern_right_class_count) = derive_kern_classes(kern_map)
 
     if kern_map:
-        matrix_size = kern_left_class_count * kern_right_class_count
+        _, kern_pairs = sparse_kern_rows(kern_matrix, kern_left_class_count, kern_right_class_count)
+        rows_size = (kern_left_class_count + 1) * 2 + len(kern_pairs) * 2
         entries_size = (len(kern_left_classes) + len(kern_right_classes)) * 3
         print(f"  [{style_label}] Kerning classes: {kern_left_class_count} left, {kern_right_class_count} right, "
-              f"{matrix_size + entries_size} bytes", file=sys.stderr)
+              f"{len(kern_pairs)} class pairs, {rows_size + entries_size} bytes "
+              f"(dense matrix would be {kern_left_class_count * kern_right_class_count})", file=sys.stderr)
 
     # SMP codepoints in ligature inputs / outputs are filtered inside
     # extract_ligatures_fonttools (see the codepoints_set filter), so every
@@ -729,7 +751,7 @@ assert struct.calcsize(GLYPH_STRUCT_FORMAT) == 16
 
 def pack_style_sections(sd):
     """Pack one StyleRasterData into binary section bytearrays.
-    Returns (intervals_data, glyphs_data, kern_left, kern_right, kern_matrix, ligatures, bitmaps)."""
+    Returns (intervals_data, glyphs_data, kern_left, kern_right, kern_rows, ligatures, bitmaps)."""
     intervals_data = bytearray()
     offset = 0
     for i_start, i_end in sd.intervals:
@@ -751,9 +773,13 @@ def pack_style_sections(sd):
     for cp, cls in sd.kern_right_classes:
         kern_right_data += struct.pack("<HB", cp, cls)
 
-    kern_matrix_data = bytearray()
+    # Sparse kern rows: uint16 row starts, then (uint8 rightClass, int8 adjust) pairs
+    kern_rows_data = bytearray()
     if sd.kern_matrix:
-        kern_matrix_data = bytearray(struct.pack(f"<{len(sd.kern_matrix)}b", *sd.kern_matrix))
+        row_starts, pairs = sparse_kern_rows(sd.kern_matrix, sd.kern_left_class_count, sd.kern_right_class_count)
+        kern_rows_data += struct.pack(f"<{len(row_starts)}H", *row_starts)
+        for rc, adjust in pairs:
+            kern_rows_data += struct.pack("<Bb", rc, adjust)
 
     ligature_data = bytearray()
     for packed_pair, lig_cp in sd.ligature_pairs:
@@ -765,7 +791,7 @@ def pack_style_sections(sd):
     assert len(bitmap_data) == sd.total_bitmap_size
 
     return (intervals_data, glyphs_data, kern_left_data, kern_right_data,
-            kern_matrix_data, ligature_data, bitmap_data)
+            kern_rows_data, ligature_data, bitmap_data)
 
 
 def style_sections_total_size(sections):
@@ -777,7 +803,7 @@ def style_sections_total_size(sections):
 
 def generate_cpfont_multistyle(style_fonts, size, intervals, output_path,
                                force_autohint=False, fallback_style_fonts=None):
-    """Generate a multi-style v4 .cpfont file.
+    """Generate a multi-style .cpfont file.
 
     style_fonts: dict of {style_id: fontfile_path} e.g. {0: "Regular.ttf", 2: "Italic.ttf"}
     fallback_style_fonts: optional dict of {style_id: fallback_fontfile_path}
@@ -815,15 +841,15 @@ def generate_cpfont_multistyle(style_fonts, size, intervals, output_path,
         current_offset += style_sections_total_size(packed_sections[style_id])
 
     # Build global header
-    # V4 header: magic(8) + version(2) + flags(2) + styleCount(1) + reserved(19) = 32
+    # Header: magic(8) + version(2) + flags(2) + styleCount(1) + reserved(19) = 32
     header = struct.pack("<8sHHB19s", MAGIC, CPFONT_VERSION, flags, style_count, bytes(19))
     assert len(header) == HEADER_SIZE
 
     # Build style TOC entries
-    # Each entry: styleId(1) + pad(3) + intervalCount(4) + glyphCount(4) +
+    # Each entry: styleId(1) + kernPairs(2) + pad(1) + intervalCount(4) + glyphCount(4) +
     #   advanceY(1) + ascender(2) + descender(2) + kernL(2) + kernR(2) +
     #   kernLCls(1) + kernRCls(1) + ligCount(1) + dataOffset(4) + reserved(4) = 32
-    STYLE_TOC_FORMAT = "<B3xIIBhhHHBBBI4x"
+    STYLE_TOC_FORMAT = "<BHxIIBhhHHBBBI4x"
     assert struct.calcsize(STYLE_TOC_FORMAT) == STYLE_TOC_ENTRY_SIZE
 
     toc_data = bytearray()
@@ -835,8 +861,9 @@ def generate_cpfont_multistyle(style_fonts, size, intervals, output_path,
                   f"size is too large for this format.",
                   file=sys.stderr)
             sys.exit(1)
+        _, kern_pairs = sparse_kern_rows(sd.kern_matrix, sd.kern_left_class_count, sd.kern_right_class_count)
         toc_data += struct.pack(STYLE_TOC_FORMAT,
-                                style_id,
+                                style_id, len(kern_pairs),
                                 len(sd.intervals), len(sd.all_glyphs),
                                 sd.advanceY, sd.ascender, sd.descender,
                                 len(sd.kern_left_classes), len(sd.kern_right_classes),
@@ -856,7 +883,7 @@ def generate_cpfont_multistyle(style_fonts, size, intervals, output_path,
         total_file_size = f.tell()
 
     # Print summary
-    print(f"  Output: {output_path} (v4, {style_count} styles)", file=sys.stderr)
+    print(f"  Output: {output_path} (v{CPFONT_VERSION}, {style_count} styles)", file=sys.stderr)
     print(f"    Header+TOC: {HEADER_SIZE + len(toc_data)} bytes", file=sys.stderr)
     for style_id in sorted(raster_data.keys()):
         sd = raster_data[style_id]
@@ -900,9 +927,9 @@ def main():
     parser.add_argument("--list-presets", action="store_true",
                         help="List available interval presets and exit.")
 
-    # Multi-style mode: per-style font file arguments (generates v4 .cpfont)
+    # Multi-style mode: per-style font file arguments (generates a multi-style .cpfont)
     parser.add_argument("--regular", dest="font_regular",
-                        help="Font file for regular style (enables multi-style v4 mode).")
+                        help="Font file for regular style (enables multi-style mode).")
     parser.add_argument("--bold", dest="font_bold",
                         help="Font file for bold style.")
     parser.add_argument("--italic", dest="font_italic",
@@ -996,11 +1023,11 @@ def main():
         font_name = base
 
     if not is_multistyle:
-        # Single font file provided: wrap as a single-style v4 font
+        # Single font file provided: wrap as a single-style font
         style_map = {"regular": 0, "bold": 1, "italic": 2, "bolditalic": 3}
         style_fonts[style_map[args.style]] = fontfile
 
-    # Always generate v4 format
+    # Always generate the current multi-style format
     if args.output and len(sizes) != 1:
         print("Error: --output can only be used with a single size", file=sys.stderr)
         sys.exit(1)
@@ -1012,7 +1039,8 @@ def main():
         else:
             filename = f"{font_name}_{sz}.cpfont"
             output_path = os.path.join(output_dir, filename)
-        print(f"Generating {output_path} (size {sz}, {len(style_fonts)} style(s), v4)...", file=sys.stderr)
+        print(f"Generating {output_path} (size {sz}, {len(style_fonts)} style(s), v{CPFONT_VERSION})...",
+              file=sys.stderr)
         total_size += generate_cpfont_multistyle(
             style_fonts, sz, intervals, output_path,
             force_autohint=args.force_autohint,
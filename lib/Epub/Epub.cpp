@@ -282,6 +282,18 @@ void Epub::discoverCssFilesFromZip() {
   }
 }
 
+bool Epub::zipHasImages() const {
+  ZipFile zf(filepath);
+  bool found = false;
+  if (!zf.enumerateFilePaths([&](std::string_view filePath) {
+        found = found || FsHelpers::hasJpgExtension(filePath) || FsHelpers::hasPngExtension(filePath);
+      })) {
+    LOG_ERR("EBP", "Failed to enumerate ZIP file paths for image discovery");
+    return true;
+  }
+  return found;
+}
+
 void Epub::parseCssFiles() const {
   // Maximum CSS file size we'll attempt to parse (uncompressed)
   // Larger files risk memory exhaustion on ESP32
@@ -429,6 +441,7 @@ bool Epub::load(const bool buildIfMissing, const bool skipLoadingCss) {
     return false;
   }
   discoverCssFilesFromZip();
+  bookMetadata.hasImages = zipHasImages();
   if (!bookMetadataCache->endContentOpfPass()) {
     LOG_ERR("EBP", "Could not end writing content.opf pass");
     return false;
@@ -558,6 +571,14 @@ const std::string& Epub::getLanguage() const {
   return bookMetadataCache->coreMetadata.language;
 }
 
+bool Epub::hasImages() const {
+  if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
+    return true;
+  }
+
+  return bookMetadataCache->coreMetadata.hasImages;
+}
+
 std::string Epub::getCoverBmpPath(bool cropped) const {
   const auto coverFileName = std::string("cover") + (cropped ? "_crop" : "");
   return cachePath + "/" + coverFileName + ".bmp";
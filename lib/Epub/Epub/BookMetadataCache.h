@@ -14,6 +14,7 @@ class BookMetadataCache {
     std::string language;
     std::string coverItemHref;
     std::string textReferenceHref;
+    bool hasImages = true;  // the EPUB holds images in a decodable format (JPEG/PNG)
   };
 
   struct SpineEntry {
@@ -8,10 +8,15 @@
 
 namespace {
 
+// Arena space an element may need beyond its share of the page record: the element object
+// itself (TextBlock included), alignment padding and the word-offset sentinel.
+constexpr size_t MAX_ELEMENT_FOOTPRINT =
+    std::max({sizeof(PageLine), sizeof(PageImage), sizeof(PageHorizontalRule)}) + 2 * alignof(std::max_align_t) + 8;
+
 template <typename Predicate>
-void renderFilteredPageElements(const std::vector<std::shared_ptr<PageElement>>& elements, GfxRenderer& renderer,
-                                const int fontId, const int xOffset, const int yOffset, Predicate&& predicate) {
-  for (const auto& element : elements) {
+void renderFilteredPageElements(const std::vector<PageElement*>& elements, GfxRenderer& renderer, const int fontId,
+                                const int xOffset, const int yOffset, Predicate&& predicate) {
+  for (auto* element : elements) {
     if (predicate(*element)) {
       element->render(renderer, fontId, xOffset, yOffset);
     }
@@ -21,7 +26,7 @@ void renderFilteredPageElements(const std::vector<std::shared_ptr<PageElement>>&
 }  // namespace
 
 void PageLine::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) {
-  block->render(renderer, fontId, xPos + xOffset, yPos + yOffset);
+  block.render(renderer, fontId, xPos + xOffset, yPos + yOffset);
 }
 
 bool PageLine::serialize(HalFile& file) {
@@ -29,17 +34,20 @@ bool PageLine::serialize(HalFile& file) {
   serialization::writePod(file, yPos);
 
   // serialize TextBlock pointed to by PageLine
-  return block->serialize(file);
+  return block.serialize(file);
 }
 
-std::unique_ptr<PageLine> PageLine::deserialize(HalFile& file) {
+PageLine* PageLine::deserialize(serialization::BufferReader& reader, PageArena& arena) {
   int16_t xPos;
   int16_t yPos;
-  serialization::readPod(file, xPos);
-  serialization::readPod(file, yPos);
+  serialization::readPod(reader, xPos);
+  serialization::readPod(reader, yPos);
 
-  auto tb = TextBlock::deserialize(file);
-  return std::unique_ptr<PageLine>(new PageLine(std::move(tb), xPos, yPos));
+  auto tb = TextBlock::deserialize(reader, arena);
+  if (!tb) {
+    return nullptr;
+  }
+  return arena.create<PageLine>(std::move(*tb), xPos, yPos);
 }
 
 void PageImage::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) {
@@ -55,14 +63,14 @@ bool PageImage::serialize(HalFile& file) {
   return imageBlock->serialize(file);
 }
 
-std::unique_ptr<PageImage> PageImage::deserialize(HalFile& file) {
+PageImage* PageImage::deserialize(serialization::BufferReader& reader, PageArena& arena) {
   int16_t xPos;
   int16_t yPos;
-  serialization::readPod(file, xPos);
-  serialization::readPod(file, yPos);
+  serialization::readPod(reader, xPos);
+  serialization::readPod(reader, yPos);
 
-  auto ib = ImageBlock::deserialize(file);
-  return std::unique_ptr<PageImage>(new PageImage(std::move(ib), xPos, yPos));
+  auto ib = ImageBlock::deserialize(reader);
+  return arena.create<PageImage>(std::move(ib), xPos, yPos);
 }
 
 void PageHorizontalRule::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) {
@@ -82,15 +90,15 @@ bool PageHorizontalRule::serialize(HalFile& file) {
   return true;
 }
 
-std::unique_ptr<PageHorizontalRule> PageHorizontalRule::deserialize(HalFile& file) {
+PageHorizontalRule* PageHorizontalRule::deserialize(serialization::BufferReader& reader, PageArena& arena) {
   int16_t xPos = 0;
   int16_t yPos = 0;
   uint16_t width = 0;
   uint8_t thickness = 0;
-  serialization::readPod(file, xPos);
-  serialization::readPod(file, yPos);
-  serialization::readPod(file, width);
-  serialization::readPod(file, thickness);
+  serialization::readPod(reader, xPos);
+  serialization::readPod(reader, yPos);
+  serialization::readPod(reader, width);
+  serialization::readPod(reader, thickness);
 
   if (width == 0 || thickness == 0) {
     LOG_ERR("PGE", "Deserialization failed: invalid horizontal rule metadata (width=%u thickness=%u)", width,
@@ -98,12 +106,11 @@ std::unique_ptr<PageHorizontalRule> PageHorizontalRule::deserialize(HalFile& fil
     return nullptr;
   }
 
-  auto* rule = new (std::nothrow) PageHorizontalRule(width, thickness, xPos, yPos);
+  auto* rule = arena.create<PageHorizontalRule>(width, thickness, xPos, yPos);
   if (!rule) {
     LOG_ERR("PGE", "Deserialization failed: could not allocate PageHorizontalRule");
-    return nullptr;
   }
-  return std::unique_ptr<PageHorizontalRule>(rule);
+  return rule;
 }
 
 void Page::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) const {
@@ -115,6 +122,13 @@ void Page::renderImages(GfxRenderer& renderer, const int fontId, const int xOffs
                              [](const PageElement& element) { return element.getTag() == TAG_PageImage; });
 }
 
+Page::~Page() {
+  // The arena frees the memory but doesn't run destructors
+  for (auto* element : elements) {
+    element->~PageElement();
+  }
+}
+
 bool Page::serialize(HalFile& file) const {
   const uint16_t count = elements.size();
   serialization::writePod(file, count);
@@ -143,37 +157,47 @@ bool Page::serialize(HalFile& file) const {
   return true;
 }
 
-std::unique_ptr<Page> Page::deserialize(HalFile& file) {
-  auto page = std::unique_ptr<Page>(new Page());
+std::unique_ptr<Page> Page::deserialize(serialization::BufferReader& reader) {
+  auto page = std::unique_ptr<Page>(new (std::nothrow) Page());
+  if (!page) {
+    return nullptr;
+  }
 
   uint16_t count;
-  serialization::readPod(file, count);
+  serialization::readPod(reader, count);
+
+  // Word text and per-word arrays never take more room in RAM than in the record, so the rest
+  // of the record plus a fixed allowance per element fits the whole page in one arena chunk.
+  if (!page->arena.reserve(reader.remaining() + count * MAX_ELEMENT_FOOTPRINT)) {
+    LOG_ERR("PGE", "Deserialization failed: could not allocate arena for %u elements", count);
+    return nullptr;
+  }
+  page->elements.reserve(count);
 
   for (uint16_t i = 0; i < count; i++) {
     uint8_t tag;
-    serialization::readPod(file, tag);
+    serialization::readPod(reader, tag);
 
+    PageElement* element = nullptr;
     if (tag == TAG_PageLine) {
-      auto pl = PageLine::deserialize(file);
-      page->elements.push_back(std::move(pl));
+      element = PageLine::deserialize(reader, page->arena);
     } else if (tag == TAG_PageImage) {
-      auto pi = PageImage::deserialize(file);
-      page->elements.push_back(std::move(pi));
+      element = PageImage::deserialize(reader, page->arena);
     } else if (tag == TAG_PageHorizontalRule) {
-      auto rule = PageHorizontalRule::deserialize(file);
-      if (!rule) {
-        return nullptr;
-      }
-      page->elements.push_back(std::move(rule));
+      element = PageHorizontalRule::deserialize(reader, page->arena);
     } else {
       LOG_ERR("PGE", "Deserialization failed: Unknown tag %u", tag);
       return nullptr;
     }
+    if (!element) {
+      return nullptr;
+    }
+    page->elements.push_back(element);
   }
 
   // Deserialize footnotes
   uint16_t fnCount;
-  serialization::readPod(file, fnCount);
+  serialization::readPod(reader, fnCount);
   if (fnCount > MAX_FOOTNOTES_PER_PAGE) {
     LOG_ERR("PGE", "Invalid footnote count %u", fnCount);
     return nullptr;
@@ -181,8 +205,8 @@ std::unique_ptr<Page> Page::deserialize(HalFile& file) {
   page->footnotes.resize(fnCount);
   for (uint16_t i = 0; i < fnCount; i++) {
     auto& entry = page->footnotes[i];
-    if (file.read(entry.number, sizeof(entry.number)) != sizeof(entry.number) ||
-        file.read(entry.href, sizeof(entry.href)) != sizeof(entry.href)) {
+    if (reader.read(entry.number, sizeof(entry.number)) != sizeof(entry.number) ||
+        reader.read(entry.href, sizeof(entry.href)) != sizeof(entry.href)) {
       LOG_ERR("PGE", "Failed to read footnote %u", i);
       return nullptr;
     }
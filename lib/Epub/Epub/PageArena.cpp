@@ -0,0 +1,60 @@
+#include "PageArena.h"
+
+#include <Logging.h>
+
+#include <algorithm>
+
+namespace {
+uint8_t* alignUp(uint8_t* ptr, const size_t align) {
+  const auto addr = reinterpret_cast<uintptr_t>(ptr);
+  return reinterpret_cast<uint8_t*>((addr + align - 1) & ~(static_cast<uintptr_t>(align) - 1));
+}
+}  // namespace
+
+bool PageArena::addChunk(const size_t capacity) {
+  auto* raw = new (std::nothrow) uint8_t[sizeof(Chunk) + capacity];
+  if (!raw) {
+    LOG_ERR("PGA", "Failed to allocate %u byte chunk", static_cast<unsigned>(capacity));
+    return false;
+  }
+  auto* chunk = reinterpret_cast<Chunk*>(raw);
+  chunk->next = head;
+  chunk->capacity = capacity;
+  chunk->used = 0;
+  head = chunk;
+  return true;
+}
+
+bool PageArena::reserve(const size_t bytes) {
+  if (head && head->capacity - head->used >= bytes) {
+    return true;
+  }
+  return addChunk(bytes);
+}
+
+void* PageArena::allocate(const size_t bytes, const size_t align) {
+  if (head) {
+    uint8_t* start = alignUp(head->data() + head->used, align);
+    const size_t end = static_cast<size_t>(start - head->data()) + bytes;
+    if (end <= head->capacity) {
+      head->used = end;
+      return start;
+    }
+  }
+
+  // Worst-case padding is align - 1 since chunk data is only pointer aligned
+  if (!addChunk(std::max(bytes + align - 1, DEFAULT_CHUNK_SIZE))) {
+    return nullptr;
+  }
+  uint8_t* start = alignUp(head->data(), align);
+  head->used = static_cast<size_t>(start - head->data()) + bytes;
+  return start;
+}
+
+void PageArena::reset() {
+  while (head) {
+    Chunk* next = head->next;
+    delete[] reinterpret_cast<uint8_t*>(head);
+    head = next;
+  }
+}
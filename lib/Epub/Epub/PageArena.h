@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+// Bump allocator for the contents of one page: elements, word text and per-word arrays.
+// Allocations are a pointer bump inside the current chunk and are never freed one by one;
+// every chunk is released together on reset() or destruction. The arena does not run
+// destructors, so owners must destroy objects with non-trivial destructors themselves.
+//
+// Loading a page reserve()s the whole page up front so it lands in a single exactly-sized
+// chunk; without a reservation the arena grows by DEFAULT_CHUNK_SIZE chunks.
+class PageArena {
+  struct Chunk {
+    Chunk* next;
+    size_t capacity;
+    size_t used;
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+  };
+
+  Chunk* head = nullptr;
+
+  bool addChunk(size_t capacity);
+
+ public:
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 1024;
+
+  PageArena() = default;
+  ~PageArena() { reset(); }
+  PageArena(PageArena&& other) noexcept : head(other.head) { other.head = nullptr; }
+  PageArena& operator=(PageArena&& other) noexcept {
+    if (this != &other) {
+      reset();
+      head = other.head;
+      other.head = nullptr;
+    }
+    return *this;
+  }
+  PageArena(const PageArena&) = delete;
+  PageArena& operator=(const PageArena&) = delete;
+
+  // Make sure the next `bytes` of allocations (including alignment padding) fit in one chunk.
+  bool reserve(size_t bytes);
+  // Returns nullptr when out of memory.
+  void* allocate(size_t bytes, size_t align);
+  void reset();
+
+  template <typename T>
+  T* allocateArray(const size_t count) {
+    return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  template <typename T, typename... Args>
+  T* create(Args&&... args) {
+    void* mem = allocate(sizeof(T), alignof(T));
+    return mem ? new (mem) T(std::forward<Args>(args)...) : nullptr;
+  }
+};
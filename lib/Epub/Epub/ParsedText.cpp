@@ -26,6 +26,18 @@ constexpr size_t RTL_PARAGRAPH_PROBE_WORDS = 3;
 constexpr int RTL_PER_WORD_PROBE_DEPTH = 64;
 constexpr size_t MIN_JUSTIFY_GAPS = 1;
 
+// Total-fit line breaking (Knuth & Plass), in the units of the original algorithm: badness 0..10000,
+// demerits = (line penalty + badness)^2 + penalty^2.
+constexpr int64_t KP_LINE_PENALTY = 10;
+constexpr int64_t KP_HYPHEN_PENALTY = 50;
+constexpr int64_t KP_CONSECUTIVE_HYPHEN_DEMERITS = 3000;
+constexpr int64_t KP_MAX_BADNESS = 10000;
+// Memory bounds per paragraph: paragraphs with more break candidates (word boundaries plus hyphenation
+// points) fall back to the greedy breakers, and at most KP_MAX_ACTIVE_NODES line starts are considered
+// at once (the node with the worst total is dropped first).
+constexpr size_t KP_MAX_CANDIDATES = 1024;
+constexpr size_t KP_MAX_ACTIVE_NODES = 40;
+
 // Byte-level pre-check: Hebrew UTF-8 lead bytes 0xD6-0xD7, Arabic/Syriac 0xD8-0xDB.
 bool mayContainRtlBytes(const char* str) {
   for (const auto* p = reinterpret_cast<const unsigned char*>(str); *p; ++p) {
@@ -464,7 +476,7 @@ int ParsedText::resolveFirstLineIndent(const bool isFirstLine, const GfxRenderer
 }
 // Consumes data to minimize memory usage
 void ParsedText::layoutAndExtractLines(const GfxRenderer& renderer, const int fontId, const uint16_t viewportWidth,
-                                       const std::function<void(std::shared_ptr<TextBlock>)>& processLine,
+                                       const std::function<void(TextBlock&&)>& processLine,
                                        const bool includeLastLine) {
   if (words.empty()) {
     return;
@@ -508,7 +520,10 @@ void ParsedText::layoutAndExtractLines(const GfxRenderer& renderer, const int fo
   auto wordWidths = calculateWordWidths(renderer, fontId);
 
   std::vector<size_t> lineBreakIndices;
-  if (hyphenationEnabled) {
+  if (optimalLineBreaks && blockStyle.alignment == CssTextAlign::Justify &&
+      computeOptimalLineBreaks(renderer, fontId, pageWidth, wordWidths, lineBreakIndices)) {
+    // Total-fit layout succeeded
+  } else if (hyphenationEnabled) {
     // Use greedy layout that can split words mid-loop when a hyphenated prefix fits.
     lineBreakIndices =
         computeHyphenatedLineBreaks(renderer, fontId, pageWidth, wordWidths, wordContinues, wordNoSpaceBefore);
@@ -552,17 +567,7 @@ std::vector<size_t> ParsedText::computeLineBreaks(const GfxRenderer& renderer, c
   }
 
   const int firstLineIndent = resolveFirstLineIndent(true, renderer, fontId);
-
-  // Ensure any word that would overflow even as the first entry on a line is split using fallback hyphenation.
-  for (size_t i = 0; i < wordWidths.size(); ++i) {
-    // First word needs to fit in reduced width if there's an indent
-    const int effectiveWidth = i == 0 ? pageWidth - firstLineIndent : pageWidth;
-    while (wordWidths[i] > effectiveWidth) {
-      if (!hyphenateWordAtIndex(i, effectiveWidth, renderer, fontId, wordWidths, /*allowFallbackBreaks=*/true)) {
-        break;
-      }
-    }
-  }
+  splitOversizedWords(renderer, fontId, pageWidth, wordWidths);
 
   const size_t totalWordCount = words.size();
 
@@ -659,6 +664,21 @@ std::vector<size_t> ParsedText::computeLineBreaks(const GfxRenderer& renderer, c
   return lineBreakIndices;
 }
 
+// Ensures any word that would overflow even as the first entry on a line is split using fallback hyphenation.
+void ParsedText::splitOversizedWords(const GfxRenderer& renderer, const int fontId, const int pageWidth,
+                                     std::vector<uint16_t>& wordWidths) {
+  const int firstLineIndent = resolveFirstLineIndent(true, renderer, fontId);
+  for (size_t i = 0; i < wordWidths.size(); ++i) {
+    // First word needs to fit in reduced width if there's an indent
+    const int effectiveWidth = i == 0 ? pageWidth - firstLineIndent : pageWidth;
+    while (wordWidths[i] > effectiveWidth) {
+      if (!hyphenateWordAtIndex(i, effectiveWidth, renderer, fontId, wordWidths, /*allowFallbackBreaks=*/true)) {
+        break;
+      }
+    }
+  }
+}
+
 // Builds break indices while opportunistically splitting the word that would overflow the current line.
 std::vector<size_t> ParsedText::computeHyphenatedLineBreaks(const GfxRenderer& renderer, const int fontId,
                                                             const int pageWidth, std::vector<uint16_t>& wordWidths,
@@ -733,6 +753,213 @@ std::vector<size_t> ParsedText::computeHyphenatedLineBreaks(const GfxRenderer& r
   return lineBreakIndices;
 }
 
+// Paragraph-level optimal line breaking. Every word boundary and, with hyphenation enabled, every
+// Hyphenator::breakOffsets point is a candidate break; hyphenation points carry a penalty. Lines are scored
+// by how far their gaps have to stretch to fill the width and the break sequence with the least total
+// demerits wins. Returns false (leaving words intact apart from splitOversizedWords) when the paragraph is
+// too long for the memory bounds or has no feasible layout; the caller then breaks greedily.
+bool ParsedText::computeOptimalLineBreaks(const GfxRenderer& renderer, const int fontId, const int pageWidth,
+                                          std::vector<uint16_t>& wordWidths, std::vector<size_t>& lineBreakIndices) {
+  if (words.empty()) {
+    return false;
+  }
+
+  // Bounded after the split, which can add words, so the tables below never outgrow the candidate limit
+  splitOversizedWords(renderer, fontId, pageWidth, wordWidths);
+  const size_t wordCount = words.size();
+  if (wordCount >= KP_MAX_CANDIDATES) {
+    return false;
+  }
+  const int firstLineWidth = pageWidth - resolveFirstLineIndent(true, renderer, fontId);
+  // Justification stretches each gap; a gap stretched by half a space counts as badness 100.
+  const int64_t stretchPerGap = std::max(1, renderer.getSpaceWidth(fontId, EpdFontFamily::REGULAR) / 2);
+
+  // widthBefore[k]: natural width of words [0, k) including the gaps between them.
+  // gapsBefore[k]: justifiable gaps in front of words [1, k), counted as extractLine does.
+  std::vector<int32_t> widthBefore(wordCount + 1, 0);
+  std::vector<uint16_t> gapsBefore(wordCount + 1, 0);
+  std::vector<int16_t> gap(wordCount, 0);
+  for (size_t j = 0; j < wordCount; ++j) {
+    bool stretches = false;
+    if (j > 0 && wordNoSpaceBefore[j]) {
+      stretches = true;
+    } else if (j > 0 && !wordContinues[j]) {
+      gap[j] = static_cast<int16_t>(
+          renderer.getSpaceAdvance(fontId, lastCodepoint(words[j - 1]), firstCodepoint(words[j]), wordStyles[j - 1]));
+      stretches = true;
+    } else if (j > 0) {
+      gap[j] = static_cast<int16_t>(
+          renderer.getKerning(fontId, lastCodepoint(words[j - 1]), firstCodepoint(words[j]), wordStyles[j - 1]));
+      stretches = words[j] == " ";
+    }
+    widthBefore[j + 1] = widthBefore[j] + gap[j] + wordWidths[j];
+    gapsBefore[j + 1] = static_cast<uint16_t>(gapsBefore[j] + (stretches ? 1 : 0));
+  }
+
+  // Candidate 0 is the paragraph start and the last one the paragraph end. byteOffset 0 means "break before
+  // the word"; otherwise the break falls inside it and the line ends with the measured prefix.
+  struct Candidate {
+    uint16_t word;
+    uint16_t byteOffset;
+    uint16_t prefixWidth;
+    uint16_t remainderWidth;
+    bool insertHyphen;
+  };
+  std::vector<Candidate> candidates;
+  candidates.reserve(wordCount + 1);
+  candidates.push_back({0, 0, 0, 0, false});
+  for (size_t j = 0; j < wordCount; ++j) {
+    if (j > 0 && !wordContinues[j]) {
+      candidates.push_back({static_cast<uint16_t>(j), 0, 0, 0, false});
+    }
+    if (!hyphenationEnabled) continue;
+    const std::string& word = words[j];
+    const auto style = wordStyles[j];
+    for (const auto& info : Hyphenator::breakOffsets(word, false)) {
+      if (info.byteOffset == 0 || info.byteOffset >= word.size()) continue;
+      if (candidates.size() + 1 >= KP_MAX_CANDIDATES) {
+        return false;
+      }
+      const uint16_t prefixWidth =
+          measureWordWidth(renderer, fontId, word.substr(0, info.byteOffset), style, info.requiresInsertedHyphen);
+      const uint16_t remainderWidth = measureWordWidth(renderer, fontId, word.substr(info.byteOffset), style);
+      candidates.push_back({static_cast<uint16_t>(j), static_cast<uint16_t>(info.byteOffset), prefixWidth,
+                            remainderWidth, info.requiresInsertedHyphen});
+    }
+  }
+  candidates.push_back({static_cast<uint16_t>(wordCount), 0, 0, 0, false});
+  const size_t candidateCount = candidates.size();
+  if (candidateCount > KP_MAX_CANDIDATES) {
+    return false;
+  }
+
+  constexpr int64_t UNREACHED = std::numeric_limits<int64_t>::max();
+  std::vector<int64_t> totalDemerits(candidateCount, UNREACHED);
+  std::vector<uint16_t> previous(candidateCount, 0);
+  std::vector<uint16_t> active;
+  active.reserve(KP_MAX_ACTIVE_NODES + 1);
+  totalDemerits[0] = 0;
+  active.push_back(0);
+
+  for (size_t c = 1; c < candidateCount; ++c) {
+    const Candidate& end = candidates[c];
+    const bool isLastLine = c == candidateCount - 1;
+    int64_t bestTotal = UNREACHED;
+    uint16_t bestPrevious = 0;
+
+    for (size_t i = 0; i < active.size();) {
+      const Candidate& start = candidates[active[i]];
+      // A line holds the start word (whole, or the remainder after a hyphenation break), the words in
+      // between, and then nothing / the prefix of the end word.
+      int lineWidth;
+      int gaps;
+      if (end.word == start.word) {
+        if (end.byteOffset == 0 || start.byteOffset != 0) {
+          ++i;
+          continue;  // two breaks inside one word: left to splitOversizedWords
+        }
+        lineWidth = end.prefixWidth;
+        gaps = 0;
+      } else {
+        lineWidth = (start.byteOffset == 0 ? wordWidths[start.word] : start.remainderWidth) +
+                    widthBefore[end.word] - widthBefore[start.word + 1];
+        gaps = gapsBefore[end.word] - gapsBefore[start.word + 1];
+        if (end.byteOffset != 0) {
+          lineWidth += gap[end.word] + end.prefixWidth;
+          gaps = gapsBefore[end.word + 1] - gapsBefore[start.word + 1];
+        }
+      }
+
+      const int availableWidth = active[i] == 0 ? firstLineWidth : pageWidth;
+      if (lineWidth > availableWidth) {
+        // Lines from this start only get longer past a word boundary: retire it. Hyphenation prefixes are
+        // not monotonic (the added hyphen), so those are just skipped.
+        if (end.byteOffset == 0) {
+          active.erase(active.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+          ++i;
+        }
+        continue;
+      }
+
+      int64_t badness = 0;
+      if (!isLastLine) {
+        const int64_t slack = availableWidth - lineWidth;
+        if (gaps == 0) {
+          badness = slack > 0 ? KP_MAX_BADNESS : 0;
+        } else {
+          const int64_t stretch = stretchPerGap * gaps;
+          // Beyond 5x the stretch the cube would overflow anyway; badness saturates at 10000 well before that
+          badness = slack >= stretch * 5
+                        ? KP_MAX_BADNESS
+                        : std::min(KP_MAX_BADNESS, 100 * slack * slack * slack / (stretch * stretch * stretch));
+        }
+      }
+      int64_t demerits = (KP_LINE_PENALTY + badness) * (KP_LINE_PENALTY + badness);
+      if (end.byteOffset != 0) {
+        demerits += KP_HYPHEN_PENALTY * KP_HYPHEN_PENALTY;
+        if (start.byteOffset != 0) demerits += KP_CONSECUTIVE_HYPHEN_DEMERITS;
+      }
+
+      const int64_t total = totalDemerits[active[i]] + demerits;
+      if (total < bestTotal) {
+        bestTotal = total;
+        bestPrevious = active[i];
+      }
+      ++i;
+    }
+
+    if (bestTotal != UNREACHED) {
+      totalDemerits[c] = bestTotal;
+      previous[c] = bestPrevious;
+      if (!isLastLine) {
+        active.push_back(static_cast<uint16_t>(c));
+        if (active.size() > KP_MAX_ACTIVE_NODES) {
+          const auto worst = std::max_element(active.begin(), active.end(), [&](const uint16_t a, const uint16_t b) {
+            return totalDemerits[a] < totalDemerits[b];
+          });
+          active.erase(worst);
+        }
+      }
+    }
+    if (active.empty() && !isLastLine) {
+      return false;  // nothing fits (e.g. an unbreakable group wider than the line)
+    }
+  }
+  if (totalDemerits[candidateCount - 1] == UNREACHED) {
+    return false;
+  }
+
+  std::vector<uint16_t> chosen;
+  for (uint16_t c = static_cast<uint16_t>(candidateCount - 1); c != 0; c = previous[c]) {
+    chosen.push_back(c);
+  }
+  std::reverse(chosen.begin(), chosen.end());
+
+  // Split the hyphenated words back to front so earlier word indices stay valid, then emit the break
+  // indices front to back, shifted by the splits before each break.
+  for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+    const Candidate& candidate = candidates[*it];
+    if (candidate.byteOffset != 0) {
+      splitWordAt(candidate.word, candidate.byteOffset, candidate.insertHyphen, candidate.prefixWidth,
+                  candidate.remainderWidth, wordWidths);
+    }
+  }
+  lineBreakIndices.clear();
+  lineBreakIndices.reserve(chosen.size());
+  size_t splits = 0;
+  for (const uint16_t c : chosen) {
+    const Candidate& candidate = candidates[c];
+    if (candidate.byteOffset != 0) {
+      lineBreakIndices.push_back(candidate.word + splits + 1);
+      ++splits;
+    } else {
+      lineBreakIndices.push_back(candidate.word + splits);
+    }
+  }
+  return true;
+}
+
 // Splits words[wordIndex] into prefix (adding a hyphen only when needed) and remainder when a legal breakpoint fits the
 // available width.
 bool ParsedText::hyphenateWordAtIndex(const size_t wordIndex, const int availableWidth, const GfxRenderer& renderer,
@@ -779,10 +1006,23 @@ bool ParsedText::hyphenateWordAtIndex(const size_t wordIndex, const int availabl
     return false;
   }
 
+  const uint16_t remainderWidth = measureWordWidth(renderer, fontId, word.substr(chosenOffset), style);
+  splitWordAt(wordIndex, chosenOffset, chosenNeedsHyphen, static_cast<uint16_t>(chosenWidth), remainderWidth,
+              wordWidths);
+  return true;
+}
+
+// Splits words[wordIndex] at byteOffset into a prefix (plus a hyphen when insertHyphen) and a remainder word that
+// starts the next line. Widths are the caller's measurements of the two parts.
+void ParsedText::splitWordAt(const size_t wordIndex, const size_t byteOffset, const bool insertHyphen,
+                             const uint16_t prefixWidth, const uint16_t remainderWidth,
+                             std::vector<uint16_t>& wordWidths) {
+  const auto style = wordStyles[wordIndex];
+
   // Split the word at the selected breakpoint and append a hyphen if required.
-  std::string remainder = word.substr(chosenOffset);
-  words[wordIndex].resize(chosenOffset);
-  if (chosenNeedsHyphen) {
+  std::string remainder = words[wordIndex].substr(byteOffset);
+  words[wordIndex].resize(byteOffset);
+  if (insertHyphen) {
     words[wordIndex].push_back('-');
   }
 
@@ -816,17 +1056,15 @@ bool ParsedText::hyphenateWordAtIndex(const size_t wordIndex, const int availabl
   wordNoSpaceBefore.insert(wordNoSpaceBefore.begin() + wordIndex + 1, false);
 
   // Update cached widths to reflect the new prefix/remainder pairing.
-  wordWidths[wordIndex] = static_cast<uint16_t>(chosenWidth);
-  const uint16_t remainderWidth = measureWordWidth(renderer, fontId, remainder, style);
+  wordWidths[wordIndex] = prefixWidth;
   wordWidths.insert(wordWidths.begin() + wordIndex + 1, remainderWidth);
-  return true;
 }
 
 void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const std::vector<uint16_t>& wordWidths,
                              const std::vector<bool>& continuesVec, const std::vector<bool>& noSpaceBeforeVec,
                              const std::vector<size_t>& lineBreakIndices,
-                             const std::function<void(std::shared_ptr<TextBlock>)>& processLine,
-                             const GfxRenderer& renderer, const int fontId) {
+                             const std::function<void(TextBlock&&)>& processLine, const GfxRenderer& renderer,
+                             const int fontId) {
   const size_t lineBreak = lineBreakIndices[breakIndex];
   const size_t lastBreakAt = breakIndex > 0 ? lineBreakIndices[breakIndex - 1] : 0;
   const size_t lineWordCount = lineBreak - lastBreakAt;
@@ -1133,8 +1371,7 @@ void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const
   }
 
   if (!lineHasFocusSplit) {
-    processLine(std::make_shared<TextBlock>(std::move(lineWords), std::move(lineXPos), std::move(lineWordStyles),
-                                            std::vector<uint8_t>{}, std::vector<uint16_t>{}, blockStyle));
+    processLine(TextBlock(lineWords, lineXPos, lineWordStyles, {}, {}, blockStyle));
     return;
   }
 
@@ -1179,6 +1416,5 @@ void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const
     }
   }
 
-  processLine(std::make_shared<TextBlock>(std::move(outWords), std::move(outXPos), std::move(outStyles),
-                                          std::move(outBoundaries), std::move(outSuffixX), blockStyle));
+  processLine(TextBlock(outWords, outXPos, outStyles, outBoundaries, outSuffixX, blockStyle));
 }
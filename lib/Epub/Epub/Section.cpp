@@ -1,27 +1,127 @@
 #include "Section.h"
 
+#include <Arduino.h>
+#include <FontCacheManager.h>
+#include <FontSubsetCollector.h>
+#include <GfxRenderer.h>
 #include <HalStorage.h>
 #include <Logging.h>
+#include <Memory.h>
+#include <SdCardFont.h>
 #include <Serialization.h>
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "Epub/css/CssParser.h"
 #include "Page.h"
+#include "hyphenation/HyphenationCache.h"
 #include "hyphenation/Hyphenator.h"
 #include "parsers/ChapterHtmlSlimParser.h"
 
 namespace {
-// v27: words NFC-composed at layout time; bump invalidates NFD section caches.
-constexpr uint8_t SECTION_FILE_VERSION = 27;
+// v28: anchor map replaced by a hash-sorted anchor index plus string pool.
+// v29: optimalLineBreaks header field.
+// v30: image blocks record their EPUB item href.
+// v31: imageFree header field.
+constexpr uint8_t SECTION_FILE_VERSION = 31;
+// Leave room for layout of the next chapter and image decoding before holding extra pages
+constexpr size_t MIN_FREE_HEAP_FOR_PREFETCH = 64 * 1024;
 constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + sizeof(int) + sizeof(float) + sizeof(bool) + sizeof(uint8_t) +
                                  sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(bool) + sizeof(bool) +
-                                 sizeof(uint8_t) + sizeof(bool) + sizeof(uint32_t) + sizeof(uint32_t) +
-                                 sizeof(uint32_t) + sizeof(uint32_t);
+                                 sizeof(uint8_t) + sizeof(bool) + sizeof(bool) + sizeof(bool) + sizeof(uint32_t) +
+                                 sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t);
+
+// Anchor index entry on disk: uint32 hash, uint32 string pool offset, uint16 page
+constexpr uint32_t ANCHOR_ENTRY_SIZE = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint16_t);
 
 struct PageLutEntry {
   uint32_t fileOffset;
   uint16_t paragraphIndex;
   uint16_t listItemIndex;
 };
+
+SdCardFont* findSdCardFont(const GfxRenderer& renderer, const int fontId) {
+  const auto it = renderer.getSdCardFonts().find(fontId);
+  return it != renderer.getSdCardFonts().end() ? it->second : nullptr;
+}
+
+// The book's subset of an SD card font lives next to its sections and is shared by all of them
+std::string fontSubsetPath(const Epub& epub, const int fontId) {
+  char name[24];
+  snprintf(name, sizeof(name), "/font_%08x.cpfont", static_cast<unsigned>(fontId));
+  return epub.getCachePath() + name;
+}
+
+// Hyphenation results are shared by every section of the book, one table per language
+std::string hyphenationCachePath(const Epub& epub, const char* languageTag) {
+  return epub.getCachePath() + "/hyph_" + languageTag + ".bin";
+}
+
+void loadHyphenationCache(const std::string& path, HyphenationCache& cache) {
+  HalFile file;
+  if (!Storage.exists(path.c_str()) || !Storage.openFileForRead("SCT", path, file)) return;
+  const size_t size = HyphenationCache::dataSize();
+  if (file.size() != size || file.read(cache.data(), size) != static_cast<int>(size)) {
+    cache.clear();
+    return;
+  }
+  if (!cache.validateLoaded()) {
+    LOG_DBG("SCT", "Ignoring stale hyphenation cache %s", path.c_str());
+  }
+}
+
+void saveHyphenationCache(const std::string& path, HyphenationCache& cache) {
+  HalFile file;
+  if (!Storage.openFileForWrite("SCT", path, file)) return;
+  if (file.write(cache.data(), HyphenationCache::dataSize()) != HyphenationCache::dataSize()) {
+    LOG_ERR("SCT", "Failed to write hyphenation cache %s", path.c_str());
+    file.close();
+    Storage.remove(path.c_str());
+  }
+}
+
+// FNV-1a 32-bit
+uint32_t anchorHash(const std::string& anchor) {
+  uint32_t hash = 2166136261u;
+  for (const char c : anchor) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Anchor index layout: uint16 count, then `count` entries sorted by hash (ties keep
+// document order so the first occurrence of a duplicate id wins), then the string pool
+// holding each anchor as a serialized string. Lookups binary-search the table and read
+// back only the candidate's name to rule out hash collisions.
+void writeAnchorIndex(HalFile& file, const std::vector<std::pair<std::string, uint16_t>>& anchors) {
+  const uint16_t count = static_cast<uint16_t>(std::min<size_t>(anchors.size(), UINT16_MAX));
+  std::vector<std::pair<uint32_t, uint16_t>> sorted;  // <hash, anchor index>
+  sorted.reserve(count);
+  for (uint16_t i = 0; i < count; i++) {
+    sorted.emplace_back(anchorHash(anchors[i].first), i);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  // Pool offsets follow document order, so compute them up front
+  std::vector<uint32_t> poolOffsets(count);
+  uint32_t poolSize = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    poolOffsets[i] = poolSize;
+    poolSize += sizeof(uint32_t) + anchors[i].first.size();
+  }
+
+  serialization::writePod(file, count);
+  for (const auto& [hash, index] : sorted) {
+    serialization::writePod(file, hash);
+    serialization::writePod(file, poolOffsets[index]);
+    serialization::writePod(file, anchors[index].second);
+  }
+  for (uint16_t i = 0; i < count; i++) {
+    serialization::writeString(file, anchors[i].first);
+  }
+}
 }  // namespace
 
 uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
@@ -41,11 +141,82 @@ uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
   return position;
 }
 
+bool Section::loadLuts() const {
+  if (!pageOffsets.empty()) {
+    return true;
+  }
+
+  HalFile f;
+  if (!Storage.openFileForRead("SCT", filePath, f)) {
+    return false;
+  }
+
+  const uint32_t fileSize = f.size();
+  if (fileSize < HEADER_SIZE) {
+    return false;
+  }
+
+  uint16_t count;
+  uint32_t lutOffset, paragraphLutOffset, liLutOffset;
+  f.seek(HEADER_SIZE - sizeof(uint32_t) * 4 - sizeof(uint16_t));
+  serialization::readPod(f, count);
+  serialization::readPod(f, lutOffset);
+  f.seek(HEADER_SIZE - sizeof(uint32_t) * 2);
+  serialization::readPod(f, paragraphLutOffset);
+  serialization::readPod(f, liLutOffset);
+  if (count == 0 || lutOffset < HEADER_SIZE || lutOffset + count * sizeof(uint32_t) > fileSize ||
+      paragraphLutOffset + sizeof(uint16_t) + count * sizeof(uint16_t) > fileSize ||
+      liLutOffset + count * sizeof(uint16_t) > fileSize) {
+    LOG_ERR("SCT", "Invalid LUT offsets for %u pages", count);
+    return false;
+  }
+
+  uint16_t paragraphCount;
+  f.seek(paragraphLutOffset);
+  serialization::readPod(f, paragraphCount);
+  if (paragraphCount != count) {
+    LOG_ERR("SCT", "Paragraph LUT count %u does not match page count %u", paragraphCount, count);
+    return false;
+  }
+
+  // One seek and one bulk read per table
+  const auto readTable = [&f](const uint32_t offset, void* dst, const size_t bytes) {
+    return f.seek(offset) && f.read(dst, bytes) == static_cast<int>(bytes);
+  };
+  pageOffsets.resize(count);
+  pageParagraphIndices.resize(count);
+  pageListItemIndices.resize(count);
+  if (!readTable(lutOffset, pageOffsets.data(), count * sizeof(uint32_t)) ||
+      !readTable(paragraphLutOffset + sizeof(uint16_t), pageParagraphIndices.data(), count * sizeof(uint16_t)) ||
+      !readTable(liLutOffset, pageListItemIndices.data(), count * sizeof(uint16_t))) {
+    LOG_ERR("SCT", "Failed to read page LUTs");
+    resetLuts();
+    return false;
+  }
+
+  pagesEnd = lutOffset;
+  return true;
+}
+
+void Section::resetLuts() const {
+  // Cached pages were located through the LUTs, drop them too
+  for (auto& slot : pageCache) {
+    slot = {};
+  }
+  pageOffsets.clear();
+  pageOffsets.shrink_to_fit();
+  pageParagraphIndices.clear();
+  pageParagraphIndices.shrink_to_fit();
+  pageListItemIndices.clear();
+  pageListItemIndices.shrink_to_fit();
+  pagesEnd = 0;
+}
+
 void Section::writeSectionFileHeader(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
                                      const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                                      const uint16_t viewportHeight, const bool hyphenationEnabled,
                                      const bool embeddedStyle, const uint8_t imageRendering,
-                                     const bool focusReadingEnabled) {
+                                     const bool focusReadingEnabled, const bool optimalLineBreaks) {
   if (!file) {
     LOG_DBG("SCT", "File not open for writing header");
     return;
@@ -54,7 +225,8 @@ void Section::writeSectionFileHeader(const int fontId, const float lineCompressi
                                    sizeof(extraParagraphSpacing) + sizeof(paragraphAlignment) + sizeof(viewportWidth) +
                                    sizeof(viewportHeight) + sizeof(pageCount) + sizeof(hyphenationEnabled) +
                                    sizeof(embeddedStyle) + sizeof(imageRendering) + sizeof(focusReadingEnabled) +
-                                   sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t),
+                                   sizeof(optimalLineBreaks) + sizeof(imageFree) + sizeof(uint32_t) + sizeof(uint32_t) +
+                                   sizeof(uint32_t) + sizeof(uint32_t),
                 "Header size mismatch");
   serialization::writePod(file, SECTION_FILE_VERSION);
   serialization::writePod(file, fontId);
@@ -67,6 +239,8 @@ void Section::writeSectionFileHeader(const int fontId, const float lineCompressi
   serialization::writePod(file, embeddedStyle);
   serialization::writePod(file, imageRendering);
   serialization::writePod(file, focusReadingEnabled);
+  serialization::writePod(file, optimalLineBreaks);
+  serialization::writePod(file, false);  // Placeholder for imageFree (patched later)
   serialization::writePod(file, pageCount);  // Placeholder for page count (will be initially 0, patched later)
   serialization::writePod(file, static_cast<uint32_t>(0));  // Placeholder for LUT offset (patched later)
   serialization::writePod(file, static_cast<uint32_t>(0));  // Placeholder for anchor map offset (patched later)
@@ -77,7 +251,9 @@ void Section::writeSectionFileHeader(const int fontId, const float lineCompressi
 bool Section::loadSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
                               const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                               const uint16_t viewportHeight, const bool hyphenationEnabled, const bool embeddedStyle,
-                              const uint8_t imageRendering, const bool focusReadingEnabled) {
+                              const uint8_t imageRendering, const bool focusReadingEnabled,
+                              const bool optimalLineBreaks) {
+  resetLuts();
   if (!Storage.openFileForRead("SCT", filePath, file)) {
     return false;
   }
@@ -103,6 +279,7 @@ bool Section::loadSectionFile(const int fontId, const float lineCompression, con
     bool fileEmbeddedStyle;
     uint8_t fileImageRendering;
     bool fileFocusReadingEnabled;
+    bool fileOptimalLineBreaks;
     serialization::readPod(file, fileFontId);
     serialization::readPod(file, fileLineCompression);
     serialization::readPod(file, fileExtraParagraphSpacing);
@@ -113,12 +290,16 @@ bool Section::loadSectionFile(const int fontId, const float lineCompression, con
     serialization::readPod(file, fileEmbeddedStyle);
     serialization::readPod(file, fileImageRendering);
     serialization::readPod(file, fileFocusReadingEnabled);
+    serialization::readPod(file, fileOptimalLineBreaks);
+    // Depends only on the chapter's content, so a rebuild for new settings can use it too
+    serialization::readPod(file, imageFree);
 
     if (fontId != fileFontId || lineCompression != fileLineCompression ||
         extraParagraphSpacing != fileExtraParagraphSpacing || paragraphAlignment != fileParagraphAlignment ||
         viewportWidth != fileViewportWidth || viewportHeight != fileViewportHeight ||
         hyphenationEnabled != fileHyphenationEnabled || embeddedStyle != fileEmbeddedStyle ||
-        imageRendering != fileImageRendering || focusReadingEnabled != fileFocusReadingEnabled) {
+        imageRendering != fileImageRendering || focusReadingEnabled != fileFocusReadingEnabled ||
+        optimalLineBreaks != fileOptimalLineBreaks) {
       file.close();
       LOG_ERR("SCT", "Deserialization failed: Parameters do not match");
       clearCache();
@@ -129,12 +310,20 @@ bool Section::loadSectionFile(const int fontId, const float lineCompression, con
   serialization::readPod(file, pageCount);
   // Explicit close() required: member variable persists beyond function scope
   file.close();
+  if (SdCardFont* sdFont = findSdCardFont(renderer, fontId)) {
+    if (SdCardFont::bookSubsetsEnabled()) {
+      sdFont->attachSubset(fontSubsetPath(*epub, fontId));
+    } else {
+      sdFont->detachSubset();
+    }
+  }
   LOG_DBG("SCT", "Deserialization succeeded: %d pages", pageCount);
   return true;
 }
 
 // Your updated class method (assuming you are using the 'SD' object, which is a wrapper for a specific filesystem)
 bool Section::clearCache() const {
+  resetLuts();
   if (!Storage.exists(filePath.c_str())) {
     LOG_DBG("SCT", "Cache does not exist, no action needed");
     return true;
@@ -153,9 +342,8 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
                                 const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                                 const uint16_t viewportHeight, const bool hyphenationEnabled, const bool embeddedStyle,
                                 const uint8_t imageRendering, const bool focusReadingEnabled,
-                                const std::function<void()>& popupFn) {
+                                const bool optimalLineBreaks, const std::function<void()>& popupFn) {
   const auto localPath = epub->getSpineItem(spineIndex).href;
-  const auto tmpHtmlPath = epub->getCachePath() + "/.tmp_" + std::to_string(spineIndex) + ".html";
 
   // Create cache directory if it doesn't exist
   {
@@ -163,48 +351,13 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     Storage.mkdir(sectionsDir.c_str());
   }
 
-  // Retry logic for SD card timing issues
-  bool success = false;
-  uint32_t fileSize = 0;
-  for (int attempt = 0; attempt < 3 && !success; attempt++) {
-    if (attempt > 0) {
-      LOG_DBG("SCT", "Retrying stream (attempt %d)...", attempt + 1);
-      delay(50);  // Brief delay before retry
-    }
-
-    // Remove any incomplete file from previous attempt before retrying
-    if (Storage.exists(tmpHtmlPath.c_str())) {
-      Storage.remove(tmpHtmlPath.c_str());
-    }
-
-    HalFile tmpHtml;
-    if (!Storage.openFileForWrite("SCT", tmpHtmlPath, tmpHtml)) {
-      continue;
-    }
-    success = epub->readItemContentsToStream(localPath, tmpHtml, 1024);
-    fileSize = tmpHtml.size();
-    // Explicitly close() file before calling Storage.remove()
-    tmpHtml.close();
-
-    // If streaming failed, remove the incomplete file immediately
-    if (!success && Storage.exists(tmpHtmlPath.c_str())) {
-      Storage.remove(tmpHtmlPath.c_str());
-      LOG_DBG("SCT", "Removed incomplete temp file after failed attempt");
-    }
-  }
-
-  if (!success) {
-    LOG_ERR("SCT", "Failed to stream item contents to temp file after retries");
-    return false;
-  }
-
-  LOG_DBG("SCT", "Streamed temp HTML to %s (%d bytes)", tmpHtmlPath.c_str(), fileSize);
-
+  resetLuts();
   if (!Storage.openFileForWrite("SCT", filePath, file)) {
     return false;
   }
   writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
-                         viewportHeight, hyphenationEnabled, embeddedStyle, imageRendering, focusReadingEnabled);
+                         viewportHeight, hyphenationEnabled, embeddedStyle, imageRendering, focusReadingEnabled,
+                         optimalLineBreaks);
   std::vector<PageLutEntry> lut = {};
 
   // Derive the content base directory and image cache path prefix for the parser
@@ -219,6 +372,7 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
       if (!cssParser->loadFromCache()) {
         LOG_ERR("SCT", "Failed to load CSS from cache");
       }
+      cssParser->beginStyleMemo();
     }
   }
 
@@ -236,16 +390,50 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
   }
 
   ChapterHtmlSlimParser visitor(
-      epub, tmpHtmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
-      viewportHeight, hyphenationEnabled, focusReadingEnabled,
+      epub, localPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+      viewportHeight, hyphenationEnabled, focusReadingEnabled, optimalLineBreaks,
       [this, &lut](std::unique_ptr<Page> page, const uint16_t paragraphIndex, const uint16_t listItemIndex) {
         lut.push_back({this->onPageComplete(std::move(page)), paragraphIndex, listItemIndex});
       },
       embeddedStyle, contentBase, imageBasePath, imageRendering, std::move(tocAnchors), popupFn, cssParser);
+  // Glyphs this section uses, appended to the book's font subset once the build succeeds
+  SdCardFont* subsetFont = SdCardFont::bookSubsetsEnabled() ? findSdCardFont(renderer, fontId) : nullptr;
+  FontSubsetCollector subsetCollector;
+  if (subsetFont) visitor.setFontSubsetCollector(&subsetCollector);
+  visitor.setImageOrigin(imageOriginX, imageOriginY);
+  visitor.setImageFree(imageFree || !epub->hasImages());
   Hyphenator::setPreferredLanguage(epub->getLanguage());
-  success = visitor.parseAndBuildPages();
+  // Hyphenation results carry over from earlier builds of the book through its cache directory, so
+  // re-indexing after a layout change skips the words already hyphenated
+  HyphenationCache hyphenationCache;
+  const char* hyphenationLanguage = hyphenationEnabled ? Hyphenator::languageTag() : nullptr;
+  if (hyphenationLanguage && hyphenationCache.begin(hyphenationLanguage, Hyphenator::patternSetId())) {
+    loadHyphenationCache(hyphenationCachePath(*epub, hyphenationLanguage), hyphenationCache);
+    Hyphenator::setResultCache(&hyphenationCache);
+  }
+  // Memoize word widths for this build only; fonts and settings may change before the next one
+  FontCacheManager* fontCacheManager = renderer.getFontCacheManager();
+  if (fontCacheManager) fontCacheManager->enableWordWidthCache();
+  const bool success = visitor.parseAndBuildPages();
+  if (fontCacheManager) {
+    if (WordWidthCache* widthCache = fontCacheManager->getWordWidthCache()) widthCache->logStats("layout");
+    fontCacheManager->disableWordWidthCache();
+  }
+  if (hyphenationCache.isActive()) {
+    Hyphenator::setResultCache(nullptr);
+    LOG_DBG("SCT", "Hyphenation cache: hits=%lu misses=%lu evictions=%lu",
+            static_cast<unsigned long>(hyphenationCache.getStats().hits),
+            static_cast<unsigned long>(hyphenationCache.getStats().misses),
+            static_cast<unsigned long>(hyphenationCache.getStats().evictions));
+    if (hyphenationCache.isDirty()) {
+      saveHyphenationCache(hyphenationCachePath(*epub, hyphenationLanguage), hyphenationCache);
+    }
+  }
+  if (cssParser) {
+    cssParser->logStyleMemoStats();
+    cssParser->endStyleMemo();
+  }
 
-  Storage.remove(tmpHtmlPath.c_str());
   if (!success) {
     LOG_ERR("SCT", "Failed to parse XML and build pages");
     // Explicitly close() file before calling Storage.remove()
@@ -276,14 +464,9 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     return false;
   }
 
-  // Write anchor-to-page map for fragment navigation (e.g. footnote targets)
+  // Write anchor-to-page index for fragment navigation (e.g. footnote targets)
   const uint32_t anchorMapOffset = file.position();
-  const auto& anchors = visitor.getAnchors();
-  serialization::writePod(file, static_cast<uint16_t>(anchors.size()));
-  for (const auto& [anchor, page] : anchors) {
-    serialization::writeString(file, anchor);
-    serialization::writePod(file, page);
-  }
+  writeAnchorIndex(file, visitor.getAnchors());
 
   const uint32_t paragraphLutOffset = file.position();
   serialization::writePod(file, static_cast<uint16_t>(lut.size()));
@@ -296,8 +479,10 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     serialization::writePod(file, entry.listItemIndex);
   }
 
-  // Patch header with final pageCount, lutOffset, anchorMapOffset, paragraphLutOffset, and liLutOffset
-  file.seek(HEADER_SIZE - sizeof(uint32_t) * 4 - sizeof(pageCount));
+  // Patch header with imageFree, final pageCount, lutOffset, anchorMapOffset, paragraphLutOffset, and liLutOffset
+  imageFree = visitor.isImageFree();
+  file.seek(HEADER_SIZE - sizeof(uint32_t) * 4 - sizeof(pageCount) - sizeof(imageFree));
+  serialization::writePod(file, imageFree);
   serialization::writePod(file, pageCount);
   serialization::writePod(file, lutOffset);
   serialization::writePod(file, anchorMapOffset);
@@ -308,41 +493,135 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
   if (cssParser) {
     cssParser->clear();
   }
+
+  if (subsetFont && !subsetCollector.empty()) {
+    subsetFont->updateSubset(fontSubsetPath(*epub, fontId), subsetCollector.entries());
+  }
+
+  // Keep the freshly built LUTs so the first page turn doesn't read them back
+  pageOffsets.reserve(lut.size());
+  pageParagraphIndices.reserve(lut.size());
+  pageListItemIndices.reserve(lut.size());
+  for (const auto& entry : lut) {
+    pageOffsets.push_back(entry.fileOffset);
+    pageParagraphIndices.push_back(entry.paragraphIndex);
+    pageListItemIndices.push_back(entry.listItemIndex);
+  }
+  pagesEnd = lutOffset;
   return true;
 }
 
-std::unique_ptr<Page> Section::loadPageFromSectionFile() {
-  if (!Storage.openFileForRead("SCT", filePath, file)) {
+std::unique_ptr<Page> Section::loadPage(const int pageIndex) const {
+  if (!loadLuts() || pageIndex < 0 || pageIndex >= static_cast<int>(pageOffsets.size())) {
     return nullptr;
   }
 
-  file.seek(HEADER_SIZE - sizeof(uint32_t) * 4);
-  uint32_t lutOffset;
-  serialization::readPod(file, lutOffset);
-  file.seek(lutOffset + sizeof(uint32_t) * currentPage);
-  uint32_t pagePos;
-  serialization::readPod(file, pagePos);
-  file.seek(pagePos);
+  // Page records are contiguous, so the next page's offset bounds this one
+  const uint32_t pagePos = pageOffsets[pageIndex];
+  const bool isLastPage = pageIndex + 1 == static_cast<int>(pageOffsets.size());
+  const uint32_t pageEnd = isLastPage ? pagesEnd : pageOffsets[pageIndex + 1];
+  if (pageEnd <= pagePos) {
+    LOG_ERR("SCT", "Invalid extent for page %d", pageIndex);
+    return nullptr;
+  }
+  const uint32_t pageSize = pageEnd - pagePos;
+  const auto buffer = makeUniqueNoThrow<uint8_t[]>(pageSize);
+  if (!buffer) {
+    LOG_ERR("SCT", "Failed to allocate %u bytes for page %d", pageSize, pageIndex);
+    return nullptr;
+  }
 
-  auto page = Page::deserialize(file);
-  // Explicit close() required: member variable persists beyond function scope
-  file.close();
+  HalFile f;
+  if (!Storage.openFileForRead("SCT", filePath, f)) {
+    return nullptr;
+  }
+  const bool readOk = f.seek(pagePos) && f.read(buffer.get(), pageSize) == static_cast<int>(pageSize);
+  if (!readOk) {
+    LOG_ERR("SCT", "Failed to read page %d", pageIndex);
+    return nullptr;
+  }
+
+  serialization::BufferReader reader(buffer.get(), pageSize);
+  return Page::deserialize(reader);
+}
+
+std::unique_ptr<Page> Section::loadPageFromSectionFile() { return loadPage(currentPage); }
+
+std::shared_ptr<Page> Section::findCachedPage(const int pageIndex) const {
+  for (const auto& slot : pageCache) {
+    if (slot.page && slot.pageIndex == pageIndex) {
+      return slot.page;
+    }
+  }
+  return nullptr;
+}
+
+void Section::cachePage(const int pageIndex, std::shared_ptr<Page> page) {
+  // Reuse an empty slot, otherwise evict the page furthest from the one being cached
+  auto* victim = &pageCache[0];
+  for (auto& slot : pageCache) {
+    if (!slot.page) {
+      victim = &slot;
+      break;
+    }
+    if (std::abs(slot.pageIndex - pageIndex) > std::abs(victim->pageIndex - pageIndex)) {
+      victim = &slot;
+    }
+  }
+  victim->pageIndex = pageIndex;
+  victim->page = std::move(page);
+}
+
+std::shared_ptr<Page> Section::getCurrentPage() {
+  const int pageIndex = currentPage;
+  if (auto page = findCachedPage(pageIndex)) {
+    return page;
+  }
+
+  std::shared_ptr<Page> page = loadPage(pageIndex);
+  if (page) {
+    cachePage(pageIndex, page);
+  }
   return page;
 }
 
+void Section::prefetchAdjacentPages() {
+  const int pageIndex = currentPage;
+
+  // Drop pages that are no longer neighbours before loading new ones
+  for (auto& slot : pageCache) {
+    if (slot.page && std::abs(slot.pageIndex - pageIndex) > 1) {
+      slot = {};
+    }
+  }
+
+  // Forward first: it is by far the more common turn
+  for (const int neighbour : {pageIndex + 1, pageIndex - 1}) {
+    if (neighbour < 0 || neighbour >= pageCount || findCachedPage(neighbour)) {
+      continue;
+    }
+    if (ESP.getFreeHeap() < MIN_FREE_HEAP_FOR_PREFETCH) {
+      LOG_DBG("SCT", "Low heap (%u bytes), skipping page prefetch", ESP.getFreeHeap());
+      return;
+    }
+    std::shared_ptr<Page> page = loadPage(neighbour);
+    if (!page) {
+      return;
+    }
+    cachePage(neighbour, std::move(page));
+  }
+}
+
 std::string Section::getTextFromSectionFile() {
   std::string fullText;
   auto p = this->loadPageFromSectionFile();
   if (p) {
     for (const auto& el : p->elements) {
       if (el->getTag() == TAG_PageLine) {
-        const auto& line = static_cast<const PageLine&>(*el);
-        if (line.getBlock()) {
-          const auto& words = line.getBlock()->getWords();
-          for (const auto& w : words) {
-            if (!fullText.empty()) fullText += " ";
-            fullText += w;
-          }
+        const auto& block = static_cast<const PageLine&>(*el).getBlock();
+        for (size_t i = 0; i < block.wordCount(); i++) {
+          if (!fullText.empty()) fullText += " ";
+          fullText.append(block.getWord(i), block.getWordLength(i));
         }
       }
     }
@@ -351,6 +630,10 @@ std::string Section::getTextFromSectionFile() {
 }
 
 std::optional<uint16_t> Section::getCachedPageCount() const {
+  if (!pageOffsets.empty()) {
+    return static_cast<uint16_t>(pageOffsets.size());
+  }
+
   HalFile f;
   if (!Storage.openFileForRead("SCT", filePath, f)) {
     return std::nullopt;
@@ -384,12 +667,48 @@ std::optional<uint16_t> Section::getPageForAnchor(const std::string& anchor) con
   f.seek(anchorMapOffset);
   uint16_t count;
   serialization::readPod(f, count);
-  for (uint16_t i = 0; i < count; i++) {
-    std::string key;
+  const uint32_t tableOffset = anchorMapOffset + sizeof(uint16_t);
+  const uint32_t poolOffset = tableOffset + count * ANCHOR_ENTRY_SIZE;
+  if (count == 0 || poolOffset > fileSize) {
+    return std::nullopt;
+  }
+
+  // Lower bound on the hash column
+  const uint32_t hash = anchorHash(anchor);
+  uint16_t lo = 0;
+  uint16_t hi = count;
+  while (lo < hi) {
+    const uint16_t mid = lo + (hi - lo) / 2;
+    uint32_t midHash;
+    f.seek(tableOffset + mid * ANCHOR_ENTRY_SIZE);
+    serialization::readPod(f, midHash);
+    if (midHash < hash) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  // Verify the name for each entry sharing the hash
+  for (uint16_t i = lo; i < count; i++) {
+    uint32_t entryHash, nameOffset;
     uint16_t page;
-    serialization::readString(f, key);
+    f.seek(tableOffset + i * ANCHOR_ENTRY_SIZE);
+    serialization::readPod(f, entryHash);
+    if (entryHash != hash) {
+      break;
+    }
+    serialization::readPod(f, nameOffset);
     serialization::readPod(f, page);
-    if (key == anchor) {
+
+    f.seek(poolOffset + nameOffset);
+    uint32_t nameLen;
+    serialization::readPod(f, nameLen);
+    if (nameLen != anchor.size()) {
+      continue;
+    }
+    std::string key(nameLen, '\0');
+    if (f.read(&key[0], nameLen) == static_cast<int>(nameLen) && key == anchor) {
       return page;
     }
   }
@@ -398,120 +717,34 @@ std::optional<uint16_t> Section::getPageForAnchor(const std::string& anchor) con
 }
 
 std::optional<uint16_t> Section::getPageForParagraphIndex(const uint16_t pIndex) const {
-  HalFile f;
-  if (!Storage.openFileForRead("SCT", filePath, f)) {
-    return std::nullopt;
-  }
-
-  const uint32_t fileSize = f.size();
-  f.seek(HEADER_SIZE - sizeof(uint32_t) * 2);
-  uint32_t paragraphLutOffset;
-  serialization::readPod(f, paragraphLutOffset);
-  if (paragraphLutOffset == 0 || paragraphLutOffset >= fileSize) {
-    return std::nullopt;
-  }
-
-  f.seek(paragraphLutOffset);
-  uint16_t count;
-  serialization::readPod(f, count);
-  if (count == 0) {
+  if (!loadLuts()) {
     return std::nullopt;
   }
 
-  const uint32_t lutEnd = paragraphLutOffset + sizeof(uint16_t) + count * sizeof(uint16_t);
-  if (lutEnd > fileSize) {
-    return std::nullopt;
-  }
-
-  uint16_t resultPage = count - 1;
-  for (uint16_t i = 0; i < count; i++) {
-    uint16_t pagePIdx;
-    serialization::readPod(f, pagePIdx);
-    if (pagePIdx >= pIndex) {
-      resultPage = i;
-      break;
-    }
+  // Paragraph indices are a running counter, so the LUT is sorted: first page at or past pIndex
+  const auto it = std::lower_bound(pageParagraphIndices.begin(), pageParagraphIndices.end(), pIndex);
+  if (it == pageParagraphIndices.end()) {
+    return static_cast<uint16_t>(pageParagraphIndices.size() - 1);
   }
-
-  return resultPage;
+  return static_cast<uint16_t>(it - pageParagraphIndices.begin());
 }
 
 std::optional<uint16_t> Section::getParagraphIndexForPage(const uint16_t page) const {
-  HalFile f;
-  if (!Storage.openFileForRead("SCT", filePath, f)) {
-    return std::nullopt;
-  }
-
-  const uint32_t fileSize = f.size();
-  f.seek(HEADER_SIZE - sizeof(uint32_t) * 2);
-  uint32_t paragraphLutOffset;
-  serialization::readPod(f, paragraphLutOffset);
-  if (paragraphLutOffset == 0 || paragraphLutOffset >= fileSize) {
-    return std::nullopt;
-  }
-
-  f.seek(paragraphLutOffset);
-  uint16_t count;
-  serialization::readPod(f, count);
-  if (count == 0 || page >= count) {
-    return std::nullopt;
-  }
-
-  const uint32_t entryEnd = paragraphLutOffset + sizeof(uint16_t) + (page + 1) * sizeof(uint16_t);
-  if (entryEnd > fileSize) {
+  if (!loadLuts() || page >= pageParagraphIndices.size()) {
     return std::nullopt;
   }
-
-  f.seek(paragraphLutOffset + sizeof(uint16_t) + page * sizeof(uint16_t));
-  uint16_t pIdx;
-  serialization::readPod(f, pIdx);
-  return pIdx;
+  return pageParagraphIndices[page];
 }
 
 std::optional<uint16_t> Section::getPageForListItemIndex(const uint16_t liIndex) const {
-  HalFile f;
-  if (!Storage.openFileForRead("SCT", filePath, f)) {
-    return std::nullopt;
-  }
-
-  const uint32_t fileSize = f.size();
-  f.seek(HEADER_SIZE - sizeof(uint32_t));
-  uint32_t liLutOffset;
-  serialization::readPod(f, liLutOffset);
-  if (liLutOffset == 0 || liLutOffset >= fileSize) {
-    return std::nullopt;
-  }
-
-  // The li LUT shares count with the paragraph LUT; read count from paragraphLutOffset
-  f.seek(HEADER_SIZE - sizeof(uint32_t) * 2);
-  uint32_t paragraphLutOffset;
-  serialization::readPod(f, paragraphLutOffset);
-  if (paragraphLutOffset == 0 || paragraphLutOffset >= fileSize) {
+  if (!loadLuts()) {
     return std::nullopt;
   }
 
-  f.seek(paragraphLutOffset);
-  uint16_t count;
-  serialization::readPod(f, count);
-  if (count == 0) {
-    return std::nullopt;
-  }
-
-  const uint32_t lutEnd = liLutOffset + count * sizeof(uint16_t);
-  if (lutEnd > fileSize) {
-    return std::nullopt;
+  // Same running-counter property as the paragraph LUT
+  const auto it = std::lower_bound(pageListItemIndices.begin(), pageListItemIndices.end(), liIndex);
+  if (it == pageListItemIndices.end()) {
+    return static_cast<uint16_t>(pageListItemIndices.size() - 1);
   }
-
-  f.seek(liLutOffset);
-  uint16_t resultPage = count - 1;
-  for (uint16_t i = 0; i < count; i++) {
-    uint16_t pageLiIdx;
-    serialization::readPod(f, pageLiIdx);
-    if (pageLiIdx >= liIndex) {
-      resultPage = i;
-      break;
-    }
-  }
-
-  return resultPage;
+  return static_cast<uint16_t>(it - pageListItemIndices.begin());
 }
@@ -1,8 +1,10 @@
 #pragma once
+#include <array>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "Epub.h"
 
@@ -16,9 +18,33 @@ class Section {
   std::string filePath;
   HalFile file;
 
+  // Per-page LUTs, read once from the section file and kept in RAM for page turns and lookups
+  mutable std::vector<uint32_t> pageOffsets;
+  mutable std::vector<uint16_t> pageParagraphIndices;
+  mutable std::vector<uint16_t> pageListItemIndices;
+  mutable uint32_t pagesEnd = 0;  // End of the last page record (start of the page offset LUT)
+  int16_t imageOriginX = 0;       // screen position pages are rendered at, for index-time image decodes
+  int16_t imageOriginY = 0;
+  // Read from an earlier build's header, even one for other settings: the chapter references no images
+  bool imageFree = false;
+
+  // Deserialized pages around currentPage (previous, current, next), filled by prefetchAdjacentPages
+  static constexpr int PAGE_CACHE_SLOTS = 3;
+  struct CachedPage {
+    int pageIndex = -1;
+    std::shared_ptr<Page> page;
+  };
+  mutable std::array<CachedPage, PAGE_CACHE_SLOTS> pageCache;
+
+  bool loadLuts() const;
+  void resetLuts() const;
+  std::unique_ptr<Page> loadPage(int pageIndex) const;
+  std::shared_ptr<Page> findCachedPage(int pageIndex) const;
+  void cachePage(int pageIndex, std::shared_ptr<Page> page);
   void writeSectionFileHeader(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                               uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled,
-                              bool embeddedStyle, uint8_t imageRendering, bool focusReadingEnabled);
+                              bool embeddedStyle, uint8_t imageRendering, bool focusReadingEnabled,
+                              bool optimalLineBreaks);
   uint32_t onPageComplete(std::unique_ptr<Page> page);
 
  public:
@@ -33,13 +59,24 @@ class Section {
   ~Section() = default;
   bool loadSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                        uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle,
-                       uint8_t imageRendering, bool focusReadingEnabled);
+                       uint8_t imageRendering, bool focusReadingEnabled, bool optimalLineBreaks);
   bool clearCache() const;
+  // Screen position of the viewport's top-left corner. Images decoded while indexing are dithered there,
+  // so they match a decode at render time.
+  void setImageOrigin(const int16_t x, const int16_t y) {
+    imageOriginX = x;
+    imageOriginY = y;
+  }
   bool createSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                          uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle,
-                         uint8_t imageRendering, bool focusReadingEnabled,
+                         uint8_t imageRendering, bool focusReadingEnabled, bool optimalLineBreaks,
                          const std::function<void()>& popupFn = nullptr);
   std::unique_ptr<Page> loadPageFromSectionFile();
+  // Page at currentPage, served from the prefetch cache when it was loaded ahead of time.
+  std::shared_ptr<Page> getCurrentPage();
+  // Deserialize the pages either side of currentPage so the next turn doesn't wait on the SD card.
+  // Call once the current page is on screen.
+  void prefetchAdjacentPages();
   std::string getTextFromSectionFile();
 
   // Look up the page number for an anchor id from the section cache file.
@@ -3,23 +3,28 @@
 #include <FontCacheManager.h>
 #include <GfxRenderer.h>
 #include <Logging.h>
+#include <Memory.h>
 #include <Serialization.h>
 
 #include "Epub/converters/DirectPixelWriter.h"
 #include "Epub/converters/ImageDecoderFactory.h"
+#include "Epub/converters/PixelCache.h"
 
 // Cache file format:
 // - uint16_t width
 // - uint16_t height
 // - uint8_t pixels[...] - 2 bits per pixel, packed (4 pixels per byte), row-major order
+// New caches use the band-packed variant described in PixelCache.h (PACKED_FLAG set in width).
 
-ImageBlock::ImageBlock(const std::string& imagePath, int16_t width, int16_t height)
-    : imagePath(imagePath), width(width), height(height) {}
+ImageBlock::ImageBlock(const std::string& imagePath, const std::string& sourceHref, int16_t width, int16_t height)
+    : imagePath(imagePath), sourceHref(sourceHref), width(width), height(height) {}
 
 bool ImageBlock::imageExists() const { return Storage.exists(imagePath.c_str()); }
 
 namespace {
 
+ImageBlock::SourceExtractor sourceExtractor;
+
 std::string getCachePath(const std::string& imagePath) {
   // Replace extension with .pxc (pixel cache)
   size_t dotPos = imagePath.rfind('.');
@@ -29,6 +34,117 @@ std::string getCachePath(const std::string& imagePath) {
   return imagePath + ".pxc";
 }
 
+void drawCacheRow(DirectPixelWriter& pw, const uint8_t* rowBuffer, int x, int destY, int width) {
+  pw.beginRow(destY);
+  // On a grayscale strip pass only a narrow column window of the image is in
+  // the active band; skip the rest instead of unpacking+clipping every pixel.
+  int colStart, colEnd;
+  pw.bandColRange(x, width, colStart, colEnd);
+  for (int col = colStart; col < colEnd; col++) {
+    const int byteIdx = col >> 2;            // col / 4
+    const int bitShift = 6 - (col & 3) * 2;  // MSB first within byte
+    uint8_t pixelValue = (rowBuffer[byteIdx] >> bitShift) & 0x03;
+
+    pw.writePixel(x + col, pixelValue);
+  }
+}
+
+// Packed layout: only the bands that touch the active strip are read and
+// unpacked, so a landscape strip pass skips most of the file. In portrait a
+// strip is a column window, which still needs every band, but the bands are
+// a fraction of the plain size for flat artwork.
+bool renderFromPackedCache(GfxRenderer& renderer, HalFile& cacheFile, int x, int y, int width, int height) {
+  uint16_t bandRows = 0;
+  uint16_t bandCount = 0;
+  if (cacheFile.read(&bandRows, 2) != 2 || cacheFile.read(&bandCount, 2) != 2 || bandRows == 0 ||
+      bandCount != (height + bandRows - 1) / bandRows) {
+    LOG_ERR("IMG", "Invalid packed cache header");
+    return false;
+  }
+
+  const size_t tableBytes = ((size_t)bandCount + 1) * sizeof(uint32_t);
+  const size_t bytesPerRow = (width + 3) / 4;
+  const size_t bandBytes = bandRows * bytesPerRow;
+  const size_t maxPackedBytes = PackBits::maxEncodedSize(bandBytes);
+  const auto offsets = makeUniqueNoThrow<uint32_t[]>(bandCount + 1);
+  const auto rows = makeUniqueNoThrow<uint8_t[]>(bandBytes);
+  const auto packedRows = makeUniqueNoThrow<uint8_t[]>(maxPackedBytes);
+  if (!offsets || !rows || !packedRows) {
+    LOG_ERR("IMG", "Failed to allocate packed cache buffers");
+    return false;
+  }
+  if (cacheFile.read(offsets.get(), tableBytes) != static_cast<int>(tableBytes)) {
+    return false;
+  }
+  const size_t dataStart = PixelCache::PACKED_HEADER_SIZE + tableBytes;
+
+  DirectPixelWriter pw;
+  pw.init(renderer);
+
+  for (int band = 0; band < bandCount; band++) {
+    const int rowStart = band * bandRows;
+    const int bandHeight = (height - rowStart < bandRows) ? (height - rowStart) : bandRows;
+    if (!renderer.glyphIntersectsStrip(x, y + rowStart, x + width - 1, y + rowStart + bandHeight - 1)) {
+      continue;
+    }
+
+    const uint32_t packedBytes = offsets[band + 1] - offsets[band];
+    if (offsets[band + 1] < offsets[band] || packedBytes > maxPackedBytes ||
+        !cacheFile.seek(dataStart + offsets[band]) ||
+        cacheFile.read(packedRows.get(), packedBytes) != static_cast<int>(packedBytes) ||
+        !PackBits::decode(packedRows.get(), packedBytes, rows.get(), bandHeight * bytesPerRow)) {
+      LOG_ERR("IMG", "Packed cache read error in band %d", band);
+      return false;
+    }
+    for (int row = 0; row < bandHeight; row++) {
+      drawCacheRow(pw, rows.get() + row * bytesPerRow, x, y + rowStart + row, width);
+    }
+  }
+
+  LOG_DBG("IMG", "Packed cache render complete");
+  return true;
+}
+
+// Complete means the header matches the block and the file is as long as the header says: an interrupted
+// write leaves the plain rows short, or the packed offset table zeroed
+bool cacheFileComplete(const std::string& cachePath, const int expectedWidth, const int expectedHeight) {
+  HalFile cacheFile;
+  if (!Storage.openFileForRead("IMG", cachePath, cacheFile)) {
+    return false;
+  }
+
+  uint16_t cachedWidth, cachedHeight;
+  if (cacheFile.read(&cachedWidth, 2) != 2 || cacheFile.read(&cachedHeight, 2) != 2) {
+    return false;
+  }
+  const bool packed = (cachedWidth & PixelCache::PACKED_FLAG) != 0;
+  cachedWidth &= ~PixelCache::PACKED_FLAG;
+  if (abs(cachedWidth - expectedWidth) > 1 || abs(cachedHeight - expectedHeight) > 1) {
+    return false;
+  }
+
+  const size_t fileSize = cacheFile.size();
+  const size_t bytesPerRow = (cachedWidth + 3) / 4;
+  if (!packed) {
+    return fileSize == 4 + bytesPerRow * cachedHeight;
+  }
+
+  uint16_t bandRows = 0;
+  uint16_t bandCount = 0;
+  if (cacheFile.read(&bandRows, 2) != 2 || cacheFile.read(&bandCount, 2) != 2 || bandRows == 0 ||
+      bandCount != (cachedHeight + bandRows - 1) / bandRows) {
+    return false;
+  }
+  // The last offset is where the band data ends
+  const size_t tableBytes = ((size_t)bandCount + 1) * sizeof(uint32_t);
+  uint32_t dataBytes = 0;
+  if (!cacheFile.seek(PixelCache::PACKED_HEADER_SIZE + tableBytes - sizeof(uint32_t)) ||
+      cacheFile.read(&dataBytes, sizeof(dataBytes)) != sizeof(dataBytes)) {
+    return false;
+  }
+  return fileSize == PixelCache::PACKED_HEADER_SIZE + tableBytes + dataBytes;
+}
+
 bool renderFromCache(GfxRenderer& renderer, const std::string& cachePath, int x, int y, int expectedWidth,
                      int expectedHeight) {
   HalFile cacheFile;
@@ -40,6 +156,8 @@ bool renderFromCache(GfxRenderer& renderer, const std::string& cachePath, int x,
   if (cacheFile.read(&cachedWidth, 2) != 2 || cacheFile.read(&cachedHeight, 2) != 2) {
     return false;
   }
+  const bool packed = (cachedWidth & PixelCache::PACKED_FLAG) != 0;
+  cachedWidth &= ~PixelCache::PACKED_FLAG;
 
   // Verify dimensions are close (allow 1 pixel tolerance for rounding differences)
   int widthDiff = abs(cachedWidth - expectedWidth);
@@ -54,7 +172,11 @@ bool renderFromCache(GfxRenderer& renderer, const std::string& cachePath, int x,
   expectedWidth = cachedWidth;
   expectedHeight = cachedHeight;
 
-  LOG_DBG("IMG", "Loading from cache: %s (%dx%d)", cachePath.c_str(), cachedWidth, cachedHeight);
+  LOG_DBG("IMG", "Loading from cache: %s (%dx%d%s)", cachePath.c_str(), cachedWidth, cachedHeight,
+          packed ? ", packed" : "");
+  if (packed) {
+    return renderFromPackedCache(renderer, cacheFile, x, y, cachedWidth, cachedHeight);
+  }
 
   // Read several rows per SD access. A full-page image is re-rendered on every
   // grayscale strip pass (~14x per page), and a one-row-per-read loop here means
@@ -97,19 +219,7 @@ bool renderFromCache(GfxRenderer& renderer, const std::string& cachePath, int x,
     const uint8_t* rowBuffer = readBuffer + (size_t)bufferRow * bytesPerRow;
     bufferRow++;
 
-    const int destY = y + row;
-    pw.beginRow(destY);
-    // On a grayscale strip pass only a narrow column window of the image is in
-    // the active band; skip the rest instead of unpacking+clipping every pixel.
-    int colStart, colEnd;
-    pw.bandColRange(x, cachedWidth, colStart, colEnd);
-    for (int col = colStart; col < colEnd; col++) {
-      const int byteIdx = col >> 2;            // col / 4
-      const int bitShift = 6 - (col & 3) * 2;  // MSB first within byte
-      uint8_t pixelValue = (rowBuffer[byteIdx] >> bitShift) & 0x03;
-
-      pw.writePixel(x + col, pixelValue);
-    }
+    drawCacheRow(pw, rowBuffer, x, y + row, cachedWidth);
   }
 
   free(readBuffer);
@@ -119,6 +229,10 @@ bool renderFromCache(GfxRenderer& renderer, const std::string& cachePath, int x,
 
 }  // namespace
 
+bool ImageBlock::cacheIsValid() const { return cacheFileComplete(getCachePath(imagePath), width, height); }
+
+void ImageBlock::setSourceExtractor(SourceExtractor extractor) { sourceExtractor = std::move(extractor); }
+
 void ImageBlock::render(GfxRenderer& renderer, const int x, const int y) {
   // The font-prewarm scan pass only accumulates glyphs; an image contributes
   // none, and its DirectPixelWriter output bypasses the renderer's scan-mode
@@ -156,7 +270,15 @@ void ImageBlock::render(GfxRenderer& renderer, const int x, const int y) {
     return;  // Successfully rendered from cache
   }
 
-  // No cache - need to decode the image
+  // No cache - need to decode the image. The extracted copy is deleted once its cache is complete, so it
+  // may have to come out of the EPUB again first.
+  if (!Storage.exists(imagePath.c_str()) && sourceExtractor && !sourceHref.empty()) {
+    LOG_DBG("IMG", "Extracting image again: %s", sourceHref.c_str());
+    if (!sourceExtractor(sourceHref, imagePath)) {
+      LOG_ERR("IMG", "Failed to extract image: %s", sourceHref.c_str());
+    }
+  }
+
   // Check if image file exists
   HalFile file;
   if (!Storage.openFileForRead("IMG", imagePath, file)) {
@@ -183,6 +305,7 @@ void ImageBlock::render(GfxRenderer& renderer, const int x, const int y) {
   config.performanceMode = false;
   config.useExactDimensions = true;  // Use pre-calculated dimensions to avoid rounding mismatches
   config.cachePath = cachePath;      // Enable caching during decode
+  config.packCache = true;
 
   ImageToFramebufferDecoder* decoder = ImageDecoderFactory::getDecoder(imagePath);
   if (!decoder) {
@@ -199,20 +322,54 @@ void ImageBlock::render(GfxRenderer& renderer, const int x, const int y) {
   }
 
   LOG_DBG("IMG", "Decode successful");
+  // Later renders are served by the new cache alone
+  if (cacheIsValid()) {
+    Storage.remove(imagePath.c_str());
+  }
+}
+
+bool ImageBlock::decodeToCache(GfxRenderer& renderer, const int x, const int y) const {
+  ImageToFramebufferDecoder* decoder = ImageDecoderFactory::getDecoder(imagePath);
+  if (!decoder) {
+    return false;
+  }
+
+  // Same configuration as the decode in render(), so the cached pixels are identical
+  RenderConfig config;
+  config.x = x;
+  config.y = y;
+  config.maxWidth = width;
+  config.maxHeight = height;
+  config.useGrayscale = true;
+  config.useDithering = true;
+  config.performanceMode = false;
+  config.useExactDimensions = true;
+  config.cachePath = getCachePath(imagePath);
+  config.cacheOnly = true;
+  config.packCache = true;
+
+  if (!decoder->decodeToFramebuffer(imagePath, renderer, config)) {
+    LOG_DBG("IMG", "Index-time decode failed, decoding on first view: %s", imagePath.c_str());
+    return false;
+  }
+  return true;
 }
 
 bool ImageBlock::serialize(HalFile& file) {
   serialization::writeString(file, imagePath);
+  serialization::writeString(file, sourceHref);
   serialization::writePod(file, width);
   serialization::writePod(file, height);
   return true;
 }
 
-std::unique_ptr<ImageBlock> ImageBlock::deserialize(HalFile& file) {
+std::unique_ptr<ImageBlock> ImageBlock::deserialize(serialization::BufferReader& reader) {
   std::string path;
-  serialization::readString(file, path);
+  std::string href;
+  serialization::readString(reader, path);
+  serialization::readString(reader, href);
   int16_t w, h;
-  serialization::readPod(file, w);
-  serialization::readPod(file, h);
-  return std::unique_ptr<ImageBlock>(new ImageBlock(path, w, h));
+  serialization::readPod(reader, w);
+  serialization::readPod(reader, h);
+  return std::unique_ptr<ImageBlock>(new ImageBlock(path, href, w, h));
 }
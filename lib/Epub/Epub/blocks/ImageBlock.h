@@ -1,31 +1,50 @@
 #pragma once
 #include <HalStorage.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 
 #include "Block.h"
 
+namespace serialization {
+class BufferReader;
+}
+
 class ImageBlock final : public Block {
  public:
-  ImageBlock(const std::string& imagePath, int16_t width, int16_t height);
+  // Writes the EPUB item at href to path on the SD card
+  using SourceExtractor = std::function<bool(const std::string& href, const std::string& path)>;
+
+  // imagePath is the extracted copy of the EPUB item sourceHref; its pixel cache sits next to it
+  ImageBlock(const std::string& imagePath, const std::string& sourceHref, int16_t width, int16_t height);
   ~ImageBlock() override = default;
 
   const std::string& getImagePath() const { return imagePath; }
+  const std::string& getSourceHref() const { return sourceHref; }
   int16_t getWidth() const { return width; }
   int16_t getHeight() const { return height; }
 
   bool imageExists() const;
+  // True when the pixel cache is complete for this block's size, so the extracted copy can be deleted
+  bool cacheIsValid() const;
+  // Lets render() extract the source image again when it was deleted and the pixel cache is missing or
+  // unreadable. Set while a book is open; nullptr to clear.
+  static void setSourceExtractor(SourceExtractor extractor);
 
   BlockType getType() override { return IMAGE_BLOCK; }
   bool isEmpty() override { return false; }
 
   void render(GfxRenderer& renderer, const int x, const int y);
+  // Decode the image into its pixel cache without drawing, so render() never has to decode it.
+  // x/y is where the block will render; the dither pattern depends on it.
+  bool decodeToCache(GfxRenderer& renderer, int x, int y) const;
   bool serialize(HalFile& file);
-  static std::unique_ptr<ImageBlock> deserialize(HalFile& file);
+  static std::unique_ptr<ImageBlock> deserialize(serialization::BufferReader& reader);
 
  private:
   std::string imagePath;
+  std::string sourceHref;
   int16_t width;
   int16_t height;
 };
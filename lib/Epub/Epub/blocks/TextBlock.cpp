@@ -7,25 +7,81 @@
 
 #include <cstring>
 
-void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int x, const int y) const {
+TextBlock::TextBlock(const std::vector<std::string>& words, const std::vector<int16_t>& word_xpos,
+                     const std::vector<EpdFontFamily::Style>& word_styles, const std::vector<uint8_t>& focus_boundary,
+                     const std::vector<uint16_t>& focus_suffix_x, const BlockStyle& blockStyle)
+    : blockStyle(blockStyle) {
   // Focus annotations are optional: empty vectors mean no word in this block has a split.
-  // When present, they must be sized in lockstep with words[].
-  const bool hasFocus = !wordFocusBoundary.empty();
-  if (words.size() != wordXpos.size() || words.size() != wordStyles.size() ||
-      (hasFocus && (words.size() != wordFocusBoundary.size() || words.size() != wordFocusSuffixX.size()))) {
-    LOG_ERR("TXB", "Render skipped: size mismatch (words=%u, xpos=%u, styles=%u, boundary=%u, suffixX=%u)\n",
-            (uint32_t)words.size(), (uint32_t)wordXpos.size(), (uint32_t)wordStyles.size(),
-            (uint32_t)wordFocusBoundary.size(), (uint32_t)wordFocusSuffixX.size());
+  // When present, they must be sized in lockstep with words.
+  const bool hasFocus = !focus_boundary.empty();
+  if (words.size() != word_xpos.size() || words.size() != word_styles.size() ||
+      (hasFocus && (words.size() != focus_boundary.size() || words.size() != focus_suffix_x.size()))) {
+    LOG_ERR("TXB", "Size mismatch (words=%u, xpos=%u, styles=%u, boundary=%u, suffixX=%u)",
+            static_cast<uint32_t>(words.size()), static_cast<uint32_t>(word_xpos.size()),
+            static_cast<uint32_t>(word_styles.size()), static_cast<uint32_t>(focus_boundary.size()),
+            static_cast<uint32_t>(focus_suffix_x.size()));
+    storageFailed = true;
+    return;
+  }
+
+  size_t textBytes = 0;
+  for (const auto& w : words) textBytes += w.size() + 1;
+  // One chunk for everything: text, offsets, xpos, styles and the optional focus arrays, plus padding
+  const size_t n = words.size();
+  storage.reserve(textBytes + (n + 1) * sizeof(uint16_t) + n * sizeof(int16_t) + n * sizeof(EpdFontFamily::Style) +
+                  (hasFocus ? n * (sizeof(uint8_t) + sizeof(uint16_t)) : 0) + 4 * alignof(uint16_t));
+  if (n > UINT16_MAX || !allocateWords(storage, static_cast<uint16_t>(n), textBytes) ||
+      (hasFocus && !allocateFocus(storage))) {
+    LOG_ERR("TXB", "Failed to store %u words", static_cast<uint32_t>(n));
+    count = 0;
+    storageFailed = true;
     return;
   }
 
+  uint16_t offset = 0;
+  for (size_t i = 0; i < n; i++) {
+    wordOffsets[i] = offset;
+    memcpy(wordText + offset, words[i].c_str(), words[i].size() + 1);
+    offset = static_cast<uint16_t>(offset + words[i].size() + 1);
+  }
+  wordOffsets[n] = offset;
+  memcpy(wordXpos, word_xpos.data(), n * sizeof(int16_t));
+  memcpy(wordStyles, word_styles.data(), n * sizeof(EpdFontFamily::Style));
+  if (hasFocus) {
+    memcpy(wordFocusBoundary, focus_boundary.data(), n * sizeof(uint8_t));
+    memcpy(wordFocusSuffixX, focus_suffix_x.data(), n * sizeof(uint16_t));
+  }
+}
+
+bool TextBlock::allocateWords(PageArena& arena, const uint16_t wordCount, const size_t textBytes) {
+  // Offsets are 16-bit, so a line's text (terminators included) must stay under 64KB
+  if (textBytes > UINT16_MAX) {
+    return false;
+  }
+  count = wordCount;
+  wordOffsets = arena.allocateArray<uint16_t>(wordCount + 1);
+  wordXpos = arena.allocateArray<int16_t>(wordCount);
+  wordStyles = arena.allocateArray<EpdFontFamily::Style>(wordCount);
+  wordText = arena.allocateArray<char>(textBytes);
+  return wordOffsets && wordXpos && wordStyles && wordText;
+}
+
+bool TextBlock::allocateFocus(PageArena& arena) {
+  wordFocusBoundary = arena.allocateArray<uint8_t>(count);
+  wordFocusSuffixX = arena.allocateArray<uint16_t>(count);
+  return wordFocusBoundary && wordFocusSuffixX;
+}
+
+void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int x, const int y) const {
+  const bool hasFocus = wordFocusBoundary != nullptr;
   const bool scanning = renderer.isFontCacheScanning();
   const int ascender = renderer.getFontAscenderSize(fontId);
-  for (size_t i = 0; i < words.size(); i++) {
+  for (size_t i = 0; i < count; i++) {
+    const char* word = getWord(i);
     const int wordX = wordXpos[i] + x;
     const EpdFontFamily::Style currentStyle = wordStyles[i];
     const auto baseDir = static_cast<BidiUtils::BidiBaseDir>(
-        BidiUtils::detectParagraphLevel(words[i].c_str(), blockStyle.isRtl ? 1 : 0));
+        BidiUtils::detectParagraphLevel(word, blockStyle.isRtl ? 1 : 0));
     const uint8_t boundary = hasFocus ? wordFocusBoundary[i] : 0;
 
     // SUP/SUB shift the baseline passed to drawText; the glyph is also scaled 50% inside
@@ -49,19 +105,18 @@ void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int
       static_assert(sizeof(boldBuf) >= MAX_FOCUS_PREFIX_BYTES,
                     "boldBuf too small for max focus prefix (9 codepoints * 4 UTF-8 bytes + null)");
       const auto boldStyle = static_cast<EpdFontFamily::Style>(currentStyle | EpdFontFamily::BOLD);
-      const size_t boldLen = std::min<size_t>({static_cast<size_t>(boundary), words[i].size(), sizeof(boldBuf) - 1});
-      memcpy(boldBuf, words[i].c_str(), boldLen);
+      const size_t boldLen = std::min<size_t>({static_cast<size_t>(boundary), getWordLength(i), sizeof(boldBuf) - 1});
+      memcpy(boldBuf, word, boldLen);
       boldBuf[boldLen] = '\0';
       renderer.drawText(fontId, wordX, wordY, boldBuf, true, boldStyle, baseDir);
       const int suffixX = wordX + wordFocusSuffixX[i];
-      renderer.drawText(fontId, suffixX, wordY, words[i].c_str() + boldLen, true, currentStyle, baseDir);
+      renderer.drawText(fontId, suffixX, wordY, word + boldLen, true, currentStyle, baseDir);
     } else {
-      renderer.drawText(fontId, wordX, wordY, words[i].c_str(), true, currentStyle, baseDir);
+      renderer.drawText(fontId, wordX, wordY, word, true, currentStyle, baseDir);
     }
 
     if (!scanning && (currentStyle & EpdFontFamily::UNDERLINE) != 0) {
-      const std::string& w = words[i];
-      int underlineWidth = renderer.getTextWidth(fontId, w.c_str(), currentStyle, baseDir);
+      int underlineWidth = renderer.getTextWidth(fontId, word, currentStyle, baseDir);
       const int underlineY = wordY + ascender + 2;
 
       if ((currentStyle & (EpdFontFamily::SUP | EpdFontFamily::SUB)) != 0) {
@@ -74,29 +129,27 @@ void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int
 }
 
 bool TextBlock::serialize(HalFile& file) const {
-  // Focus annotations are optional; vectors are either empty (no splits in this block)
-  // or sized in lockstep with words[].
-  const bool hasFocus = !wordFocusBoundary.empty();
-  if (words.size() != wordXpos.size() || words.size() != wordStyles.size() ||
-      (hasFocus && (words.size() != wordFocusBoundary.size() || words.size() != wordFocusSuffixX.size()))) {
-    LOG_ERR("TXB", "Serialization failed: size mismatch (words=%u, xpos=%u, styles=%u, boundary=%u, suffixX=%u)\n",
-            static_cast<uint32_t>(words.size()), static_cast<uint32_t>(wordXpos.size()),
-            static_cast<uint32_t>(wordStyles.size()), static_cast<uint32_t>(wordFocusBoundary.size()),
-            static_cast<uint32_t>(wordFocusSuffixX.size()));
+  if (storageFailed) {
+    LOG_ERR("TXB", "Serialization failed: block has no word storage");
     return false;
   }
 
   // Word data
-  serialization::writePod(file, static_cast<uint16_t>(words.size()));
-  for (const auto& w : words) serialization::writeString(file, w);
-  for (auto x : wordXpos) serialization::writePod(file, x);
-  for (auto s : wordStyles) serialization::writePod(file, s);
-  // Focus block: 1-byte presence flag, followed by per-word vectors only when present.
+  serialization::writePod(file, count);
+  for (uint16_t i = 0; i < count; i++) {
+    const uint32_t len = getWordLength(i);
+    serialization::writePod(file, len);
+    file.write(reinterpret_cast<const uint8_t*>(getWord(i)), len);
+  }
+  file.write(reinterpret_cast<const uint8_t*>(wordXpos), count * sizeof(int16_t));
+  file.write(reinterpret_cast<const uint8_t*>(wordStyles), count * sizeof(EpdFontFamily::Style));
+  // Focus block: 1-byte presence flag, followed by per-word arrays only when present.
   // Saves 3 bytes/word when focus reading is disabled or no word on this line was split.
+  const bool hasFocus = wordFocusBoundary != nullptr;
   serialization::writePod(file, static_cast<uint8_t>(hasFocus ? 1 : 0));
   if (hasFocus) {
-    for (auto b : wordFocusBoundary) serialization::writePod(file, b);
-    for (auto sx : wordFocusSuffixX) serialization::writePod(file, sx);
+    file.write(wordFocusBoundary, count * sizeof(uint8_t));
+    file.write(reinterpret_cast<const uint8_t*>(wordFocusSuffixX), count * sizeof(uint16_t));
   }
 
   // Style (alignment + margins/padding/indent)
@@ -118,59 +171,79 @@ bool TextBlock::serialize(HalFile& file) const {
   return true;
 }
 
-std::unique_ptr<TextBlock> TextBlock::deserialize(HalFile& file) {
+std::optional<TextBlock> TextBlock::deserialize(serialization::BufferReader& reader, PageArena& arena) {
   uint16_t wc;
-  std::vector<std::string> words;
-  std::vector<int16_t> wordXpos;
-  std::vector<EpdFontFamily::Style> wordStyles;
-  std::vector<uint8_t> wordFocusBoundary;
-  std::vector<uint16_t> wordFocusSuffixX;
-  BlockStyle blockStyle;
+  TextBlock block;
+  BlockStyle& blockStyle = block.blockStyle;
 
   // Word count
-  serialization::readPod(file, wc);
+  serialization::readPod(reader, wc);
 
   // Sanity check: prevent allocation of unreasonably large vectors (max 10000 words per block)
   if (wc > 10000) {
     LOG_ERR("TXB", "Deserialization failed: word count %u exceeds maximum", wc);
-    return nullptr;
+    return std::nullopt;
+  }
+
+  // Size the text first so all words share one arena allocation
+  const size_t wordsStart = reader.position();
+  size_t textBytes = 0;
+  for (uint16_t i = 0; i < wc; i++) {
+    uint32_t len = 0;
+    serialization::readPod(reader, len);
+    if (!reader.seek(reader.position() + len)) {
+      LOG_ERR("TXB", "Deserialization failed: word %u overruns the page record", i);
+      return std::nullopt;
+    }
+    textBytes += len + 1;
+  }
+  reader.seek(wordsStart);
+  if (!block.allocateWords(arena, wc, textBytes)) {
+    LOG_ERR("TXB", "Deserialization failed: could not store %u words", wc);
+    return std::nullopt;
   }
 
   // Word data
-  words.resize(wc);
-  wordXpos.resize(wc);
-  wordStyles.resize(wc);
-  for (auto& w : words) serialization::readString(file, w);
-  for (auto& x : wordXpos) serialization::readPod(file, x);
-  for (auto& s : wordStyles) serialization::readPod(file, s);
-  // Focus block: presence flag, then vectors only if present. Empty vectors when absent
+  uint16_t offset = 0;
+  for (uint16_t i = 0; i < wc; i++) {
+    uint32_t len = 0;
+    serialization::readPod(reader, len);
+    block.wordOffsets[i] = offset;
+    reader.read(block.wordText + offset, len);
+    block.wordText[offset + len] = '\0';
+    offset = static_cast<uint16_t>(offset + len + 1);
+  }
+  block.wordOffsets[wc] = offset;
+  reader.read(block.wordXpos, wc * sizeof(int16_t));
+  reader.read(block.wordStyles, wc * sizeof(EpdFontFamily::Style));
+  // Focus block: presence flag, then arrays only if present. Null arrays when absent
   // signal "no splits in this block" to render() (zero per-word RAM cost).
   uint8_t hasFocus;
-  serialization::readPod(file, hasFocus);
+  serialization::readPod(reader, hasFocus);
   if (hasFocus) {
-    wordFocusBoundary.resize(wc);
-    wordFocusSuffixX.resize(wc);
-    for (auto& b : wordFocusBoundary) serialization::readPod(file, b);
-    for (auto& sx : wordFocusSuffixX) serialization::readPod(file, sx);
+    if (!block.allocateFocus(arena)) {
+      LOG_ERR("TXB", "Deserialization failed: could not store focus annotations");
+      return std::nullopt;
+    }
+    reader.read(block.wordFocusBoundary, wc * sizeof(uint8_t));
+    reader.read(block.wordFocusSuffixX, wc * sizeof(uint16_t));
   }
 
   // Style (alignment + margins/padding/indent)
-  serialization::readPod(file, blockStyle.alignment);
-  serialization::readPod(file, blockStyle.textAlignDefined);
-  serialization::readPod(file, blockStyle.marginTop);
-  serialization::readPod(file, blockStyle.marginBottom);
-  serialization::readPod(file, blockStyle.marginLeft);
-  serialization::readPod(file, blockStyle.marginRight);
-  serialization::readPod(file, blockStyle.paddingTop);
-  serialization::readPod(file, blockStyle.paddingBottom);
-  serialization::readPod(file, blockStyle.paddingLeft);
-  serialization::readPod(file, blockStyle.paddingRight);
-  serialization::readPod(file, blockStyle.textIndent);
-  serialization::readPod(file, blockStyle.textIndentDefined);
-  serialization::readPod(file, blockStyle.isRtl);
-  serialization::readPod(file, blockStyle.directionDefined);
-
-  return std::unique_ptr<TextBlock>(new TextBlock(std::move(words), std::move(wordXpos), std::move(wordStyles),
-                                                  std::move(wordFocusBoundary), std::move(wordFocusSuffixX),
-                                                  blockStyle));
+  serialization::readPod(reader, blockStyle.alignment);
+  serialization::readPod(reader, blockStyle.textAlignDefined);
+  serialization::readPod(reader, blockStyle.marginTop);
+  serialization::readPod(reader, blockStyle.marginBottom);
+  serialization::readPod(reader, blockStyle.marginLeft);
+  serialization::readPod(reader, blockStyle.marginRight);
+  serialization::readPod(reader, blockStyle.paddingTop);
+  serialization::readPod(reader, blockStyle.paddingBottom);
+  serialization::readPod(reader, blockStyle.paddingLeft);
+  serialization::readPod(reader, blockStyle.paddingRight);
+  serialization::readPod(reader, blockStyle.textIndent);
+  serialization::readPod(reader, blockStyle.textIndentDefined);
+  serialization::readPod(reader, blockStyle.isRtl);
+  serialization::readPod(reader, blockStyle.directionDefined);
+
+  return block;
 }
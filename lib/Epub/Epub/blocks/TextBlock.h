@@ -2,51 +2,66 @@
 #include <EpdFontFamily.h>
 #include <HalStorage.h>
 
-#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "Block.h"
 #include "BlockStyle.h"
+#include "Epub/PageArena.h"
+
+namespace serialization {
+class BufferReader;
+}
 
 // Represents a line of text on a page
 class TextBlock final : public Block {
  private:
-  std::vector<std::string> words;
-  std::vector<int16_t> wordXpos;
-  std::vector<EpdFontFamily::Style> wordStyles;
-  // Per-word focus boundary: N > 0 means the first N bytes of words[i] are rendered bold,
+  // Word i is the NUL-terminated string at wordText + wordOffsets[i]; wordOffsets holds
+  // wordCount() + 1 entries so lengths fall out of neighbouring offsets. All arrays live in
+  // one arena: the owning page's when deserialized, `storage` when built during layout.
+  char* wordText = nullptr;
+  uint16_t* wordOffsets = nullptr;
+  int16_t* wordXpos = nullptr;
+  EpdFontFamily::Style* wordStyles = nullptr;
+  // Per-word focus boundary: N > 0 means the first N bytes of word i are rendered bold,
   // the remainder in the base style. 0 means no split (whole word uses wordStyles[i]).
   // N encodes the bold PREFIX length only — bounded to 9 codepoints (≤36 UTF-8 bytes) by
   // FOCUS_READING_PERCENT's 1..9 clamp in ParsedText::addWord, so it always fits in uint8_t.
-  // Vector is empty when no focus splits exist anywhere in the block (zero per-word RAM cost
+  // Null when no focus splits exist anywhere in the block (zero per-word RAM cost
   // when focus reading is disabled, or on lines that happen to contain no splittable words).
-  std::vector<uint8_t> wordFocusBoundary;
+  uint8_t* wordFocusBoundary = nullptr;
   // Pre-computed pixel offset from word start to the regular suffix, stored when boundary > 0.
   // Eliminates getTextAdvanceX from the render path. 0 when boundary == 0.
-  // Empty in lockstep with wordFocusBoundary.
-  std::vector<uint16_t> wordFocusSuffixX;
+  // Null in lockstep with wordFocusBoundary.
+  uint16_t* wordFocusSuffixX = nullptr;
+  uint16_t count = 0;
+  // Set when the layout vectors handed to the constructor could not be stored
+  bool storageFailed = false;
   BlockStyle blockStyle;
+  PageArena storage;
+
+  bool allocateWords(PageArena& arena, uint16_t wordCount, size_t textBytes);
+  bool allocateFocus(PageArena& arena);
 
  public:
-  explicit TextBlock(std::vector<std::string> words, std::vector<int16_t> word_xpos,
-                     std::vector<EpdFontFamily::Style> word_styles, std::vector<uint8_t> focus_boundary,
-                     std::vector<uint16_t> focus_suffix_x, const BlockStyle& blockStyle = BlockStyle())
-      : words(std::move(words)),
-        wordXpos(std::move(word_xpos)),
-        wordStyles(std::move(word_styles)),
-        wordFocusBoundary(std::move(focus_boundary)),
-        wordFocusSuffixX(std::move(focus_suffix_x)),
-        blockStyle(blockStyle) {}
+  TextBlock() = default;
+  explicit TextBlock(const std::vector<std::string>& words, const std::vector<int16_t>& word_xpos,
+                     const std::vector<EpdFontFamily::Style>& word_styles, const std::vector<uint8_t>& focus_boundary,
+                     const std::vector<uint16_t>& focus_suffix_x, const BlockStyle& blockStyle = BlockStyle());
+  TextBlock(TextBlock&&) = default;
+  TextBlock& operator=(TextBlock&&) = default;
   ~TextBlock() override = default;
   void setBlockStyle(const BlockStyle& blockStyle) { this->blockStyle = blockStyle; }
   const BlockStyle& getBlockStyle() const { return blockStyle; }
-  const std::vector<std::string>& getWords() const { return words; }
-  bool isEmpty() override { return words.empty(); }
-  size_t wordCount() const { return words.size(); }
+  const char* getWord(const size_t i) const { return wordText + wordOffsets[i]; }
+  size_t getWordLength(const size_t i) const { return wordOffsets[i + 1] - wordOffsets[i] - 1; }
+  bool isEmpty() override { return count == 0; }
+  size_t wordCount() const { return count; }
   // given a renderer works out where to break the words into lines
   void render(const GfxRenderer& renderer, int fontId, int x, int y) const;
   BlockType getType() override { return TEXT_BLOCK; }
   bool serialize(HalFile& file) const;
-  static std::unique_ptr<TextBlock> deserialize(HalFile& file);
+  // Word text and arrays are placed in `arena`, which must outlive the returned block.
+  static std::optional<TextBlock> deserialize(serialization::BufferReader& reader, PageArena& arena);
 };
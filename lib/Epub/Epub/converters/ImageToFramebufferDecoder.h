@@ -19,6 +19,8 @@ struct RenderConfig {
   bool performanceMode = false;
   bool useExactDimensions = false;  // If true, use maxWidth/maxHeight as exact output size (no recalculation)
   std::string cachePath;            // If non-empty, decoder will write pixel cache to this path
+  bool cacheOnly = false;           // If true, only write the pixel cache and leave the framebuffer untouched
+  bool packCache = false;           // If true, write the band-packed cache layout (see PixelCache)
 };
 
 class ImageToFramebufferDecoder {
@@ -8,6 +8,63 @@
 #include <cstring>
 #include <string>
 
+// PackBits run-length coding, used for compressed pixel caches. Each control
+// byte n is followed by n + 1 literal bytes (n < 128) or by one byte repeated
+// 257 - n times (n > 128). Flat illustration areas collapse to 2 bytes per
+// 128-byte run; noisy areas grow by at most 1 byte in 128.
+namespace PackBits {
+
+inline size_t maxEncodedSize(size_t length) { return length + (length + 127) / 128; }
+
+inline size_t encode(const uint8_t* src, size_t length, uint8_t* dst) {
+  size_t in = 0;
+  size_t out = 0;
+  while (in < length) {
+    size_t run = 1;
+    while (in + run < length && run < 128 && src[in + run] == src[in]) run++;
+    if (run >= 3) {
+      dst[out++] = static_cast<uint8_t>(257 - run);
+      dst[out++] = src[in];
+      in += run;
+      continue;
+    }
+    // Literal stretch up to the next run of 3 or more
+    const size_t start = in;
+    while (in < length && in - start < 128) {
+      if (in + 2 < length && src[in] == src[in + 1] && src[in] == src[in + 2]) break;
+      in++;
+    }
+    dst[out++] = static_cast<uint8_t>(in - start - 1);
+    memcpy(dst + out, src + start, in - start);
+    out += in - start;
+  }
+  return out;
+}
+
+// Returns false unless src decodes to exactly length bytes
+inline bool decode(const uint8_t* src, size_t srcLength, uint8_t* dst, size_t length) {
+  size_t in = 0;
+  size_t out = 0;
+  while (in < srcLength && out < length) {
+    const uint8_t control = src[in++];
+    if (control < 128) {
+      const size_t count = control + 1;
+      if (in + count > srcLength || out + count > length) return false;
+      memcpy(dst + out, src + in, count);
+      in += count;
+      out += count;
+    } else if (control > 128) {
+      const size_t count = 257 - control;
+      if (in >= srcLength || out + count > length) return false;
+      memset(dst + out, src[in++], count);
+      out += count;
+    }
+  }
+  return out == length;
+}
+
+}  // namespace PackBits
+
 // Streaming cache writer for 2-bit pixels (4 levels). Packs 4 pixels per byte,
 // MSB first.
 //
@@ -25,6 +82,13 @@
 // loop over y, inner over x: see jpeg.inl DecodeJPEG). Consecutive MCU rows map
 // to contiguous, non-overlapping destination row ranges, so once a block whose
 // top row is Y arrives, every output row < Y is final and is flushed to disk.
+//
+// Two file layouts share the 4-byte header (uint16_t width, uint16_t height):
+// - plain: height rows of packed pixels follow.
+// - packed (width has PACKED_FLAG set): uint16_t rows per band, uint16_t band
+//   count, uint32_t offsets[band count + 1] relative to the end of the table,
+//   then each band's rows PackBits-coded as one run. A renderer can seek to just
+//   the bands a strip pass needs, and flat illustrations shrink several-fold.
 struct PixelCache {
   uint8_t* buffer;   // band buffer: (bandRows + 1) rows; last row kept zeroed
   uint8_t* zeroRow;  // points at the spare zeroed row, for gap/clip fill
@@ -40,6 +104,16 @@ struct PixelCache {
   std::string cachePathStr;
   bool ok;
 
+  // Packed layout only: rows are staged until a band is complete, then coded
+  bool packed;
+  int packBandRows;
+  int stagedRows;
+  int packBand;
+  int packBandCount;
+  uint8_t* packRows;
+  uint8_t* packOut;
+  uint32_t* bandOffsets;
+
   PixelCache()
       : buffer(nullptr),
         zeroRow(nullptr),
@@ -51,16 +125,35 @@ struct PixelCache {
         bandRows(0),
         bandStart(0),
         flushedRows(0),
-        ok(false) {}
+        ok(false),
+        packed(false),
+        packBandRows(0),
+        stagedRows(0),
+        packBand(0),
+        packBandCount(0),
+        packRows(nullptr),
+        packOut(nullptr),
+        bandOffsets(nullptr) {}
   PixelCache(const PixelCache&) = delete;
   PixelCache& operator=(const PixelCache&) = delete;
 
   static constexpr int MIN_BAND_ROWS = 16;
   static constexpr size_t MAX_BAND_BYTES = 24 * 1024;  // band working-set ceiling
+  static constexpr uint16_t PACKED_FLAG = 0x8000;
+  static constexpr size_t PACKED_BAND_BYTES = 2048;  // unpacked bytes per band in the packed layout
+  static constexpr size_t PACKED_HEADER_SIZE = 8;    // before the band offset table
+
+  // Rows per band in the packed layout for an image this wide
+  static int packedBandRows(int w) {
+    const int rows = static_cast<int>(PACKED_BAND_BYTES / static_cast<size_t>((w + 3) / 4));
+    return rows < 1 ? 1 : rows;
+  }
 
   // Open the cache file, write the header, and allocate a band buffer big enough
   // to hold the tallest single decode block (maxBlockDstRows output rows).
-  bool begin(const std::string& cachePath, int w, int h, int ox, int oy, int maxBlockDstRows) {
+  // With pack set the packed layout is written; if its buffers can't be
+  // allocated the plain layout is used instead.
+  bool begin(const std::string& cachePath, int w, int h, int ox, int oy, int maxBlockDstRows, bool pack = false) {
     width = w;
     height = h;
     originX = ox;
@@ -104,15 +197,26 @@ struct PixelCache {
     }
     cachePathStr = cachePath;
 
-    uint16_t w16 = (uint16_t)w;
+    packed = pack && beginPacked();
+
+    uint16_t w16 = (uint16_t)w | (packed ? PACKED_FLAG : 0);
     uint16_t h16 = (uint16_t)h;
-    if (file.write(&w16, 2) != 2 || file.write(&h16, 2) != 2) {
+    bool headerOk = file.write(&w16, 2) == 2 && file.write(&h16, 2) == 2;
+    if (packed) {
+      const uint16_t rows16 = (uint16_t)packBandRows;
+      const uint16_t count16 = (uint16_t)packBandCount;
+      const size_t tableBytes = (size_t)(packBandCount + 1) * sizeof(uint32_t);
+      headerOk = headerOk && file.write(&rows16, 2) == 2 && file.write(&count16, 2) == 2 &&
+                 file.write(bandOffsets, tableBytes) == tableBytes;  // placeholder, rewritten by finalize()
+    }
+    if (!headerOk) {
       LOG_ERR("IMG", "Failed to write cache header: %s", cachePath.c_str());
       abort();
       return false;
     }
 
-    LOG_DBG("IMG", "Cache stream started: %s (%dx%d, band %d rows)", cachePath.c_str(), w, h, bandRows);
+    LOG_DBG("IMG", "Cache stream started: %s (%dx%d, band %d rows%s)", cachePath.c_str(), w, h, bandRows,
+            packed ? ", packed" : "");
     ok = true;
     return true;
   }
@@ -128,7 +232,7 @@ struct PixelCache {
     for (int r = bandStart; r < newTopRow; ++r) {
       const int idx = r - bandStart;
       const uint8_t* rowPtr = (idx < bandRows) ? (buffer + (size_t)idx * bytesPerRow) : zeroRow;
-      if (file.write(rowPtr, (size_t)bytesPerRow) != (size_t)bytesPerRow) {
+      if (!writeRow(rowPtr)) {
         LOG_ERR("IMG", "Cache write error at row %d", r);
         ok = false;
         return false;
@@ -150,15 +254,26 @@ struct PixelCache {
     for (int r = flushedRows; r < height; ++r) {
       const int idx = r - bandStart;
       const uint8_t* rowPtr = (idx >= 0 && idx < bandRows) ? (buffer + (size_t)idx * bytesPerRow) : zeroRow;
-      if (file.write(rowPtr, (size_t)bytesPerRow) != (size_t)bytesPerRow) {
+      if (!writeRow(rowPtr)) {
         LOG_ERR("IMG", "Cache write error at row %d", r);
         abort();
         return false;
       }
     }
+    [[maybe_unused]] size_t fileBytes = 4 + (size_t)bytesPerRow * height;  // only logged
+    if (packed) {
+      const size_t tableBytes = (size_t)(packBandCount + 1) * sizeof(uint32_t);
+      if (!flushPackedBand() || !file.seek(PACKED_HEADER_SIZE) ||
+          file.write(bandOffsets, tableBytes) != tableBytes) {
+        LOG_ERR("IMG", "Failed to write packed cache bands");
+        abort();
+        return false;
+      }
+      fileBytes = PACKED_HEADER_SIZE + tableBytes + bandOffsets[packBandCount];
+    }
     file.close();
-    LOG_DBG("IMG", "Cache written: %s (%dx%d, %d bytes)", cachePathStr.c_str(), width, height,
-            4 + bytesPerRow * height);
+    LOG_DBG("IMG", "Cache written: %s (%dx%d, %u bytes)", cachePathStr.c_str(), width, height,
+            (unsigned)fileBytes);
     ok = false;  // file handed off; nothing left to clean up
     return true;
   }
@@ -183,5 +298,50 @@ struct PixelCache {
       free(buffer);
       buffer = nullptr;
     }
+    freePacked();
+  }
+
+ private:
+  bool beginPacked() {
+    packBandRows = packedBandRows(width);
+    packBandCount = (height + packBandRows - 1) / packBandRows;
+    stagedRows = 0;
+    packBand = 0;
+    const size_t bandBytes = (size_t)packBandRows * bytesPerRow;
+    packRows = (uint8_t*)malloc(bandBytes);
+    packOut = (uint8_t*)malloc(PackBits::maxEncodedSize(bandBytes));
+    bandOffsets = (uint32_t*)calloc((size_t)packBandCount + 1, sizeof(uint32_t));
+    if (!packRows || !packOut || !bandOffsets) {
+      LOG_ERR("IMG", "OOM packed cache buffers, writing plain cache");
+      freePacked();
+      return false;
+    }
+    return true;
+  }
+
+  void freePacked() {
+    free(packRows);
+    free(packOut);
+    free(bandOffsets);
+    packRows = nullptr;
+    packOut = nullptr;
+    bandOffsets = nullptr;
+  }
+
+  bool writeRow(const uint8_t* row) {
+    if (!packed) return file.write(row, (size_t)bytesPerRow) == (size_t)bytesPerRow;
+    memcpy(packRows + (size_t)stagedRows * bytesPerRow, row, (size_t)bytesPerRow);
+    if (++stagedRows < packBandRows) return true;
+    return flushPackedBand();
+  }
+
+  bool flushPackedBand() {
+    if (stagedRows == 0) return true;
+    const size_t packedBytes = PackBits::encode(packRows, (size_t)stagedRows * bytesPerRow, packOut);
+    stagedRows = 0;
+    if (packBand >= packBandCount || file.write(packOut, packedBytes) != packedBytes) return false;
+    bandOffsets[packBand + 1] = bandOffsets[packBand] + (uint32_t)packedBytes;
+    packBand++;
+    return true;
   }
 };
@@ -194,6 +194,7 @@ int pngDrawCallback(PNGDRAW* pDraw) {
   int outXBase = ctx->config->x;
   int screenWidth = ctx->screenWidth;
   bool useDithering = ctx->config->useDithering;
+  const bool drawing = !ctx->config->cacheOnly;
   bool caching = ctx->caching;
 
   // Pre-compute orientation and render-mode state once per row
@@ -231,7 +232,7 @@ int pngDrawCallback(PNGDRAW* pDraw) {
         ditheredGray = gray / 85;
         if (ditheredGray > 3) ditheredGray = 3;
       }
-      pw.writePixel(outX, ditheredGray);
+      if (drawing) pw.writePixel(outX, ditheredGray);
       if (caching) cw.writePixel(outX, ditheredGray);
     }
 
@@ -365,11 +366,16 @@ bool PngToFramebufferConverter::decodeToFramebuffer(const std::string& imagePath
   // re-decode on every one of an image page's ~14 render passes.
   ctx.caching = !config.cachePath.empty();
   if (ctx.caching) {
-    if (!ctx.cache.begin(config.cachePath, ctx.dstWidth, ctx.dstHeight, config.x, config.y, 1)) {
+    if (!ctx.cache.begin(config.cachePath, ctx.dstWidth, ctx.dstHeight, config.x, config.y, 1, config.packCache)) {
       LOG_ERR("PNG", "Failed to start cache stream, continuing without caching");
       ctx.caching = false;
     }
   }
+  if (config.cacheOnly && !ctx.caching) {
+    free(ctx.grayLineBuffer);
+    ctx.grayLineBuffer = nullptr;
+    return false;
+  }
 
   unsigned long decodeStart = millis();
   rc = png->decode(&ctx, 0);
@@ -387,11 +393,8 @@ bool PngToFramebufferConverter::decodeToFramebuffer(const std::string& imagePath
   LOG_DBG("PNG", "PNG decoding complete - render time: %lu ms", decodeTime);
 
   // Finalize the streamed cache (caching may have been cleared on a flush error).
-  if (ctx.caching) {
-    ctx.cache.finalize();
-  }
-
-  return true;
+  const bool cached = ctx.caching && ctx.cache.finalize();
+  return cached || !config.cacheOnly;
 }
 
 bool PngToFramebufferConverter::supportsFormat(const std::string& extension) {
@@ -0,0 +1,57 @@
+#include "CssAncestorStack.h"
+
+namespace {
+constexpr uint32_t FNV32_OFFSET_BASIS = 2166136261u;
+constexpr uint32_t FNV32_PRIME = 16777619u;
+// Class hashes start from a different seed so a class never aliases a tag of the same name
+constexpr uint32_t CLASS_SEED = FNV32_OFFSET_BASIS ^ 0x2Eu;
+
+uint32_t hashFolded(uint32_t h, const std::string_view name) {
+  for (const char c : name) {
+    h ^= static_cast<uint8_t>((c >= 'A' && c <= 'Z') ? c + 32 : c);
+    h *= FNV32_PRIME;
+  }
+  return h == 0 ? 1 : h;  // 0 means "unconstrained" in a selector step
+}
+
+bool isClassSeparator(const char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'; }
+}  // namespace
+
+uint32_t CssAncestorStack::hashTag(const std::string_view tagName) { return hashFolded(FNV32_OFFSET_BASIS, tagName); }
+
+uint32_t CssAncestorStack::hashClass(const std::string_view className) { return hashFolded(CLASS_SEED, className); }
+
+void CssAncestorStack::setDepth(const int depth) {
+  depth_ = depth;
+  if (valid_ > depth) valid_ = depth;
+}
+
+void CssAncestorStack::push(const std::string_view tagName, const std::string_view classAttr) {
+  if (valid_ != depth_ || depth_ >= MAX_DEPTH) return;
+
+  Entry& entry = entries_[depth_];
+  entry.tagHash = hashTag(tagName);
+  entry.bloom = (depth_ > 0 ? entries_[depth_ - 1].bloom : 0) | featureBits(entry.tagHash);
+  entry.classCount = 0;
+  size_t start = 0;
+  for (size_t i = 0; i <= classAttr.size(); i++) {
+    if (i < classAttr.size() && !isClassSeparator(classAttr[i])) continue;
+    if (i > start && entry.classCount < MAX_CLASSES) {
+      const uint32_t classHash = hashClass(classAttr.substr(start, i - start));
+      entry.classHashes[entry.classCount++] = classHash;
+      entry.bloom |= featureBits(classHash);
+    }
+    start = i + 1;
+  }
+  valid_ = depth_ + 1;
+}
+
+bool CssAncestorStack::matches(const int index, const uint32_t tagHash, const uint32_t classHash) const {
+  const Entry& entry = entries_[index];
+  if (tagHash != 0 && entry.tagHash != tagHash) return false;
+  if (classHash == 0) return true;
+  for (uint8_t i = 0; i < entry.classCount; i++) {
+    if (entry.classHashes[i] == classHash) return true;
+  }
+  return false;
+}
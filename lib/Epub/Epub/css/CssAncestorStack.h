@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Open-element context for matching descendant and child selectors.
+ *
+ * Each open element contributes its tag and class names as 32-bit case-folded
+ * hashes, plus a 64-bit bloom filter of every feature (tag or class) on the
+ * path from the root down to and including it. A contextual rule whose
+ * ancestor features are not all in the parent's filter cannot match, so most
+ * rules are rejected without walking the stack.
+ *
+ * The HTML parser calls setDepth() for every element it styles, then push()
+ * once the element's own style is resolved. Lookups made in between see the
+ * element's ancestors only. Elements deeper than MAX_DEPTH, or below one that
+ * was never pushed, are treated as having unknown ancestry.
+ */
+class CssAncestorStack {
+ public:
+  static constexpr uint8_t MAX_DEPTH = 32;
+  static constexpr uint8_t MAX_CLASSES = 4;  // further classes on one element are ignored
+
+  static uint32_t hashTag(std::string_view tagName);
+  static uint32_t hashClass(std::string_view className);
+  static uint64_t featureBits(uint32_t hash) { return (1ull << (hash & 63)) | (1ull << ((hash >> 6) & 63)); }
+
+  void setDepth(int depth);
+  void push(std::string_view tagName, std::string_view classAttr);
+  void clear() { depth_ = valid_ = 0; }
+
+  // True when all ancestors of the current element are known
+  [[nodiscard]] bool complete() const { return valid_ >= depth_; }
+  // Number of ancestors; index size() - 1 is the parent
+  [[nodiscard]] int size() const { return depth_; }
+  // Union of the features of all ancestors
+  [[nodiscard]] uint64_t bloom() const { return depth_ > 0 ? entries_[depth_ - 1].bloom : 0; }
+  // A zero hash leaves that part of the compound unconstrained
+  [[nodiscard]] bool matches(int index, uint32_t tagHash, uint32_t classHash) const;
+
+ private:
+  struct Entry {
+    uint64_t bloom;
+    uint32_t tagHash;
+    uint32_t classHashes[MAX_CLASSES];
+    uint8_t classCount;
+  };
+
+  Entry entries_[MAX_DEPTH] = {};
+  int depth_ = 0;
+  int valid_ = 0;
+};
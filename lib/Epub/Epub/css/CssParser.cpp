@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include <Logging.h>
+#include <Memory.h>
 
 #include <algorithm>
 #include <array>
@@ -41,10 +42,6 @@ constexpr size_t READ_BUFFER_SIZE = 512;
 // Prevents unbounded memory growth from pathological CSS files
 constexpr size_t MAX_RULES = 1500;
 
-// Minimum free heap required to apply CSS during rendering
-// If below this threshold, we skip CSS to avoid display artifacts.
-constexpr size_t MIN_FREE_HEAP_FOR_CSS = 48 * 1024;
-
 // Maximum length for a single selector string
 // Prevents parsing of extremely long or malformed selectors
 constexpr size_t MAX_SELECTOR_LENGTH = 256;
@@ -428,6 +425,100 @@ CssStyle CssParser::parseDeclarations(std::string_view declBlock) {
 
 // Rule processing
 
+// Packed CssStyle records, shared by the rule table and descendant/child rules
+
+namespace {
+constexpr size_t CSS_LENGTH_FIELD_COUNT = 11;
+
+void packLength(uint8_t*& out, const CssLength& len) {
+  memcpy(out, &len.value, sizeof(len.value));
+  out += sizeof(len.value);
+  *out++ = static_cast<uint8_t>(len.unit);
+}
+
+void unpackLength(const uint8_t*& in, CssLength& len) {
+  memcpy(&len.value, in, sizeof(len.value));
+  in += sizeof(len.value);
+  len.unit = static_cast<CssUnit>(*in++);
+}
+
+void packStyle(uint8_t* out, const CssStyle& style) {
+  *out++ = static_cast<uint8_t>(style.textAlign);
+  *out++ = static_cast<uint8_t>(style.fontStyle);
+  *out++ = static_cast<uint8_t>(style.fontWeight);
+  *out++ = static_cast<uint8_t>(style.textDecoration);
+  *out++ = static_cast<uint8_t>(style.direction);
+  for (const CssLength* len : {&style.textIndent, &style.marginTop, &style.marginBottom, &style.marginLeft,
+                               &style.marginRight, &style.paddingTop, &style.paddingBottom, &style.paddingLeft,
+                               &style.paddingRight, &style.imageHeight, &style.imageWidth}) {
+    packLength(out, *len);
+  }
+  *out++ = static_cast<uint8_t>(style.display);
+  *out++ = static_cast<uint8_t>(style.verticalAlign);
+
+  uint32_t definedBits = 0;
+  if (style.defined.textAlign) definedBits |= 1 << 0;
+  if (style.defined.fontStyle) definedBits |= 1 << 1;
+  if (style.defined.fontWeight) definedBits |= 1 << 2;
+  if (style.defined.textDecoration) definedBits |= 1 << 3;
+  if (style.defined.textIndent) definedBits |= 1 << 4;
+  if (style.defined.marginTop) definedBits |= 1 << 5;
+  if (style.defined.marginBottom) definedBits |= 1 << 6;
+  if (style.defined.marginLeft) definedBits |= 1 << 7;
+  if (style.defined.marginRight) definedBits |= 1 << 8;
+  if (style.defined.paddingTop) definedBits |= 1 << 9;
+  if (style.defined.paddingBottom) definedBits |= 1 << 10;
+  if (style.defined.paddingLeft) definedBits |= 1 << 11;
+  if (style.defined.paddingRight) definedBits |= 1 << 12;
+  if (style.defined.imageHeight) definedBits |= 1 << 13;
+  if (style.defined.imageWidth) definedBits |= 1 << 14;
+  if (style.defined.display) definedBits |= 1 << 15;
+  if (style.defined.direction) definedBits |= 1 << 16;
+  if (style.defined.verticalAlign) definedBits |= 1 << 17;
+  memcpy(out, &definedBits, sizeof(definedBits));
+}
+
+void unpackStyle(const uint8_t* in, CssStyle& style) {
+  style.textAlign = static_cast<CssTextAlign>(*in++);
+  style.fontStyle = static_cast<CssFontStyle>(*in++);
+  style.fontWeight = static_cast<CssFontWeight>(*in++);
+  style.textDecoration = static_cast<CssTextDecoration>(*in++);
+  style.direction = static_cast<CssTextDirection>(*in++);
+  for (CssLength* len : {&style.textIndent, &style.marginTop, &style.marginBottom, &style.marginLeft,
+                         &style.marginRight, &style.paddingTop, &style.paddingBottom, &style.paddingLeft,
+                         &style.paddingRight, &style.imageHeight, &style.imageWidth}) {
+    unpackLength(in, *len);
+  }
+  style.display = static_cast<CssDisplay>(*in++);
+  style.verticalAlign = static_cast<CssVerticalAlign>(*in++);
+
+  uint32_t definedBits = 0;
+  memcpy(&definedBits, in, sizeof(definedBits));
+  style.defined.textAlign = (definedBits & 1 << 0) != 0;
+  style.defined.fontStyle = (definedBits & 1 << 1) != 0;
+  style.defined.fontWeight = (definedBits & 1 << 2) != 0;
+  style.defined.textDecoration = (definedBits & 1 << 3) != 0;
+  style.defined.textIndent = (definedBits & 1 << 4) != 0;
+  style.defined.marginTop = (definedBits & 1 << 5) != 0;
+  style.defined.marginBottom = (definedBits & 1 << 6) != 0;
+  style.defined.marginLeft = (definedBits & 1 << 7) != 0;
+  style.defined.marginRight = (definedBits & 1 << 8) != 0;
+  style.defined.paddingTop = (definedBits & 1 << 9) != 0;
+  style.defined.paddingBottom = (definedBits & 1 << 10) != 0;
+  style.defined.paddingLeft = (definedBits & 1 << 11) != 0;
+  style.defined.paddingRight = (definedBits & 1 << 12) != 0;
+  style.defined.imageHeight = (definedBits & 1 << 13) != 0;
+  style.defined.imageWidth = (definedBits & 1 << 14) != 0;
+  style.defined.display = (definedBits & 1 << 15) != 0;
+  style.defined.direction = (definedBits & 1 << 16) != 0;
+  style.defined.verticalAlign = (definedBits & 1 << 17) != 0;
+}
+
+static_assert(CssParser::PACKED_STYLE_SIZE ==
+                  5 + CSS_LENGTH_FIELD_COUNT * (sizeof(float) + sizeof(uint8_t)) + 2 + sizeof(uint32_t),
+              "PACKED_STYLE_SIZE must match packStyle");
+}  // namespace
+
 void CssParser::processRuleBlockWithStyle(std::string_view selectorGroup, const CssStyle& style) {
   // Check if we've reached the rule limit before processing
   if (rulesBySelector_.size() >= MAX_RULES) {
@@ -451,20 +542,24 @@ void CssParser::processRuleBlockWithStyle(std::string_view selectorGroup, const
         }
 
         // TODO: Support richer CSS selector syntax in the future. For now we only
-        // handle `tag`, `.class`, or `tag.class`. Reject anything containing a
-        // character that introduces unsupported syntax:
+        // handle `tag`, `.class`, or `tag.class`, optionally combined with
+        // descendant (' ') and child ('>') combinators. Reject anything containing
+        // a character that introduces unsupported syntax:
         //   '+'  adjacent sibling combinator
-        //   '>'  child combinator
         //   '['  attribute selector
         //   ':'  pseudo class/element
         //   '#'  ID selector
         //   '~'  general sibling combinator
         //   '*'  wildcard
-        //   ' '  descendant combinator
-        // Single-pass scan via find_first_of instead of eight sequential find() calls.
-        constexpr std::string_view kUnsupportedSelectorChars = "+>[:#~* ";
+        // Single-pass scan via find_first_of instead of six sequential find() calls.
+        constexpr std::string_view kUnsupportedSelectorChars = "+[:#~*";
         if (sel.find_first_of(kUnsupportedSelectorChars) != std::string_view::npos) return;
 
+        if (std::any_of(sel.begin(), sel.end(), [](const char c) { return c == '>' || isCssWhitespace(c); })) {
+          addContextRule(sel, style);
+          return;
+        }
+
         // Skip if this would exceed the rule limit
         if (rulesBySelector_.size() >= MAX_RULES) {
           LOG_DBG("CSS", "Reached max rules limit, stopping selector processing");
@@ -474,15 +569,91 @@ void CssParser::processRuleBlockWithStyle(std::string_view selectorGroup, const
 
         // Store or merge with existing. Hash/equal are case-insensitive, so two
         // selectors that differ only in ASCII case collide on insert and merge.
+        // A merged selector takes the source order of its latest block.
         auto it = rulesBySelector_.find(sel);
         if (it != rulesBySelector_.end()) {
-          it->second.applyOver(style);
+          it->second.style.applyOver(style);
+          it->second.order = nextRuleOrder_++;
         } else {
-          rulesBySelector_.emplace(std::string(sel), style);
+          rulesBySelector_.emplace(std::string(sel), FlatRule{style, nextRuleOrder_++});
         }
       });
 }
 
+bool CssParser::addContextRule(const std::string_view selector, const CssStyle& style) {
+  if (contextRules_.size() >= MAX_CONTEXT_RULES) {
+    LOG_DBG("CSS", "Reached max descendant/child rules (%zu), skipping: %.*s", MAX_CONTEXT_RULES,
+            static_cast<int>(selector.size()), selector.data());
+    return false;
+  }
+
+  // Split into compounds, remembering which ones follow a '>'
+  std::string_view compounds[MAX_CONTEXT_STEPS + 1];
+  bool isChild[MAX_CONTEXT_STEPS + 1] = {};
+  size_t count = 0;
+  bool pendingChild = false;
+  for (size_t i = 0; i < selector.size();) {
+    if (isCssWhitespace(selector[i])) {
+      i++;
+      continue;
+    }
+    if (selector[i] == '>') {
+      if (count == 0 || pendingChild) return false;
+      pendingChild = true;
+      i++;
+      continue;
+    }
+    size_t end = i;
+    while (end < selector.size() && selector[end] != '>' && !isCssWhitespace(selector[end])) end++;
+    if (count == MAX_CONTEXT_STEPS + 1) return false;
+    isChild[count] = pendingChild;
+    compounds[count++] = selector.substr(i, end - i);
+    pendingChild = false;
+    i = end;
+  }
+  if (pendingChild || count < 2) return false;
+
+  ContextRule rule{};
+  rule.subjectKey = ruleHash(CompositeKey{compounds[count - 1]});
+  rule.firstStep = static_cast<uint16_t>(contextSteps_.size());
+  rule.stepCount = static_cast<uint8_t>(count - 1);
+  unsigned classes = 0;
+  unsigned tags = 0;
+  for (size_t i = 0; i < count; i++) {
+    // Each compound is `tag`, `.class` or `tag.class`, as for flat selectors
+    const std::string_view compound = compounds[i];
+    const size_t dot = compound.find('.');
+    const std::string_view tag = compound.substr(0, dot);
+    const std::string_view cls = dot == std::string_view::npos ? std::string_view{} : compound.substr(dot + 1);
+    if ((dot != std::string_view::npos && (cls.empty() || cls.find('.') != std::string_view::npos)) ||
+        (tag.empty() && cls.empty())) {
+      contextSteps_.resize(rule.firstStep);
+      return false;
+    }
+    classes += !cls.empty();
+    tags += !tag.empty();
+    if (i == count - 1) break;  // the subject is matched through subjectKey
+
+    ContextStep step{};
+    step.tagHash = tag.empty() ? 0 : CssAncestorStack::hashTag(tag);
+    step.classHash = cls.empty() ? 0 : CssAncestorStack::hashClass(cls);
+    step.child = isChild[i + 1];
+    if (step.tagHash) rule.ancestorMask |= CssAncestorStack::featureBits(step.tagHash);
+    if (step.classHash) rule.ancestorMask |= CssAncestorStack::featureBits(step.classHash);
+    contextSteps_.push_back(step);
+  }
+  // Steps were collected left to right; matching walks from the parent outwards
+  std::reverse(contextSteps_.begin() + rule.firstStep, contextSteps_.end());
+  rule.specificity = static_cast<uint8_t>(std::min(255u, classes * 16 + tags));
+  rule.order = nextRuleOrder_++;
+  packStyle(rule.style, style);
+
+  const auto pos = std::upper_bound(contextRules_.begin(), contextRules_.end(), rule.subjectKey,
+                                    [](const uint64_t key, const ContextRule& r) { return key < r.subjectKey; });
+  contextRules_.insert(pos, rule);
+  return true;
+}
+
 // Main parsing entry point
 
 bool CssParser::loadFromStream(HalFile& source) {
@@ -490,6 +661,7 @@ bool CssParser::loadFromStream(HalFile& source) {
     LOG_ERR("CSS", "Cannot read from invalid file");
     return false;
   }
+  resetStyleMemo();
 
   size_t totalRead = 0;
 
@@ -628,58 +800,369 @@ bool CssParser::loadFromStream(HalFile& source) {
   return true;
 }
 
+void CssParser::clear() {
+  rulesBySelector_.clear();
+  contextRules_.clear();
+  contextSteps_.clear();
+  nextRuleOrder_ = 0;
+  closeRuleTable();
+  resetStyleMemo();
+}
+
 // Style resolution
 
-CssStyle CssParser::resolveStyle(std::string_view tagName, std::string_view classAttr) const {
-  static bool lowHeapWarningLogged = false;
-  if (ESP.getFreeHeap() < MIN_FREE_HEAP_FOR_CSS) {
-    if (!lowHeapWarningLogged) {
-      lowHeapWarningLogged = true;
-      LOG_DBG("CSS", "Warning: low heap (%u bytes) below MIN_FREE_HEAP_FOR_CSS (%u), returning empty style",
-              ESP.getFreeHeap(), static_cast<unsigned>(MIN_FREE_HEAP_FOR_CSS));
+bool CssParser::beginStyleMemo() {
+  styleMemo_ = makeUniqueNoThrow<StyleMemoEntry[]>(STYLE_MEMO_SIZE);
+  if (!styleMemo_) {
+    LOG_ERR("CSS", "OOM: style memo");
+    return false;
+  }
+  resetStyleMemo();
+  styleMemoStats_ = StyleMemoStats{};
+  return true;
+}
+
+void CssParser::endStyleMemo() { styleMemo_.reset(); }
+
+void CssParser::resetStyleMemo() const {
+  if (!styleMemo_) return;
+  for (uint8_t slot = 0; slot < STYLE_MEMO_SIZE; slot++) styleMemo_[slot].key = 0;
+}
+
+uint64_t CssParser::styleMemoKey(const std::string_view tagName, const std::string_view classAttr) {
+  // FNV-1a over the lowercased tag, a separator, then the class attribute as written
+  uint64_t h = 0xCBF29CE484222325ull;
+  const auto mix = [&h](const uint8_t byte) {
+    h ^= byte;
+    h *= 0x100000001B3ull;
+  };
+  for (const char c : tagName) mix(static_cast<uint8_t>(asciiToLower(c)));
+  mix(0);
+  for (const char c : classAttr) mix(static_cast<uint8_t>(c));
+  return h == 0 ? 1 : h;  // 0 marks an empty slot
+}
+
+void CssParser::logStyleMemoStats(const char* label) {
+  const uint32_t total = styleMemoStats_.hits + styleMemoStats_.misses;
+  LOG_DBG("CSS", "[%s] style memo hits=%lu misses=%lu (%.1f%% hit rate) evictions=%lu rule page reads=%lu", label,
+          static_cast<unsigned long>(styleMemoStats_.hits), static_cast<unsigned long>(styleMemoStats_.misses),
+          total > 0 ? 100.0f * styleMemoStats_.hits / total : 0.0f,
+          static_cast<unsigned long>(styleMemoStats_.evictions),
+          static_cast<unsigned long>(styleMemoStats_.rulePageReads));
+  styleMemoStats_ = StyleMemoStats{};
+}
+
+CssStyle CssParser::resolveStyle(const std::string_view tagName, const std::string_view classAttr,
+                                 const CssAncestorStack* ancestors) const {
+  uint64_t key = 0;
+  uint8_t target = 0;
+  bool foundFree = false;
+  if (styleMemo_) {
+    key = styleMemoKey(tagName, classAttr);
+    target = key & (STYLE_MEMO_SIZE - 1);
+    for (uint8_t i = 0, slot = target; i < STYLE_MEMO_PROBES; i++, slot = (slot + 1) & (STYLE_MEMO_SIZE - 1)) {
+      if (styleMemo_[slot].key == key) {
+        styleMemoStats_.hits++;
+        if (!styleMemo_[slot].hasContextRules) return styleMemo_[slot].style;
+        // Contextual rules interleave with the flat ones by specificity, so the whole cascade is redone
+        MatchedRules matches;
+        collectFlatRules(tagName, classAttr, matches);
+        collectContextRules(tagName, classAttr, ancestors, matches);
+        return applyInCascadeOrder(matches);
+      }
+      if (styleMemo_[slot].key == 0) {
+        target = slot;
+        foundFree = true;
+        break;
+      }
     }
-    return CssStyle{};
+    styleMemoStats_.misses++;
   }
 
-  CssStyle result;
+  MatchedRules matches;
+  collectFlatRules(tagName, classAttr, matches);
+  const bool hasContextRules = collectContextRules(tagName, classAttr, ancestors, matches);
+  const CssStyle style = applyInCascadeOrder(matches);
+  if (styleMemo_) {
+    if (!foundFree) styleMemoStats_.evictions++;
+    styleMemo_[target] = {key, style, hasContextRules};
+  }
+  return style;
+}
 
-  // 1. Apply element-level style (lowest priority). The map's hash/equal are
-  // case-insensitive, so the raw tagName view can be used as the lookup key.
-  if (auto it = rulesBySelector_.find(tagName); it != rulesBySelector_.end()) {
-    result.applyOver(it->second);
+CssParser::MatchedRule* CssParser::MatchedRules::next() {
+  if (count == MAX_MATCHED_RULES) {
+    LOG_DBG("CSS", "More than %u rules match one element, ignoring the rest", MAX_MATCHED_RULES);
+    return nullptr;
   }
+  return &rules[count++];
+}
 
-  if (classAttr.empty()) return result;
+void CssParser::collectFlatRules(std::string_view tagName, std::string_view classAttr, MatchedRules& matches) const {
+  // Specificities as for contextual rules: 1 per tag, 16 per class. Both the map and the rule table match
+  // selectors case-insensitively, so the raw views are the keys.
+  collectRule(CompositeKey{tagName}, 1, matches);
+
+  if (classAttr.empty()) return;
 
   // TODO: Support combinations of classes (e.g. style on .class1.class2)
-  // 2. Apply class styles (medium priority). The transparent hash/equal accept
-  // a CompositeKey, so we never materialize the concatenation.
+  // A CompositeKey is hashed and compared piecewise, so we never materialize the concatenation.
   forEachDelimitedToken(classAttr, isCssWhitespace, [&](std::string_view cls) {
-    if (auto it = rulesBySelector_.find(CompositeKey{".", cls}); it != rulesBySelector_.end()) {
-      result.applyOver(it->second);
-    }
+    collectRule(CompositeKey{".", cls}, 16, matches);
+    collectRule(CompositeKey{tagName, ".", cls}, 17, matches);
   });
+}
 
-  // TODO: Support combinations of classes (e.g. style on p.class1.class2)
-  // 3. Apply element.class styles (higher priority).
-  forEachDelimitedToken(classAttr, isCssWhitespace, [&](std::string_view cls) {
-    if (auto it = rulesBySelector_.find(CompositeKey{tagName, ".", cls}); it != rulesBySelector_.end()) {
-      result.applyOver(it->second);
+bool CssParser::collectContextRules(const std::string_view tagName, const std::string_view classAttr,
+                                    const CssAncestorStack* ancestors, MatchedRules& matches) const {
+  if (contextRules_.empty()) return false;
+
+  bool hasCandidates = false;
+  const bool canMatch = ancestors && ancestors->complete();
+  const uint64_t bloom = canMatch ? ancestors->bloom() : 0;
+
+  const auto collect = [&](const CompositeKey key) {
+    const uint64_t subjectKey = ruleHash(key);
+    auto it = std::lower_bound(contextRules_.begin(), contextRules_.end(), subjectKey,
+                               [](const ContextRule& r, const uint64_t k) { return r.subjectKey < k; });
+    for (; it != contextRules_.end() && it->subjectKey == subjectKey; ++it) {
+      hasCandidates = true;
+      if (!canMatch || (it->ancestorMask & ~bloom) != 0 || !matchesAncestors(*it, *ancestors)) continue;
+      MatchedRule* match = matches.next();
+      if (!match) return;
+      match->specificity = it->specificity;
+      match->order = it->order;
+      memcpy(match->style, it->style, PACKED_STYLE_SIZE);
     }
+  };
+  collect(CompositeKey{tagName});
+  forEachDelimitedToken(classAttr, isCssWhitespace, [&](std::string_view cls) {
+    collect(CompositeKey{".", cls});
+    collect(CompositeKey{tagName, ".", cls});
   });
+  return hasCandidates;
+}
+
+CssStyle CssParser::applyInCascadeOrder(MatchedRules& matches) {
+  // Insertion sort: a handful of rules, mostly collected in order already
+  for (uint8_t i = 1; i < matches.count; i++) {
+    for (uint8_t j = i; j > 0; j--) {
+      MatchedRule& a = matches.rules[j - 1];
+      MatchedRule& b = matches.rules[j];
+      if (a.specificity != b.specificity ? a.specificity < b.specificity : a.order <= b.order) break;
+      std::swap(a, b);
+    }
+  }
 
+  CssStyle result;
+  for (uint8_t i = 0; i < matches.count; i++) {
+    CssStyle style;
+    unpackStyle(matches.rules[i].style, style);
+    result.applyOver(style);
+  }
   return result;
 }
 
+bool CssParser::matchesAncestors(const ContextRule& rule, const CssAncestorStack& ancestors) const {
+  // Walk outwards from the parent. A descendant step may match any ancestor, so on failure further out
+  // we retry it higher up; a child step must match exactly at the next position.
+  const ContextStep* steps = contextSteps_.data() + rule.firstStep;
+  int positions[MAX_CONTEXT_STEPS];
+  uint8_t step = 0;
+  int pos = ancestors.size() - 1;
+  while (step < rule.stepCount) {
+    const ContextStep& current = steps[step];
+    bool found = false;
+    for (; pos >= 0; pos--) {
+      if (ancestors.matches(pos, current.tagHash, current.classHash)) {
+        found = true;
+        break;
+      }
+      if (current.child) break;
+    }
+    if (found) {
+      positions[step++] = pos--;
+      continue;
+    }
+    // Backtrack to the nearest descendant step that can move further out
+    while (true) {
+      if (step == 0) return false;
+      step--;
+      if (!steps[step].child || step == 0) {
+        // steps[0] is anchored to the subject: it may move only if the subject is a descendant, not a child
+        if (step == 0 && steps[0].child) return false;
+        pos = positions[step] - 1;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
 // Inline style parsing (static - doesn't need rule database)
 
 CssStyle CssParser::parseInlineStyle(std::string_view styleValue) { return parseDeclarations(styleValue); }
 
 // Cache serialization
+//
+// The cache is a compiled rule table that is queried in place rather than
+// loaded back into rulesBySelector_:
+//   u8 version, u8 rules per page, u16 rule count, u16 context rule count, u16 context step count
+//   u64 fences[page count]  selector hash of the first record of each page
+//   records[rule count]     u64 selector hash + u16 source order + packed CssStyle, sorted by hash
+//   context rules, then context steps, field by field
+// Selectors are identified by a 64-bit case-folded hash only. A lookup
+// binary-searches the fences in RAM and reads a single page of records.
+// The few descendant/child rules are read back into RAM.
 
 // Cache file name (version is CssParser::CSS_CACHE_VERSION)
 constexpr char rulesCache[] = "/css_rules.cache";
 
+namespace {
+constexpr size_t RULE_TABLE_HEADER_SIZE = 8;
+constexpr size_t CONTEXT_RULE_SIZE = 8 + 8 + 2 + 2 + 1 + 1 + CssParser::PACKED_STYLE_SIZE;
+constexpr size_t CONTEXT_STEP_SIZE = 4 + 4 + 1;
+
+uint64_t readRecordHash(const uint8_t* record) {
+  uint64_t hash;
+  memcpy(&hash, record, sizeof(hash));
+  return hash;
+}
+}  // namespace
+
+uint64_t CssParser::ruleHash(const CompositeKey key) {
+  // 64-bit FNV-1a regardless of size_t: the hash is stored on disk and must not collide in practice
+  uint64_t h = 0xCBF29CE484222325ull;
+  for (std::string_view piece : key.pieces) {
+    for (const char c : piece) {
+      h ^= static_cast<uint8_t>(asciiToLower(c));
+      h *= 0x100000001B3ull;
+    }
+  }
+  return h;
+}
+
+bool CssParser::collectRule(const CompositeKey key, const uint8_t specificity, MatchedRules& matches) const {
+  if (!rulesBySelector_.empty()) {
+    const auto it = rulesBySelector_.find(key);
+    if (it == rulesBySelector_.end()) return false;
+    MatchedRule* match = matches.next();
+    if (!match) return false;
+    match->specificity = specificity;
+    match->order = it->second.order;
+    packStyle(match->style, it->second.style);
+    return true;
+  }
+  if (tableRuleCount_ == 0) return false;
+
+  const uint64_t hash = ruleHash(key);
+  const auto fence = std::upper_bound(ruleFences_.begin(), ruleFences_.end(), hash);
+  if (fence == ruleFences_.begin()) return false;
+  const auto page = static_cast<uint16_t>(fence - ruleFences_.begin() - 1);
+  const uint8_t* records = loadRulePage(page);
+  if (!records) return false;
+
+  const size_t count = std::min<size_t>(RULES_PER_PAGE, tableRuleCount_ - page * RULES_PER_PAGE);
+  size_t lo = 0;
+  size_t hi = count;
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    const uint8_t* record = records + mid * RULE_RECORD_SIZE;
+    const uint64_t midHash = readRecordHash(record);
+    if (midHash == hash) {
+      MatchedRule* match = matches.next();
+      if (!match) return false;
+      match->specificity = specificity;
+      memcpy(&match->order, record + sizeof(uint64_t), sizeof(uint16_t));
+      memcpy(match->style, record + sizeof(uint64_t) + sizeof(uint16_t), PACKED_STYLE_SIZE);
+      return true;
+    }
+    if (midHash < hash) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return false;
+}
+
+const uint8_t* CssParser::loadRulePage(const uint16_t page) const {
+  uint8_t victim = 0;
+  for (uint8_t slot = 0; slot < RULE_PAGE_SLOTS; slot++) {
+    if (rulePageIds_[slot] == page) {
+      rulePageUse_[slot] = ++rulePageClock_;
+      return rulePages_.get() + slot * RULE_PAGE_BYTES;
+    }
+    if (rulePageUse_[slot] < rulePageUse_[victim]) victim = slot;
+  }
+
+  if (!ruleTableFile_ && !Storage.openFileForRead("CSS", cachePath + rulesCache, ruleTableFile_)) {
+    return nullptr;
+  }
+  const size_t count = std::min<size_t>(RULES_PER_PAGE, tableRuleCount_ - page * RULES_PER_PAGE);
+  const size_t offset =
+      RULE_TABLE_HEADER_SIZE + ruleFences_.size() * sizeof(uint64_t) + static_cast<size_t>(page) * RULE_PAGE_BYTES;
+  uint8_t* dest = rulePages_.get() + victim * RULE_PAGE_BYTES;
+  if (!ruleTableFile_.seek(offset) ||
+      ruleTableFile_.read(dest, count * RULE_RECORD_SIZE) != static_cast<int>(count * RULE_RECORD_SIZE)) {
+    LOG_ERR("CSS", "Failed to read rule table page %u", page);
+    rulePageIds_[victim] = NO_RULE_PAGE;
+    rulePageUse_[victim] = 0;
+    return nullptr;
+  }
+  styleMemoStats_.rulePageReads++;
+  rulePageIds_[victim] = page;
+  rulePageUse_[victim] = ++rulePageClock_;
+  return dest;
+}
+
+bool CssParser::loadContextRules(HalFile& file, const size_t offset, const uint16_t ruleCount,
+                                 const uint16_t stepCount) {
+  const size_t bytes = ruleCount * CONTEXT_RULE_SIZE + stepCount * CONTEXT_STEP_SIZE;
+  auto data = makeUniqueNoThrow<uint8_t[]>(bytes);
+  if (!data) {
+    LOG_ERR("CSS", "OOM: CSS context rules");
+    return false;
+  }
+  if (!file.seek(offset) || file.read(data.get(), bytes) != static_cast<int>(bytes)) {
+    LOG_ERR("CSS", "Failed to read CSS context rules");
+    return false;
+  }
+
+  const uint8_t* p = data.get();
+  contextRules_.resize(ruleCount);
+  for (auto& rule : contextRules_) {
+    memcpy(&rule.subjectKey, p, 8);
+    memcpy(&rule.ancestorMask, p + 8, 8);
+    memcpy(&rule.firstStep, p + 16, 2);
+    memcpy(&rule.order, p + 18, 2);
+    rule.stepCount = p[20];
+    rule.specificity = p[21];
+    memcpy(rule.style, p + 22, PACKED_STYLE_SIZE);
+    p += CONTEXT_RULE_SIZE;
+    if (rule.stepCount > MAX_CONTEXT_STEPS || rule.firstStep + rule.stepCount > stepCount) {
+      LOG_DBG("CSS", "Invalid CSS context rule");
+      return false;
+    }
+  }
+  contextSteps_.resize(stepCount);
+  for (auto& step : contextSteps_) {
+    memcpy(&step.tagHash, p, 4);
+    memcpy(&step.classHash, p + 4, 4);
+    step.child = p[8];
+    p += CONTEXT_STEP_SIZE;
+  }
+  return true;
+}
+
+void CssParser::closeRuleTable() {
+  if (ruleTableFile_) ruleTableFile_.close();
+  rulePages_.reset();
+  ruleFences_.clear();
+  ruleFences_.shrink_to_fit();
+  tableRuleCount_ = 0;
+}
+
 bool CssParser::hasCache() const { return Storage.exists((cachePath + rulesCache).c_str()); }
 
 void CssParser::deleteCache() const {
@@ -691,77 +1174,67 @@ bool CssParser::saveToCache() const {
     return false;
   }
 
+  // Sort (hash, rule) pairs rather than packed records, to keep the transient footprint small
+  std::vector<std::pair<uint64_t, const FlatRule*>> sorted;
+  sorted.reserve(rulesBySelector_.size());
+  for (const auto& pair : rulesBySelector_) {
+    sorted.emplace_back(ruleHash(CompositeKey{pair.first}), &pair.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
   HalFile file;
   if (!Storage.openFileForWrite("CSS", cachePath + rulesCache, file)) {
     return false;
   }
 
-  // Write version
+  const auto ruleCount = static_cast<uint16_t>(sorted.size());
+  const auto contextRuleCount = static_cast<uint16_t>(contextRules_.size());
+  const auto contextStepCount = static_cast<uint16_t>(contextSteps_.size());
   file.write(CssParser::CSS_CACHE_VERSION);
-
-  // Write rule count
-  const auto ruleCount = static_cast<uint16_t>(rulesBySelector_.size());
+  file.write(RULES_PER_PAGE);
   file.write(reinterpret_cast<const uint8_t*>(&ruleCount), sizeof(ruleCount));
+  file.write(reinterpret_cast<const uint8_t*>(&contextRuleCount), sizeof(contextRuleCount));
+  file.write(reinterpret_cast<const uint8_t*>(&contextStepCount), sizeof(contextStepCount));
 
-  // Write each rule: selector string + CssStyle fields
-  for (const auto& pair : rulesBySelector_) {
-    // Write selector string (length-prefixed)
-    const auto selectorLen = static_cast<uint16_t>(pair.first.size());
-    file.write(reinterpret_cast<const uint8_t*>(&selectorLen), sizeof(selectorLen));
-    file.write(reinterpret_cast<const uint8_t*>(pair.first.data()), selectorLen);
-
-    // Write CssStyle fields (all are POD types)
-    const CssStyle& style = pair.second;
-    file.write(static_cast<uint8_t>(style.textAlign));
-    file.write(static_cast<uint8_t>(style.fontStyle));
-    file.write(static_cast<uint8_t>(style.fontWeight));
-    file.write(static_cast<uint8_t>(style.textDecoration));
-    file.write(static_cast<uint8_t>(style.direction));
-
-    // Write CssLength fields (value + unit)
-    auto writeLength = [&file](const CssLength& len) {
-      file.write(reinterpret_cast<const uint8_t*>(&len.value), sizeof(len.value));
-      file.write(static_cast<uint8_t>(len.unit));
-    };
-
-    writeLength(style.textIndent);
-    writeLength(style.marginTop);
-    writeLength(style.marginBottom);
-    writeLength(style.marginLeft);
-    writeLength(style.marginRight);
-    writeLength(style.paddingTop);
-    writeLength(style.paddingBottom);
-    writeLength(style.paddingLeft);
-    writeLength(style.paddingRight);
-    writeLength(style.imageHeight);
-    writeLength(style.imageWidth);
-    file.write(static_cast<uint8_t>(style.display));
-    file.write(static_cast<uint8_t>(style.verticalAlign));
-
-    // Write defined flags as uint32_t
-    uint32_t definedBits = 0;
-    if (style.defined.textAlign) definedBits |= 1 << 0;
-    if (style.defined.fontStyle) definedBits |= 1 << 1;
-    if (style.defined.fontWeight) definedBits |= 1 << 2;
-    if (style.defined.textDecoration) definedBits |= 1 << 3;
-    if (style.defined.textIndent) definedBits |= 1 << 4;
-    if (style.defined.marginTop) definedBits |= 1 << 5;
-    if (style.defined.marginBottom) definedBits |= 1 << 6;
-    if (style.defined.marginLeft) definedBits |= 1 << 7;
-    if (style.defined.marginRight) definedBits |= 1 << 8;
-    if (style.defined.paddingTop) definedBits |= 1 << 9;
-    if (style.defined.paddingBottom) definedBits |= 1 << 10;
-    if (style.defined.paddingLeft) definedBits |= 1 << 11;
-    if (style.defined.paddingRight) definedBits |= 1 << 12;
-    if (style.defined.imageHeight) definedBits |= 1 << 13;
-    if (style.defined.imageWidth) definedBits |= 1 << 14;
-    if (style.defined.display) definedBits |= 1 << 15;
-    if (style.defined.direction) definedBits |= 1 << 16;
-    if (style.defined.verticalAlign) definedBits |= 1 << 17;
-    file.write(reinterpret_cast<const uint8_t*>(&definedBits), sizeof(definedBits));
-  }
-
-  LOG_DBG("CSS", "Saved %u rules to cache", ruleCount);
+  for (size_t i = 0; i < sorted.size(); i += RULES_PER_PAGE) {
+    file.write(reinterpret_cast<const uint8_t*>(&sorted[i].first), sizeof(uint64_t));
+  }
+
+  uint8_t record[RULE_RECORD_SIZE];
+  for (const auto& [hash, rule] : sorted) {
+    memcpy(record, &hash, sizeof(hash));
+    memcpy(record + sizeof(hash), &rule->order, sizeof(rule->order));
+    packStyle(record + sizeof(hash) + sizeof(rule->order), rule->style);
+    if (file.write(record, sizeof(record)) != sizeof(record)) {
+      LOG_ERR("CSS", "Failed to write CSS rule table");
+      file.close();
+      deleteCache();
+      return false;
+    }
+  }
+
+  bool ok = true;
+  for (const auto& rule : contextRules_) {
+    ok = ok && file.write(reinterpret_cast<const uint8_t*>(&rule.subjectKey), 8) == 8;
+    ok = ok && file.write(reinterpret_cast<const uint8_t*>(&rule.ancestorMask), 8) == 8;
+    ok = ok && file.write(reinterpret_cast<const uint8_t*>(&rule.firstStep), 2) == 2;
+    ok = ok && file.write(reinterpret_cast<const uint8_t*>(&rule.order), 2) == 2;
+    ok = ok && file.write(rule.stepCount) == 1 && file.write(rule.specificity) == 1;
+    ok = ok && file.write(rule.style, PACKED_STYLE_SIZE) == PACKED_STYLE_SIZE;
+  }
+  for (const auto& step : contextSteps_) {
+    ok = ok && file.write(reinterpret_cast<const uint8_t*>(&step.tagHash), 4) == 4;
+    ok = ok && file.write(reinterpret_cast<const uint8_t*>(&step.classHash), 4) == 4;
+    ok = ok && file.write(step.child) == 1;
+  }
+  if (!ok) {
+    LOG_ERR("CSS", "Failed to write CSS context rules");
+    file.close();
+    deleteCache();
+    return false;
+  }
+
+  LOG_DBG("CSS", "Saved %u rules and %u descendant/child rules to cache", ruleCount, contextRuleCount);
   return true;
 }
 
@@ -789,158 +1262,60 @@ bool CssParser::loadFromCache() {
     return false;
   }
 
-  // Read rule count
+  uint8_t rulesPerPage = 0;
   uint16_t ruleCount = 0;
-  if (file.read(&ruleCount, sizeof(ruleCount)) != sizeof(ruleCount)) {
+  uint16_t contextRuleCount = 0;
+  uint16_t contextStepCount = 0;
+  if (file.read(&rulesPerPage, 1) != 1 || file.read(&ruleCount, sizeof(ruleCount)) != sizeof(ruleCount) ||
+      file.read(&contextRuleCount, sizeof(contextRuleCount)) != sizeof(contextRuleCount) ||
+      file.read(&contextStepCount, sizeof(contextStepCount)) != sizeof(contextStepCount)) {
     return false;
   }
-
-  if (ruleCount > MAX_RULES) {
-    LOG_DBG("CSS", "Invalid cache rule count (%u > %zu)", ruleCount, MAX_RULES);
-    rulesBySelector_.clear();
+  if (rulesPerPage != RULES_PER_PAGE || ruleCount > MAX_RULES || contextRuleCount > MAX_CONTEXT_RULES ||
+      contextStepCount > contextRuleCount * MAX_CONTEXT_STEPS) {
+    LOG_DBG("CSS", "Invalid rule table (%u rules, %u per page)", ruleCount, rulesPerPage);
     return false;
   }
 
-  auto hasRemainingBytes = [&file](const size_t neededBytes) -> bool {
-    return static_cast<size_t>(file.available()) >= neededBytes;
-  };
-
-  constexpr size_t CSS_LENGTH_FIELD_COUNT = 11;
-  constexpr size_t CSS_LENGTH_BYTES = sizeof(float) + sizeof(uint8_t);
-  constexpr size_t CSS_FIXED_STYLE_BYTES =
-      5 * sizeof(uint8_t) + (CSS_LENGTH_FIELD_COUNT * CSS_LENGTH_BYTES) + sizeof(uint8_t) + sizeof(uint32_t);
-
-  // Read each rule
-  for (uint16_t i = 0; i < ruleCount; ++i) {
-    // Read selector string
-    uint16_t selectorLen = 0;
-    if (!hasRemainingBytes(sizeof(selectorLen))) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    if (file.read(&selectorLen, sizeof(selectorLen)) != sizeof(selectorLen)) {
-      rulesBySelector_.clear();
-      return false;
-    }
-
-    if (selectorLen == 0 || selectorLen > MAX_SELECTOR_LENGTH || !hasRemainingBytes(selectorLen)) {
-      LOG_DBG("CSS", "Invalid selector length in cache: %u", selectorLen);
-      rulesBySelector_.clear();
-      return false;
-    }
-
-    std::string selector;
-    selector.resize(selectorLen);
-    if (file.read(&selector[0], selectorLen) != selectorLen) {
-      rulesBySelector_.clear();
-      return false;
-    }
-
-    if (!hasRemainingBytes(CSS_FIXED_STYLE_BYTES)) {
-      LOG_DBG("CSS", "Truncated CSS cache while reading style payload");
-      rulesBySelector_.clear();
-      return false;
-    }
-
-    // Read CssStyle fields
-    CssStyle style;
-    uint8_t enumVal;
-
-    if (file.read(&enumVal, 1) != 1) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    style.textAlign = static_cast<CssTextAlign>(enumVal);
-
-    if (file.read(&enumVal, 1) != 1) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    style.fontStyle = static_cast<CssFontStyle>(enumVal);
-
-    if (file.read(&enumVal, 1) != 1) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    style.fontWeight = static_cast<CssFontWeight>(enumVal);
-
-    if (file.read(&enumVal, 1) != 1) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    style.textDecoration = static_cast<CssTextDecoration>(enumVal);
-
-    if (file.read(&enumVal, 1) != 1) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    style.direction = static_cast<CssTextDirection>(enumVal);
-
-    // Read CssLength fields
-    auto readLength = [&file](CssLength& len) -> bool {
-      if (file.read(&len.value, sizeof(len.value)) != sizeof(len.value)) {
-        return false;
-      }
-      uint8_t unitVal;
-      if (file.read(&unitVal, 1) != 1) {
-        return false;
-      }
-      len.unit = static_cast<CssUnit>(unitVal);
-      return true;
-    };
-
-    if (!readLength(style.textIndent) || !readLength(style.marginTop) || !readLength(style.marginBottom) ||
-        !readLength(style.marginLeft) || !readLength(style.marginRight) || !readLength(style.paddingTop) ||
-        !readLength(style.paddingBottom) || !readLength(style.paddingLeft) || !readLength(style.paddingRight) ||
-        !readLength(style.imageHeight) || !readLength(style.imageWidth)) {
-      rulesBySelector_.clear();
-      return false;
-    }
-
-    // Read display value
-    uint8_t displayVal;
-    if (file.read(&displayVal, 1) != 1) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    style.display = static_cast<CssDisplay>(displayVal);
+  const size_t pageCount = (ruleCount + RULES_PER_PAGE - 1) / RULES_PER_PAGE;
+  const size_t contextOffset =
+      RULE_TABLE_HEADER_SIZE + pageCount * sizeof(uint64_t) + static_cast<size_t>(ruleCount) * RULE_RECORD_SIZE;
+  const size_t expectedSize =
+      contextOffset + contextRuleCount * CONTEXT_RULE_SIZE + contextStepCount * CONTEXT_STEP_SIZE;
+  if (file.size() != expectedSize) {
+    LOG_DBG("CSS", "Truncated CSS rule table (%zu bytes, expected %zu)", file.size(), expectedSize);
+    return false;
+  }
+  if (contextRuleCount > 0 && !loadContextRules(file, contextOffset, contextRuleCount, contextStepCount)) {
+    clear();
+    return false;
+  }
+  if (ruleCount == 0) {
+    return true;
+  }
+  if (!file.seek(RULE_TABLE_HEADER_SIZE)) {
+    clear();
+    return false;
+  }
 
-    // Read verticalAlign value
-    uint8_t verticalAlignVal;
-    if (file.read(&verticalAlignVal, 1) != 1) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    style.verticalAlign = static_cast<CssVerticalAlign>(verticalAlignVal);
+  rulePages_ = makeUniqueNoThrow<uint8_t[]>(RULE_PAGE_SLOTS * RULE_PAGE_BYTES);
+  if (!rulePages_) {
+    LOG_ERR("CSS", "OOM: CSS rule page cache");
+    return false;
+  }
+  ruleFences_.resize(pageCount);
+  const size_t fenceBytes = pageCount * sizeof(uint64_t);
+  if (file.read(ruleFences_.data(), fenceBytes) != static_cast<int>(fenceBytes)) {
+    closeRuleTable();
+    return false;
+  }
+  for (uint8_t slot = 0; slot < RULE_PAGE_SLOTS; slot++) {
+    rulePageIds_[slot] = NO_RULE_PAGE;
+    rulePageUse_[slot] = 0;
+  }
+  rulePageClock_ = 0;
+  tableRuleCount_ = ruleCount;
 
-    // Read defined flags
-    uint32_t definedBits = 0;
-    if (file.read(&definedBits, sizeof(definedBits)) != sizeof(definedBits)) {
-      rulesBySelector_.clear();
-      return false;
-    }
-    style.defined.textAlign = (definedBits & 1 << 0) != 0;
-    style.defined.fontStyle = (definedBits & 1 << 1) != 0;
-    style.defined.fontWeight = (definedBits & 1 << 2) != 0;
-    style.defined.textDecoration = (definedBits & 1 << 3) != 0;
-    style.defined.textIndent = (definedBits & 1 << 4) != 0;
-    style.defined.marginTop = (definedBits & 1 << 5) != 0;
-    style.defined.marginBottom = (definedBits & 1 << 6) != 0;
-    style.defined.marginLeft = (definedBits & 1 << 7) != 0;
-    style.defined.marginRight = (definedBits & 1 << 8) != 0;
-    style.defined.paddingTop = (definedBits & 1 << 9) != 0;
-    style.defined.paddingBottom = (definedBits & 1 << 10) != 0;
-    style.defined.paddingLeft = (definedBits & 1 << 11) != 0;
-    style.defined.paddingRight = (definedBits & 1 << 12) != 0;
-    style.defined.imageHeight = (definedBits & 1 << 13) != 0;
-    style.defined.imageWidth = (definedBits & 1 << 14) != 0;
-    style.defined.display = (definedBits & 1 << 15) != 0;
-    style.defined.direction = (definedBits & 1 << 16) != 0;
-    style.defined.verticalAlign = (definedBits & 1 << 17) != 0;
-
-    rulesBySelector_[selector] = style;
-  }
-
-  LOG_DBG("CSS", "Loaded %u rules from cache", ruleCount);
+  LOG_DBG("CSS", "Opened rule table with %u rules", ruleCount);
   return true;
 }
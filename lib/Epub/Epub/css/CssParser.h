@@ -3,29 +3,34 @@
 #include <HalStorage.h>
 
 #include <initializer_list>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "CssAncestorStack.h"
 #include "CssStyle.h"
 
 /**
  * Lightweight CSS parser for EPUB stylesheets
  *
  * Parses CSS files and extracts styling information relevant for e-ink display.
- * Uses a two-phase approach: first tokenizes the CSS content, then builds
- * a rule database that can be queried during HTML parsing.
+ * Uses a two-phase approach: first tokenizes the CSS content into an in-memory
+ * rule map, then compiles it to an on-disk rule table (saveToCache). During
+ * HTML parsing the table is queried in place (loadFromCache), so resolving
+ * styles costs a few KB of RAM however large the stylesheets are.
  *
  * Supported selectors:
  *   - Element selectors: p, div, h1, etc.
  *   - Class selectors: .classname
  *   - Combined: element.classname
+ *   - Descendant and child selectors over those: .chapter p, blockquote > p
  *   - Grouped: selector1, selector2 { }
  *
  * Not supported (silently ignored):
- *   - Descendant/child selectors
+ *   - Sibling combinators, attribute and ID selectors
  *   - Pseudo-classes and pseudo-elements
  *   - Media queries (content is skipped)
  *   - @import, @font-face, etc.
@@ -33,7 +38,9 @@
 class CssParser {
  public:
   // Bump when CSS cache format or rules change; section caches are invalidated when this changes
-  static constexpr uint8_t CSS_CACHE_VERSION = 6;
+  static constexpr uint8_t CSS_CACHE_VERSION = 9;
+  // Bytes of one CssStyle in the rule table
+  static constexpr size_t PACKED_STYLE_SIZE = 66;
 
   explicit CssParser(std::string cachePath) : cachePath(std::move(cachePath)) {}
   ~CssParser() = default;
@@ -52,13 +59,36 @@ class CssParser {
 
   /**
    * Look up the style for an HTML element, considering tag name and class attributes.
-   * Applies CSS cascade: element style < class style < element.class style
+   * Applies the CSS cascade: every matching rule, flat or descendant/child, in
+   * order of specificity (element < class < element.class, counting each
+   * compound of a contextual selector), with source order breaking ties
    *
    * @param tagName The HTML element name (e.g., "p", "div")
    * @param classAttr The class attribute value (may contain multiple space-separated classes)
+   * @param ancestors The element's open ancestors; descendant/child selectors are skipped without them
    * @return Combined style with all applicable rules merged
    */
-  [[nodiscard]] CssStyle resolveStyle(std::string_view tagName, std::string_view classAttr) const;
+  [[nodiscard]] CssStyle resolveStyle(std::string_view tagName, std::string_view classAttr,
+                                      const CssAncestorStack* ancestors = nullptr) const;
+
+  struct StyleMemoStats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+    uint32_t rulePageReads = 0;  // rule table pages read from the SD card
+  };
+
+  /**
+   * Memoize resolveStyle results by (tag, class attribute) until endStyleMemo().
+   * Meant to wrap one section build, where generated EPUBs repeat the same few
+   * combinations (e.g. <p class="calibre12">) thousands of times. Loading or
+   * clearing rules empties the memo.
+   * @return false on OOM; styles are then resolved without the memo
+   */
+  bool beginStyleMemo();
+  void endStyleMemo();
+  void logStyleMemoStats(const char* label = "section");
+  [[nodiscard]] const StyleMemoStats& getStyleMemoStats() const { return styleMemoStats_; }
 
   /**
    * Parse an inline style attribute string.
@@ -70,17 +100,19 @@ class CssParser {
   /**
    * Check if any rules have been loaded
    */
-  [[nodiscard]] bool empty() const { return rulesBySelector_.empty(); }
+  [[nodiscard]] bool empty() const { return ruleCount() == 0; }
 
   /**
-   * Get count of loaded rule sets
+   * Get count of loaded rule sets (parsed, or in the opened rule table)
    */
-  [[nodiscard]] size_t ruleCount() const { return rulesBySelector_.size(); }
+  [[nodiscard]] size_t ruleCount() const {
+    return (rulesBySelector_.empty() ? tableRuleCount_ : rulesBySelector_.size()) + contextRules_.size();
+  }
 
   /**
    * Clear all loaded rules
    */
-  void clear() { rulesBySelector_.clear(); }
+  void clear();
 
   /**
    * Check if CSS rules cache file exists
@@ -99,8 +131,8 @@ class CssParser {
   bool saveToCache() const;
 
   /**
-   * Load CSS rules from a cache file.
-   * Clears any existing rules before loading.
+   * Open the rule table in the cache file for lookups. Only the page fences
+   * are read; rule pages are read on demand. Clears any existing rules first.
    * @return true if cache was loaded successfully
    */
   bool loadFromCache();
@@ -137,11 +169,101 @@ class CssParser {
     bool operator()(std::string_view a, CompositeKey b) const noexcept;
   };
 
+  // A flat selector's merged style and the source order of its last declaration block
+  struct FlatRule {
+    CssStyle style;
+    uint16_t order;
+  };
+
   // Storage: maps selector -> style properties. Hash/equal are case-insensitive.
-  std::unordered_map<std::string, CssStyle, SvHash, SvEqual> rulesBySelector_;
+  std::unordered_map<std::string, FlatRule, SvHash, SvEqual> rulesBySelector_;
+  // Source order of the next selector kept, shared by flat and descendant/child rules
+  uint16_t nextRuleOrder_ = 0;
 
   std::string cachePath;
 
+  // Resolved styles by hash of (lowercased tag, class attribute); a small open-addressed table whose
+  // home slot is overwritten when the probe window is full. Allocated only between begin/endStyleMemo.
+  static constexpr uint8_t STYLE_MEMO_SIZE = 32;  // power of two; ~3.5KB
+  static constexpr uint8_t STYLE_MEMO_PROBES = 4;
+  struct StyleMemoEntry {
+    uint64_t key;
+    CssStyle style;        // only valid when hasContextRules is false
+    bool hasContextRules;  // a descendant/child rule could apply, so the style depends on the ancestors
+  };
+  mutable std::unique_ptr<StyleMemoEntry[]> styleMemo_;
+  mutable StyleMemoStats styleMemoStats_;
+
+  // Compiled rule table opened by loadFromCache(). ruleFences_ holds the first selector hash of each page
+  // of RULES_PER_PAGE records; a lookup reads one page through a small LRU page cache.
+  static constexpr uint8_t RULES_PER_PAGE = 8;
+  static constexpr uint8_t RULE_PAGE_SLOTS = 4;
+  static constexpr size_t RULE_RECORD_SIZE = sizeof(uint64_t) + sizeof(uint16_t) + PACKED_STYLE_SIZE;
+  static constexpr size_t RULE_PAGE_BYTES = RULES_PER_PAGE * RULE_RECORD_SIZE;  // ~600 bytes
+  static constexpr uint16_t NO_RULE_PAGE = UINT16_MAX;
+  std::vector<uint64_t> ruleFences_;
+  uint16_t tableRuleCount_ = 0;
+  mutable HalFile ruleTableFile_;  // opened on the first page read
+  mutable std::unique_ptr<uint8_t[]> rulePages_;
+  mutable uint16_t rulePageIds_[RULE_PAGE_SLOTS] = {};
+  mutable uint32_t rulePageUse_[RULE_PAGE_SLOTS] = {};
+  mutable uint32_t rulePageClock_ = 0;
+
+  // Descendant/child selectors, e.g. ".chapter p" or "blockquote > p". subjectKey is the ruleHash of the
+  // rightmost compound, so candidates are found with the same keys as flat rules. Steps run from the
+  // parent outwards; a zero hash leaves that part of a compound unconstrained. Kept sorted by subjectKey
+  // and held in RAM in both phases (the rule table stores them after the flat records).
+  struct ContextStep {
+    uint32_t tagHash;
+    uint32_t classHash;
+    uint8_t child;  // 1 if this compound must be the direct parent of the one to its right
+  };
+  struct ContextRule {
+    uint64_t subjectKey;
+    uint64_t ancestorMask;  // CssAncestorStack features required of the ancestors
+    uint16_t firstStep;
+    uint16_t order;  // source order, the tie-break between equal specificities
+    uint8_t stepCount;
+    uint8_t specificity;
+    uint8_t style[PACKED_STYLE_SIZE];
+  };
+  static constexpr size_t MAX_CONTEXT_RULES = 64;
+  static constexpr uint8_t MAX_CONTEXT_STEPS = 4;
+  std::vector<ContextRule> contextRules_;
+  std::vector<ContextStep> contextSteps_;
+
+  // Rules matching one element, applied lowest specificity first. Styles are copied out packed since
+  // rule table pages may be evicted while the rest are collected.
+  struct MatchedRule {
+    uint8_t specificity;
+    uint16_t order;
+    uint8_t style[PACKED_STYLE_SIZE];
+  };
+  static constexpr uint8_t MAX_MATCHED_RULES = 16;
+  struct MatchedRules {
+    MatchedRule rules[MAX_MATCHED_RULES];
+    uint8_t count = 0;
+    MatchedRule* next();  // nullptr once full
+  };
+
+  static uint64_t ruleHash(CompositeKey key);
+  // Adds the flat rule for `key`, from the rule map while parsing or from the rule table
+  bool collectRule(CompositeKey key, uint8_t specificity, MatchedRules& matches) const;
+  const uint8_t* loadRulePage(uint16_t page) const;
+  void closeRuleTable();
+  bool loadContextRules(HalFile& file, size_t offset, uint16_t ruleCount, uint16_t stepCount);
+
+  static uint64_t styleMemoKey(std::string_view tagName, std::string_view classAttr);
+  void resetStyleMemo() const;
+  void collectFlatRules(std::string_view tagName, std::string_view classAttr, MatchedRules& matches) const;
+  // Adds matching descendant/child rules. Returns whether any has this element's tag or a class as its
+  // subject, i.e. whether the result can depend on the ancestors at all.
+  bool collectContextRules(std::string_view tagName, std::string_view classAttr, const CssAncestorStack* ancestors,
+                           MatchedRules& matches) const;
+  static CssStyle applyInCascadeOrder(MatchedRules& matches);
+  bool matchesAncestors(const ContextRule& rule, const CssAncestorStack& ancestors) const;
+  bool addContextRule(std::string_view selector, const CssStyle& style);
+
   // Internal parsing helpers
   void processRuleBlockWithStyle(std::string_view selectorGroup, const CssStyle& style);
   static CssStyle parseDeclarations(std::string_view declBlock);
@@ -0,0 +1,106 @@
+#include "HyphenationCache.h"
+
+#include <cstring>
+#include <new>
+
+bool HyphenationCache::begin(const char* languageTag, const uint32_t patternSetId) {
+  end();
+  block.reset(new (std::nothrow) uint64_t[dataSize() / sizeof(uint64_t)]);
+  if (!block) return false;
+  strncpy(language, languageTag, sizeof(language) - 1);
+  language[sizeof(language) - 1] = '\0';
+  patternSet = patternSetId;
+  clear();
+  return true;
+}
+
+void HyphenationCache::end() {
+  block.reset();
+  language[0] = '\0';
+  patternSet = 0;
+  dirty = false;
+}
+
+void HyphenationCache::clear() {
+  memset(data(), 0, dataSize());
+  header().magic = MAGIC;
+  header().version = VERSION;
+  header().slotCount = SLOT_COUNT;
+  memcpy(header().language, language, sizeof(language));
+  header().patternSet = patternSet;
+  dirty = false;
+}
+
+bool HyphenationCache::validateLoaded() {
+  if (!block) return false;
+  const Header& h = header();
+  if (h.magic == MAGIC && h.version == VERSION && h.slotCount == SLOT_COUNT &&
+      memcmp(h.language, language, sizeof(language)) == 0 && h.patternSet == patternSet) {
+    dirty = false;
+    return true;
+  }
+  clear();
+  return false;
+}
+
+uint64_t HyphenationCache::keyFor(const std::string& word, const bool includeFallback) {
+  // FNV-1a over the word, seeded with the fallback flag
+  uint64_t h = 0xCBF29CE484222325ull;
+  const auto mix = [&h](const uint8_t byte) {
+    h ^= byte;
+    h *= 0x100000001B3ull;
+  };
+  mix(includeFallback ? 1 : 0);
+  for (const char c : word) mix(static_cast<uint8_t>(c));
+  return h == EMPTY_KEY ? 1 : h;
+}
+
+bool HyphenationCache::find(const std::string& word, const bool includeFallback,
+                            std::vector<Hyphenator::BreakInfo>& breaks) {
+  if (!block || word.size() < MIN_WORD_BYTES || word.size() > MAX_WORD_BYTES) return false;
+  const uint64_t key = keyFor(word, includeFallback);
+  Slot* table = slots();
+  for (uint16_t i = 0, slot = key & (SLOT_COUNT - 1); i < PROBE_LIMIT; i++, slot = (slot + 1) & (SLOT_COUNT - 1)) {
+    const Slot& entry = table[slot];
+    if (entry.key == EMPTY_KEY) break;
+    if (entry.key != key || entry.wordLength != word.size() || entry.count > MAX_BREAKS) continue;
+    // Loaded tables come from disk, so a break must still land inside the word
+    breaks.clear();
+    for (uint8_t b = 0; b < entry.count; b++) {
+      const size_t offset = entry.breaks[b] & ~INSERTED_HYPHEN;
+      if (offset == 0 || offset >= word.size()) break;
+      breaks.push_back({offset, (entry.breaks[b] & INSERTED_HYPHEN) != 0});
+    }
+    if (breaks.size() != entry.count) continue;
+    stats.hits++;
+    return true;
+  }
+  stats.misses++;
+  return false;
+}
+
+void HyphenationCache::insert(const std::string& word, const bool includeFallback,
+                              const std::vector<Hyphenator::BreakInfo>& breaks) {
+  if (!block || word.size() < MIN_WORD_BYTES || word.size() > MAX_WORD_BYTES || breaks.size() > MAX_BREAKS) return;
+  const uint64_t key = keyFor(word, includeFallback);
+  Slot* table = slots();
+  const uint16_t home = key & (SLOT_COUNT - 1);
+  uint16_t target = home;
+  for (uint16_t i = 0, slot = home; i < PROBE_LIMIT; i++, slot = (slot + 1) & (SLOT_COUNT - 1)) {
+    if (table[slot].key == EMPTY_KEY || table[slot].key == key) {
+      target = slot;
+      break;
+    }
+  }
+  Slot& entry = table[target];
+  if (entry.key != EMPTY_KEY && entry.key != key) stats.evictions++;
+  entry.key = key;
+  entry.wordLength = static_cast<uint8_t>(word.size());
+  entry.count = static_cast<uint8_t>(breaks.size());
+  memset(entry.breaks, 0, sizeof(entry.breaks));
+  for (size_t b = 0; b < breaks.size(); b++) {
+    const uint8_t flag = breaks[b].requiresInsertedHyphen ? INSERTED_HYPHEN : 0;
+    entry.breaks[b] = static_cast<uint8_t>(breaks[b].byteOffset) | flag;
+  }
+  dirty = true;
+}
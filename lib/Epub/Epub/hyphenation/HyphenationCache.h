@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Hyphenator.h"
+
+// Memo of Hyphenator::breakOffsets results for one language, keyed by a hash of the word. A chapter
+// re-hyphenates the same long words many times, and every re-layout (font size, margins) of a book
+// runs them through the Liang patterns again.
+//
+// The table is a fixed open-addressed array of SLOT_COUNT entries, allocated by begin(). Lookups
+// probe a short window; when the window is full the home slot is overwritten. The table is one
+// contiguous block whose bytes are also its on-disk form, so a caller can spill it to the book cache
+// and read it back for the next section (see Section::createSectionFile).
+class HyphenationCache {
+ public:
+  static constexpr uint16_t SLOT_COUNT = 1024;  // power of two; ~24KB
+  static constexpr uint8_t MAX_BREAKS = 14;
+  // Break offsets are packed into 7 bits; longer words are not cached
+  static constexpr size_t MAX_WORD_BYTES = 127;
+  // Shorter words are cheap to hyphenate and would crowd out the long ones
+  static constexpr size_t MIN_WORD_BYTES = 6;
+
+  struct Stats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+  };
+
+  HyphenationCache() = default;
+  ~HyphenationCache() = default;
+  HyphenationCache(const HyphenationCache&) = delete;
+  HyphenationCache& operator=(const HyphenationCache&) = delete;
+
+  // Allocates an empty table for the given primary language tag and its pattern set
+  // (Hyphenator::patternSetId()). Returns false on OOM, leaving the cache inactive.
+  bool begin(const char* languageTag, uint32_t patternSetId);
+  void end();
+  bool isActive() const { return block != nullptr; }
+
+  // The whole table, dataSize() bytes. Read a spilled table into it, then call validateLoaded().
+  uint8_t* data() { return reinterpret_cast<uint8_t*>(block.get()); }
+  static size_t dataSize() { return HEADER_SIZE + SLOT_COUNT * sizeof(Slot); }
+  // Keeps the loaded table if it was written for this language, pattern set and format, else starts empty.
+  bool validateLoaded();
+  // True once an entry was added since begin() or validateLoaded()
+  bool isDirty() const { return dirty; }
+  // Drops every entry
+  void clear();
+
+  bool find(const std::string& word, bool includeFallback, std::vector<Hyphenator::BreakInfo>& breaks);
+  void insert(const std::string& word, bool includeFallback, const std::vector<Hyphenator::BreakInfo>& breaks);
+
+  void resetStats() { stats = Stats{}; }
+  const Stats& getStats() const { return stats; }
+
+ private:
+  static constexpr uint32_t MAGIC = 0x43594850;  // "PHYC"
+  static constexpr uint16_t VERSION = 2;
+  static constexpr uint16_t PROBE_LIMIT = 8;
+  static constexpr uint64_t EMPTY_KEY = 0;  // keyFor never returns it
+  static constexpr uint8_t INSERTED_HYPHEN = 0x80;
+
+  struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t slotCount;
+    char language[8];
+    uint32_t patternSet;
+    uint32_t reserved;
+  };
+  static constexpr size_t HEADER_SIZE = sizeof(Header);
+
+  struct Slot {
+    uint64_t key;
+    uint8_t wordLength;
+    uint8_t count;
+    uint8_t breaks[MAX_BREAKS];  // byte offset | INSERTED_HYPHEN
+  };
+  static_assert(sizeof(Header) % alignof(Slot) == 0, "slots must stay aligned after the header");
+  static_assert(sizeof(Slot) == 24, "Slot must remain compact");
+
+  static uint64_t keyFor(const std::string& word, bool includeFallback);
+  Header& header() { return *reinterpret_cast<Header*>(block.get()); }
+  Slot* slots() { return reinterpret_cast<Slot*>(data() + HEADER_SIZE); }
+
+  std::unique_ptr<uint64_t[]> block;
+  char language[8] = {};
+  uint32_t patternSet = 0;
+  bool dirty = false;
+  Stats stats;
+};
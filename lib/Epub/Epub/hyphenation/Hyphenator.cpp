@@ -6,11 +6,13 @@
 #include <cassert>
 #include <vector>
 
+#include "HyphenationCache.h"
 #include "HyphenationCommon.h"
 #include "LanguageHyphenator.h"
 #include "LanguageRegistry.h"
 
 const LanguageHyphenator* Hyphenator::cachedHyphenator_ = nullptr;
+HyphenationCache* Hyphenator::resultCache_ = nullptr;
 
 namespace {
 
@@ -177,6 +179,19 @@ std::vector<Hyphenator::BreakInfo> Hyphenator::breakOffsets(const std::string& w
     return {};
   }
 
+  std::vector<BreakInfo> breaks;
+  if (resultCache_ && resultCache_->find(word, includeFallback, breaks)) {
+    return breaks;
+  }
+  breaks = computeBreakOffsets(word, includeFallback);
+  if (resultCache_) {
+    resultCache_->insert(word, includeFallback, breaks);
+  }
+  return breaks;
+}
+
+std::vector<Hyphenator::BreakInfo> Hyphenator::computeBreakOffsets(const std::string& word,
+                                                                   const bool includeFallback) {
   // Convert to codepoints and normalize word boundaries.
   auto cps = collectCodepoints(word);
   trimSurroundingPunctuationAndFootnote(cps);
@@ -272,4 +287,19 @@ std::vector<Hyphenator::BreakInfo> Hyphenator::breakOffsets(const std::string& w
   return breaks;
 }
 
-void Hyphenator::setPreferredLanguage(const std::string& lang) { cachedHyphenator_ = hyphenatorForLanguage(lang); }
+void Hyphenator::setPreferredLanguage(const std::string& lang) {
+  cachedHyphenator_ = hyphenatorForLanguage(lang);
+  resultCache_ = nullptr;
+}
+
+const char* Hyphenator::languageTag() {
+  if (!cachedHyphenator_) return nullptr;
+  for (const auto& entry : getLanguageEntries()) {
+    if (entry.hyphenator == cachedHyphenator_) return entry.primaryTag;
+  }
+  return nullptr;
+}
+
+uint32_t Hyphenator::patternSetId() { return cachedHyphenator_ ? cachedHyphenator_->patternSetId() : 0; }
+
+void Hyphenator::setResultCache(HyphenationCache* cache) { resultCache_ = cache; }
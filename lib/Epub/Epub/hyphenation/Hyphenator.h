@@ -1,9 +1,11 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+class HyphenationCache;
 class LanguageHyphenator;
 
 class Hyphenator {
@@ -36,8 +38,21 @@ class Hyphenator {
   static std::vector<BreakInfo> breakOffsets(const std::string& word, bool includeFallback);
 
   // Provide a publication-level language hint (e.g. "en", "en-US", "ru") used to select hyphenation rules.
+  // Also detaches any result cache, which belongs to the previous language.
   static void setPreferredLanguage(const std::string& lang);
 
+  // Primary tag ("en", "de", ...) of the selected rules, or nullptr when the language has none.
+  static const char* languageTag();
+
+  // Identifies the pattern set behind languageTag(), 0 when the language has none.
+  static uint32_t patternSetId();
+
+  // Memoize breakOffsets() in cache (nullptr to stop). It must have been begun for languageTag().
+  static void setResultCache(HyphenationCache* cache);
+
  private:
+  static std::vector<BreakInfo> computeBreakOffsets(const std::string& word, bool includeFallback);
+
   static const LanguageHyphenator* cachedHyphenator_;
+  static HyphenationCache* resultCache_;
 };
\ No newline at end of file
@@ -17,7 +17,23 @@ class LanguageHyphenator {
   size_t minPrefix() const { return config_.minPrefix; }
   size_t minSuffix() const { return config_.minSuffix; }
 
+  // Non-zero FNV-1a hash of the pattern trie and word limits, so results saved by one firmware build
+  // (HyphenationCache) are not reused after the patterns change. Hashed on first use.
+  uint32_t patternSetId() const {
+    if (patternSetId_ == 0) {
+      uint32_t h = 2166136261u;
+      const auto mix = [&h](const uint8_t byte) { h = (h ^ byte) * 16777619u; };
+      for (size_t i = 0; i < patterns_.size; i++) mix(patterns_.data[i]);
+      for (const size_t value : {patterns_.rootOffset, config_.minPrefix, config_.minSuffix}) {
+        for (int shift = 0; shift < 32; shift += 8) mix(static_cast<uint8_t>(value >> shift));
+      }
+      patternSetId_ = h == 0 ? 1 : h;
+    }
+    return patternSetId_;
+  }
+
  protected:
   const SerializedHyphenationPatterns& patterns_;
   LiangWordConfig config_;
+  mutable uint32_t patternSetId_ = 0;
 };
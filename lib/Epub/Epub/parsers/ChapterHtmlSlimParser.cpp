@@ -1,5 +1,6 @@
 #include "ChapterHtmlSlimParser.h"
 
+#include <FontSubsetCollector.h>
 #include <FsHelpers.h>
 #include <GfxRenderer.h>
 #include <HalStorage.h>
@@ -18,8 +19,9 @@
 #include "Epub/converters/ImageToFramebufferDecoder.h"
 #include "Epub/htmlEntities.h"
 
-// Minimum file size (in bytes) to show indexing popup - smaller chapters don't benefit from it
+// Minimum inflated item size (in bytes) to show indexing popup - smaller chapters don't benefit from it
 constexpr size_t MIN_SIZE_FOR_POPUP = 10 * 1024;  // 10KB
+// Chunk size for inflating the spine item straight into expat
 constexpr size_t PARSE_BUFFER_SIZE = 1024;
 
 // Hard cap on the number of anchor IDs recorded per chapter. Legitimate navigation
@@ -37,6 +39,32 @@ constexpr const char* UNDERLINE_TAGS[] = {"u", "ins"};
 constexpr const char* IMAGE_TAGS[] = {"img"};
 constexpr const char* SKIP_TAGS[] = {"head"};
 
+namespace {
+// Print sink that hands each inflated chunk from the ZIP reader directly to expat, so a
+// chapter is parsed in a single pass over the EPUB with no temp file on the SD card.
+class XmlParserSink final : public Print {
+  XML_Parser parser;
+  bool failed = false;
+
+ public:
+  explicit XmlParserSink(XML_Parser parser) : parser(parser) {}
+
+  bool hasFailed() const { return failed; }
+
+  size_t write(const uint8_t data) override { return write(&data, 1); }
+
+  size_t write(const uint8_t* buffer, const size_t size) override {
+    if (failed) return 0;
+    if (XML_Parse(parser, reinterpret_cast<const char*>(buffer), static_cast<int>(size), XML_FALSE) ==
+        XML_STATUS_ERROR) {
+      failed = true;
+      return 0;
+    }
+    return size;
+  }
+};
+}  // namespace
+
 bool isWhitespace(const char c) { return c == ' ' || c == '\r' || c == '\n' || c == '\t'; }
 
 bool matches(const char* tag_name, const char* const* possible_tags, size_t count) {
@@ -186,6 +214,7 @@ void ChapterHtmlSlimParser::flushPartWordBuffer() {
   // flush the buffer
   partWordBuffer[partWordBufferIndex] = '\0';
   currentTextBlock->addWord(partWordBuffer, fontStyle, false, nextWordContinues);
+  if (subsetCollector) subsetCollector->add(partWordBuffer, fontStyle & EpdFontFamily::BOLD_ITALIC);
   partWordBufferIndex = 0;
   nextWordContinues = false;
 }
@@ -213,7 +242,8 @@ void ChapterHtmlSlimParser::startNewTextBlock(const BlockStyle& blockStyle) {
   // If the pending anchor is a TOC chapter boundary, force a page break after the previous
   // block is flushed so the chapter starts on a fresh page.
   flushPendingAnchor();
-  currentTextBlock.reset(new ParsedText(extraParagraphSpacing, hyphenationEnabled, focusReadingEnabled, blockStyle));
+  currentTextBlock.reset(
+      new ParsedText(extraParagraphSpacing, hyphenationEnabled, focusReadingEnabled, blockStyle, optimalLineBreaks));
   wordsExtractedInBlock = 0;
 }
 
@@ -264,13 +294,10 @@ void ChapterHtmlSlimParser::emitHorizontalRule(const BlockStyle& blockStyle) {
 
   currentPageNextY += topSpacing;
 
-  auto pageRule = std::shared_ptr<PageHorizontalRule>(
-      new (std::nothrow) PageHorizontalRule(width, ruleThickness, xPos, currentPageNextY));
-  if (!pageRule) {
+  if (!currentPage->addElement<PageHorizontalRule>(width, ruleThickness, xPos, currentPageNextY)) {
     LOG_ERR("EHP", "Failed to create PageHorizontalRule");
     return;
   }
-  currentPage->elements.push_back(pageRule);
   currentPageNextY = static_cast<int16_t>(currentPageNextY + ruleThickness + bottomSpacing);
 
   if (!pendingAnchorId.empty()) {
@@ -341,7 +368,9 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
   // before tag-specific branches emit any content or metadata.
   CssStyle cssStyle;
   if (self->cssParser) {
-    cssStyle = self->cssParser->resolveStyle(name, classAttr);
+    self->cssAncestors.setDepth(self->depth);
+    cssStyle = self->cssParser->resolveStyle(name, classAttr, &self->cssAncestors);
+    self->cssAncestors.push(name, classAttr);
     if (!styleAttr.empty()) {
       CssStyle inlineStyle = CssParser::parseInlineStyle(styleAttr);
       cssStyle.applyOver(inlineStyle);
@@ -462,7 +491,7 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
 
       // Skip image if CSS display:none
       if (self->cssParser) {
-        CssStyle imgDisplayStyle = self->cssParser->resolveStyle("img", classAttr);
+        CssStyle imgDisplayStyle = self->cssParser->resolveStyle("img", classAttr, &self->cssAncestors);
         if (!styleAttr.empty()) {
           imgDisplayStyle.applyOver(CssParser::parseInlineStyle(styleAttr));
         }
@@ -478,26 +507,12 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
 
         {
           // Resolve the image path relative to the HTML file
-          std::string resolvedPath = FsHelpers::normalisePath(FsHelpers::decodeUriEscapes(self->contentBase + src));
+          const std::string resolvedPath = self->resolveImageHref(src.c_str());
 
           if (ImageDecoderFactory::isFormatSupported(resolvedPath)) {
-            // Create a unique filename for the cached image
-            std::string ext;
-            size_t extPos = resolvedPath.rfind('.');
-            if (extPos != std::string::npos) {
-              ext = resolvedPath.substr(extPos);
-            }
-            std::string cachedImagePath = self->imageBasePath + std::to_string(self->imageCounter++) + ext;
-
-            // Extract image to cache file
-            HalFile cachedImageFile;
-            bool extractSuccess = false;
-            if (Storage.openFileForWrite("EHP", cachedImagePath, cachedImageFile)) {
-              extractSuccess = self->epub->readItemContentsToStream(resolvedPath, cachedImageFile, 4096);
-              cachedImageFile.flush();
-              cachedImageFile.close();
-              delay(50);  // Give SD card time to sync
-            }
+            // The scan pass already extracted the image; the chapter is still being inflated here
+            std::string cachedImagePath;
+            const bool extractSuccess = self->claimStagedImage(resolvedPath, cachedImagePath);
 
             if (extractSuccess) {
               // Get image dimensions
@@ -509,7 +524,9 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
                 int displayWidth = 0;
                 int displayHeight = 0;
                 const float emSize = static_cast<float>(self->renderer.getFontAscenderSize(self->fontId));
-                CssStyle imgStyle = self->cssParser ? self->cssParser->resolveStyle("img", classAttr) : CssStyle{};
+                CssStyle imgStyle = self->cssParser
+                                        ? self->cssParser->resolveStyle("img", classAttr, &self->cssAncestors)
+                                        : CssStyle{};
                 // Merge inline style (e.g. style="height: 2em") so it overrides stylesheet rules
                 if (!styleAttr.empty()) {
                   imgStyle.applyOver(CssParser::parseInlineStyle(styleAttr));
@@ -653,18 +670,22 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
                 self->currentPageNextY += imageMarginTop;
 
                 // Create ImageBlock and add to page
-                auto imageBlock = std::make_shared<ImageBlock>(cachedImagePath, displayWidth, displayHeight);
+                auto imageBlock =
+                    std::make_shared<ImageBlock>(cachedImagePath, resolvedPath, displayWidth, displayHeight);
                 if (!imageBlock) {
                   LOG_ERR("EHP", "Failed to create ImageBlock");
                   return;
                 }
                 int xPos = (self->viewportWidth - displayWidth) / 2;
-                auto pageImage = std::make_shared<PageImage>(imageBlock, xPos, self->currentPageNextY);
-                if (!pageImage) {
+                // Decoded into the final-size pixel cache once the chapter stream is closed, rather than
+                // on the first page view
+                self->pendingImageDecodes.push_back(
+                    {imageBlock, static_cast<int16_t>(self->imageOriginX + xPos),
+                     static_cast<int16_t>(self->imageOriginY + self->currentPageNextY)});
+                if (!self->currentPage->addElement<PageImage>(imageBlock, xPos, self->currentPageNextY)) {
                   LOG_ERR("EHP", "Failed to create PageImage");
                   return;
                 }
-                self->currentPage->elements.push_back(pageImage);
                 self->currentPageNextY += displayHeight + imageMarginBottom;
 
                 // The image consumed the empty block's accumulated vertical spacing.
@@ -829,6 +850,7 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
 
       if (strcmp(name, "li") == 0) {
         self->currentTextBlock->addWord("\xe2\x80\xa2", EpdFontFamily::REGULAR);
+        if (self->subsetCollector) self->subsetCollector->add(0x2022, EpdFontFamily::REGULAR);
       }
     }
   } else if (matches(name, UNDERLINE_TAGS, std::size(UNDERLINE_TAGS))) {
@@ -1120,7 +1142,7 @@ void XMLCALL ChapterHtmlSlimParser::characterData(void* userData, const XML_Char
                                         : self->viewportWidth;
     self->currentTextBlock->layoutAndExtractLines(
         self->renderer, self->fontId, effectiveWidth,
-        [self](const std::shared_ptr<TextBlock>& textBlock) { self->addLineToPage(textBlock); }, false);
+        [self](TextBlock&& textBlock) { self->addLineToPage(std::move(textBlock)); }, false);
   }
 }
 
@@ -1261,6 +1283,111 @@ void XMLCALL ChapterHtmlSlimParser::endElement(void* userData, const XML_Char* n
   }
 }
 
+std::string ChapterHtmlSlimParser::resolveImageHref(const char* src) const {
+  return FsHelpers::normalisePath(FsHelpers::decodeUriEscapes(contentBase + src));
+}
+
+void XMLCALL ChapterHtmlSlimParser::imageScanStartElement(void* userData, const XML_Char* name,
+                                                          const XML_Char** atts) {
+  auto* self = static_cast<ChapterHtmlSlimParser*>(userData);
+  if (!matches(name, IMAGE_TAGS, std::size(IMAGE_TAGS))) return;
+  const char* src = getAttribute(atts, "src");
+  if (!src || src[0] == '\0') return;
+
+  std::string href = self->resolveImageHref(src);
+  if (!ImageDecoderFactory::isFormatSupported(href)) return;
+  for (const auto& staged : self->stagedImages) {
+    if (staged.href == href) return;
+  }
+  self->stagedImages.push_back({std::move(href), {}, false});
+}
+
+void ChapterHtmlSlimParser::stageImages() {
+  // Scan pass: collect the chapter's image hrefs without laying anything out. The hidden ones (CSS
+  // display:none) are collected too, and removed again after the layout pass.
+  XML_Parser parser = XML_ParserCreate(nullptr);
+  if (!parser) {
+    LOG_ERR("EHP", "Couldn't allocate memory for image scan parser");
+    return;
+  }
+  XML_SetUserData(parser, this);
+  XML_SetStartElementHandler(parser, imageScanStartElement);
+  XML_SetDefaultHandlerExpand(parser, [](void*, const XML_Char*, int) {});
+  XmlParserSink sink(parser);
+  const bool streamed = epub->readItemContentsToStream(itemHref, sink, PARSE_BUFFER_SIZE);
+  if (sink.hasFailed() || !streamed || XML_Parse(parser, nullptr, 0, XML_TRUE) == XML_STATUS_ERROR) {
+    // The layout pass reports the error; images found before it are still extracted
+    LOG_DBG("EHP", "Image scan stopped early: %s", itemHref.c_str());
+  } else {
+    imageFree = stagedImages.empty();
+  }
+  destroyXmlParser(parser);
+
+  // Only now, with the chapter stream closed, inflate the images: one ZIP entry at a time
+  for (auto& staged : stagedImages) {
+    const size_t extPos = staged.href.rfind('.');
+    const std::string ext = extPos != std::string::npos ? staged.href.substr(extPos) : std::string{};
+    const std::string path = imageBasePath + std::to_string(imageCounter++) + ext;
+
+    HalFile cachedImageFile;
+    bool extractSuccess = false;
+    if (Storage.openFileForWrite("EHP", path, cachedImageFile)) {
+      extractSuccess = epub->readItemContentsToStream(staged.href, cachedImageFile, 4096);
+      cachedImageFile.flush();
+      cachedImageFile.close();
+      delay(50);  // Give SD card time to sync
+    }
+    if (extractSuccess) {
+      staged.path = path;
+    } else {
+      LOG_ERR("EHP", "Failed to extract image: %s", staged.href.c_str());
+      Storage.remove(path.c_str());
+    }
+  }
+}
+
+bool ChapterHtmlSlimParser::claimStagedImage(const std::string& href, std::string& imagePath) {
+  for (auto& staged : stagedImages) {
+    if (staged.href != href) continue;
+    if (staged.path.empty()) return false;
+    if (!staged.claimed) {
+      staged.claimed = true;
+      imagePath = staged.path;
+      return true;
+    }
+
+    // Each ImageBlock owns its pixel cache, so a repeated image gets its own copy of the source
+    const size_t extPos = staged.path.rfind('.');
+    imagePath = imageBasePath + std::to_string(imageCounter++) +
+                (extPos != std::string::npos ? staged.path.substr(extPos) : std::string{});
+    HalFile copy;
+    if (!Storage.openFileForWrite("EHP", imagePath, copy)) return false;
+    const bool copied = Storage.readFileToStream(staged.path.c_str(), copy, 4096);
+    copy.close();
+    if (!copied) Storage.remove(imagePath.c_str());
+    return copied;
+  }
+  return false;
+}
+
+void ChapterHtmlSlimParser::finishImages(const bool decode) {
+  if (decode) {
+    // A complete pixel cache replaces the extracted source image. render() extracts it from the EPUB
+    // again if the cache later goes missing or fails to read.
+    for (const auto& pending : pendingImageDecodes) {
+      if (pending.block->decodeToCache(renderer, pending.x, pending.y) && pending.block->cacheIsValid()) {
+        Storage.remove(pending.block->getImagePath().c_str());
+      }
+    }
+  }
+  pendingImageDecodes.clear();
+
+  for (const auto& staged : stagedImages) {
+    if (!staged.claimed && !staged.path.empty()) Storage.remove(staged.path.c_str());
+  }
+  stagedImages.clear();
+}
+
 bool ChapterHtmlSlimParser::parseAndBuildPages() {
   // Initialize block style stack with a root entry representing "no ancestor block elements".
   // The user's paragraph alignment is set as the default so child elements without explicit
@@ -1279,11 +1406,21 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   paragraphAlignmentBlockStyle.alignment = align;
   startNewTextBlock(paragraphAlignmentBlockStyle);
 
+  // Get inflated item size to decide whether to show indexing popup.
+  size_t itemSize = 0;
+  if (popupFn && epub->getItemSize(itemHref, &itemSize) && itemSize >= MIN_SIZE_FOR_POPUP) {
+    popupFn();
+  }
+
+  if (imageRendering == 0 && !imageFree) {
+    stageImages();
+  }
+
   XML_Parser parser = XML_ParserCreate(nullptr);
-  int done;
 
   if (!parser) {
     LOG_ERR("EHP", "Couldn't allocate memory for parser");
+    finishImages(false);
     return false;
   }
 
@@ -1291,55 +1428,33 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   // Using DefaultHandlerExpand preserves normal entity expansion from DOCTYPE
   XML_SetDefaultHandlerExpand(parser, defaultHandlerExpand);
 
-  HalFile file;
-  if (!Storage.openFileForRead("EHP", filepath, file)) {
-    destroyXmlParser(parser);
-    return false;
-  }
-
-  // Get file size to decide whether to show indexing popup.
-  if (popupFn && file.size() >= MIN_SIZE_FOR_POPUP) {
-    popupFn();
-  }
-
   XML_SetUserData(parser, this);
   XML_SetElementHandler(parser, startElement, endElement);
   XML_SetCharacterDataHandler(parser, characterData);
 
   // Compute the time taken to parse and build pages
   const uint32_t chapterStartTime = millis();
-  do {
-    void* const buf = XML_GetBuffer(parser, PARSE_BUFFER_SIZE);
-    if (!buf) {
-      LOG_ERR("EHP", "Couldn't allocate memory for buffer");
-      destroyXmlParser(parser);
-      file.close();
-      return false;
-    }
+  XmlParserSink sink(parser);
+  const bool streamed = epub->readItemContentsToStream(itemHref, sink, PARSE_BUFFER_SIZE);
 
-    const size_t len = file.read(buf, PARSE_BUFFER_SIZE);
-
-    if (len == 0 && file.available() > 0) {
-      LOG_ERR("EHP", "File read error");
-      destroyXmlParser(parser);
-      file.close();
-      return false;
-    }
-
-    done = file.available() == 0;
+  if (sink.hasFailed() || (streamed && XML_Parse(parser, nullptr, 0, XML_TRUE) == XML_STATUS_ERROR)) {
+    LOG_ERR("EHP", "Parse error at line %lu:\n%s", XML_GetCurrentLineNumber(parser),
+            XML_ErrorString(XML_GetErrorCode(parser)));
+    destroyXmlParser(parser);
+    finishImages(false);
+    return false;
+  }
 
-    if (XML_ParseBuffer(parser, static_cast<int>(len), done) == XML_STATUS_ERROR) {
-      LOG_ERR("EHP", "Parse error at line %lu:\n%s", XML_GetCurrentLineNumber(parser),
-              XML_ErrorString(XML_GetErrorCode(parser)));
-      destroyXmlParser(parser);
-      file.close();
-      return false;
-    }
-  } while (!done);
+  if (!streamed) {
+    LOG_ERR("EHP", "Failed to stream item contents: %s", itemHref.c_str());
+    destroyXmlParser(parser);
+    finishImages(false);
+    return false;
+  }
   LOG_DBG("EHP", "Time to parse and build pages: %lu ms", millis() - chapterStartTime);
 
   destroyXmlParser(parser);
-  file.close();
+  finishImages(true);
 
   // Process last page if there is still text
   if (currentTextBlock) {
@@ -1357,7 +1472,7 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   return true;
 }
 
-void ChapterHtmlSlimParser::addLineToPage(std::shared_ptr<TextBlock> line) {
+void ChapterHtmlSlimParser::addLineToPage(TextBlock&& line) {
   const int lineHeight = renderer.getLineHeight(fontId) * lineCompression;
 
   if (!currentPage) {
@@ -1373,7 +1488,7 @@ void ChapterHtmlSlimParser::addLineToPage(std::shared_ptr<TextBlock> line) {
   }
 
   // Track cumulative words to assign footnotes to the page containing their anchor
-  wordsExtractedInBlock += line->wordCount();
+  wordsExtractedInBlock += line.wordCount();
   auto footnoteIt = pendingFootnotes.begin();
   while (footnoteIt != pendingFootnotes.end() && footnoteIt->first <= wordsExtractedInBlock) {
     currentPage->addFootnote(footnoteIt->second.number, footnoteIt->second.href);
@@ -1382,8 +1497,11 @@ void ChapterHtmlSlimParser::addLineToPage(std::shared_ptr<TextBlock> line) {
   pendingFootnotes.erase(pendingFootnotes.begin(), footnoteIt);
 
   // Apply horizontal left inset (margin + padding) as x position offset
-  const int16_t xOffset = line->getBlockStyle().leftInset();
-  currentPage->elements.push_back(std::make_shared<PageLine>(line, xOffset, currentPageNextY));
+  const int16_t xOffset = line.getBlockStyle().leftInset();
+  if (!currentPage->addElement<PageLine>(std::move(line), xOffset, currentPageNextY)) {
+    LOG_ERR("EHP", "Failed to create PageLine");
+    return;
+  }
   currentPageNextY += lineHeight;
 }
 
@@ -1416,7 +1534,7 @@ void ChapterHtmlSlimParser::makePages() {
 
   currentTextBlock->layoutAndExtractLines(
       renderer, fontId, effectiveWidth,
-      [this](const std::shared_ptr<TextBlock>& textBlock) { addLineToPage(textBlock); });
+      [this](TextBlock&& textBlock) { addLineToPage(std::move(textBlock)); });
 
   // Fallback: transfer any remaining pending footnotes to current page.
   // Normally addLineToPage handles this via word-index tracking, but this catches
@@ -12,18 +12,20 @@
 #include "Epub/ParsedText.h"
 #include "Epub/blocks/ImageBlock.h"
 #include "Epub/blocks/TextBlock.h"
+#include "Epub/css/CssAncestorStack.h"
 #include "Epub/css/CssParser.h"
 #include "Epub/css/CssStyle.h"
 
 class Page;
 class GfxRenderer;
 class Epub;
+class FontSubsetCollector;
 
 #define MAX_WORD_SIZE 200
 
 class ChapterHtmlSlimParser {
   std::shared_ptr<Epub> epub;
-  const std::string& filepath;
+  const std::string& itemHref;  // spine item path inside the EPUB, inflated straight into expat
   GfxRenderer& renderer;
   std::function<void(std::unique_ptr<Page>, uint16_t, uint16_t)> completePageFn;
   std::function<void()> popupFn;  // Popup callback
@@ -48,12 +50,32 @@ class ChapterHtmlSlimParser {
   uint16_t viewportHeight;
   bool hyphenationEnabled;
   bool focusReadingEnabled;
+  bool optimalLineBreaks;
   const CssParser* cssParser;
+  CssAncestorStack cssAncestors;  // open elements, for descendant/child selectors
   bool embeddedStyle;
   uint8_t imageRendering;
   std::string contentBase;
   std::string imageBasePath;
   int imageCounter = 0;
+  // Images are extracted from the EPUB between a scan pass and the layout pass, and decoded into their pixel
+  // caches after it, so neither competes with the chapter's inflate window for heap
+  struct StagedImage {
+    std::string href;  // resolved path inside the EPUB
+    std::string path;  // extracted copy on the SD card
+    bool claimed = false;
+  };
+  std::vector<StagedImage> stagedImages;
+  struct PendingImageDecode {
+    std::shared_ptr<ImageBlock> block;
+    int16_t x;  // screen position the block renders at
+    int16_t y;
+  };
+  std::vector<PendingImageDecode> pendingImageDecodes;
+  bool imageFree = false;  // the chapter references no decodable image, so the scan pass is skipped
+  int16_t imageOriginX = 0;
+  int16_t imageOriginY = 0;
+  FontSubsetCollector* subsetCollector = nullptr;  // optional: records glyphs for the book's font subset
 
   // Style tracking (replaces depth-based approach)
   struct StyleStackEntry {
@@ -103,18 +125,24 @@ class ChapterHtmlSlimParser {
   void makePages();
   static void applyDirectionToEntry(StyleStackEntry& entry, const CssStyle& css);
   void emitHorizontalRule(const BlockStyle& blockStyle);
+  std::string resolveImageHref(const char* src) const;
+  void stageImages();
+  bool claimStagedImage(const std::string& href, std::string& imagePath);
+  // Decodes the queued images (unless the build failed) and removes extracted images no block uses
+  void finishImages(bool decode);
   // XML callbacks
   static void XMLCALL startElement(void* userData, const XML_Char* name, const XML_Char** atts);
   static void XMLCALL characterData(void* userData, const XML_Char* s, int len);
   static void XMLCALL defaultHandlerExpand(void* userData, const XML_Char* s, int len);
   static void XMLCALL endElement(void* userData, const XML_Char* name);
+  static void XMLCALL imageScanStartElement(void* userData, const XML_Char* name, const XML_Char** atts);
 
  public:
-  explicit ChapterHtmlSlimParser(std::shared_ptr<Epub> epub, const std::string& filepath, GfxRenderer& renderer,
+  explicit ChapterHtmlSlimParser(std::shared_ptr<Epub> epub, const std::string& itemHref, GfxRenderer& renderer,
                                  const int fontId, const float lineCompression, const bool extraParagraphSpacing,
                                  const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                                  const uint16_t viewportHeight, const bool hyphenationEnabled,
-                                 const bool focusReadingEnabled,
+                                 const bool focusReadingEnabled, const bool optimalLineBreaks,
                                  const std::function<void(std::unique_ptr<Page>, uint16_t, uint16_t)>& completePageFn,
                                  const bool embeddedStyle, const std::string& contentBase,
                                  const std::string& imageBasePath, const uint8_t imageRendering = 0,
@@ -122,8 +150,10 @@ class ChapterHtmlSlimParser {
                                  const std::function<void()>& popupFn = nullptr, const CssParser* cssParser = nullptr)
 
       : epub(epub),
-        filepath(filepath),
+        itemHref(itemHref),
         renderer(renderer),
+        completePageFn(completePageFn),
+        popupFn(popupFn),
         fontId(fontId),
         lineCompression(lineCompression),
         extraParagraphSpacing(extraParagraphSpacing),
@@ -132,8 +162,7 @@ class ChapterHtmlSlimParser {
         viewportHeight(viewportHeight),
         hyphenationEnabled(hyphenationEnabled),
         focusReadingEnabled(focusReadingEnabled),
-        completePageFn(completePageFn),
-        popupFn(popupFn),
+        optimalLineBreaks(optimalLineBreaks),
         cssParser(cssParser),
         embeddedStyle(embeddedStyle),
         imageRendering(imageRendering),
@@ -142,7 +171,17 @@ class ChapterHtmlSlimParser {
         tocAnchors(std::move(tocAnchors)) {}
 
   ~ChapterHtmlSlimParser() = default;
+  void setFontSubsetCollector(FontSubsetCollector* collector) { subsetCollector = collector; }
+  // Screen position of the viewport's top-left corner, where pages are rendered
+  // Skip the image scan pass for a chapter already known to reference no images
+  void setImageFree(const bool free) { imageFree = free; }
+  // True when the chapter was known, or found by a complete scan pass, to reference no images
+  bool isImageFree() const { return imageFree; }
+  void setImageOrigin(const int16_t x, const int16_t y) {
+    imageOriginX = x;
+    imageOriginY = y;
+  }
   bool parseAndBuildPages();
-  void addLineToPage(std::shared_ptr<TextBlock> line);
+  void addLineToPage(TextBlock&& line);
   const std::vector<std::pair<std::string, uint16_t>>& getAnchors() const { return anchorData; }
 };
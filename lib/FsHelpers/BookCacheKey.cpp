@@ -0,0 +1,244 @@
+#include "BookCacheKey.h"
+
+#include <HalStorage.h>
+#include <Logging.h>
+#include <Memory.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace BookCacheKey {
+
+namespace {
+// Version 2: copies of one book at different paths get separate keys
+constexpr uint8_t INDEX_VERSION = 2;
+constexpr char INDEX_FILE[] = "/cache_keys.bin";
+// Oldest entries are dropped beyond this; a dropped book is simply re-hashed the next time it opens
+constexpr size_t MAX_INDEX_ENTRIES = 128;
+// Bytes hashed from each end of a file that isn't a ZIP
+constexpr size_t EDGE_BYTES = 4096;
+constexpr size_t EOCD_SIZE = 22;
+constexpr size_t EOCD_SCAN = 1024;
+constexpr size_t CHUNK_SIZE = 512;
+
+struct IndexEntry {
+  std::string path;
+  uint32_t size;
+  uint64_t fingerprint;
+};
+
+bool enabled = false;
+// The index of the last cache dir used; in practice there is only /.crosspoint
+std::string indexDir;
+std::vector<IndexEntry> index;
+
+uint64_t fnv1a(uint64_t h, const uint8_t* data, const size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    h ^= data[i];
+    h *= 0x100000001B3ull;
+  }
+  return h;
+}
+
+uint32_t readLe32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16 |
+         static_cast<uint32_t>(p[3]) << 24;
+}
+
+bool hashRange(HalFile& file, const size_t offset, size_t length, uint8_t* buffer, uint64_t& h) {
+  if (!file.seek(offset)) return false;
+  while (length > 0) {
+    const size_t want = std::min(length, CHUNK_SIZE);
+    if (file.read(buffer, want) != static_cast<int>(want)) return false;
+    h = fnv1a(h, buffer, want);
+    length -= want;
+  }
+  return true;
+}
+
+// Hashes the central directory and EOCD record. Returns false if the file doesn't look like a ZIP.
+bool hashZipDirectory(HalFile& file, const size_t fileSize, uint8_t* buffer, uint64_t& h) {
+  if (fileSize < EOCD_SIZE) return false;
+  const size_t scanRange = std::min(fileSize, EOCD_SCAN);
+  auto tail = makeUniqueNoThrow<uint8_t[]>(scanRange);
+  if (!tail) {
+    LOG_ERR("BCK", "OOM: EOCD scan buffer");
+    return false;
+  }
+  if (!file.seek(fileSize - scanRange) || file.read(tail.get(), scanRange) != static_cast<int>(scanRange)) {
+    return false;
+  }
+
+  for (size_t i = scanRange - EOCD_SIZE + 1; i-- > 0;) {
+    if (readLe32(&tail[i]) != 0x06054b50) continue;
+    const uint32_t dirSize = readLe32(&tail[i + 12]);
+    const uint32_t dirOffset = readLe32(&tail[i + 16]);
+    if (static_cast<uint64_t>(dirOffset) + dirSize > fileSize) return false;
+    h = fnv1a(h, &tail[i], EOCD_SIZE);
+    return hashRange(file, dirOffset, dirSize, buffer, h);
+  }
+  return false;
+}
+
+std::string pathKey(const std::string& filepath) { return std::to_string(std::hash<std::string>{}(filepath)); }
+
+std::string fingerprintKey(const uint64_t fingerprint) {
+  char key[17];
+  snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(fingerprint));
+  return key;
+}
+
+void loadIndex(const std::string& cacheDir) {
+  if (indexDir == cacheDir) return;
+  indexDir = cacheDir;
+  index.clear();
+
+  HalFile file;
+  const std::string indexPath = cacheDir + INDEX_FILE;
+  if (!Storage.exists(indexPath.c_str()) || !Storage.openFileForRead("BCK", indexPath, file)) return;
+  const size_t fileSize = file.size();
+  auto data = makeUniqueNoThrow<uint8_t[]>(fileSize);
+  if (!data || file.read(data.get(), fileSize) != static_cast<int>(fileSize)) {
+    LOG_ERR("BCK", "Failed to read cache key index");
+    return;
+  }
+  file.close();
+
+  serialization::BufferReader reader(data.get(), fileSize);
+  uint8_t version = 0;
+  uint16_t count = 0;
+  serialization::readPod(reader, version);
+  serialization::readPod(reader, count);
+  if (version != INDEX_VERSION) {
+    LOG_DBG("BCK", "Ignoring cache key index version %u", version);
+    return;
+  }
+  index.reserve(std::min<size_t>(count, MAX_INDEX_ENTRIES));
+  for (uint16_t i = 0; i < count && reader.remaining() > 0; i++) {
+    IndexEntry entry;
+    serialization::readString(reader, entry.path);
+    serialization::readPod(reader, entry.size);
+    if (reader.read(&entry.fingerprint, sizeof(entry.fingerprint)) != sizeof(entry.fingerprint)) break;
+    index.push_back(std::move(entry));
+  }
+}
+
+void saveIndex() {
+  HalFile file;
+  if (!Storage.openFileForWrite("BCK", indexDir + INDEX_FILE, file)) return;
+  serialization::writePod(file, INDEX_VERSION);
+  serialization::writePod(file, static_cast<uint16_t>(index.size()));
+  for (const auto& entry : index) {
+    serialization::writeString(file, entry.path);
+    serialization::writePod(file, entry.size);
+    serialization::writePod(file, entry.fingerprint);
+  }
+  file.close();
+}
+
+std::vector<IndexEntry>::iterator findEntry(const std::string& path) {
+  return std::find_if(index.begin(), index.end(), [&](const IndexEntry& entry) { return entry.path == path; });
+}
+
+// True if a book at another path that still exists uses this fingerprint
+bool fingerprintInUse(const uint64_t fingerprint, const std::string& path) {
+  return std::any_of(index.begin(), index.end(), [&](const IndexEntry& entry) {
+    return entry.fingerprint == fingerprint && entry.path != path && Storage.exists(entry.path.c_str());
+  });
+}
+}  // namespace
+
+void setContentKeysEnabled(const bool value) { enabled = value; }
+
+bool contentKeysEnabled() { return enabled; }
+
+bool computeFingerprint(const std::string& filepath, uint64_t& fingerprint) {
+  HalFile file;
+  if (!Storage.openFileForRead("BCK", filepath, file)) return false;
+  const size_t fileSize = file.size();
+  uint8_t buffer[CHUNK_SIZE];
+
+  uint64_t h = 0xCBF29CE484222325ull;
+  for (int shift = 0; shift < 32; shift += 8) {
+    const uint8_t byte = static_cast<uint8_t>(static_cast<uint32_t>(fileSize) >> shift);
+    h = fnv1a(h, &byte, 1);
+  }
+  const uint64_t seed = h;
+
+  if (!hashZipDirectory(file, fileSize, buffer, h)) {
+    h = seed;
+    const size_t head = std::min(fileSize, EDGE_BYTES);
+    const size_t tail = std::min(fileSize - head, EDGE_BYTES);
+    if (!hashRange(file, 0, head, buffer, h) || !hashRange(file, fileSize - tail, tail, buffer, h)) {
+      LOG_ERR("BCK", "Failed to read %s", filepath.c_str());
+      return false;
+    }
+  }
+  fingerprint = h;
+  return true;
+}
+
+std::string cachePathFor(const std::string& cacheDir, const char* prefix, const std::string& filepath) {
+  const std::string base = cacheDir + "/" + prefix;
+  if (!enabled) return base + pathKey(filepath);
+
+  HalFile file;
+  if (!Storage.openFileForRead("BCK", filepath, file)) return base + pathKey(filepath);
+  const auto fileSize = static_cast<uint32_t>(file.size());
+  file.close();
+
+  loadIndex(cacheDir);
+  const auto it = findEntry(filepath);
+  if (it != index.end() && it->size == fileSize) return base + fingerprintKey(it->fingerprint);
+
+  uint64_t fingerprint = 0;
+  if (!computeFingerprint(filepath, fingerprint)) return base + pathKey(filepath);
+  if (it != index.end()) index.erase(it);
+  if (fingerprintInUse(fingerprint, filepath)) {
+    // A second copy of a book that is still on the card gets its own cache, so the copies don't share
+    // reading progress and deleting one leaves the other's cache alone
+    fingerprint = fnv1a(fingerprint, reinterpret_cast<const uint8_t*>(filepath.data()), filepath.size());
+  } else {
+    // Entries whose file is gone were this book before it was moved or re-copied; it takes their cache over
+    index.erase(std::remove_if(index.begin(), index.end(),
+                               [&](const IndexEntry& entry) { return entry.fingerprint == fingerprint; }),
+                index.end());
+  }
+  if (index.size() >= MAX_INDEX_ENTRIES) index.erase(index.begin());
+  index.push_back({filepath, fileSize, fingerprint});
+  saveIndex();
+  LOG_DBG("BCK", "Fingerprinted %s -> %016llx", filepath.c_str(), static_cast<unsigned long long>(fingerprint));
+  return base + fingerprintKey(fingerprint);
+}
+
+void notePathMoved(const std::string& cacheDir, const std::string& oldPath, const std::string& newPath) {
+  if (!enabled) return;
+  loadIndex(cacheDir);
+  if (findEntry(oldPath) == index.end()) return;
+  // A book moved over another one replaces it, and the old fingerprint no longer applies to that path
+  const auto replaced = findEntry(newPath);
+  if (replaced != index.end()) index.erase(replaced);
+  findEntry(oldPath)->path = newPath;
+  saveIndex();
+}
+
+bool cacheSharedWithOtherPath(const std::string& cacheDir, const std::string& path) {
+  if (!enabled) return false;
+  loadIndex(cacheDir);
+  const auto it = findEntry(path);
+  return it != index.end() && fingerprintInUse(it->fingerprint, path);
+}
+
+void forgetPath(const std::string& cacheDir, const std::string& path) {
+  if (!enabled) return;
+  loadIndex(cacheDir);
+  const auto it = findEntry(path);
+  if (it == index.end()) return;
+  index.erase(it);
+  saveIndex();
+}
+
+}  // namespace BookCacheKey
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Names the per-book cache directory (<cacheDir>/<prefix><key>) shared by Epub, Xtc and Txt.
+//
+// By default the key is std::hash of the file path, so renaming or moving a book orphans its cache.
+// With content keys enabled the key is a fingerprint of the file instead: its size mixed with a hash of
+// the ZIP central directory (which carries every entry's CRC32) for EPUBs, or of the leading and
+// trailing bytes (the XTC header and page table) for other files. Fingerprints are remembered in a
+// small path -> (size, fingerprint) index stored in the cache dir, so opening a known book costs one
+// file open and moving a book only re-hashes it once. A copy of a book that is still on the card at
+// another path has the path mixed into its key, so each copy keeps its own cache and progress.
+namespace BookCacheKey {
+
+void setContentKeysEnabled(bool enabled);
+bool contentKeysEnabled();
+
+// Returns <cacheDir>/<prefix><key> for the book. Falls back to the path key when the file can't be read.
+std::string cachePathFor(const std::string& cacheDir, const char* prefix, const std::string& filepath);
+
+// Hashes the file contents as described above. Returns false if the file can't be opened.
+bool computeFingerprint(const std::string& filepath, uint64_t& fingerprint);
+
+// Keep the index in step with file operations. notePathMoved lets a moved book keep its fingerprint
+// without re-hashing; forgetPath drops an entry whose file is being deleted or replaced.
+void notePathMoved(const std::string& cacheDir, const std::string& oldPath, const std::string& newPath);
+void forgetPath(const std::string& cacheDir, const std::string& path);
+// True when another book still on the card uses this path's cache, which must then be kept on delete.
+// Only indexes written before copies got separate keys, or an entry evicted from the index, lead here.
+bool cacheSharedWithOtherPath(const std::string& cacheDir, const std::string& path);
+
+}  // namespace BookCacheKey
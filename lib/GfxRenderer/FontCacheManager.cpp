@@ -14,6 +14,7 @@ void FontCacheManager::setFontDecompressor(FontDecompressor* d) { fontDecompress
 
 void FontCacheManager::clearCache() {
   if (fontDecompressor_) fontDecompressor_->clearCache();
+  glyphCoverageCache_.end();
   for (auto& [id, font] : sdCardFonts_) {
     font->clearCache();
   }
@@ -45,8 +46,18 @@ void FontCacheManager::prewarmCache(int fontId, const char* utf8Text, uint8_t st
   }
 }
 
+bool FontCacheManager::enableGlyphCoverageCache(const uint32_t budgetBytes) {
+  return glyphCoverageCache_.begin(budgetBytes);
+}
+
+bool FontCacheManager::enableWordWidthCache() { return wordWidthCache_.begin(); }
+
+void FontCacheManager::disableWordWidthCache() { wordWidthCache_.end(); }
+
 void FontCacheManager::logStats(const char* label) {
   if (fontDecompressor_) fontDecompressor_->logStats(label);
+  if (glyphCoverageCache_.isActive()) glyphCoverageCache_.logStats(label);
+  if (wordWidthCache_.isActive()) wordWidthCache_.logStats(label);
   for (auto& [id, font] : sdCardFonts_) {
     font->logStats(label);
   }
@@ -54,6 +65,8 @@ void FontCacheManager::logStats(const char* label) {
 
 void FontCacheManager::resetStats() {
   if (fontDecompressor_) fontDecompressor_->resetStats();
+  glyphCoverageCache_.resetStats();
+  wordWidthCache_.resetStats();
   for (auto& [id, font] : sdCardFonts_) {
     font->resetStats();
   }
@@ -6,6 +6,9 @@
 #include <map>
 #include <string>
 
+#include "GlyphCoverageCache.h"
+#include "WordWidthCache.h"
+
 class FontDecompressor;
 class SdCardFont;
 
@@ -27,6 +30,23 @@ class FontCacheManager {
   // The FontDecompressor pointer, needed by GfxRenderer::getGlyphBitmap()
   FontDecompressor* getDecompressor() const { return fontDecompressor_; }
 
+  // Opt-in glyph coverage cache for pages drawn in several passes (anti-aliased text). Lives until
+  // the next clearCache(), i.e. the end of the current PrewarmScope. Returns false on OOM, in which
+  // case rendering simply stays uncached.
+  bool enableGlyphCoverageCache(uint32_t budgetBytes = GlyphCoverageCache::DEFAULT_BUDGET_BYTES);
+  // nullptr unless enabled for the current page
+  GlyphCoverageCache* getGlyphCoverageCache() {
+    return glyphCoverageCache_.isActive() ? &glyphCoverageCache_ : nullptr;
+  }
+
+  // Opt-in memo of GfxRenderer::getTextAdvanceX results, enabled for the duration of a layout pass
+  // (e.g. a Section build). Independent of clearCache(). Returns false on OOM, in which case words
+  // are simply measured every time.
+  bool enableWordWidthCache();
+  void disableWordWidthCache();
+  // nullptr unless enabled
+  WordWidthCache* getWordWidthCache() { return wordWidthCache_.isActive() ? &wordWidthCache_ : nullptr; }
+
   // RAII scope for two-pass prewarm pattern
   class PrewarmScope {
    public:
@@ -48,6 +68,8 @@ class FontCacheManager {
   const std::map<int, EpdFontFamily>& fontMap_;
   const std::map<int, SdCardFont*>& sdCardFonts_;
   FontDecompressor* fontDecompressor_ = nullptr;
+  GlyphCoverageCache glyphCoverageCache_;
+  WordWidthCache wordWidthCache_;
 
   enum class ScanMode : uint8_t { None, Scanning };
   ScanMode scanMode_ = ScanMode::None;
@@ -54,6 +54,17 @@ const uint8_t* GfxRenderer::getGlyphBitmap(const EpdFontData* fontData, const Ep
   return &fontData->bitmap[glyph->dataOffset];
 }
 
+bool GfxRenderer::hasStableGlyphBitmap(const EpdFontData* fontData, const EpdGlyph* glyph) const {
+  if (fontData->groups != nullptr) {
+    auto* fd = fontCacheManager_ ? fontCacheManager_->getDecompressor() : nullptr;
+    return fd && fd->getPageBitmap(fontData, static_cast<uint32_t>(glyph - fontData->glyph)) != nullptr;
+  }
+  if (fontData->glyphMissCtx) {
+    return !SdCardFont::fromMissCtx(fontData->glyphMissCtx)->isOverflowGlyph(glyph);
+  }
+  return true;
+}
+
 void GfxRenderer::ensureSdCardFontReady(int fontId, const char* utf8Text, uint8_t styleMask) const {
   auto it = sdCardFonts_.find(fontId);
   if (it != sdCardFonts_.end()) {
@@ -136,6 +147,421 @@ static inline void rotateCoordinates(const GfxRenderer::Orientation orientation,
 
 enum class TextRotation { None, Rotated90CW };
 
+// Glyph blitting. Glyphs are decoded 8 rows at a time into a 1-bit ink mask
+// (MSB-first, one byte per 8 glyph columns) for the active RenderMode, then
+// written into the framebuffer / strip target a byte at a time instead of
+// through drawPixel. Each Orientation x TextRotation pair maps glyph rows either
+// onto physical rows (written as byte spans) or onto physical columns (written
+// as transposed 8x8 tiles); which one, and in which direction, is fixed at
+// compile time.
+namespace {
+
+constexpr int GLYPH_BAND_ROWS = 8;
+constexpr int GLYPH_BAND_STRIDE = 32;  // EpdGlyph::width is a uint8_t, so at most 256 / 8 bytes per row
+
+using GlyphBand = uint8_t[GLYPH_BAND_ROWS][GLYPH_BAND_STRIDE];
+
+// How physical (x, y) change per glyph column (gx) and glyph row (gy).
+struct GlyphMapping {
+  int pxPerGx, pxPerGy, pyPerGx, pyPerGy;
+};
+
+// Turns logical steps per glyph column / row into physical ones: the same transforms as rotateCoordinates.
+template <GfxRenderer::Orientation orientation>
+constexpr GlyphMapping orientSteps(const int lxPerGx, const int lxPerGy, const int lyPerGx, const int lyPerGy) {
+  switch (orientation) {
+    case GfxRenderer::Portrait:
+      return {lyPerGx, lyPerGy, -lxPerGx, -lxPerGy};
+    case GfxRenderer::LandscapeClockwise:
+      return {-lxPerGx, -lxPerGy, -lyPerGx, -lyPerGy};
+    case GfxRenderer::PortraitInverted:
+      return {-lyPerGx, -lyPerGy, lxPerGx, lxPerGy};
+    case GfxRenderer::LandscapeCounterClockwise:
+    default:
+      return {lxPerGx, lxPerGy, lyPerGx, lyPerGy};
+  }
+}
+
+template <GfxRenderer::Orientation orientation, TextRotation rotation>
+constexpr GlyphMapping glyphMapping() {
+  // Logical step per glyph column / row (see the coordinate setup in renderCharImpl)
+  if constexpr (rotation == TextRotation::None) {
+    return orientSteps<orientation>(1, 0, 0, 1);
+  } else {
+    return orientSteps<orientation>(0, 1, -1, 0);
+  }
+}
+
+inline uint8_t reverseBits(uint8_t v) {
+  v = static_cast<uint8_t>((v & 0xF0) >> 4 | (v & 0x0F) << 4);
+  v = static_cast<uint8_t>((v & 0xCC) >> 2 | (v & 0x33) << 2);
+  return static_cast<uint8_t>((v & 0xAA) >> 1 | (v & 0x55) << 1);
+}
+
+// 8x8 bit-matrix transpose (Hacker's Delight transpose8): out[c] bit (7 - r) = in[r] bit (7 - c).
+inline void transpose8x8(const uint8_t in[GLYPH_BAND_ROWS], uint8_t out[GLYPH_BAND_ROWS]) {
+  uint32_t x = static_cast<uint32_t>(in[0]) << 24 | static_cast<uint32_t>(in[1]) << 16 |
+               static_cast<uint32_t>(in[2]) << 8 | in[3];
+  uint32_t y = static_cast<uint32_t>(in[4]) << 24 | static_cast<uint32_t>(in[5]) << 16 |
+               static_cast<uint32_t>(in[6]) << 8 | in[7];
+  uint32_t t = (x ^ (x >> 7)) & 0x00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;
+  y = y ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC;
+  y = y ^ t ^ (t << 14);
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+  for (int i = 0; i < 4; i++) {
+    out[i] = static_cast<uint8_t>(x >> (24 - 8 * i));
+    out[i + 4] = static_cast<uint8_t>(y >> (24 - 8 * i));
+  }
+}
+
+// 8 bits of an MSB-first bitstream starting at bitPos; bits past `len` bytes read as 0.
+inline uint8_t readBits8(const uint8_t* src, const uint32_t bitPos, const uint32_t len) {
+  const uint32_t i = bitPos >> 3;
+  const uint32_t shift = bitPos & 7;
+  uint32_t window = static_cast<uint32_t>(src[i]) << 8;
+  if (shift != 0 && i + 1 < len) window |= src[i + 1];
+  return static_cast<uint8_t>(window << shift >> 8);
+}
+
+// Same for 16 bits (8 pixels of a 2-bit glyph).
+inline uint16_t readBits16(const uint8_t* src, const uint32_t bitPos, const uint32_t len) {
+  const uint32_t i = bitPos >> 3;
+  const uint32_t shift = bitPos & 7;
+  uint32_t window = static_cast<uint32_t>(src[i]) << 16;
+  if (i + 1 < len) window |= static_cast<uint32_t>(src[i + 1]) << 8;
+  if (shift != 0 && i + 2 < len) window |= src[i + 2];
+  return static_cast<uint16_t>(window << shift >> 8);
+}
+
+// Raw 2-bit font values are 0 = white .. 3 = black. BW draws every non-white
+// pixel, the MSB plane flags both grays and the LSB plane flags dark gray only
+// (matching the bmpVal tests of the per-pixel renderer this replaced).
+template <GfxRenderer::RenderMode mode>
+inline uint8_t inkFrom2Bit(const uint16_t pixels) {
+  const uint32_t hi = (pixels >> 1) & 0x5555u;
+  const uint32_t lo = pixels & 0x5555u;
+  uint32_t ink;
+  if constexpr (mode == GfxRenderer::BW) {
+    ink = hi | lo;
+  } else if constexpr (mode == GfxRenderer::GRAYSCALE_MSB) {
+    ink = hi ^ lo;
+  } else {
+    ink = hi & ~lo;
+  }
+  // Gather the low bit of each pair: bit 2k -> bit k
+  ink = (ink | (ink >> 1)) & 0x3333u;
+  ink = (ink | (ink >> 2)) & 0x0F0Fu;
+  ink = (ink | (ink >> 4)) & 0x00FFu;
+  return static_cast<uint8_t>(ink);
+}
+
+using DecodeGlyphBandFn = void (*)(const uint8_t* bitmap, int width, int height, int gy0, GlyphBand& band);
+
+// Decodes glyph rows [gy0, gy0 + 8) into `band`; rows past the glyph are zeroed.
+template <bool is2Bit, GfxRenderer::RenderMode mode>
+void decodeGlyphBand(const uint8_t* bitmap, const int width, const int height, const int gy0, GlyphBand& band) {
+  const int rowBytes = (width + 7) >> 3;
+  const uint8_t tailMask = static_cast<uint8_t>(0xFF << ((8 - (width & 7)) & 7));
+  const uint32_t pixelCount = static_cast<uint32_t>(width) * height;
+  const uint32_t len = is2Bit ? (pixelCount + 3) / 4 : (pixelCount + 7) / 8;
+  const int rows = std::min(GLYPH_BAND_ROWS, height - gy0);
+
+  for (int r = 0; r < rows; r++) {
+    const uint32_t rowPixel = static_cast<uint32_t>(gy0 + r) * width;
+    for (int b = 0; b < rowBytes; b++) {
+      const uint32_t pixel = rowPixel + b * 8;
+      if constexpr (is2Bit) {
+        band[r][b] = inkFrom2Bit<mode>(readBits16(bitmap, pixel * 2, len));
+      } else {
+        band[r][b] = readBits8(bitmap, pixel, len);
+      }
+    }
+    band[r][rowBytes - 1] &= tailMask;
+  }
+  for (int r = rows; r < GLYPH_BAND_ROWS; r++) {
+    memset(band[r], 0, rowBytes);
+  }
+}
+
+// Same, from a GlyphCoverageCache mask: row-aligned high and low bit planes (just one for 1-bit glyphs)
+template <bool is2Bit, GfxRenderer::RenderMode mode>
+void decodeMaskBand(const uint8_t* mask, const int width, const int height, const int gy0, GlyphBand& band) {
+  const int rowBytes = (width + 7) >> 3;
+  const int rows = std::min(GLYPH_BAND_ROWS, height - gy0);
+  const uint8_t* hi = mask + gy0 * rowBytes;
+  const uint8_t* lo = is2Bit ? hi + height * rowBytes : hi;
+
+  for (int r = 0; r < rows; r++, hi += rowBytes, lo += rowBytes) {
+    for (int b = 0; b < rowBytes; b++) {
+      if constexpr (!is2Bit || mode == GfxRenderer::BW) {
+        band[r][b] = hi[b] | lo[b];
+      } else if constexpr (mode == GfxRenderer::GRAYSCALE_MSB) {
+        band[r][b] = hi[b] ^ lo[b];
+      } else {
+        band[r][b] = hi[b] & ~lo[b];
+      }
+    }
+  }
+  for (int r = rows; r < GLYPH_BAND_ROWS; r++) {
+    memset(band[r], 0, rowBytes);
+  }
+}
+
+DecodeGlyphBandFn selectGlyphDecoder(const bool is2Bit, const GfxRenderer::RenderMode renderMode,
+                                     const bool coverageMask) {
+  if (!is2Bit) return coverageMask ? decodeMaskBand<false, GfxRenderer::BW> : decodeGlyphBand<false, GfxRenderer::BW>;
+  switch (renderMode) {
+    case GfxRenderer::GRAYSCALE_MSB:
+      return coverageMask ? decodeMaskBand<true, GfxRenderer::GRAYSCALE_MSB>
+                          : decodeGlyphBand<true, GfxRenderer::GRAYSCALE_MSB>;
+    case GfxRenderer::GRAYSCALE_LSB:
+      return coverageMask ? decodeMaskBand<true, GfxRenderer::GRAYSCALE_LSB>
+                          : decodeGlyphBand<true, GfxRenderer::GRAYSCALE_LSB>;
+    case GfxRenderer::BW:
+    default:
+      return coverageMask ? decodeMaskBand<true, GfxRenderer::BW> : decodeGlyphBand<true, GfxRenderer::BW>;
+  }
+}
+
+// Writes 8 ink bits covering physical columns [phyX, phyX + 8) of one row.
+// Bytes outside the row are dropped; panel widths are whole bytes, so this is an exact clip.
+inline void writeInk8(uint8_t* row, const int rowBytes, const int phyX, const uint8_t ink, const bool black) {
+  if (ink == 0) return;
+  const int byteIndex = phyX >= 0 ? phyX >> 3 : -((7 - phyX) >> 3);
+  const int shift = phyX - byteIndex * 8;
+  const uint8_t head = static_cast<uint8_t>(ink >> shift);
+  const uint8_t tail = static_cast<uint8_t>(ink << (8 - shift));
+  if (head && byteIndex >= 0 && byteIndex < rowBytes) {
+    if (black) {
+      row[byteIndex] &= static_cast<uint8_t>(~head);
+    } else {
+      row[byteIndex] |= head;
+    }
+  }
+  if (tail && byteIndex + 1 >= 0 && byteIndex + 1 < rowBytes) {
+    if (black) {
+      row[byteIndex + 1] &= static_cast<uint8_t>(~tail);
+    } else {
+      row[byteIndex + 1] |= tail;
+    }
+  }
+}
+
+// originX/originY: logical position of glyph pixel (0, 0). black: clear bits (ink) instead of setting them.
+template <GfxRenderer::Orientation orientation, TextRotation rotation>
+void blitGlyphOriented(const GfxRenderer& renderer, const DecodeGlyphBandFn decode, const uint8_t* bitmap,
+                       const int width, const int height, const int originX, const int originY, const bool black) {
+  constexpr GlyphMapping m = glyphMapping<orientation, rotation>();
+  // Transposed: glyph rows run along physical rows, so each glyph column becomes one physical row
+  constexpr bool transposed = m.pxPerGy != 0;
+
+  int px0, py0;
+  rotateCoordinates(orientation, originX, originY, &px0, &py0, renderer.getDisplayWidth(), renderer.getDisplayHeight());
+
+  uint8_t* target = renderer.getWriteTarget();
+  const int targetY0 = renderer.getWriteOriginY();
+  const int targetRows = renderer.getWriteRows();
+  const int rowBytes = renderer.getDisplayWidthBytes();
+  const int glyphRowBytes = (width + 7) >> 3;
+
+  GlyphBand band;
+  for (int gy0 = 0; gy0 < height; gy0 += GLYPH_BAND_ROWS) {
+    decode(bitmap, width, height, gy0, band);
+
+    if constexpr (!transposed) {
+      const int rows = std::min(GLYPH_BAND_ROWS, height - gy0);
+      for (int r = 0; r < rows; r++) {
+        const int py = py0 + m.pyPerGy * (gy0 + r);
+        if (py < targetY0 || py >= targetY0 + targetRows) continue;
+        uint8_t* row = target + static_cast<int32_t>(py - targetY0) * rowBytes;
+        for (int b = 0; b < glyphRowBytes; b++) {
+          if constexpr (m.pxPerGx > 0) {
+            writeInk8(row, rowBytes, px0 + b * 8, band[r][b], black);
+          } else {
+            writeInk8(row, rowBytes, px0 - b * 8 - 7, reverseBits(band[r][b]), black);
+          }
+        }
+      }
+    } else {
+      const int phyX = m.pxPerGy > 0 ? px0 + gy0 : px0 - gy0 - 7;
+      for (int b = 0; b < glyphRowBytes; b++) {
+        uint8_t tile[GLYPH_BAND_ROWS];
+        uint8_t columns[GLYPH_BAND_ROWS];
+        uint8_t any = 0;
+        for (int r = 0; r < GLYPH_BAND_ROWS; r++) {
+          tile[r] = band[r][b];
+          any |= tile[r];
+        }
+        if (any == 0) continue;
+        transpose8x8(tile, columns);
+
+        const int cols = std::min(8, width - b * 8);
+        for (int c = 0; c < cols; c++) {
+          const int py = py0 + m.pyPerGx * (b * 8 + c);
+          if (py < targetY0 || py >= targetY0 + targetRows) continue;
+          uint8_t* row = target + static_cast<int32_t>(py - targetY0) * rowBytes;
+          writeInk8(row, rowBytes, phyX, m.pxPerGy > 0 ? columns[c] : reverseBits(columns[c]), black);
+        }
+      }
+    }
+  }
+}
+
+// bitmap is a packed font bitmap, or a GlyphCoverageCache mask when coverageMask is set.
+template <TextRotation rotation>
+void blitGlyph(const GfxRenderer& renderer, const GfxRenderer::RenderMode renderMode, const bool is2Bit,
+               const bool coverageMask, const uint8_t* bitmap, const int width, const int height, const int originX,
+               const int originY, const bool black) {
+  const DecodeGlyphBandFn decode = selectGlyphDecoder(is2Bit, renderMode, coverageMask);
+  switch (renderer.getOrientation()) {
+    case GfxRenderer::Portrait:
+      blitGlyphOriented<GfxRenderer::Portrait, rotation>(renderer, decode, bitmap, width, height, originX, originY,
+                                                         black);
+      break;
+    case GfxRenderer::LandscapeClockwise:
+      blitGlyphOriented<GfxRenderer::LandscapeClockwise, rotation>(renderer, decode, bitmap, width, height, originX,
+                                                                   originY, black);
+      break;
+    case GfxRenderer::PortraitInverted:
+      blitGlyphOriented<GfxRenderer::PortraitInverted, rotation>(renderer, decode, bitmap, width, height, originX,
+                                                                 originY, black);
+      break;
+    case GfxRenderer::LandscapeCounterClockwise:
+      blitGlyphOriented<GfxRenderer::LandscapeCounterClockwise, rotation>(renderer, decode, bitmap, width, height,
+                                                                          originX, originY, black);
+      break;
+  }
+}
+
+// Packed-plane images (XTC pages) go through the same byte / 8x8-tile writers as glyphs. A "line" is one
+// stored row (RowMajor) or one stored column (ColumnMajorReversed); its bits are the MSB-first ink bytes.
+// Lines have no width limit, so they are combined straight from the planes instead of through a GlyphBand.
+template <GfxRenderer::PackedPlane::Ink ink>
+inline uint8_t planeInk(const uint8_t* a, const uint8_t* b, const size_t i) {
+  using Ink = GfxRenderer::PackedPlane::Ink;
+  if constexpr (ink == Ink::Set) {
+    return a[i];
+  } else if constexpr (ink == Ink::Clear) {
+    return static_cast<uint8_t>(~a[i]);
+  } else if constexpr (ink == Ink::Either) {
+    return a[i] | b[i];
+  } else if constexpr (ink == Ink::Differ) {
+    return a[i] ^ b[i];
+  } else {
+    return static_cast<uint8_t>(~a[i] & b[i]);
+  }
+}
+
+template <GfxRenderer::Orientation orientation, GfxRenderer::PackedPlane::Layout layout,
+          GfxRenderer::PackedPlane::Ink ink>
+void blitPlaneOriented(const GfxRenderer& renderer, const GfxRenderer::PackedPlane& image, const int x, const int y,
+                       const bool black) {
+  constexpr bool rowMajor = layout == GfxRenderer::PackedPlane::Layout::RowMajor;
+  // Pixel (gx, gy) is bit gx of line gy. Column-major lines run down the page and step leftwards.
+  constexpr GlyphMapping m = rowMajor ? orientSteps<orientation>(1, 0, 0, 1) : orientSteps<orientation>(0, -1, 1, 0);
+  constexpr bool transposed = m.pxPerGy != 0;
+
+  const int lineLength = rowMajor ? image.width : image.height;
+  const int lineCount = rowMajor ? image.height : image.width;
+  const int lineBytes = (lineLength + 7) >> 3;
+  const uint8_t tailMask = static_cast<uint8_t>(0xFF << ((8 - (lineLength & 7)) & 7));
+
+  int px0, py0;
+  rotateCoordinates(orientation, rowMajor ? x : x + image.width - 1, y, &px0, &py0, renderer.getDisplayWidth(),
+                    renderer.getDisplayHeight());
+
+  uint8_t* target = renderer.getWriteTarget();
+  const int targetY0 = renderer.getWriteOriginY();
+  const int targetRows = renderer.getWriteRows();
+  const int rowBytes = renderer.getDisplayWidthBytes();
+  const auto inkAt = [&](const int line, const int b) {
+    const size_t i = static_cast<size_t>(line) * lineBytes + b;
+    const uint8_t bits = planeInk<ink>(image.plane, image.plane2, i);
+    return b == lineBytes - 1 ? static_cast<uint8_t>(bits & tailMask) : bits;
+  };
+
+  if constexpr (!transposed) {
+    for (int gy = 0; gy < lineCount; gy++) {
+      const int py = py0 + m.pyPerGy * gy;
+      if (py < targetY0 || py >= targetY0 + targetRows) continue;
+      uint8_t* row = target + static_cast<int32_t>(py - targetY0) * rowBytes;
+      for (int b = 0; b < lineBytes; b++) {
+        if constexpr (m.pxPerGx > 0) {
+          writeInk8(row, rowBytes, px0 + b * 8, inkAt(gy, b), black);
+        } else {
+          writeInk8(row, rowBytes, px0 - b * 8 - 7, reverseBits(inkAt(gy, b)), black);
+        }
+      }
+    }
+  } else {
+    for (int gy0 = 0; gy0 < lineCount; gy0 += GLYPH_BAND_ROWS) {
+      const int phyX = m.pxPerGy > 0 ? px0 + gy0 : px0 - gy0 - 7;
+      const int lines = std::min(GLYPH_BAND_ROWS, lineCount - gy0);
+      for (int b = 0; b < lineBytes; b++) {
+        uint8_t tile[GLYPH_BAND_ROWS] = {};
+        uint8_t columns[GLYPH_BAND_ROWS];
+        uint8_t any = 0;
+        for (int r = 0; r < lines; r++) {
+          tile[r] = inkAt(gy0 + r, b);
+          any |= tile[r];
+        }
+        if (any == 0) continue;
+        transpose8x8(tile, columns);
+
+        const int cols = std::min(8, lineLength - b * 8);
+        for (int c = 0; c < cols; c++) {
+          const int py = py0 + m.pyPerGx * (b * 8 + c);
+          if (py < targetY0 || py >= targetY0 + targetRows) continue;
+          uint8_t* row = target + static_cast<int32_t>(py - targetY0) * rowBytes;
+          writeInk8(row, rowBytes, phyX, m.pxPerGy > 0 ? columns[c] : reverseBits(columns[c]), black);
+        }
+      }
+    }
+  }
+}
+
+template <GfxRenderer::Orientation orientation, GfxRenderer::PackedPlane::Layout layout>
+void blitPlaneInk(const GfxRenderer& renderer, const GfxRenderer::PackedPlane& image, const int x, const int y,
+                  const bool black) {
+  using Ink = GfxRenderer::PackedPlane::Ink;
+  switch (image.ink) {
+    case Ink::Set:
+      blitPlaneOriented<orientation, layout, Ink::Set>(renderer, image, x, y, black);
+      break;
+    case Ink::Clear:
+      blitPlaneOriented<orientation, layout, Ink::Clear>(renderer, image, x, y, black);
+      break;
+    case Ink::Either:
+      blitPlaneOriented<orientation, layout, Ink::Either>(renderer, image, x, y, black);
+      break;
+    case Ink::Differ:
+      blitPlaneOriented<orientation, layout, Ink::Differ>(renderer, image, x, y, black);
+      break;
+    case Ink::SecondOnly:
+      blitPlaneOriented<orientation, layout, Ink::SecondOnly>(renderer, image, x, y, black);
+      break;
+  }
+}
+
+template <GfxRenderer::Orientation orientation>
+void blitPlane(const GfxRenderer& renderer, const GfxRenderer::PackedPlane& image, const int x, const int y,
+               const bool black) {
+  if (image.layout == GfxRenderer::PackedPlane::Layout::RowMajor) {
+    blitPlaneInk<orientation, GfxRenderer::PackedPlane::Layout::RowMajor>(renderer, image, x, y, black);
+  } else {
+    blitPlaneInk<orientation, GfxRenderer::PackedPlane::Layout::ColumnMajorReversed>(renderer, image, x, y, black);
+  }
+}
+
+}  // namespace
+
 // Shared glyph rendering logic for normal and rotated text.
 // Coordinate mapping and cursor advance direction are selected at compile time via the template parameter.
 // Render a glyph at 50% scale. Used for SUP/SUB style bits.
@@ -212,6 +638,34 @@ static void renderCharScaled(const GfxRenderer& renderer, GfxRenderer::RenderMod
   }
 }
 
+// getGlyphBitmap, served from the page's glyph coverage cache when one is enabled. Only glyphs that
+// cost a decompression or SD card read are cached; flash-resident bitmaps are already a plain pointer.
+struct GlyphSource {
+  const uint8_t* data;
+  bool coverageMask;  // data is a GlyphCoverageCache mask rather than the font's packed bitmap
+};
+
+// Only glyphs whose bitmap would be fetched again on the next pass (hot-group decompression, SD card
+// overflow reads) go through the coverage cache; prewarmed and flash bitmaps are drawn in place.
+static GlyphSource getGlyphSource(const GfxRenderer& renderer, const EpdFontData* fontData, const EpdGlyph* glyph,
+                                  const uint32_t cp) {
+  FontCacheManager* fcm = renderer.getFontCacheManager();
+  GlyphCoverageCache* cache = fcm ? fcm->getGlyphCoverageCache() : nullptr;
+  if (!cache || glyph->width == 0 || glyph->height == 0 || renderer.hasStableGlyphBitmap(fontData, glyph)) {
+    return {renderer.getGlyphBitmap(fontData, glyph), false};
+  }
+
+  if (const uint8_t* mask = cache->find(fontData, cp)) {
+    return {mask, true};
+  }
+  const uint8_t* bitmap = renderer.getGlyphBitmap(fontData, glyph);
+  if (bitmap == nullptr) {
+    return {nullptr, false};
+  }
+  const uint8_t* mask = cache->insert(fontData, cp, bitmap, glyph->width, glyph->height, fontData->is2Bit);
+  return mask ? GlyphSource{mask, true} : GlyphSource{bitmap, false};
+}
+
 template <TextRotation rotation = TextRotation::None>
 static void renderCharImpl(const GfxRenderer& renderer, GfxRenderer::RenderMode renderMode,
                            const EpdFontFamily& fontFamily, const uint32_t cp, int cursorX, int cursorY,
@@ -246,79 +700,28 @@ static void renderCharImpl(const GfxRenderer& renderer, GfxRenderer::RenderMode
     }
   }
 
-  const uint8_t* bitmap = renderer.getGlyphBitmap(fontData, glyph);
-
-  if (bitmap != nullptr) {
-    // For Normal:  outer loop advances screenY, inner loop advances screenX
-    // For Rotated: outer loop advances screenX, inner loop advances screenY (in reverse)
-    int outerBase, innerBase;
-    if constexpr (rotation == TextRotation::Rotated90CW) {
-      outerBase = cursorX + fontData->ascender - top;  // screenX = outerBase + glyphY
-      innerBase = cursorY - left;                      // screenY = innerBase - glyphX
-    } else {
-      outerBase = cursorY - top;   // screenY = outerBase + glyphY
-      innerBase = cursorX + left;  // screenX = innerBase + glyphX
-    }
-
-    if (is2Bit) {
-      int pixelPosition = 0;
-      for (int glyphY = 0; glyphY < height; glyphY++) {
-        const int outerCoord = outerBase + glyphY;
-        for (int glyphX = 0; glyphX < width; glyphX++, pixelPosition++) {
-          int screenX, screenY;
-          if constexpr (rotation == TextRotation::Rotated90CW) {
-            screenX = outerCoord;
-            screenY = innerBase - glyphX;
-          } else {
-            screenX = innerBase + glyphX;
-            screenY = outerCoord;
-          }
-
-          const uint8_t byte = bitmap[pixelPosition >> 2];
-          const uint8_t bit_index = (3 - (pixelPosition & 3)) * 2;
-          // the direct bit from the font is 0 -> white, 1 -> light gray, 2 -> dark gray, 3 -> black
-          // we swap this to better match the way images and screen think about colors:
-          // 0 -> black, 1 -> dark grey, 2 -> light grey, 3 -> white
-          const uint8_t bmpVal = 3 - ((byte >> bit_index) & 0x3);
-
-          if (renderMode == GfxRenderer::BW && bmpVal < 3) {
-            // Black (also paints over the grays in BW mode)
-            renderer.drawPixel(screenX, screenY, pixelState);
-          } else if (renderMode == GfxRenderer::GRAYSCALE_MSB && (bmpVal == 1 || bmpVal == 2)) {
-            // Light gray (also mark the MSB if it's going to be a dark gray too)
-            // Dedicated X3 gray LUTs now provide proper 4-level gray on both devices
-            // We have to flag pixels in reverse for the gray buffers, as 0 leave alone, 1 update
-            renderer.drawPixel(screenX, screenY, false);
-          } else if (renderMode == GfxRenderer::GRAYSCALE_LSB && bmpVal == 1) {
-            // Dark gray
-            renderer.drawPixel(screenX, screenY, false);
-          }
-        }
-      }
-    } else {
-      int pixelPosition = 0;
-      for (int glyphY = 0; glyphY < height; glyphY++) {
-        const int outerCoord = outerBase + glyphY;
-        for (int glyphX = 0; glyphX < width; glyphX++, pixelPosition++) {
-          int screenX, screenY;
-          if constexpr (rotation == TextRotation::Rotated90CW) {
-            screenX = outerCoord;
-            screenY = innerBase - glyphX;
-          } else {
-            screenX = innerBase + glyphX;
-            screenY = outerCoord;
-          }
-
-          const uint8_t byte = bitmap[pixelPosition >> 3];
-          const uint8_t bit_index = 7 - (pixelPosition & 7);
+  const GlyphSource source = getGlyphSource(renderer, fontData, glyph, cp);
+  if (source.data == nullptr) {
+    return;
+  }
 
-          if ((byte >> bit_index) & 1) {
-            renderer.drawPixel(screenX, screenY, pixelState);
-          }
-        }
-      }
-    }
+  // Logical position of glyph pixel (0, 0).
+  // For Normal:  glyph rows advance screenY, glyph columns advance screenX
+  // For Rotated: glyph rows advance screenX, glyph columns advance screenY (in reverse)
+  int originX, originY;
+  if constexpr (rotation == TextRotation::Rotated90CW) {
+    originX = cursorX + fontData->ascender - top;
+    originY = cursorY - left;
+  } else {
+    originX = cursorX + left;
+    originY = cursorY - top;
   }
+
+  // 1-bit glyphs always draw in pixelState. 2-bit glyphs do in BW; the grayscale planes flag pixels
+  // in reverse (0 leave alone, 1 update), so they set bits instead.
+  const bool black = pixelState && (!is2Bit || renderMode == GfxRenderer::BW);
+  blitGlyph<rotation>(renderer, renderMode, is2Bit, source.coverageMask, source.data, width, height, originX, originY,
+                      black);
 }
 
 // IMPORTANT: This function is in critical rendering path and is called for every pixel. Please keep it as simple and
@@ -1251,6 +1654,27 @@ void GfxRenderer::drawBitmap1Bit(const Bitmap& bitmap, const int x, const int y,
   free(rowBytes);
 }
 
+void GfxRenderer::drawPackedPlane(const PackedPlane& image, const int x, const int y, const bool state) const {
+  if (!image.plane || image.width <= 0 || image.height <= 0) return;
+  const bool twoPlanes = image.ink != PackedPlane::Ink::Set && image.ink != PackedPlane::Ink::Clear;
+  if (twoPlanes && !image.plane2) return;
+
+  switch (orientation) {
+    case Portrait:
+      blitPlane<Portrait>(*this, image, x, y, state);
+      break;
+    case LandscapeClockwise:
+      blitPlane<LandscapeClockwise>(*this, image, x, y, state);
+      break;
+    case PortraitInverted:
+      blitPlane<PortraitInverted>(*this, image, x, y, state);
+      break;
+    case LandscapeCounterClockwise:
+      blitPlane<LandscapeCounterClockwise>(*this, image, x, y, state);
+      break;
+  }
+}
+
 void GfxRenderer::fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state) const {
   if (numPoints < 3) return;
 
@@ -1453,6 +1877,85 @@ std::vector<std::string> GfxRenderer::wrappedText(const int fontId, const char*
   return lines;
 }
 
+size_t GfxRenderer::fitTextLine(const int fontId, const std::string_view text, const int maxWidth,
+                                const EpdFontFamily::Style style) const {
+  const auto fontIt = fontMap.find(fontId);
+  if (fontIt == fontMap.end()) {
+    LOG_ERR("GFX", "Font %d not found", fontId);
+    return text.size();
+  }
+  const auto& font = fontIt->second;
+  const auto sdIt = sdCardFonts_.find(fontId);
+  const SdCardFont* sdFont =
+      sdIt != sdCardFonts_.end() && sdIt->second->hasAdvanceTable() ? sdIt->second : nullptr;
+  const uint8_t sdStyle = sdFont ? resolveSdCardStyle(*sdFont, style) : 0;
+  const bool isSupSub = (style & (EpdFontFamily::SUP | EpdFontFamily::SUB)) != 0;
+
+  // Running advance, rounded exactly as getTextAdvanceX rounds the same prefix: SD card fonts sum
+  // fixed-point advances and snap once, built-in fonts snap each (advance + kern) pair as they go.
+  int32_t sdWidthFP = 0;
+  int snappedPx = 0;
+  int32_t prevAdvanceFP = 0;
+  uint32_t prevCp = 0;
+  const auto prefixWidth = [&]() {
+    return sdFont ? fp4::toPixel(sdWidthFP) : snappedPx + fp4::toPixel(prevAdvanceFP);
+  };
+
+  size_t firstBoundary = 0;  // end of the first codepoint and its combining marks
+  size_t lastFit = 0;
+  size_t lastSpaceFit = 0;
+  const char* const begin = text.data();
+  const char* const end = begin + text.size();
+  const char* cursor = begin;
+  while (cursor < end) {
+    const char* const cpStart = cursor;
+    uint32_t cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&cursor));
+    if (cp == 0) {
+      cursor = end;
+      break;
+    }
+    const bool isCombining = utf8IsCombiningMark(cp);
+
+    if (!isCombining && cpStart > begin) {
+      // The prefix before this codepoint is complete
+      const size_t boundary = cpStart - begin;
+      if (firstBoundary == 0) firstBoundary = boundary;
+      if (prefixWidth() > maxWidth) break;
+      lastFit = boundary;
+      if (cp == ' ') lastSpaceFit = boundary;
+    }
+
+    if (sdFont) {
+      int32_t advFP = sdFont->getAdvance(cp, sdStyle);
+      if (advFP == 0 && !isCombining) {
+        const EpdGlyph* glyph = font.getGlyph(cp, style);
+        advFP = glyph ? glyph->advanceX : 0;
+      }
+      sdWidthFP += isSupSub ? (advFP + 1) / 2 : advFP;
+      if (!isCombining) {
+        if (prevCp != 0) sdWidthFP += font.getKerning(prevCp, cp, style);
+        prevCp = cp;
+      }
+      continue;
+    }
+    if (isCombining) continue;
+
+    cp = font.applyLigatures(cp, cursor, style);
+    if (prevCp != 0) {
+      snappedPx += fp4::toPixel(prevAdvanceFP + font.getKerning(prevCp, cp, style));
+    }
+    const EpdGlyph* glyph = font.getGlyph(cp, style);
+    prevAdvanceFP = glyph ? glyph->advanceX : 0;
+    if (isSupSub) prevAdvanceFP = (prevAdvanceFP + 1) / 2;
+    prevCp = cp;
+  }
+
+  if (cursor >= end && prefixWidth() <= maxWidth) return text.size();
+  if (lastSpaceFit > 0) return lastSpaceFit;
+  if (lastFit > 0) return lastFit;
+  return firstBoundary > 0 ? firstBoundary : text.size();
+}
+
 // Note: Internal driver treats screen in command orientation; this library exposes a logical orientation
 int GfxRenderer::getScreenWidth() const {
   switch (orientation) {
@@ -1614,10 +2117,26 @@ int GfxRenderer::getKerning(const int fontId, const uint32_t leftCp, const uint3
   return fp4::toPixel(kernFP);                                           // snap 4.4 fixed-point to nearest pixel
 }
 
-int GfxRenderer::getTextAdvanceX(const int fontId, const char* text, EpdFontFamily::Style style) const {
-  // Advance table fast-path for SD card fonts during layout.
-  // No kerning/ligature lookup — consistent with previous metadataOnly behavior
-  // where kern/lig data was not loaded.
+int GfxRenderer::getTextAdvanceX(const int fontId, const char* text, const EpdFontFamily::Style style) const {
+  WordWidthCache* widthCache = fontCacheManager_ ? fontCacheManager_->getWordWidthCache() : nullptr;
+  if (!widthCache) {
+    return measureTextAdvanceX(fontId, text, style);
+  }
+
+  const uint64_t key = WordWidthCache::keyFor(fontId, static_cast<uint8_t>(style), text, strlen(text));
+  int16_t width;
+  if (widthCache->find(key, width)) {
+    return width;
+  }
+  const int measured = measureTextAdvanceX(fontId, text, style);
+  widthCache->insert(key, static_cast<int16_t>(measured));
+  return measured;
+}
+
+int GfxRenderer::measureTextAdvanceX(const int fontId, const char* text, EpdFontFamily::Style style) const {
+  // Advance table fast-path for SD card fonts during layout. Kerning comes from
+  // the font's resident kern tables (loaded with the advance table); ligatures
+  // are not applied.
   auto sdIt = sdCardFonts_.find(fontId);
   if (sdIt != sdCardFonts_.end() && sdIt->second->hasAdvanceTable()) {
     int32_t widthFP = 0;
@@ -1629,13 +2148,19 @@ int GfxRenderer::getTextAdvanceX(const int fontId, const char* text, EpdFontFami
       return 0;
     }
     const auto& font = fontIt->second;
+    uint32_t prevCp = 0;
     while (uint32_t cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&text))) {
+      const bool isCombining = utf8IsCombiningMark(cp);
       int32_t advFP = sdIt->second->getAdvance(cp, styleIdx);
-      if (advFP == 0 && !utf8IsCombiningMark(cp)) {
+      if (advFP == 0 && !isCombining) {
         const EpdGlyph* glyph = font.getGlyph(cp, style);
         advFP = glyph ? glyph->advanceX : 0;
       }
       widthFP += isSupSub ? (advFP + 1) / 2 : advFP;
+      if (!isCombining) {
+        if (prevCp != 0) widthFP += font.getKerning(prevCp, cp, style);
+        prevCp = cp;
+      }
     }
     return fp4::toPixel(widthFP);
   }
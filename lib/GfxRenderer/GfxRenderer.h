@@ -17,6 +17,7 @@ class SdCardFont;
 #include <cstring>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Bitmap.h"
@@ -37,6 +38,28 @@ class GfxRenderer {
     LandscapeCounterClockwise  // 800x480 logical coordinates, native panel orientation
   };
 
+  // A 1-bit image stored as packed bit planes, drawn by drawPackedPlane() a byte at a time.
+  // RowMajor: (width + 7) / 8 bytes per row, MSB = leftmost pixel.
+  // ColumnMajorReversed: (height + 7) / 8 bytes per column, columns stored right to left, MSB = topmost pixel.
+  // A pixel is drawn where `ink` holds for its bit in `plane` (a) and, for the two-plane modes, `plane2` (b).
+  struct PackedPlane {
+    enum class Layout : uint8_t { RowMajor, ColumnMajorReversed };
+    enum class Ink : uint8_t {
+      Set,        // a
+      Clear,      // !a
+      Either,     // a | b
+      Differ,     // a ^ b
+      SecondOnly  // !a & b
+    };
+
+    const uint8_t* plane = nullptr;
+    const uint8_t* plane2 = nullptr;
+    Layout layout = Layout::RowMajor;
+    Ink ink = Ink::Set;
+    int width = 0;
+    int height = 0;
+  };
+
  private:
   static constexpr size_t BW_BUFFER_CHUNK_SIZE = 8000;  // 8KB chunks to allow for non-contiguous memory
 
@@ -77,6 +100,8 @@ class GfxRenderer {
   void renderChar(const EpdFontFamily& fontFamily, uint32_t cp, int* x, int* y, bool pixelState,
                   EpdFontFamily::Style style) const;
   void freeBwBufferChunks();
+  // Uncached getTextAdvanceX
+  int measureTextAdvanceX(int fontId, const char* text, EpdFontFamily::Style style) const;
   template <Color color>
   void drawPixelDither(int x, int y) const;
   template <Color color>
@@ -187,6 +212,7 @@ class GfxRenderer {
   void drawBitmap(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight, float cropX = 0,
                   float cropY = 0) const;
   void drawBitmap1Bit(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight) const;
+  void drawPackedPlane(const PackedPlane& image, int x, int y, bool state = true) const;
   void fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state = true) const;
 
   // Text
@@ -215,6 +241,12 @@ class GfxRenderer {
   /// truncated with an ellipsis (U+2026).
   std::vector<std::string> wrappedText(int fontId, const char* text, int maxWidth, int maxLines,
                                        EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
+  /// Byte length of the longest prefix of \p text that fits in \p maxWidth pixels, preferring to end just
+  /// before a space. Widths match getTextAdvanceX of the prefix, but are accumulated in a single pass, so
+  /// wrapping a long line is linear. Never splits a codepoint from its combining marks, and returns at
+  /// least the first codepoint of non-empty text even if it does not fit.
+  size_t fitTextLine(int fontId, std::string_view text, int maxWidth,
+                     EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
 
   // Helper for drawing rotated text (90 degrees clockwise, for side buttons)
   void drawTextRotated90CW(int fontId, int x, int y, const char* text, bool black = true,
@@ -249,6 +281,9 @@ class GfxRenderer {
 
   // Font helpers
   const uint8_t* getGlyphBitmap(const EpdFontData* fontData, const EpdGlyph* glyph) const;
+  // True when getGlyphBitmap() returns storage that outlives the page: flash, a prewarmed
+  // FontDecompressor page buffer or SdCardFont glyph store. Hot-group and overflow glyphs are not.
+  bool hasStableGlyphBitmap(const EpdFontData* fontData, const EpdGlyph* glyph) const;
 
   // Low level functions
   uint8_t* getFrameBuffer() const;
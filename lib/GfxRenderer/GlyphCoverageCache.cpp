@@ -0,0 +1,173 @@
+#include "GlyphCoverageCache.h"
+
+#include <Logging.h>
+#include <Memory.h>
+
+#include <cstring>
+
+bool GlyphCoverageCache::begin(const uint32_t budgetBytes) {
+  end();
+  pool = makeUniqueNoThrow<uint8_t[]>(budgetBytes);
+  entries = makeUniqueNoThrow<Entry[]>(MAX_ENTRIES);
+  table = makeUniqueNoThrow<uint16_t[]>(TABLE_SIZE);
+  if (!pool || !entries || !table) {
+    LOG_ERR("GCC", "OOM: glyph coverage cache (%lu bytes)", static_cast<unsigned long>(budgetBytes));
+    end();
+    return false;
+  }
+  budget = budgetBytes;
+  rebuildTable();
+  return true;
+}
+
+void GlyphCoverageCache::end() {
+  pool.reset();
+  entries.reset();
+  table.reset();
+  budget = 0;
+  used = 0;
+  entryCount = 0;
+  useClock = 0;
+}
+
+uint16_t GlyphCoverageCache::slotFor(const EpdFontData* fontData, const uint32_t codepoint) {
+  uint32_t h = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(fontData)) ^ (codepoint * 0x9E3779B1u);
+  h ^= h >> 15;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  return static_cast<uint16_t>(h & (TABLE_SIZE - 1));
+}
+
+int GlyphCoverageCache::findEntry(const EpdFontData* fontData, const uint32_t codepoint) const {
+  for (uint16_t slot = slotFor(fontData, codepoint);; slot = (slot + 1) & (TABLE_SIZE - 1)) {
+    const uint16_t index = table[slot];
+    if (index == EMPTY_SLOT) return -1;
+    const Entry& entry = entries[index];
+    if (entry.fontData == fontData && entry.codepoint == codepoint) return index;
+  }
+}
+
+const uint8_t* GlyphCoverageCache::find(const EpdFontData* fontData, const uint32_t codepoint) {
+  if (!pool) return nullptr;
+  const int index = findEntry(fontData, codepoint);
+  if (index < 0) {
+    stats.misses++;
+    return nullptr;
+  }
+  stats.hits++;
+  entries[index].lastUse = ++useClock;
+  return pool.get() + entries[index].offset;
+}
+
+uint32_t GlyphCoverageCache::maskSize(const uint8_t width, const uint8_t height, const bool is2Bit) {
+  const uint32_t planeBytes = static_cast<uint32_t>((width + 7) >> 3) * height;
+  return is2Bit ? planeBytes * 2 : planeBytes;
+}
+
+// Spreads a packed glyph bitmap (pixels run on across rows) into row-aligned bit planes
+static void packCoverageMask(const uint8_t* bitmap, const uint8_t width, const uint8_t height, const bool is2Bit,
+                             uint8_t* mask) {
+  const uint32_t rowBytes = (width + 7) >> 3;
+  const uint32_t planeBytes = rowBytes * height;
+  memset(mask, 0, is2Bit ? planeBytes * 2 : planeBytes);
+  uint8_t* hi = mask;
+  uint8_t* lo = mask + planeBytes;
+
+  uint32_t pixel = 0;
+  for (uint32_t y = 0; y < height; y++) {
+    for (uint32_t x = 0; x < width; x++, pixel++) {
+      const uint32_t byte = y * rowBytes + (x >> 3);
+      const uint8_t bit = static_cast<uint8_t>(0x80 >> (x & 7));
+      if (is2Bit) {
+        const uint8_t raw = (bitmap[pixel >> 2] >> ((3 - (pixel & 3)) * 2)) & 0x3;
+        if (raw & 0x2) hi[byte] |= bit;
+        if (raw & 0x1) lo[byte] |= bit;
+      } else if ((bitmap[pixel >> 3] >> (7 - (pixel & 7))) & 1) {
+        hi[byte] |= bit;
+      }
+    }
+  }
+}
+
+const uint8_t* GlyphCoverageCache::insert(const EpdFontData* fontData, const uint32_t codepoint,
+                                          const uint8_t* bitmap, const uint8_t width, const uint8_t height,
+                                          const bool is2Bit) {
+  const uint32_t size = maskSize(width, height, is2Bit);
+  if (!pool || size == 0 || size > budget) return nullptr;
+
+  if (used + size > budget || entryCount >= MAX_ENTRIES) {
+    evictFor(size);
+  }
+
+  Entry& entry = entries[entryCount];
+  entry.fontData = fontData;
+  entry.codepoint = codepoint;
+  entry.offset = used;
+  entry.size = size;
+  entry.lastUse = ++useClock;
+  packCoverageMask(bitmap, width, height, is2Bit, pool.get() + used);
+
+  uint16_t slot = slotFor(fontData, codepoint);
+  while (table[slot] != EMPTY_SLOT) slot = (slot + 1) & (TABLE_SIZE - 1);
+  table[slot] = entryCount;
+
+  entryCount++;
+  used += size;
+  if (used > stats.peakBytes) stats.peakBytes = used;
+  return pool.get() + entry.offset;
+}
+
+void GlyphCoverageCache::evictFor(const uint32_t size) {
+  // Evict down to three quarters of the budget (and entry count) rather than just enough room, so a
+  // page that overflows the cache pays for one compaction per batch of inserts, not one per glyph.
+  const uint32_t byteTarget = budget - budget / 4;
+  const uint32_t keepBytes = byteTarget > size ? byteTarget - size : 0;
+  constexpr uint16_t keepEntries = MAX_ENTRIES - MAX_ENTRIES / 4;
+
+  uint32_t liveBytes = used;
+  uint16_t liveEntries = entryCount;
+  while (liveEntries > 0 && (liveBytes > keepBytes || liveEntries > keepEntries)) {
+    int oldest = -1;
+    for (uint16_t i = 0; i < entryCount; i++) {
+      if (entries[i].fontData == nullptr) continue;
+      if (oldest < 0 || entries[i].lastUse < entries[oldest].lastUse) oldest = i;
+    }
+    liveBytes -= entries[oldest].size;
+    liveEntries--;
+    entries[oldest].fontData = nullptr;  // marks the entry evicted
+    stats.evictions++;
+  }
+
+  // Entries are in pool order, so survivors only ever move towards the front
+  uint16_t kept = 0;
+  uint32_t offset = 0;
+  for (uint16_t i = 0; i < entryCount; i++) {
+    Entry entry = entries[i];
+    if (entry.fontData == nullptr) continue;
+    if (entry.offset != offset) memmove(pool.get() + offset, pool.get() + entry.offset, entry.size);
+    entry.offset = offset;
+    offset += entry.size;
+    entries[kept++] = entry;
+  }
+  entryCount = kept;
+  used = offset;
+  rebuildTable();
+}
+
+void GlyphCoverageCache::rebuildTable() {
+  for (uint16_t slot = 0; slot < TABLE_SIZE; slot++) table[slot] = EMPTY_SLOT;
+  for (uint16_t i = 0; i < entryCount; i++) {
+    uint16_t slot = slotFor(entries[i].fontData, entries[i].codepoint);
+    while (table[slot] != EMPTY_SLOT) slot = (slot + 1) & (TABLE_SIZE - 1);
+    table[slot] = i;
+  }
+}
+
+void GlyphCoverageCache::logStats(const char* label) {
+  const uint32_t total = stats.hits + stats.misses;
+  LOG_DBG("GCC", "[%s] hits=%lu misses=%lu (%.1f%% hit rate) evictions=%lu peak=%lu/%lu bytes", label,
+          static_cast<unsigned long>(stats.hits), static_cast<unsigned long>(stats.misses),
+          total > 0 ? 100.0f * stats.hits / total : 0.0f, static_cast<unsigned long>(stats.evictions),
+          static_cast<unsigned long>(stats.peakBytes), static_cast<unsigned long>(budget));
+  resetStats();
+}
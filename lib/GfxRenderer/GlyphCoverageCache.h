@@ -0,0 +1,81 @@
+#pragma once
+
+#include <EpdFontData.h>
+
+#include <cstdint>
+#include <memory>
+
+// Per-page cache of glyph coverage masks, keyed by (font style data, codepoint). An anti-aliased page
+// is drawn once for BW and then once per strip for each grayscale plane; without the cache every pass
+// decompresses hot-group glyphs and re-reads SD card overflow glyphs again. Glyphs whose bitmaps already
+// stay put for the page (flash, prewarmed page buffers and glyph stores) are not copied in.
+//
+// A mask stores the glyph as row-aligned bit planes, MSB first, rows of (width + 7) / 8 bytes: one
+// plane of ink bits for 1-bit fonts, two for 2-bit fonts (the high bits of the raw pixel values, then
+// the low bits), so each render mode's ink is a byte-wise combination of the planes.
+//
+// All masks share one pool of budgetBytes allocated by begin(). When an insert does not fit, the
+// least recently used entries are evicted and the survivors compacted to the front of the pool.
+class GlyphCoverageCache {
+ public:
+  static constexpr uint32_t DEFAULT_BUDGET_BYTES = 16 * 1024;
+  static constexpr uint16_t MAX_ENTRIES = 256;
+
+  struct Stats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+    uint32_t peakBytes = 0;
+  };
+
+  GlyphCoverageCache() = default;
+  ~GlyphCoverageCache() = default;
+  GlyphCoverageCache(const GlyphCoverageCache&) = delete;
+  GlyphCoverageCache& operator=(const GlyphCoverageCache&) = delete;
+
+  // Allocates the pool. Returns false on OOM, leaving the cache inactive.
+  bool begin(uint32_t budgetBytes = DEFAULT_BUDGET_BYTES);
+  // Frees the pool and all entries.
+  void end();
+  bool isActive() const { return pool != nullptr; }
+
+  static uint32_t maskSize(uint8_t width, uint8_t height, bool is2Bit);
+
+  // Returned masks stay valid until the next insert() or end().
+  const uint8_t* find(const EpdFontData* fontData, uint32_t codepoint);
+  // Converts the packed glyph `bitmap` into a mask in the cache, evicting as needed. Returns the mask,
+  // or nullptr when the cache is inactive or the mask is larger than the whole budget.
+  const uint8_t* insert(const EpdFontData* fontData, uint32_t codepoint, const uint8_t* bitmap, uint8_t width,
+                        uint8_t height, bool is2Bit);
+
+  void logStats(const char* label = "render");
+  void resetStats() { stats = Stats{}; }
+  const Stats& getStats() const { return stats; }
+
+ private:
+  struct Entry {
+    const EpdFontData* fontData;
+    uint32_t codepoint;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t lastUse;
+  };
+
+  // Open-addressing index over `entries`; power of two, at least twice MAX_ENTRIES.
+  static constexpr uint16_t TABLE_SIZE = 512;
+  static constexpr uint16_t EMPTY_SLOT = UINT16_MAX;
+
+  std::unique_ptr<uint8_t[]> pool;
+  std::unique_ptr<Entry[]> entries;  // kept in pool order, so compaction is a single forward pass
+  std::unique_ptr<uint16_t[]> table;
+  uint32_t budget = 0;
+  uint32_t used = 0;
+  uint16_t entryCount = 0;
+  uint32_t useClock = 0;
+  Stats stats;
+
+  static uint16_t slotFor(const EpdFontData* fontData, uint32_t codepoint);
+  int findEntry(const EpdFontData* fontData, uint32_t codepoint) const;
+  void evictFor(uint32_t size);
+  void rebuildTable();
+};
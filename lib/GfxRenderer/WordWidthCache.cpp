@@ -0,0 +1,72 @@
+#include "WordWidthCache.h"
+
+#include <Logging.h>
+#include <Memory.h>
+
+bool WordWidthCache::begin() {
+  end();
+  keys = makeUniqueNoThrow<uint64_t[]>(TABLE_SIZE);
+  widths = makeUniqueNoThrow<int16_t[]>(TABLE_SIZE);
+  if (!keys || !widths) {
+    LOG_ERR("WWC", "OOM: word width cache");
+    end();
+    return false;
+  }
+  for (uint16_t slot = 0; slot < TABLE_SIZE; slot++) keys[slot] = EMPTY_KEY;
+  return true;
+}
+
+void WordWidthCache::end() {
+  keys.reset();
+  widths.reset();
+}
+
+uint64_t WordWidthCache::keyFor(const int fontId, const uint8_t style, const char* text, const size_t length) {
+  // FNV-1a over the word, seeded with the font and style
+  uint64_t h = 0xCBF29CE484222325ull;
+  const auto mix = [&h](const uint8_t byte) {
+    h ^= byte;
+    h *= 0x100000001B3ull;
+  };
+  for (int shift = 0; shift < 32; shift += 8) mix(static_cast<uint8_t>(static_cast<uint32_t>(fontId) >> shift));
+  mix(style);
+  for (size_t i = 0; i < length; i++) mix(static_cast<uint8_t>(text[i]));
+  return h == EMPTY_KEY ? 1 : h;
+}
+
+bool WordWidthCache::find(const uint64_t key, int16_t& width) {
+  if (!keys) return false;
+  for (uint16_t i = 0, slot = key & (TABLE_SIZE - 1); i < PROBE_LIMIT; i++, slot = (slot + 1) & (TABLE_SIZE - 1)) {
+    if (keys[slot] == key) {
+      stats.hits++;
+      width = widths[slot];
+      return true;
+    }
+    if (keys[slot] == EMPTY_KEY) break;
+  }
+  stats.misses++;
+  return false;
+}
+
+void WordWidthCache::insert(const uint64_t key, const int16_t width) {
+  if (!keys) return;
+  const uint16_t home = key & (TABLE_SIZE - 1);
+  uint16_t target = home;
+  for (uint16_t i = 0, slot = home; i < PROBE_LIMIT; i++, slot = (slot + 1) & (TABLE_SIZE - 1)) {
+    if (keys[slot] == EMPTY_KEY || keys[slot] == key) {
+      target = slot;
+      break;
+    }
+  }
+  if (keys[target] != EMPTY_KEY && keys[target] != key) stats.evictions++;
+  keys[target] = key;
+  widths[target] = width;
+}
+
+void WordWidthCache::logStats(const char* label) {
+  const uint32_t total = stats.hits + stats.misses;
+  LOG_DBG("WWC", "[%s] hits=%lu misses=%lu (%.1f%% hit rate) evictions=%lu", label,
+          static_cast<unsigned long>(stats.hits), static_cast<unsigned long>(stats.misses),
+          total > 0 ? 100.0f * stats.hits / total : 0.0f, static_cast<unsigned long>(stats.evictions));
+  resetStats();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Memo of measured word advances, keyed by (font id, style, word). Layout measures the same short
+// words ("the", "and", punctuation-attached tokens) thousands of times per chapter, and hyphenation
+// re-measures the same prefixes while looking for a break; each measurement walks the glyph, kerning
+// and ligature tables of every codepoint.
+//
+// Entries are a 64-bit hash of the key plus the width, in a fixed open-addressed table allocated by
+// begin(). Lookups probe a short window; when the window is full the home slot is overwritten.
+class WordWidthCache {
+ public:
+  static constexpr uint16_t TABLE_SIZE = 1024;  // power of two; ~10KB with the width array
+
+  struct Stats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t evictions = 0;
+  };
+
+  WordWidthCache() = default;
+  ~WordWidthCache() = default;
+  WordWidthCache(const WordWidthCache&) = delete;
+  WordWidthCache& operator=(const WordWidthCache&) = delete;
+
+  // Allocates an empty table. Returns false on OOM, leaving the cache inactive.
+  bool begin();
+  void end();
+  bool isActive() const { return keys != nullptr; }
+
+  static uint64_t keyFor(int fontId, uint8_t style, const char* text, size_t length);
+  bool find(uint64_t key, int16_t& width);
+  void insert(uint64_t key, int16_t width);
+
+  void logStats(const char* label = "layout");
+  void resetStats() { stats = Stats{}; }
+  const Stats& getStats() const { return stats; }
+
+ private:
+  static constexpr uint16_t PROBE_LIMIT = 8;
+  static constexpr uint64_t EMPTY_KEY = 0;  // keyFor never returns it
+
+  std::unique_ptr<uint64_t[]> keys;
+  std::unique_ptr<int16_t[]> widths;
+  Stats stats;
+};
@@ -1,9 +1,39 @@
 #pragma once
 #include <HalStorage.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 namespace serialization {
+// Read cursor over a record already pulled into RAM with a single bulk file read. Mirrors the
+// HalFile::read contract: reads past the end return a short count instead of failing hard.
+class BufferReader {
+  const uint8_t* data;
+  size_t size;
+  size_t pos = 0;
+
+ public:
+  BufferReader(const uint8_t* data, const size_t size) : data(data), size(size) {}
+
+  int read(void* buf, const size_t count) {
+    const size_t n = std::min(count, size - pos);
+    memcpy(buf, data + pos, n);
+    pos += n;
+    return static_cast<int>(n);
+  }
+
+  size_t remaining() const { return size - pos; }
+  size_t position() const { return pos; }
+  bool seek(const size_t newPos) {
+    if (newPos > size) {
+      return false;
+    }
+    pos = newPos;
+    return true;
+  }
+};
+
 template <typename T>
 void writePod(std::ostream& os, const T& value) {
   os.write(reinterpret_cast<const char*>(&value), sizeof(T));
@@ -24,6 +54,11 @@ void readPod(HalFile& file, T& value) {
   file.read(reinterpret_cast<uint8_t*>(&value), sizeof(T));
 }
 
+template <typename T>
+void readPod(BufferReader& reader, T& value) {
+  reader.read(&value, sizeof(T));
+}
+
 inline void writeString(std::ostream& os, const std::string& s) {
   const uint32_t len = s.size();
   writePod(os, len);
@@ -49,4 +84,12 @@ inline void readString(HalFile& file, std::string& s) {
   s.resize(len);
   file.read(&s[0], len);
 }
+
+inline void readString(BufferReader& reader, std::string& s) {
+  uint32_t len = 0;
+  readPod(reader, len);
+  // A corrupt length must not turn into a huge allocation
+  s.resize(std::min<size_t>(len, reader.remaining()));
+  reader.read(&s[0], s.size());
+}
 }  // namespace serialization
@@ -1,14 +1,13 @@
 #include "Txt.h"
 
+#include <BookCacheKey.h>
 #include <FsHelpers.h>
 #include <JpegToBmpConverter.h>
 #include <Logging.h>
 
 Txt::Txt(std::string path, std::string cacheBasePath)
     : filepath(std::move(path)), cacheBasePath(std::move(cacheBasePath)) {
-  // Generate cache path from file path hash
-  const size_t hash = std::hash<std::string>{}(filepath);
-  cachePath = this->cacheBasePath + "/txt_" + std::to_string(hash);
+  cachePath = BookCacheKey::cachePathFor(this->cacheBasePath, "txt_", filepath);
 }
 
 bool Txt::load() {
@@ -524,6 +524,62 @@ xtc::XtcError Xtc::loadPageStreaming(uint32_t pageIndex,
   return const_cast<xtc::XtcParser*>(parser.get())->loadPageStreaming(pageIndex, callback, chunkSize);
 }
 
+void Xtc::setNativeCacheEnabled(const bool enabled, const uint8_t orientation, const uint16_t panelWidth,
+                                const uint16_t panelHeight) const {
+  if (!loaded || !parser) {
+    return;
+  }
+  auto* xtcParser = const_cast<xtc::XtcParser*>(parser.get());
+  if (!enabled) {
+    xtcParser->disableNativeCache();
+    return;
+  }
+
+  const std::string dir = cachePath + "/native_" + std::to_string(orientation);
+  if (xtcParser->getNativeCacheDir() == dir) {
+    return;
+  }
+  if (!Storage.exists(dir.c_str())) {
+    Storage.mkdir(dir.c_str());
+  }
+  xtcParser->setNativeCache(dir, orientation, panelWidth, panelHeight);
+}
+
+bool Xtc::openNativePage(uint32_t pageIndex, HalFile& file) const {
+  if (!loaded || !parser) {
+    return false;
+  }
+  return parser->openNativePage(pageIndex, file);
+}
+
+size_t Xtc::loadNativePlane(HalFile& file, uint8_t plane, uint8_t* buffer, size_t bufferSize) const {
+  if (!loaded || !parser) {
+    return 0;
+  }
+  return const_cast<xtc::XtcParser*>(parser.get())->loadNativePlane(file, plane, buffer, bufferSize);
+}
+
+bool Xtc::beginNativePage(uint32_t pageIndex) const {
+  if (!loaded || !parser) {
+    return false;
+  }
+  return const_cast<xtc::XtcParser*>(parser.get())->beginNativePage(pageIndex);
+}
+
+bool Xtc::writeNativePlane(const uint8_t* data, size_t size) const {
+  if (!loaded || !parser) {
+    return false;
+  }
+  return const_cast<xtc::XtcParser*>(parser.get())->writeNativePlane(data, size);
+}
+
+bool Xtc::endNativePage() const {
+  if (!loaded || !parser) {
+    return false;
+  }
+  return const_cast<xtc::XtcParser*>(parser.get())->endNativePage();
+}
+
 uint8_t Xtc::calculateProgress(uint32_t currentPage) const {
   if (!loaded || !parser || parser->getPageCount() == 0) {
     return 0;
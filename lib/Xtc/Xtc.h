@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <BookCacheKey.h>
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,10 +29,10 @@ class Xtc {
   bool loaded;
 
  public:
-  explicit Xtc(std::string filepath, const std::string& cacheDir) : filepath(std::move(filepath)), loaded(false) {
-    // Create cache key based on filepath (same as Epub)
-    cachePath = cacheDir + "/xtc_" + std::to_string(std::hash<std::string>{}(this->filepath));
-  }
+  explicit Xtc(std::string filepath, const std::string& cacheDir)
+      : filepath(std::move(filepath)),
+        cachePath(BookCacheKey::cachePathFor(cacheDir, "xtc_", this->filepath)),
+        loaded(false) {}
   ~Xtc() = default;
 
   /**
@@ -94,6 +96,17 @@ class Xtc {
                                   std::function<void(const uint8_t* data, size_t size, size_t offset)> callback,
                                   size_t chunkSize = 1024) const;
 
+  /**
+   * Panel-native page cache (see XtcParser::setNativeCache)
+   * Pages are cached under <cachePath>/native_<orientation>/ once drawn. Requires setupCacheDir().
+   */
+  void setNativeCacheEnabled(bool enabled, uint8_t orientation, uint16_t panelWidth, uint16_t panelHeight) const;
+  bool openNativePage(uint32_t pageIndex, HalFile& file) const;
+  size_t loadNativePlane(HalFile& file, uint8_t plane, uint8_t* buffer, size_t bufferSize) const;
+  bool beginNativePage(uint32_t pageIndex) const;
+  bool writeNativePlane(const uint8_t* data, size_t size) const;
+  bool endNativePage() const;
+
   // Progress calculation
   uint8_t calculateProgress(uint32_t currentPage) const;
 
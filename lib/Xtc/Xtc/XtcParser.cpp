@@ -22,7 +22,12 @@ XtcParser::XtcParser()
       m_bitDepth(1),
       m_hasChapters(false),
       m_chaptersLoaded(false),
-      m_lastError(XtcError::OK) {
+      m_lastError(XtcError::OK),
+      m_nativeOrientation(0),
+      m_nativePanelWidth(0),
+      m_nativePanelHeight(0),
+      m_nativePage(0),
+      m_nativePlanesWritten(0) {
   memset(&m_header, 0, sizeof(m_header));
 }
 
@@ -100,6 +105,7 @@ XtcError XtcParser::open(const char* filepath) {
 
 void XtcParser::close() {
   closeFile();
+  disableNativeCache();
   m_isOpen = false;
   m_chaptersLoaded = false;
   m_chapters.clear();
@@ -529,6 +535,148 @@ XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
   return XtcError::OK;
 }
 
+void XtcParser::setNativeCache(std::string dir, const uint8_t orientation, const uint16_t panelWidth,
+                               const uint16_t panelHeight) {
+  if (m_nativeFile.isOpen()) {
+    endNativePage();
+  }
+  m_nativeDir = std::move(dir);
+  m_nativeOrientation = orientation;
+  m_nativePanelWidth = panelWidth;
+  m_nativePanelHeight = panelHeight;
+}
+
+void XtcParser::disableNativeCache() {
+  if (m_nativeFile.isOpen()) {
+    endNativePage();
+  }
+  m_nativeDir.clear();
+}
+
+std::string XtcParser::nativePagePath(const uint32_t pageIndex) const {
+  return m_nativeDir + "/" + std::to_string(pageIndex) + ".xtn";
+}
+
+// Panel widths are whole bytes (the framebuffer has no row padding)
+uint32_t XtcParser::nativePlaneSize() const {
+  return static_cast<uint32_t>(m_nativePanelWidth / 8) * m_nativePanelHeight;
+}
+
+bool XtcParser::readNativeHeader(HalFile& file) const {
+  NativePageHeader header;
+  if (file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  const uint8_t planeCount = getNativePlaneCount();
+  return header.magic == XTN_MAGIC && header.version == NATIVE_PAGE_VERSION &&
+         header.orientation == m_nativeOrientation && header.planeCount == planeCount &&
+         header.panelWidth == m_nativePanelWidth && header.panelHeight == m_nativePanelHeight &&
+         header.planeSize == nativePlaneSize() &&
+         file.fileSize() == sizeof(header) + static_cast<size_t>(planeCount) * header.planeSize;
+}
+
+bool XtcParser::openNativePage(const uint32_t pageIndex, HalFile& file) const {
+  if (!nativeCacheEnabled() || pageIndex >= m_header.pageCount) {
+    return false;
+  }
+  const std::string path = nativePagePath(pageIndex);
+  if (!Storage.exists(path.c_str()) || !Storage.openFileForRead("XTC", path, file)) {
+    return false;
+  }
+  if (!readNativeHeader(file)) {
+    LOG_DBG("XTC", "Stale native page %u", pageIndex);
+    file.close();
+    return false;
+  }
+  return true;
+}
+
+size_t XtcParser::loadNativePlane(HalFile& file, const uint8_t plane, uint8_t* buffer, const size_t bufferSize) {
+  const uint32_t planeSize = nativePlaneSize();
+  if (!file.isOpen() || plane >= getNativePlaneCount() || bufferSize < planeSize) {
+    m_lastError = XtcError::MEMORY_ERROR;
+    return 0;
+  }
+  if (!file.seek(sizeof(NativePageHeader) + static_cast<size_t>(plane) * planeSize) ||
+      file.read(buffer, planeSize) != static_cast<int>(planeSize)) {
+    LOG_DBG("XTC", "Native page plane %u read error", plane);
+    m_lastError = XtcError::READ_ERROR;
+    return 0;
+  }
+
+  m_lastError = XtcError::OK;
+  return planeSize;
+}
+
+bool XtcParser::beginNativePage(const uint32_t pageIndex) {
+  if (!nativeCacheEnabled() || pageIndex >= m_header.pageCount || m_nativeFile.isOpen()) {
+    return false;
+  }
+
+  // Written under a temporary name so a half-built page never looks complete
+  const std::string tmpPath = nativePagePath(pageIndex) + ".tmp";
+  if (!Storage.openFileForWrite("XTC", tmpPath, m_nativeFile)) {
+    return false;
+  }
+
+  NativePageHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = XTN_MAGIC;
+  header.version = NATIVE_PAGE_VERSION;
+  header.orientation = m_nativeOrientation;
+  header.planeCount = getNativePlaneCount();
+  header.panelWidth = m_nativePanelWidth;
+  header.panelHeight = m_nativePanelHeight;
+  header.planeSize = nativePlaneSize();
+
+  m_nativePage = pageIndex;
+  m_nativePlanesWritten = 0;
+  if (m_nativeFile.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+    LOG_ERR("XTC", "Failed to write native page %u header", pageIndex);
+    endNativePage();
+    return false;
+  }
+  return true;
+}
+
+bool XtcParser::writeNativePlane(const uint8_t* data, const size_t size) {
+  if (!m_nativeFile.isOpen() || size != nativePlaneSize() || m_nativePlanesWritten >= getNativePlaneCount()) {
+    return false;
+  }
+  if (m_nativeFile.write(data, size) != size) {
+    LOG_ERR("XTC", "Failed to write native page %u plane %u", m_nativePage, m_nativePlanesWritten);
+    // Push the count past planeCount so endNativePage() discards the file
+    m_nativePlanesWritten = getNativePlaneCount() + 1;
+    return false;
+  }
+  m_nativePlanesWritten++;
+  return true;
+}
+
+bool XtcParser::endNativePage() {
+  if (!m_nativeFile.isOpen()) {
+    return false;
+  }
+  m_nativeFile.close();
+
+  const std::string path = nativePagePath(m_nativePage);
+  const std::string tmpPath = path + ".tmp";
+  if (m_nativePlanesWritten != getNativePlaneCount()) {
+    Storage.remove(tmpPath.c_str());
+    return false;
+  }
+  if (Storage.exists(path.c_str())) {
+    Storage.remove(path.c_str());
+  }
+  if (!Storage.rename(tmpPath.c_str(), path.c_str())) {
+    LOG_ERR("XTC", "Failed to publish native page %u", m_nativePage);
+    Storage.remove(tmpPath.c_str());
+    return false;
+  }
+  LOG_DBG("XTC", "Cached native page %u", m_nativePage);
+  return true;
+}
+
 bool XtcParser::isValidXtcFile(const char* filepath) {
   HalFile file;
   if (!Storage.openFileForRead("XTC", filepath, file)) {
@@ -70,6 +70,29 @@ class XtcParser {
                              std::function<void(const uint8_t* data, size_t size, size_t offset)> callback,
                              size_t chunkSize = 1024);
 
+  /**
+   * Panel-native page cache
+   *
+   * Pages can be cached as NativePageHeader files in `dir`, already rotated into the physical
+   * framebuffer layout for `orientation`, so rendering them is a plain read into the framebuffer.
+   * The caller builds a page by drawing it normally and handing each finished framebuffer to
+   * writeNativePlane() in NativePlane order between beginNativePage() and endNativePage().
+   * Files for another orientation, panel size or bit depth are ignored.
+   */
+  void setNativeCache(std::string dir, uint8_t orientation, uint16_t panelWidth, uint16_t panelHeight);
+  void disableNativeCache();
+  bool nativeCacheEnabled() const { return !m_nativeDir.empty(); }
+  const std::string& getNativeCacheDir() const { return m_nativeDir; }
+  uint8_t getNativePlaneCount() const { return m_bitDepth == 2 ? 3 : 1; }
+  // Opens a cached page and validates its header; false if it is missing or stale
+  bool openNativePage(uint32_t pageIndex, HalFile& file) const;
+  // Reads one plane of a page opened by openNativePage(); returns bytes read, 0 on failure
+  size_t loadNativePlane(HalFile& file, uint8_t plane, uint8_t* buffer, size_t bufferSize);
+  bool beginNativePage(uint32_t pageIndex);
+  bool writeNativePlane(const uint8_t* data, size_t size);
+  // Publishes the page if every plane was written, otherwise discards it
+  bool endNativePage();
+
   // Get title/author from metadata
   std::string getTitle() const { return m_title; }
   std::string getAuthor() const { return m_author; }
@@ -98,6 +121,15 @@ class XtcParser {
   bool m_chaptersLoaded;
   XtcError m_lastError;
 
+  // Panel-native page cache (empty dir = disabled)
+  std::string m_nativeDir;
+  uint8_t m_nativeOrientation;
+  uint16_t m_nativePanelWidth;
+  uint16_t m_nativePanelHeight;
+  HalFile m_nativeFile;  // Open only between beginNativePage() and endNativePage()
+  uint32_t m_nativePage;
+  uint8_t m_nativePlanesWritten;
+
   // Internal helper functions
   XtcError readHeader();
   XtcError readFirstPageInfo();
@@ -105,6 +137,9 @@ class XtcParser {
   XtcError readAuthor();
   XtcError readChapters();
   bool readPageTableEntry(uint32_t pageIndex, PageInfo& info);
+  std::string nativePagePath(uint32_t pageIndex) const;
+  uint32_t nativePlaneSize() const;
+  bool readNativeHeader(HalFile& file) const;
 
   // File handle management — reopen on demand, close after use
   bool ensureFileOpen();
@@ -26,6 +26,8 @@ constexpr uint32_t XTCH_MAGIC = 0x48435458;  // "XTCH" in little-endian (2-bit h
 constexpr uint32_t XTG_MAGIC = 0x00475458;  // "XTG\0" for 1-bit page data
 // "XTH\0" = 0x58, 0x54, 0x48, 0x00
 constexpr uint32_t XTH_MAGIC = 0x00485458;  // "XTH\0" for 2-bit page data
+// "XTN\0" = 0x58, 0x54, 0x4E, 0x00
+constexpr uint32_t XTN_MAGIC = 0x004E5458;  // "XTN\0" for cached panel-native page data
 
 // XTeink X4 display resolution
 constexpr uint16_t DISPLAY_WIDTH = 480;
@@ -88,6 +90,34 @@ struct XtgPageHeader {
 };
 #pragma pack(pop)
 
+// Panel-native page header (16 bytes)
+// One cache file per page, holding the page already rotated into physical framebuffer rows for one
+// renderer orientation, so it can be read straight into the framebuffer. Written by the reader the
+// first time it draws a page; a file is only trusted when every plane is present.
+#pragma pack(push, 1)
+struct NativePageHeader {
+  uint32_t magic;        // 0x00: XTN_MAGIC
+  uint8_t version;       // 0x04: NATIVE_PAGE_VERSION
+  uint8_t orientation;   // 0x05: Renderer orientation the planes were rotated for
+  uint8_t planeCount;    // 0x06: 1 for XTC, 3 for XTCH (see NativePlane)
+  uint8_t reserved;      // 0x07: Always 0
+  uint16_t panelWidth;   // 0x08: Physical framebuffer width (pixels)
+  uint16_t panelHeight;  // 0x0A: Physical framebuffer height (pixels)
+  uint32_t planeSize;    // 0x0C: Bytes per plane, (panelWidth / 8) * panelHeight
+  // Followed by planeCount planes of planeSize bytes: physical row-major, 8 pixels/byte, MSB = leftmost,
+  // using the framebuffer's bit convention for that pass
+};
+#pragma pack(pop)
+
+constexpr uint8_t NATIVE_PAGE_VERSION = 1;
+
+// Plane order within a panel-native page
+enum NativePlane : uint8_t {
+  NATIVE_PLANE_BW = 0,        // Black/white frame (all non-white pixels black)
+  NATIVE_PLANE_GRAY_LSB = 1,  // Grayscale LSB pass (XTCH only)
+  NATIVE_PLANE_GRAY_MSB = 2,  // Grayscale MSB pass (XTCH only)
+};
+
 // Page information (internal use, optimized for memory)
 struct PageInfo {
   uint64_t offset;   // File offset to page data
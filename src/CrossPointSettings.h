@@ -259,6 +259,8 @@ class CrossPointSettings {
   uint8_t embeddedStyle = 1;
   // Focus Reading - emphasizes the first part of words with bold
   uint8_t focusReadingEnabled = 0;
+  // Optimal (paragraph-wide) line breaking for justified text; greedy breaking when off
+  uint8_t optimalLineBreaks = 0;
   // SD card font family name (empty = use built-in fontFamily)
   char sdFontFamilyName[32] = "";
   // Show hidden files/directories (starting with '.') in the file browser (0 = hidden, 1 = show)
@@ -267,6 +269,13 @@ class CrossPointSettings {
   uint8_t removeReadBooksFromRecents = 0;
   // Move epub to /Read/ folder on SD card when finished (0 = disabled, 1 = enabled)
   uint8_t moveFinishedToReadFolder = 0;
+  // Key book caches on a content fingerprint instead of the file path, so they survive moves (0 = off, 1 = on)
+  uint8_t contentCacheKeys = 0;
+  // Cache XTC pages pre-rotated into the panel's framebuffer layout on first view (0 = off, 1 = on)
+  uint8_t xtcNativePageCache = 0;
+  // Build a per-book subset of the SD card font while indexing, so page turns read glyphs from one small file
+  // (0 = off, 1 = on)
+  uint8_t fontBookSubsets = 0;
   // Image rendering mode in EPUB reader
   uint8_t imageRendering = IMAGES_DISPLAY;
   // Tilt-based page turning (X3 only — requires QMI8658 IMU)
@@ -151,6 +151,8 @@ inline std::vector<SettingInfo> getSettingsList(const SdCardFontRegistry* regist
                             StrId::STR_CAT_READER),
         SettingInfo::Toggle(StrId::STR_HYPHENATION, &CrossPointSettings::hyphenationEnabled, "hyphenationEnabled",
                             StrId::STR_CAT_READER),
+        SettingInfo::Toggle(StrId::STR_OPTIMAL_LINE_BREAKS, &CrossPointSettings::optimalLineBreaks, "optimalLineBreaks",
+                            StrId::STR_CAT_READER),
         SettingInfo::Enum(
             StrId::STR_ORIENTATION, &CrossPointSettings::orientation,
             {StrId::STR_PORTRAIT, StrId::STR_LANDSCAPE_CW, StrId::STR_ORIENTATION_INVERTED, StrId::STR_LANDSCAPE_CCW},
@@ -193,6 +195,12 @@ inline std::vector<SettingInfo> getSettingsList(const SdCardFontRegistry* regist
                             "removeReadBooksFromRecents", StrId::STR_CAT_SYSTEM),
         SettingInfo::Toggle(StrId::STR_MOVE_FINISHED_TO_READ, &CrossPointSettings::moveFinishedToReadFolder,
                             "moveFinishedToReadFolder", StrId::STR_CAT_SYSTEM),
+        SettingInfo::Toggle(StrId::STR_CONTENT_CACHE_KEYS, &CrossPointSettings::contentCacheKeys, "contentCacheKeys",
+                            StrId::STR_CAT_SYSTEM),
+        SettingInfo::Toggle(StrId::STR_XTC_NATIVE_PAGE_CACHE, &CrossPointSettings::xtcNativePageCache,
+                            "xtcNativePageCache", StrId::STR_CAT_SYSTEM),
+        SettingInfo::Toggle(StrId::STR_FONT_BOOK_SUBSETS, &CrossPointSettings::fontBookSubsets, "fontBookSubsets",
+                            StrId::STR_CAT_SYSTEM),
 
         // --- KOReader Sync (web-only, uses KOReaderCredentialStore) ---
         SettingInfo::DynamicString(
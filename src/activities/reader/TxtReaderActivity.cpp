@@ -8,6 +8,8 @@
 #include <Serialization.h>
 #include <Utf8.h>
 
+#include <cstdint>
+
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "MappedInputManager.h"
@@ -21,7 +23,10 @@ namespace {
 constexpr size_t CHUNK_SIZE = 8 * 1024;  // 8KB chunk for reading
 // Cache file magic and version
 constexpr uint32_t CACHE_MAGIC = 0x54585449;  // "TXTI"
-constexpr uint8_t CACHE_VERSION = 3;          // Increment when cache format changes
+constexpr uint8_t CACHE_VERSION = 5;          // Increment when cache format or line wrapping changes
+// Background indexing: time slice per loop() iteration, and pages indexed between index.bin checkpoints
+constexpr unsigned long INDEX_SLICE_MS = 50;
+constexpr size_t CHECKPOINT_PAGES = 200;
 }  // namespace
 
 void TxtReaderActivity::onEnter() {
@@ -52,6 +57,9 @@ void TxtReaderActivity::onExit() {
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
 
+  if (initialized && !indexComplete) {
+    savePageIndexCache();
+  }
   pageOffsets.clear();
   currentPageLines.clear();
   APP_STATE.readerActivityLoadCount = 0;
@@ -75,6 +83,7 @@ void TxtReaderActivity::loop() {
 
   const auto [prevTriggered, nextTriggered, fromTilt] = ReaderUtils::detectPageTurn(mappedInput);
   if (!prevTriggered && !nextTriggered) {
+    continueIndexing();
     return;
   }
 
@@ -82,6 +91,13 @@ void TxtReaderActivity::loop() {
     currentPage--;
     requestUpdate();
   } else if (nextTriggered) {
+    if (currentPage >= totalPages - 1) {
+      // Turned past the pages indexed so far: find the next one now
+      RenderLock lock(*this);
+      if (initialized && !indexComplete) {
+        indexPages(1, INDEX_SLICE_MS);
+      }
+    }
     if (currentPage < totalPages - 1) {
       currentPage++;
       requestUpdate();
@@ -119,12 +135,13 @@ void TxtReaderActivity::initializeReader() {
 
   LOG_DBG("TRS", "Viewport: %dx%d, lines per page: %d", viewportWidth, viewportHeight, linesPerPage);
 
-  // Try to load cached page index first
+  // Resume a complete or partial page index; otherwise start from the first page and index the rest in the
+  // background from loop() once it is on screen
   if (!loadPageIndexCache()) {
-    // Cache not found, build page index
-    buildPageIndex();
-    // Save to cache for next time
-    savePageIndexCache();
+    pageOffsets.assign(1, 0);
+    totalPages = 1;
+    indexComplete = false;
+    pagesAtLastCheckpoint = 0;
   }
 
   // Load saved progress
@@ -133,43 +150,65 @@ void TxtReaderActivity::initializeReader() {
   initialized = true;
 }
 
-void TxtReaderActivity::buildPageIndex() {
-  pageOffsets.clear();
-  pageOffsets.push_back(0);  // First page starts at offset 0
-
-  size_t offset = 0;
+void TxtReaderActivity::indexPages(const size_t maxPages, const unsigned long budgetMs) {
   const size_t fileSize = txt->getFileSize();
+  const unsigned long start = millis();
+  std::vector<std::string> tempLines;
 
-  LOG_DBG("TRS", "Building page index for %zu bytes...", fileSize);
-
-  GUI.drawPopup(renderer, tr(STR_INDEXING));
-
-  while (offset < fileSize) {
-    std::vector<std::string> tempLines;
+  for (size_t i = 0; i < maxPages && !indexComplete; i++) {
+    const size_t offset = pageOffsets.back();
     size_t nextOffset = offset;
 
-    if (!loadPageAtOffset(offset, tempLines, nextOffset)) {
+    // A page that cannot be loaded, makes no progress or reaches the end of the file is the last one
+    if (!loadPageAtOffset(offset, tempLines, nextOffset) || nextOffset <= offset || nextOffset >= fileSize) {
+      indexComplete = true;
       break;
     }
+    pageOffsets.push_back(nextOffset);
 
-    if (nextOffset <= offset) {
-      // No progress made, avoid infinite loop
+    if (millis() - start >= budgetMs) {
       break;
     }
+  }
 
-    offset = nextOffset;
-    if (offset < fileSize) {
-      pageOffsets.push_back(offset);
-    }
+  totalPages = pageOffsets.size();
+  if (indexComplete) {
+    LOG_DBG("TRS", "Built page index: %d pages", totalPages);
+  }
+}
+
+void TxtReaderActivity::indexUntilPage(const int page) {
+  if (indexComplete || page < totalPages) {
+    return;
+  }
 
+  LOG_DBG("TRS", "Indexing up to page %d before display...", page);
+  GUI.drawPopup(renderer, tr(STR_INDEXING));
+
+  while (!indexComplete && page >= totalPages) {
+    indexPages(page + 1 - totalPages, INDEX_SLICE_MS);
     // Yield to other tasks periodically
-    if (pageOffsets.size() % 20 == 0) {
-      vTaskDelay(1);
-    }
+    vTaskDelay(1);
   }
+  savePageIndexCache();
+}
 
-  totalPages = pageOffsets.size();
-  LOG_DBG("TRS", "Built page index: %d pages", totalPages);
+void TxtReaderActivity::continueIndexing() {
+  if (indexComplete) {
+    return;  // nothing left to do, don't contend for the render lock every loop
+  }
+  RenderLock lock(*this);
+  if (!initialized || indexComplete) {
+    return;
+  }
+
+  indexPages(SIZE_MAX, INDEX_SLICE_MS);
+
+  // Checkpoint so an interrupted index (sleep, leaving the book) resumes where it stopped
+  if (indexComplete || pageOffsets.size() - pagesAtLastCheckpoint >= CHECKPOINT_PAGES) {
+    savePageIndexCache();
+  }
+  // The status bar picks up the final page count on the next page turn; no extra refresh for it
 }
 
 bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>& outLines, size_t& nextOffset) {
@@ -230,8 +269,8 @@ bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>
     bool hasCR = (lineContentLen > 0 && buffer[pos + lineContentLen - 1] == '\r');
     size_t displayLen = hasCR ? lineContentLen - 1 : lineContentLen;
 
-    // Extract line content for display (without CR/LF)
-    std::string line(reinterpret_cast<char*>(buffer + pos), displayLen);
+    // Line content for display (without CR/LF), viewed in place in the chunk buffer
+    std::string_view line(reinterpret_cast<const char*>(buffer + pos), displayLen);
 
     // Track position within this source line (in bytes from pos)
     size_t lineBytePos = 0;
@@ -244,38 +283,9 @@ bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>
         break;
       }
 
-      int lineWidth = renderer.getTextAdvanceX(cachedFontId, line.c_str(), EpdFontFamily::REGULAR);
-
-      if (lineWidth <= viewportWidth) {
-        outLines.push_back(line);
-        lineBytePos = displayLen;  // Consumed entire display content
-        line.clear();
-        break;
-      }
-
-      // Find break point
-      size_t breakPos = line.length();
-      while (breakPos > 0 && renderer.getTextAdvanceX(cachedFontId, line.substr(0, breakPos).c_str(),
-                                                      EpdFontFamily::REGULAR) > viewportWidth) {
-        // Try to break at space
-        size_t spacePos = line.rfind(' ', breakPos - 1);
-        if (spacePos != std::string::npos && spacePos > 0) {
-          breakPos = spacePos;
-        } else {
-          // Break at character boundary for UTF-8
-          breakPos--;
-          // Make sure we don't break in the middle of a UTF-8 sequence
-          while (breakPos > 0 && (line[breakPos] & 0xC0) == 0x80) {
-            breakPos--;
-          }
-        }
-      }
-
-      if (breakPos == 0) {
-        breakPos = 1;
-      }
-
-      outLines.push_back(line.substr(0, breakPos));
+      // Single pass over the line: longest prefix that fits, ending before a space where possible
+      const size_t breakPos = renderer.fitTextLine(cachedFontId, line, viewportWidth, EpdFontFamily::REGULAR);
+      outLines.emplace_back(line.substr(0, breakPos));
 
       // Skip space at break point
       size_t skipChars = breakPos;
@@ -283,7 +293,7 @@ bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>
         skipChars++;
       }
       lineBytePos += skipChars;
-      line = line.substr(skipChars);
+      line.remove_prefix(skipChars);
     } while (!line.empty() && static_cast<int>(outLines.size()) < linesPerPage);
 
     // Determine how much of the source buffer we consumed
@@ -412,13 +422,25 @@ void TxtReaderActivity::renderPage() {
   // scope destructor clears font cache via FontCacheManager
 }
 
+float TxtReaderActivity::progressPercent() const {
+  // Until the index is complete the page count is unknown: estimate progress from the byte offset
+  if (indexComplete) {
+    return totalPages > 0 ? (currentPage + 1) * 100.0f / totalPages : 0;
+  }
+  const size_t fileSize = txt->getFileSize();
+  if (fileSize == 0 || currentPage < 0 || static_cast<size_t>(currentPage) >= pageOffsets.size()) {
+    return 0;
+  }
+  return pageOffsets[currentPage] * 100.0f / fileSize;
+}
+
 void TxtReaderActivity::renderStatusBar() const {
-  const float progress = totalPages > 0 ? (currentPage + 1) * 100.0f / totalPages : 0;
+  const float progress = progressPercent();
   std::string title;
   if (SETTINGS.statusBarTitle != CrossPointSettings::STATUS_BAR_TITLE::HIDE_TITLE) {
     title = txt->getTitle();
   }
-  GUI.drawStatusBar(renderer, progress, currentPage + 1, totalPages, title);
+  GUI.drawStatusBar(renderer, progress, currentPage + 1, indexComplete ? totalPages : -1, title);
 }
 
 void TxtReaderActivity::saveProgress() const {
@@ -438,6 +460,8 @@ void TxtReaderActivity::loadProgress() {
     uint8_t data[4];
     if (f.read(data, 4) == 4) {
       currentPage = data[0] + (data[1] << 8);
+      // Reopening mid-book: the saved page has to be indexed before it can be shown
+      indexUntilPage(currentPage);
       if (currentPage >= totalPages) {
         currentPage = totalPages - 1;
       }
@@ -459,7 +483,8 @@ bool TxtReaderActivity::loadPageIndexCache() {
   // - int32_t: font ID (to invalidate cache on font change)
   // - int32_t: screen margin (to invalidate cache on margin change)
   // - uint8_t: paragraph alignment (to invalidate cache on alignment change)
-  // - uint32_t: total pages count
+  // - uint8_t: 1 when the whole file is indexed, 0 for a checkpoint of a partial index
+  // - uint32_t: total pages count (pages found so far for a partial index)
   // - N * uint32_t: page offsets
 
   std::string cachePath = txt->getCachePath() + "/index.bin";
@@ -526,8 +551,15 @@ bool TxtReaderActivity::loadPageIndexCache() {
     return false;
   }
 
+  uint8_t complete;
+  serialization::readPod(f, complete);
+
   uint32_t numPages;
   serialization::readPod(f, numPages);
+  if (numPages == 0) {
+    LOG_DBG("TRS", "Cache has no pages, rebuilding");
+    return false;
+  }
 
   // Read page offsets
   pageOffsets.clear();
@@ -540,11 +572,13 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   totalPages = pageOffsets.size();
-  LOG_DBG("TRS", "Loaded page index cache: %d pages", totalPages);
+  indexComplete = complete != 0;
+  pagesAtLastCheckpoint = pageOffsets.size();
+  LOG_DBG("TRS", "Loaded page index cache: %d pages%s", totalPages, indexComplete ? "" : " (partial, resuming)");
   return true;
 }
 
-void TxtReaderActivity::savePageIndexCache() const {
+void TxtReaderActivity::savePageIndexCache() {
   std::string cachePath = txt->getCachePath() + "/index.bin";
   HalFile f;
   if (!Storage.openFileForWrite("TRS", cachePath, f)) {
@@ -561,6 +595,7 @@ void TxtReaderActivity::savePageIndexCache() const {
   serialization::writePod(f, static_cast<int32_t>(cachedFontId));
   serialization::writePod(f, static_cast<int32_t>(cachedScreenMargin));
   serialization::writePod(f, cachedParagraphAlignment);
+  serialization::writePod(f, static_cast<uint8_t>(indexComplete ? 1 : 0));
   serialization::writePod(f, static_cast<uint32_t>(pageOffsets.size()));
 
   // Write page offsets
@@ -568,7 +603,8 @@ void TxtReaderActivity::savePageIndexCache() const {
     serialization::writePod(f, static_cast<uint32_t>(offset));
   }
 
-  LOG_DBG("TRS", "Saved page index cache: %d pages", totalPages);
+  pagesAtLastCheckpoint = pageOffsets.size();
+  LOG_DBG("TRS", "Saved page index cache: %d pages%s", totalPages, indexComplete ? "" : " (partial)");
 }
 
 ScreenshotInfo TxtReaderActivity::getScreenshotInfo() const {
@@ -580,7 +616,7 @@ ScreenshotInfo TxtReaderActivity::getScreenshotInfo() const {
   }
   info.currentPage = currentPage + 1;
   info.totalPages = totalPages;
-  info.progressPercent = totalPages > 0 ? static_cast<int>((currentPage + 1) * 100.0f / totalPages + 0.5f) : 0;
+  info.progressPercent = txt ? static_cast<int>(progressPercent() + 0.5f) : 0;
   if (info.progressPercent > 100) info.progressPercent = 100;
   return info;
 }
@@ -16,6 +16,10 @@ class TxtReaderActivity final : public Activity {
 
   // Streaming text reader - stores file offsets for each page
   std::vector<size_t> pageOffsets;  // File offset for start of each page
+  // The index is built in the background after the first page is shown: until it completes,
+  // pageOffsets only holds the pages found so far and the last entry is the next page to scan.
+  bool indexComplete = false;
+  size_t pagesAtLastCheckpoint = 0;
   std::vector<std::string> currentPageLines;
   int linesPerPage = 0;
   int viewportWidth = 0;
@@ -32,12 +36,15 @@ class TxtReaderActivity final : public Activity {
 
   void renderPage();
   void renderStatusBar() const;
+  float progressPercent() const;
 
   void initializeReader();
   bool loadPageAtOffset(size_t offset, std::vector<std::string>& outLines, size_t& nextOffset);
-  void buildPageIndex();
+  void indexPages(size_t maxPages, unsigned long budgetMs);
+  void indexUntilPage(int page);
+  void continueIndexing();
   bool loadPageIndexCache();
-  void savePageIndexCache() const;
+  void savePageIndexCache();
   void saveProgress() const;
   void loadProgress();
 
@@ -48,6 +55,7 @@ class TxtReaderActivity final : public Activity {
   void onExit() override;
   void loop() override;
   void render(RenderLock&&) override;
+  bool skipLoopDelay() override { return initialized && !indexComplete; }
   bool isReaderActivity() const override { return true; }
   ScreenshotInfo getScreenshotInfo() const override;
 };
@@ -209,6 +209,15 @@ void XtcReaderActivity::renderPage() {
   const uint16_t pageHeight = xtc->getPageHeight();
   const uint8_t bitDepth = xtc->getBitDepth();
 
+  // Pages already cached in panel-native form are read straight into the framebuffer.
+  // Other pages are drawn from the XTC planes, and cached on the way when the setting is on.
+  // The cached page is opened and validated once, then read plane by plane.
+  const bool nativeCache = SETTINGS.xtcNativePageCache;
+  xtc->setNativeCacheEnabled(nativeCache, renderer.getOrientation(), renderer.getDisplayWidth(),
+                             renderer.getDisplayHeight());
+  HalFile nativeFile;
+  bool fromNative = nativeCache && xtc->openNativePage(currentPage, nativeFile);
+
   // Calculate buffer size for one page
   // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
   // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
@@ -218,36 +227,77 @@ void XtcReaderActivity::renderPage() {
   } else {
     pageBufferSize = ((pageWidth + 7) / 8) * pageHeight;
   }
+  const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
 
-  // Allocate page buffer
-  uint8_t* pageBuffer = static_cast<uint8_t*>(malloc(pageBufferSize));
-  if (!pageBuffer) {
-    LOG_ERR("XTR", "Failed to allocate page buffer (%lu bytes)", pageBufferSize);
+  // XTC/XTCH pages are pre-rendered with status bar included, so render full page
+  GfxRenderer::PackedPlane page;
+  page.width = pageWidth;
+  page.height = pageHeight;
+
+  // Reads the page from the XTC file. Returns the message to show on failure, nullptr on success.
+  uint8_t* pageBuffer = nullptr;
+  const auto loadXtcPage = [&]() -> const char* {
+    pageBuffer = static_cast<uint8_t*>(malloc(pageBufferSize));
+    if (!pageBuffer) {
+      LOG_ERR("XTR", "Failed to allocate page buffer (%lu bytes)", pageBufferSize);
+      return tr(STR_MEMORY_ERROR);
+    }
+    size_t bytesRead = xtc->loadPage(currentPage, pageBuffer, pageBufferSize);
+    if (bytesRead == 0) {
+      LOG_ERR("XTR", "Failed to load page %lu: bufferSize=%lu bitDepth=%u error=%s", currentPage, pageBufferSize,
+              bitDepth, xtc::errorToString(xtc->getLastError()));
+      free(pageBuffer);
+      pageBuffer = nullptr;
+      return tr(STR_PAGE_LOAD_ERROR);
+    }
+    page.plane = pageBuffer;
+    page.plane2 = bitDepth == 2 ? pageBuffer + planeSize : nullptr;  // Bit2 plane
+    return nullptr;
+  };
+  const auto showLoadError = [&](const char* message) {
     renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_MEMORY_ERROR), true, EpdFontFamily::BOLD);
+    renderer.drawCenteredText(UI_12_FONT_ID, 300, message, true, EpdFontFamily::BOLD);
     renderer.displayBuffer();
-    return;
-  }
+  };
 
-  // Load page data
-  size_t bytesRead = xtc->loadPage(currentPage, pageBuffer, pageBufferSize);
-  if (bytesRead == 0) {
-    LOG_ERR("XTR", "Failed to load page %lu: bufferSize=%lu bitDepth=%u error=%s", currentPage, pageBufferSize,
-            bitDepth, xtc::errorToString(xtc->getLastError()));
-    free(pageBuffer);
-    renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_PAGE_LOAD_ERROR), true, EpdFontFamily::BOLD);
-    renderer.displayBuffer();
-    return;
+  if (!fromNative) {
+    if (const char* error = loadXtcPage()) {
+      showLoadError(error);
+      return;
+    }
   }
+  bool buildNative = nativeCache && !fromNative && xtc->beginNativePage(currentPage);
+
+  // Fills the cleared framebuffer with one pass of the page, from the native cache or through the
+  // packed-plane blitter. A drawn pass is appended to the native page being built. When a native
+  // plane cannot be read, this and the remaining passes are drawn from the XTC page instead.
+  const auto drawPass = [&](const xtc::NativePlane plane, const GfxRenderer::PackedPlane::Ink ink,
+                            const bool state) -> const char* {
+    if (fromNative) {
+      if (xtc->loadNativePlane(nativeFile, plane, renderer.getFrameBuffer(), renderer.getBufferSize()) != 0) {
+        return nullptr;
+      }
+      LOG_ERR("XTR", "Failed to load native page %lu plane %u: %s; drawing it from the XTC page", currentPage, plane,
+              xtc::errorToString(xtc->getLastError()));
+      fromNative = false;
+      nativeFile.close();
+      if (const char* error = loadXtcPage()) {
+        return error;
+      }
+      // The failed read may have left part of the plane behind
+      renderer.clearScreen(state ? 0xFF : 0x00);
+    }
+    page.ink = ink;
+    renderer.drawPackedPlane(page, 0, 0, state);
+    if (buildNative) {
+      xtc->writeNativePlane(renderer.getFrameBuffer(), renderer.getBufferSize());
+    }
+    return nullptr;
+  };
 
   // Clear screen first
   renderer.clearScreen();
 
-  // Copy page bitmap using GfxRenderer's drawPixel
-  // XTC/XTCH pages are pre-rendered with status bar included, so render full page
-  const uint16_t maxSrcY = pageHeight;
-
   if (bitDepth == 2) {
     // XTH 2-bit mode: Two bit planes, column-major order
     // - Columns scanned right to left (x = width-1 down to 0)
@@ -255,43 +305,37 @@ void XtcReaderActivity::renderPage() {
     // - First plane: Bit1, Second plane: Bit2
     // - Pixel value = (bit1 << 1) | bit2
     // - Grayscale: 0=White, 1=Dark Grey, 2=Light Grey, 3=Black
-
-    const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
-    const uint8_t* plane1 = pageBuffer;              // Bit1 plane
-    const uint8_t* plane2 = pageBuffer + planeSize;  // Bit2 plane
-    const size_t colBytes = (pageHeight + 7) / 8;    // Bytes per column (100 for 800 height)
-
-    // Lambda to get pixel value at (x, y)
-    auto getPixelValue = [&](uint16_t x, uint16_t y) -> uint8_t {
-      const size_t colIndex = pageWidth - 1 - x;
-      const size_t byteInCol = y / 8;
-      const size_t bitInByte = 7 - (y % 8);
-      const size_t byteOffset = colIndex * colBytes + byteInCol;
-      const uint8_t bit1 = (plane1[byteOffset] >> bitInByte) & 1;
-      const uint8_t bit2 = (plane2[byteOffset] >> bitInByte) & 1;
-      return (bit1 << 1) | bit2;
-    };
+    // Each pass combines the two planes a byte at a time and blits the result
+    page.layout = GfxRenderer::PackedPlane::Layout::ColumnMajorReversed;
 
     // Optimized grayscale rendering without storeBwBuffer (saves 48KB peak memory)
     // Flow: BW display → LSB/MSB passes → grayscale display → re-render BW for next frame
 
     // Count pixel distribution for debugging
-    uint32_t pixelCounts[4] = {0, 0, 0, 0};
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        pixelCounts[getPixelValue(x, y)]++;
+    if (pageBuffer) {
+      const uint8_t* plane1 = page.plane;
+      const uint8_t* plane2 = page.plane2;
+      const size_t colBytes = (pageHeight + 7) / 8;  // Bytes per column (100 for 800 height)
+      const uint8_t tailMask = static_cast<uint8_t>(0xFF << ((8 - (pageHeight & 7)) & 7));
+      uint32_t pixelCounts[4] = {0, 0, 0, 0};
+      for (size_t col = 0; col < pageWidth; col++) {
+        for (size_t b = 0; b < colBytes; b++) {
+          const size_t i = col * colBytes + b;
+          const uint8_t mask = b == colBytes - 1 ? tailMask : 0xFF;
+          pixelCounts[1] += __builtin_popcount(~plane1[i] & plane2[i] & mask);
+          pixelCounts[2] += __builtin_popcount(plane1[i] & ~plane2[i] & mask);
+          pixelCounts[3] += __builtin_popcount(plane1[i] & plane2[i] & mask);
+        }
       }
+      pixelCounts[0] = static_cast<uint32_t>(pageWidth) * pageHeight - pixelCounts[1] - pixelCounts[2] - pixelCounts[3];
+      LOG_DBG("XTR", "Pixel distribution: White=%lu, DarkGrey=%lu, LightGrey=%lu, Black=%lu", pixelCounts[0],
+              pixelCounts[1], pixelCounts[2], pixelCounts[3]);
     }
-    LOG_DBG("XTR", "Pixel distribution: White=%lu, DarkGrey=%lu, LightGrey=%lu, Black=%lu", pixelCounts[0],
-            pixelCounts[1], pixelCounts[2], pixelCounts[3]);
 
     // Pass 1: BW buffer - draw all non-white pixels as black
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
+    if (const char* error = drawPass(xtc::NATIVE_PLANE_BW, GfxRenderer::PackedPlane::Ink::Either, true)) {
+      showLoadError(error);
+      return;
     }
 
     if (pagesUntilFullRefresh <= 1) {
@@ -308,42 +352,42 @@ void XtcReaderActivity::renderPage() {
       pagesUntilFullRefresh--;
     }
 
+    // A later pass that fails leaves the controller mid-grayscale: show the error, then resync it from that screen
+    const auto abortGrayscale = [&](const char* error) {
+      showLoadError(error);
+      renderer.cleanupGrayscaleWithFrameBuffer();
+    };
+
     // Pass 2: LSB buffer - mark DARK gray only (XTH value 1)
     // In LUT: 0 bit = apply gray effect, 1 bit = untouched
     renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) == 1) {  // Dark grey only
-          renderer.drawPixel(x, y, false);
-        }
-      }
+    if (const char* error = drawPass(xtc::NATIVE_PLANE_GRAY_LSB, GfxRenderer::PackedPlane::Ink::SecondOnly, false)) {
+      abortGrayscale(error);
+      return;
     }
     renderer.copyGrayscaleLsbBuffers();
 
     // Pass 3: MSB buffer - mark LIGHT AND DARK gray (XTH value 1 or 2)
     // In LUT: 0 bit = apply gray effect, 1 bit = untouched
     renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        const uint8_t pv = getPixelValue(x, y);
-        if (pv == 1 || pv == 2) {  // Dark grey or Light grey
-          renderer.drawPixel(x, y, false);
-        }
-      }
+    if (const char* error = drawPass(xtc::NATIVE_PLANE_GRAY_MSB, GfxRenderer::PackedPlane::Ink::Differ, false)) {
+      abortGrayscale(error);
+      return;
     }
     renderer.copyGrayscaleMsbBuffers();
+    if (buildNative) {
+      xtc->endNativePage();
+      buildNative = false;
+    }
 
     // Display grayscale overlay
     renderer.displayGrayBuffer();
 
     // Pass 4: Re-render BW to framebuffer (restore for next frame, instead of restoreBwBuffer)
     renderer.clearScreen();
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
+    if (const char* error = drawPass(xtc::NATIVE_PLANE_BW, GfxRenderer::PackedPlane::Ink::Either, true)) {
+      abortGrayscale(error);
+      return;
     }
 
     // Cleanup grayscale buffers with current frame buffer
@@ -351,25 +395,18 @@ void XtcReaderActivity::renderPage() {
 
     free(pageBuffer);
 
-    LOG_DBG("XTR", "Rendered page %lu/%lu (2-bit grayscale)", currentPage + 1, xtc->getPageCount());
+    LOG_DBG("XTR", "Rendered page %lu/%lu (2-bit grayscale%s)", currentPage + 1, xtc->getPageCount(),
+            fromNative ? ", native" : "");
     return;
   } else {
-    // 1-bit mode: 8 pixels per byte, MSB first
-    const size_t srcRowBytes = (pageWidth + 7) / 8;  // 60 bytes for 480 width
-
-    for (uint16_t srcY = 0; srcY < maxSrcY; srcY++) {
-      const size_t srcRowStart = srcY * srcRowBytes;
-
-      for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
-        // Read source pixel (MSB first, bit 7 = leftmost pixel)
-        const size_t srcByte = srcRowStart + srcX / 8;
-        const size_t srcBit = 7 - (srcX % 8);
-        const bool isBlack = !((pageBuffer[srcByte] >> srcBit) & 1);  // XTC: 0 = black, 1 = white
-
-        if (isBlack) {
-          renderer.drawPixel(srcX, srcY, true);
-        }
-      }
+    // 1-bit mode: 8 pixels per byte, MSB first (bit 7 = leftmost pixel), XTC: 0 = black, 1 = white
+    page.layout = GfxRenderer::PackedPlane::Layout::RowMajor;
+    if (const char* error = drawPass(xtc::NATIVE_PLANE_BW, GfxRenderer::PackedPlane::Ink::Clear, true)) {
+      showLoadError(error);
+      return;
+    }
+    if (buildNative) {
+      xtc->endNativePage();
     }
   }
   // White pixels are already cleared by clearScreen()
@@ -384,7 +421,8 @@ void XtcReaderActivity::renderPage() {
 
   ReaderUtils::displayWithRefreshCycle(renderer, pagesUntilFullRefresh);
 
-  LOG_DBG("XTR", "Rendered page %lu/%lu (%u-bit)", currentPage + 1, xtc->getPageCount(), bitDepth);
+  LOG_DBG("XTR", "Rendered page %lu/%lu (%u-bit%s)", currentPage + 1, xtc->getPageCount(), bitDepth,
+          fromNative ? ", native" : "");
 }
 
 void XtcReaderActivity::saveProgress() const {
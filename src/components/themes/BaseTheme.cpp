@@ -766,15 +766,22 @@ void BaseTheme::drawStatusBar(GfxRenderer& renderer, const float bookProgress, c
   int rightClusterWidth = 0;
 
   if (SETTINGS.statusBarBookProgressPercentage || SETTINGS.statusBarChapterPageCount) {
-    // Right aligned text for progress counter
-    char progressStr[32];
+    // Right aligned text for progress counter. A negative page count means the total is still being
+    // computed (e.g. a text file indexing in the background).
+    char pageCountStr[40];
+    if (pageCount >= 0) {
+      snprintf(pageCountStr, sizeof(pageCountStr), "%d/%d", currentPage, pageCount);
+    } else {
+      snprintf(pageCountStr, sizeof(pageCountStr), "%d/%s", currentPage, tr(STR_ESTIMATING));
+    }
+    char progressStr[48];
 
     if (SETTINGS.statusBarBookProgressPercentage && SETTINGS.statusBarChapterPageCount) {
-      snprintf(progressStr, sizeof(progressStr), "%d/%d  %.0f%%", currentPage, pageCount, bookProgress);
+      snprintf(progressStr, sizeof(progressStr), "%s  %.0f%%", pageCountStr, bookProgress);
     } else if (SETTINGS.statusBarBookProgressPercentage) {
       snprintf(progressStr, sizeof(progressStr), "%.0f%%", bookProgress);
     } else {
-      snprintf(progressStr, sizeof(progressStr), "%d/%d", currentPage, pageCount);
+      snprintf(progressStr, sizeof(progressStr), "%s", pageCountStr);
     }
 
     int progressTextWidth = renderer.getTextWidth(SMALL_FONT_ID, progressStr);
@@ -783,8 +790,12 @@ void BaseTheme::drawStatusBar(GfxRenderer& renderer, const float bookProgress, c
     rightClusterWidth += progressTextWidth;
   }
 
-  // Draw Progress Bar
-  if (SETTINGS.statusBarProgressBar != CrossPointSettings::STATUS_BAR_PROGRESS_BAR::HIDE_PROGRESS) {
+  // Draw Progress Bar. Chapter progress has nothing to show until the page count is known, so the bar
+  // stays hidden rather than sitting at 0%.
+  const bool chapterCountPending =
+      SETTINGS.statusBarProgressBar == CrossPointSettings::STATUS_BAR_PROGRESS_BAR::CHAPTER_PROGRESS && pageCount < 0;
+  if (SETTINGS.statusBarProgressBar != CrossPointSettings::STATUS_BAR_PROGRESS_BAR::HIDE_PROGRESS &&
+      !chapterCountPending) {
     const int barMarginLeft = fillMargin ? 0 : orientedMarginLeft;
     const int barMarginRight = fillMargin ? 0 : orientedMarginRight;
     const int progressBarMaxWidth = renderer.getScreenWidth() - barMarginLeft - barMarginRight;
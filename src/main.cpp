@@ -1,4 +1,5 @@
 #include <Arduino.h>
+#include <BookCacheKey.h>
 #include <Epub.h>
 #include <FontCacheManager.h>
 #include <FontDecompressor.h>
@@ -13,6 +14,7 @@
 #include <I18n.h>
 #include <Logging.h>
 #include <SPI.h>
+#include <SdCardFont.h>
 #include <WiFi.h>
 #include <builtinFonts/all.h>
 
@@ -345,6 +347,8 @@ void setup() {
   HalSystem::checkPanic();
 
   SETTINGS.loadFromFile();
+  BookCacheKey::setContentKeysEnabled(SETTINGS.contentCacheKeys);
+  SdCardFont::setBookSubsetsEnabled(SETTINGS.fontBookSubsets);
   APP_STATE.loadFromFile();
   RECENT_BOOKS.loadFromFile();
   I18N.setLanguage(static_cast<Language>(SETTINGS.language));
@@ -489,6 +493,8 @@ void loop() {
   halTiltSensor.update(SETTINGS.tiltPageTurn, SETTINGS.orientation, activityManager.isReaderActivity());
 
   renderer.setFadingFix(SETTINGS.fadingFix);
+  BookCacheKey::setContentKeysEnabled(SETTINGS.contentCacheKeys);
+  SdCardFont::setBookSubsetsEnabled(SETTINGS.fontBookSubsets);
 
   if (Serial && millis() - lastMemPrint >= 10000) {
     LOG_INF("MEM", "Free: %d bytes, Total: %d bytes, Min Free: %d bytes, MaxAlloc: %d bytes", ESP.getFreeHeap(),
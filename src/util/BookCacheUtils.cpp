@@ -1,5 +1,6 @@
 #include "BookCacheUtils.h"
 
+#include <BookCacheKey.h>
 #include <Epub.h>
 #include <FsHelpers.h>
 #include <Logging.h>
@@ -21,6 +22,12 @@ bool isBookCacheDirectoryName(const char* name) {
 }
 
 void clearBookCache(const std::string& path) {
+  if (BookCacheKey::cacheSharedWithOtherPath("/.crosspoint", path)) {
+    // Another copy of the book still reads from this cache; only drop this path's index entry
+    BookCacheKey::forgetPath("/.crosspoint", path);
+    LOG_DBG("BookCache", "Keeping cache shared with another copy of: %s", path.c_str());
+    return;
+  }
   if (FsHelpers::hasEpubExtension(path)) {
     Epub(path, "/.crosspoint").clearCache();
   } else if (FsHelpers::hasXtcExtension(path)) {
@@ -30,5 +37,16 @@ void clearBookCache(const std::string& path) {
   } else {
     return;
   }
+  BookCacheKey::forgetPath("/.crosspoint", path);
   LOG_DBG("BookCache", "Done checking metadata cache for: %s", path.c_str());
 }
+
+void prepareBookCacheForMove(const std::string& path) {
+  if (!BookCacheKey::contentKeysEnabled()) {
+    clearBookCache(path);
+  }
+}
+
+void finishBookCacheMove(const std::string& oldPath, const std::string& newPath) {
+  BookCacheKey::notePathMoved("/.crosspoint", oldPath, newPath);
+}
@@ -6,5 +6,12 @@
 // (EPUB, XTC, or TXT). Does nothing for other file types.
 void clearBookCache(const std::string& path);
 
+// Call before renaming or moving a book file. Path-keyed caches can't follow the file and are cleared;
+// content-keyed caches are kept and picked up again under the new path.
+void prepareBookCacheForMove(const std::string& path);
+
+// Call after a successful rename or move so the content key index follows the file without re-hashing it.
+void finishBookCacheMove(const std::string& oldPath, const std::string& newPath);
+
 // Returns true if the directory name matches a book cache entry.
 bool isBookCacheDirectoryName(const char* name);
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "CssAncestorStack.h"
+#include "CssParser.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+class CssParserTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir = fs::temp_directory_path() /
+          ("css_parser_test_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    parser = std::make_unique<CssParser>(dir.string());
+  }
+
+  void TearDown() override {
+    parser.reset();
+    fs::remove_all(dir);
+  }
+
+  void load(const std::string& css) {
+    const fs::path path = dir / "style.css";
+    std::ofstream(path, std::ios::binary) << css;
+    HalFile file;
+    ASSERT_TRUE(Storage.openFileForRead("TEST", path.string(), file));
+    ASSERT_TRUE(parser->loadFromStream(file));
+  }
+
+  // Compiles the parsed rules to the on-disk table and queries that instead
+  void reloadFromCache() {
+    ASSERT_TRUE(parser->saveToCache());
+    ASSERT_TRUE(parser->loadFromCache());
+  }
+
+  // Pushes (tag, class attribute) pairs from the root down, leaving the stack positioned for their child
+  static CssAncestorStack ancestors(std::initializer_list<std::pair<const char*, const char*>> path) {
+    CssAncestorStack stack;
+    int depth = 0;
+    for (const auto& [tag, classAttr] : path) {
+      stack.setDepth(depth++);
+      stack.push(tag, classAttr);
+    }
+    stack.setDepth(depth);
+    return stack;
+  }
+
+  fs::path dir;
+  std::unique_ptr<CssParser> parser;
+};
+
+float indentEm(const CssStyle& style) { return style.defined.textIndent ? style.textIndent.value : -1.0f; }
+
+TEST_F(CssParserTest, KeepsDescendantAndChildSelectors) {
+  load("div p { text-indent: 1em } blockquote > p { text-indent: 2em } .a .b > p.c span { text-indent: 3em }");
+  EXPECT_EQ(parser->ruleCount(), 3u);
+}
+
+TEST_F(CssParserTest, RejectsMalformedAndUnsupportedSelectors) {
+  load(
+      "p > { text-indent: 1em }"
+      "> p { text-indent: 1em }"
+      "div > > p { text-indent: 1em }"
+      "div .a..b { text-indent: 1em }"
+      "div . { text-indent: 1em }"
+      "div + p { text-indent: 1em }"
+      "div ~ p { text-indent: 1em }"
+      "#id p { text-indent: 1em }"
+      "div p:first-child { text-indent: 1em }"
+      "div [lang] { text-indent: 1em }"
+      "* p { text-indent: 1em }"
+      "a b c d e f { text-indent: 1em }");
+  EXPECT_EQ(parser->ruleCount(), 0u);
+}
+
+TEST_F(CssParserTest, KeepsMaximumLengthChain) {
+  load("a b c d e { text-indent: 1em }");
+  EXPECT_EQ(parser->ruleCount(), 1u);
+}
+
+TEST_F(CssParserTest, DescendantMatchesAnyAncestor) {
+  load(".chapter p { text-indent: 1em }");
+  const auto stack = ancestors({{"body", ""}, {"div", "chapter"}, {"section", ""}, {"div", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &stack)), 1.0f);
+
+  const auto other = ancestors({{"body", ""}, {"div", "preface"}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &other)), -1.0f);
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "")), -1.0f);
+}
+
+TEST_F(CssParserTest, ChildMatchesOnlyParent) {
+  load("blockquote > p { text-indent: 2em }");
+  const auto direct = ancestors({{"body", ""}, {"blockquote", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &direct)), 2.0f);
+
+  const auto nested = ancestors({{"body", ""}, {"blockquote", ""}, {"div", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &nested)), -1.0f);
+}
+
+TEST_F(CssParserTest, BacktracksDescendantStepPastFailedChildStep) {
+  // The nearest span has an em for a parent, so the span step must move out to the outer span
+  load("div > span p { text-indent: 1em }");
+  const auto matching = ancestors({{"div", ""}, {"span", ""}, {"em", ""}, {"span", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &matching)), 1.0f);
+
+  const auto failing = ancestors({{"span", ""}, {"div", ""}, {"em", ""}, {"span", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &failing)), -1.0f);
+}
+
+TEST_F(CssParserTest, BacktracksAcrossChainedChildSteps) {
+  // section > span fails from the nearest span; backtracking has to skip the child step back to the descendant one
+  load("div > section > span p { text-indent: 1em }");
+  const auto matching = ancestors({{"div", ""}, {"section", ""}, {"span", ""}, {"section", ""}, {"span", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &matching)), 1.0f);
+
+  const auto failing = ancestors({{"body", ""}, {"section", ""}, {"span", ""}, {"section", ""}, {"span", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &failing)), -1.0f);
+}
+
+TEST_F(CssParserTest, ChildSubjectDoesNotBacktrackPastParent) {
+  load("div > p { text-indent: 1em }");
+  const auto stack = ancestors({{"div", ""}, {"span", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &stack)), -1.0f);
+}
+
+TEST_F(CssParserTest, ClassBeatsLessSpecificDescendantSelector) {
+  // body p is (0,0,2); .noindent is (0,1,0) and wins wherever it appears in the source
+  for (const char* css : {"body p { text-indent: 1em } .noindent { text-indent: 0 }",
+                          ".noindent { text-indent: 0 } body p { text-indent: 1em }"}) {
+    SetUp();
+    load(css);
+    const auto stack = ancestors({{"html", ""}, {"body", ""}});
+    EXPECT_EQ(indentEm(parser->resolveStyle("p", "noindent", &stack)), 0.0f) << css;
+    EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &stack)), 1.0f) << css;
+  }
+}
+
+TEST_F(CssParserTest, TagClassBeatsTwoTagDescendantSelector) {
+  load("p.note { margin-left: 2em } div p { margin-left: 1em }");
+  const auto stack = ancestors({{"div", ""}});
+  const CssStyle style = parser->resolveStyle("p", "note", &stack);
+  ASSERT_TRUE(style.defined.marginLeft);
+  EXPECT_EQ(style.marginLeft.value, 2.0f);
+}
+
+TEST_F(CssParserTest, DescendantSelectorBeatsLessSpecificFlatRule) {
+  load(".chapter p { text-indent: 2em } p { text-indent: 1em }");
+  const auto stack = ancestors({{"div", "chapter"}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &stack)), 2.0f);
+}
+
+TEST_F(CssParserTest, SourceOrderBreaksSpecificityTies) {
+  // div .x and p.x are both (0,1,1)
+  load("div .x { text-indent: 1em } p.x { text-indent: 2em }");
+  const auto stack = ancestors({{"div", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "x", &stack)), 2.0f);
+
+  SetUp();
+  load("p.x { text-indent: 2em } div .x { text-indent: 1em }");
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "x", &stack)), 1.0f);
+}
+
+TEST_F(CssParserTest, CascadeSurvivesRuleTable) {
+  load("body p { text-indent: 1em } .noindent { text-indent: 0 } div .x { text-indent: 3em } p.x { text-indent: 2em }");
+  reloadFromCache();
+  const auto stack = ancestors({{"body", ""}, {"div", ""}});
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "noindent", &stack)), 0.0f);
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &stack)), 1.0f);
+  EXPECT_EQ(indentEm(parser->resolveStyle("p", "x", &stack)), 2.0f);
+}
+
+TEST_F(CssParserTest, MemoizedStylesStillDependOnAncestors) {
+  load(".chapter p { text-indent: 2em } p { text-indent: 1em } .noindent { text-indent: 0 }");
+  reloadFromCache();
+  ASSERT_TRUE(parser->beginStyleMemo());
+  const auto inside = ancestors({{"div", "chapter"}});
+  const auto outside = ancestors({{"div", ""}});
+  for (int pass = 0; pass < 2; pass++) {
+    EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &inside)), 2.0f);
+    EXPECT_EQ(indentEm(parser->resolveStyle("p", "", &outside)), 1.0f);
+    // .chapter p (0,1,1) outranks .noindent (0,1,0)
+    EXPECT_EQ(indentEm(parser->resolveStyle("p", "noindent", &inside)), 2.0f);
+    EXPECT_EQ(indentEm(parser->resolveStyle("p", "noindent", &outside)), 0.0f);
+  }
+  EXPECT_GT(parser->getStyleMemoStats().hits, 0u);
+  parser->endStyleMemo();
+}
+
+}  // namespace
@@ -75,6 +75,8 @@ const EpdFontData kTestFontData = {
   .ligaturePairCount = 0,
   .glyphMissHandler  = nullptr,
   .glyphMissCtx      = nullptr,
+  .kernRowStarts     = nullptr,
+  .kernPairs         = nullptr,
 };
 // clang-format on
 
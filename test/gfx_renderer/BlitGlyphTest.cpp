@@ -0,0 +1,165 @@
+#include <FontCacheManager.h>
+#include <FontDecompressor.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <builtinFonts/notoserif_12_regular.h>
+#include <builtinFonts/ubuntu_10_regular.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+extern HalDisplay display;
+
+namespace {
+
+constexpr int FONT_2BIT = 1;  // compressed, 2 bits per pixel
+constexpr int FONT_1BIT = 2;  // uncompressed, 1 bit per pixel
+constexpr const char* CHARS = "Ag@W|j%";
+constexpr int STRIP_ROWS = 56;
+
+// Compares the byte-wise glyph blitter behind drawText() with the per-pixel drawPixel() path it replaced
+class BlitGlyphTest : public ::testing::Test {
+ protected:
+  BlitGlyphTest()
+      : serif(&notoserif_12_regular),
+        ubuntu(&ubuntu_10_regular),
+        renderer(display),
+        fcm(renderer.getFontMap(), renderer.getSdCardFonts()) {}
+
+  void SetUp() override {
+    display.begin();
+    renderer.begin();
+    renderer.insertFont(FONT_2BIT, EpdFontFamily(&serif));
+    renderer.insertFont(FONT_1BIT, EpdFontFamily(&ubuntu));
+    ASSERT_TRUE(decompressor.init());
+    fcm.setFontDecompressor(&decompressor);
+    renderer.setFontCacheManager(&fcm);
+  }
+
+  void TearDown() override {
+    renderer.setRenderMode(GfxRenderer::BW);
+    fcm.clearCache();
+  }
+
+  // Glyph positions: inside the screen at several bit offsets, then hanging off each edge, then each corner
+  std::vector<std::pair<int, int>> positions() const {
+    const int w = renderer.getScreenWidth();
+    const int h = renderer.getScreenHeight();
+    return {{0, 0}, {13, 29}, {w / 2 + 3, h / 2 + 5}, {-6, h / 3}, {w - 7, h / 3},
+            {w / 3, -9}, {w / 3, h - 6}, {-5, -11}, {w - 4, h - 3}, {w - 9, -7}};
+  }
+
+  // Draws one character the way renderCharImpl positions it, through drawPixel
+  void drawReference(const int fontId, const uint32_t cp, const int x, const int y, const bool rotated,
+                     const bool pixelState) const {
+    const EpdFontFamily& family = renderer.getFontMap().at(fontId);
+    const EpdFontData* fontData = family.getData(EpdFontFamily::REGULAR);
+    const EpdGlyph* glyph = family.getGlyph(cp, EpdFontFamily::REGULAR);
+    ASSERT_NE(glyph, nullptr);
+    const uint8_t* bitmap = renderer.getGlyphBitmap(fontData, glyph);
+    ASSERT_NE(bitmap, nullptr);
+
+    const GfxRenderer::RenderMode mode = renderer.getRenderMode();
+    const bool black = pixelState && (!fontData->is2Bit || mode == GfxRenderer::BW);
+    const int originX = rotated ? x + fontData->ascender - glyph->top : x + glyph->left;
+    const int originY = rotated ? y - glyph->left : y + renderer.getFontAscenderSize(fontId) - glyph->top;
+
+    for (int gy = 0; gy < glyph->height; gy++) {
+      for (int gx = 0; gx < glyph->width; gx++) {
+        const int pos = gy * glyph->width + gx;
+        bool ink;
+        if (fontData->is2Bit) {
+          const uint8_t raw = (bitmap[pos >> 2] >> ((3 - (pos & 3)) * 2)) & 0x3;
+          ink = mode == GfxRenderer::BW              ? raw != 0
+                : mode == GfxRenderer::GRAYSCALE_MSB ? (raw == 1 || raw == 2)
+                                                     : raw == 2;
+        } else {
+          ink = (bitmap[pos >> 3] >> (7 - (pos & 7))) & 1;
+        }
+        const int lx = rotated ? originX + gy : originX + gx;
+        const int ly = rotated ? originY - gx : originY + gy;
+        if (ink && lx >= 0 && lx < renderer.getScreenWidth() && ly >= 0 && ly < renderer.getScreenHeight()) {
+          renderer.drawPixel(lx, ly, black);
+        }
+      }
+    }
+  }
+
+  void drawFast(const int fontId, const char* text, const int x, const int y, const bool rotated,
+                const bool pixelState) const {
+    if (rotated) {
+      renderer.drawTextRotated90CW(fontId, x, y, text, pixelState);
+    } else {
+      renderer.drawText(fontId, x, y, text, pixelState);
+    }
+  }
+
+  template <typename Draw>
+  std::vector<uint8_t> renderFrame(const uint8_t clearColor, Draw draw) const {
+    renderer.clearScreen(clearColor);
+    draw();
+    return {renderer.getFrameBuffer(), renderer.getFrameBuffer() + renderer.getBufferSize()};
+  }
+
+  // Same, one strip target at a time, stitched back into a frame
+  template <typename Draw>
+  std::vector<uint8_t> renderStrips(const uint8_t clearColor, Draw draw) const {
+    const int widthBytes = renderer.getDisplayWidthBytes();
+    const int panelHeight = renderer.getDisplayHeight();
+    std::vector<uint8_t> frame(renderer.getBufferSize());
+    std::vector<uint8_t> scratch(static_cast<size_t>(STRIP_ROWS) * widthBytes);
+    for (int y0 = 0; y0 < panelHeight; y0 += STRIP_ROWS) {
+      const int rows = std::min(STRIP_ROWS, panelHeight - y0);
+      renderer.beginStripTarget(scratch.data(), y0, rows);
+      renderer.clearScreen(clearColor);
+      draw();
+      renderer.endStripTarget();
+      memcpy(frame.data() + static_cast<size_t>(y0) * widthBytes, scratch.data(),
+             static_cast<size_t>(rows) * widthBytes);
+    }
+    return frame;
+  }
+
+  EpdFont serif;
+  EpdFont ubuntu;
+  GfxRenderer renderer;
+  FontDecompressor decompressor;
+  FontCacheManager fcm;
+};
+
+TEST_F(BlitGlyphTest, MatchesDrawPixelInEveryOrientation) {
+  for (const auto orientation : {GfxRenderer::Portrait, GfxRenderer::LandscapeClockwise,
+                                 GfxRenderer::PortraitInverted, GfxRenderer::LandscapeCounterClockwise}) {
+    renderer.setOrientation(orientation);
+    for (const auto mode : {GfxRenderer::BW, GfxRenderer::GRAYSCALE_LSB, GfxRenderer::GRAYSCALE_MSB}) {
+      renderer.setRenderMode(mode);
+      const uint8_t clearColor = mode == GfxRenderer::BW ? 0xFF : 0x00;
+      for (const int fontId : {FONT_2BIT, FONT_1BIT}) {
+        for (const bool rotated : {false, true}) {
+          for (const bool pixelState : {true, false}) {
+            for (const auto& [x, y] : positions()) {
+              for (const char* c = CHARS; *c; c++) {
+                const char text[] = {*c, '\0'};
+                const auto expected =
+                    renderFrame(clearColor, [&] { drawReference(fontId, *c, x, y, rotated, pixelState); });
+                const auto fast = [&] { drawFast(fontId, text, x, y, rotated, pixelState); };
+                const bool same = renderFrame(clearColor, fast) == expected;
+                const bool sameInStrips = renderStrips(clearColor, fast) == expected;
+                EXPECT_TRUE(same && sameInStrips)
+                    << "orientation " << orientation << " mode " << mode << " font " << fontId << " rotated "
+                    << rotated << " state " << pixelState << " '" << *c << "' at " << x << "," << y
+                    << (same ? " (strips)" : "");
+                if (!(same && sameInStrips)) return;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,147 @@
+#include <FontCacheManager.h>
+#include <FontDecompressor.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <builtinFonts/notoserif_12_bold.h>
+#include <builtinFonts/notoserif_12_italic.h>
+#include <builtinFonts/notoserif_12_regular.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+extern HalDisplay display;
+
+namespace {
+
+constexpr int FONT_ID = 1;
+constexpr const char* TEXT =
+    "The quick brown fox jumps over the lazy dog. Sphinx of black quartz, judge my vow! 0123456789 {}[]";
+
+class GlyphCoverageCacheTest : public ::testing::Test {
+ protected:
+  GlyphCoverageCacheTest()
+      : regular(&notoserif_12_regular),
+        bold(&notoserif_12_bold),
+        italic(&notoserif_12_italic),
+        renderer(display),
+        fcm(renderer.getFontMap(), renderer.getSdCardFonts()) {}
+
+  void SetUp() override {
+    display.begin();
+    renderer.begin();
+    renderer.insertFont(FONT_ID, EpdFontFamily(&regular, &bold, &italic, &italic));
+    ASSERT_TRUE(decompressor.init());
+    fcm.setFontDecompressor(&decompressor);
+    renderer.setFontCacheManager(&fcm);
+  }
+
+  void TearDown() override { fcm.clearCache(); }
+
+  // Draws the test text in every style, upright and rotated, some of it hanging off the screen edges
+  void drawPage() const {
+    const int lineHeight = renderer.getLineHeight(FONT_ID);
+    int y = -lineHeight / 2;
+    for (const auto style : {EpdFontFamily::REGULAR, EpdFontFamily::BOLD, EpdFontFamily::ITALIC}) {
+      renderer.drawText(FONT_ID, -7, y, TEXT, true, style);
+      renderer.drawText(FONT_ID, 20, y + lineHeight, TEXT, true, style);
+      y += 2 * lineHeight;
+    }
+    renderer.drawText(FONT_ID, 10, renderer.getScreenHeight() - lineHeight / 2, TEXT);
+    renderer.drawTextRotated90CW(FONT_ID, 30, renderer.getScreenHeight() - 20, TEXT);
+  }
+
+  // Renders the page in `mode`: optionally prewarming a prefix of the text, then optionally through
+  // the coverage cache, drawing every pass as the tiled grayscale path does
+  std::vector<uint8_t> render(const GfxRenderer::RenderMode mode, const size_t prewarmChars, const bool cached,
+                              const uint32_t budget = GlyphCoverageCache::DEFAULT_BUDGET_BYTES) {
+    fcm.clearCache();
+    if (prewarmChars > 0) {
+      const std::string prefix(TEXT, prewarmChars);
+      fcm.prewarmCache(FONT_ID, prefix.c_str(), 0x07);
+    }
+    if (cached) {
+      EXPECT_TRUE(fcm.enableGlyphCoverageCache(budget));
+    }
+
+    std::vector<uint8_t> frame;
+    // BW first fills the cache; the plane passes after it are the ones reading it back
+    for (const auto pass : {GfxRenderer::BW, mode}) {
+      renderer.setRenderMode(pass);
+      renderer.clearScreen(pass == GfxRenderer::BW ? 0xFF : 0x00);
+      drawPage();
+      if (pass == mode) {
+        frame.assign(renderer.getFrameBuffer(), renderer.getFrameBuffer() + renderer.getBufferSize());
+      }
+    }
+    renderer.setRenderMode(GfxRenderer::BW);
+    return frame;
+  }
+
+  EpdFont regular;
+  EpdFont bold;
+  EpdFont italic;
+  GfxRenderer renderer;
+  FontDecompressor decompressor;
+  FontCacheManager fcm;
+};
+
+TEST_F(GlyphCoverageCacheTest, CachedMasksDrawTheSamePixels) {
+  for (const auto orientation : {GfxRenderer::Portrait, GfxRenderer::LandscapeClockwise,
+                                 GfxRenderer::PortraitInverted, GfxRenderer::LandscapeCounterClockwise}) {
+    renderer.setOrientation(orientation);
+    for (const auto mode : {GfxRenderer::BW, GfxRenderer::GRAYSCALE_LSB, GfxRenderer::GRAYSCALE_MSB}) {
+      // No prewarm: every glyph comes from the hot group. Partial prewarm: both kinds on one page.
+      for (const size_t prewarm : {size_t{0}, size_t{20}}) {
+        const auto expected = render(mode, prewarm, false);
+        EXPECT_TRUE(render(mode, prewarm, true) == expected)
+            << "orientation " << orientation << " mode " << mode << " prewarm " << prewarm;
+        // Small enough that every pass evicts
+        EXPECT_TRUE(render(mode, prewarm, true, 1024) == expected)
+            << "orientation " << orientation << " mode " << mode << " prewarm " << prewarm << " (evicting)";
+      }
+    }
+  }
+}
+
+TEST_F(GlyphCoverageCacheTest, ReusesHotGroupGlyphsAcrossPasses) {
+  render(GfxRenderer::GRAYSCALE_MSB, 0, true);
+  const auto& stats = fcm.getGlyphCoverageCache()->getStats();
+  EXPECT_GT(stats.misses, 0u);
+  EXPECT_GT(stats.hits, stats.misses);
+  EXPECT_EQ(stats.evictions, 0u);
+}
+
+TEST_F(GlyphCoverageCacheTest, LeavesPrewarmedGlyphsInThePageBuffer) {
+  render(GfxRenderer::GRAYSCALE_MSB, strlen(TEXT), true);
+  const auto& stats = fcm.getGlyphCoverageCache()->getStats();
+  EXPECT_EQ(stats.hits + stats.misses, 0u);
+  EXPECT_EQ(stats.peakBytes, 0u);
+}
+
+TEST(GlyphCoverageMaskTest, SplitsPackedPixelsIntoRowAlignedPlanes) {
+  GlyphCoverageCache cache;
+  ASSERT_TRUE(cache.begin(256));
+  const EpdFontData* font = &notoserif_12_regular;  // only used as a key
+
+  // 10x2 2-bit glyph; pixels run on across rows: 0 1 2 3 3 2 1 0 1 2 | 3 0 0 0 0 0 0 0 0 3
+  const uint8_t packed2[] = {0b00011011, 0b11100100, 0b01101100, 0b00000000, 0b00000011};
+  const uint8_t* mask = cache.insert(font, 'a', packed2, 10, 2, true);
+  ASSERT_NE(mask, nullptr);
+  ASSERT_EQ(GlyphCoverageCache::maskSize(10, 2, true), 8u);
+  const uint8_t expected2[] = {
+      0b00111100, 0b01000000, 0b10000000, 0b01000000,  // high bits, rows 0 and 1
+      0b01011010, 0b10000000, 0b10000000, 0b01000000,  // low bits
+  };
+  EXPECT_EQ(memcmp(mask, expected2, sizeof(expected2)), 0);
+
+  // 9x2 1-bit glyph: 101100111 | 000000001
+  const uint8_t packed1[] = {0b10110011, 0b10000000, 0b01000000};
+  mask = cache.insert(font, 'b', packed1, 9, 2, false);
+  ASSERT_NE(mask, nullptr);
+  const uint8_t expected1[] = {0b10110011, 0b10000000, 0b00000000, 0b10000000};
+  EXPECT_EQ(memcmp(mask, expected1, sizeof(expected1)), 0);
+  EXPECT_EQ(cache.find(font, 'a')[4], expected2[4]);
+}
+
+}  // namespace
@@ -0,0 +1,174 @@
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+extern HalDisplay display;
+
+namespace {
+
+using Layout = GfxRenderer::PackedPlane::Layout;
+using Ink = GfxRenderer::PackedPlane::Ink;
+
+constexpr int STRIP_ROWS = 56;
+
+// Compares drawPackedPlane() with drawing every inked pixel through drawPixel()
+class PackedPlaneTest : public ::testing::Test {
+ protected:
+  PackedPlaneTest() : renderer(display) {}
+
+  void SetUp() override {
+    display.begin();
+    renderer.begin();
+  }
+
+  // Random planes for a width x height image; lines have no padding guarantees, so their tail bits are noise too
+  void makePlanes(const Layout layout, const int width, const int height) {
+    const int lineBytes = layout == Layout::RowMajor ? (width + 7) / 8 : (height + 7) / 8;
+    const int lines = layout == Layout::RowMajor ? height : width;
+    plane.resize(static_cast<size_t>(lineBytes) * lines);
+    plane2.resize(plane.size());
+    for (auto& b : plane) b = static_cast<uint8_t>(rng());
+    for (auto& b : plane2) b = static_cast<uint8_t>(rng());
+  }
+
+  GfxRenderer::PackedPlane image(const Layout layout, const Ink ink, const int width, const int height) const {
+    GfxRenderer::PackedPlane p;
+    p.plane = plane.data();
+    p.plane2 = plane2.data();
+    p.layout = layout;
+    p.ink = ink;
+    p.width = width;
+    p.height = height;
+    return p;
+  }
+
+  void drawReference(const GfxRenderer::PackedPlane& p, const int x, const int y, const bool state) const {
+    const bool rowMajor = p.layout == Layout::RowMajor;
+    const int lineBytes = rowMajor ? (p.width + 7) / 8 : (p.height + 7) / 8;
+    for (int row = 0; row < p.height; row++) {
+      for (int col = 0; col < p.width; col++) {
+        // RowMajor: bit col of line row. ColumnMajorReversed: bit row of line (width - 1 - col).
+        const int line = rowMajor ? row : p.width - 1 - col;
+        const int bit = rowMajor ? col : row;
+        const size_t i = static_cast<size_t>(line) * lineBytes + bit / 8;
+        const bool a = (p.plane[i] >> (7 - bit % 8)) & 1;
+        const bool b = (p.plane2[i] >> (7 - bit % 8)) & 1;
+        bool ink = false;
+        switch (p.ink) {
+          case Ink::Set:
+            ink = a;
+            break;
+          case Ink::Clear:
+            ink = !a;
+            break;
+          case Ink::Either:
+            ink = a || b;
+            break;
+          case Ink::Differ:
+            ink = a != b;
+            break;
+          case Ink::SecondOnly:
+            ink = !a && b;
+            break;
+        }
+        const int lx = x + col;
+        const int ly = y + row;
+        if (ink && lx >= 0 && lx < renderer.getScreenWidth() && ly >= 0 && ly < renderer.getScreenHeight()) {
+          renderer.drawPixel(lx, ly, state);
+        }
+      }
+    }
+  }
+
+  template <typename Draw>
+  std::vector<uint8_t> renderFrame(const uint8_t clearColor, Draw draw) const {
+    renderer.clearScreen(clearColor);
+    draw();
+    return {renderer.getFrameBuffer(), renderer.getFrameBuffer() + renderer.getBufferSize()};
+  }
+
+  // Same, one strip target at a time, stitched back into a frame
+  template <typename Draw>
+  std::vector<uint8_t> renderStrips(const uint8_t clearColor, Draw draw) const {
+    const int widthBytes = renderer.getDisplayWidthBytes();
+    const int panelHeight = renderer.getDisplayHeight();
+    std::vector<uint8_t> frame(renderer.getBufferSize());
+    std::vector<uint8_t> scratch(static_cast<size_t>(STRIP_ROWS) * widthBytes);
+    for (int y0 = 0; y0 < panelHeight; y0 += STRIP_ROWS) {
+      const int rows = std::min(STRIP_ROWS, panelHeight - y0);
+      renderer.beginStripTarget(scratch.data(), y0, rows);
+      renderer.clearScreen(clearColor);
+      draw();
+      renderer.endStripTarget();
+      memcpy(frame.data() + static_cast<size_t>(y0) * widthBytes, scratch.data(),
+             static_cast<size_t>(rows) * widthBytes);
+    }
+    return frame;
+  }
+
+  std::mt19937 rng{42};
+  std::vector<uint8_t> plane;
+  std::vector<uint8_t> plane2;
+  GfxRenderer renderer;
+};
+
+TEST_F(PackedPlaneTest, MatchesDrawPixelInEveryOrientation) {
+  // {width, height}: whole bytes, odd sizes, and lines shorter than one byte
+  const std::pair<int, int> sizes[] = {{64, 40}, {37, 19}, {5, 3}};
+  for (const auto orientation : {GfxRenderer::Portrait, GfxRenderer::LandscapeClockwise,
+                                 GfxRenderer::PortraitInverted, GfxRenderer::LandscapeCounterClockwise}) {
+    renderer.setOrientation(orientation);
+    const int w = renderer.getScreenWidth();
+    const int h = renderer.getScreenHeight();
+    for (const auto layout : {Layout::RowMajor, Layout::ColumnMajorReversed}) {
+      for (const auto& [width, height] : sizes) {
+        makePlanes(layout, width, height);
+        // Inside at two bit offsets, then hanging off each edge, then two corners
+        const std::pair<int, int> positions[] = {{0, 0},     {11, 7},        {-13, h / 2}, {w - width / 2, h / 3},
+                                                 {w / 2, -5}, {w / 3, h - 2}, {-3, -4},     {w - 3, h - height / 2}};
+        for (const auto ink : {Ink::Set, Ink::Clear, Ink::Either, Ink::Differ, Ink::SecondOnly}) {
+          const auto p = image(layout, ink, width, height);
+          for (const auto& [x, y] : positions) {
+            for (const bool state : {true, false}) {
+              const uint8_t clearColor = state ? 0xFF : 0x00;
+              const auto expected = renderFrame(clearColor, [&] { drawReference(p, x, y, state); });
+              const auto fast = [&] { renderer.drawPackedPlane(p, x, y, state); };
+              const bool same = renderFrame(clearColor, fast) == expected;
+              const bool sameInStrips = renderStrips(clearColor, fast) == expected;
+              EXPECT_TRUE(same && sameInStrips)
+                  << "orientation " << orientation << " layout " << static_cast<int>(layout) << " ink "
+                  << static_cast<int>(ink) << " " << width << "x" << height << " at " << x << "," << y << " state "
+                  << state << (same ? " (strips)" : "");
+              if (!(same && sameInStrips)) return;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(PackedPlaneTest, FullPageMatchesDrawPixel) {
+  // An XTC page: one plane covering the whole logical screen, in either layout
+  for (const auto orientation : {GfxRenderer::Portrait, GfxRenderer::LandscapeClockwise,
+                                 GfxRenderer::PortraitInverted, GfxRenderer::LandscapeCounterClockwise}) {
+    renderer.setOrientation(orientation);
+    const int w = renderer.getScreenWidth();
+    const int h = renderer.getScreenHeight();
+    for (const auto layout : {Layout::RowMajor, Layout::ColumnMajorReversed}) {
+      makePlanes(layout, w, h);
+      const auto p = image(layout, Ink::Clear, w, h);
+      const auto expected = renderFrame(0xFF, [&] { drawReference(p, 0, 0, true); });
+      EXPECT_TRUE(renderFrame(0xFF, [&] { renderer.drawPackedPlane(p, 0, 0, true); }) == expected)
+          << "orientation " << orientation << " layout " << static_cast<int>(layout);
+    }
+  }
+}
+
+}  // namespace
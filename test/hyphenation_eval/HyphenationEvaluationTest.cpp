@@ -8,7 +8,9 @@
 #include <string>
 #include <vector>
 
+#include "lib/Epub/Epub/hyphenation/HyphenationCache.h"
 #include "lib/Epub/Epub/hyphenation/HyphenationCommon.h"
+#include "lib/Epub/Epub/hyphenation/Hyphenator.h"
 #include "lib/Epub/Epub/hyphenation/LanguageHyphenator.h"
 #include "lib/Epub/Epub/hyphenation/LanguageRegistry.h"
 
@@ -232,3 +234,62 @@ TEST(HyphenationEval, Spanish) { runLanguageEval("spanish", "es", "spanish_hyphe
 TEST(HyphenationEval, Italian) { runLanguageEval("italian", "it", "italian_hyphenation_tests.txt", 98.99); }
 TEST(HyphenationEval, Polish) { runLanguageEval("polish", "pl", "polish_hyphenation_tests.txt", 98.92); }
 TEST(HyphenationEval, Swedish) { runLanguageEval("swedish", "sv", "swedish_hyphenation_tests.txt", 94.01); }
+
+TEST(HyphenationEval, ResultCacheMatchesPatterns) {
+  const std::vector<std::string> words = {"hyphenation", "extraordinary", "self-contained", "international",
+                                          "characteristically", "incomprehensibilities"};
+  Hyphenator::setPreferredLanguage("en");
+  ASSERT_STREQ(Hyphenator::languageTag(), "en");
+
+  auto sameBreaks = [](const std::vector<Hyphenator::BreakInfo>& a, const std::vector<Hyphenator::BreakInfo>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+      if (a[i].byteOffset != b[i].byteOffset || a[i].requiresInsertedHyphen != b[i].requiresInsertedHyphen) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::vector<std::vector<Hyphenator::BreakInfo>> expected;
+  for (const auto& word : words) expected.push_back(Hyphenator::breakOffsets(word, true));
+
+  const uint32_t patternSet = Hyphenator::patternSetId();
+  ASSERT_NE(patternSet, 0u);
+
+  HyphenationCache cache;
+  ASSERT_TRUE(cache.begin("en", patternSet));
+  Hyphenator::setResultCache(&cache);
+  for (size_t i = 0; i < words.size(); i++) {
+    EXPECT_TRUE(sameBreaks(Hyphenator::breakOffsets(words[i], true), expected[i])) << words[i];
+  }
+  EXPECT_EQ(cache.getStats().hits, 0u);
+  EXPECT_TRUE(cache.isDirty());
+
+  // A spilled table read back into a fresh cache answers from the table
+  std::vector<uint8_t> image(cache.data(), cache.data() + HyphenationCache::dataSize());
+  HyphenationCache reloaded;
+  ASSERT_TRUE(reloaded.begin("en", patternSet));
+  std::copy(image.begin(), image.end(), reloaded.data());
+  EXPECT_TRUE(reloaded.validateLoaded());
+  Hyphenator::setResultCache(&reloaded);
+  for (size_t i = 0; i < words.size(); i++) {
+    EXPECT_TRUE(sameBreaks(Hyphenator::breakOffsets(words[i], true), expected[i])) << words[i];
+  }
+  EXPECT_EQ(reloaded.getStats().hits, words.size());
+  EXPECT_FALSE(reloaded.isDirty());
+
+  // A table written for another language is discarded
+  HyphenationCache other;
+  ASSERT_TRUE(other.begin("de", patternSet));
+  std::copy(image.begin(), image.end(), other.data());
+  EXPECT_FALSE(other.validateLoaded());
+
+  // So is one written with other patterns for the same language
+  HyphenationCache rebuilt;
+  ASSERT_TRUE(rebuilt.begin("en", patternSet + 1));
+  std::copy(image.begin(), image.end(), rebuilt.data());
+  EXPECT_FALSE(rebuilt.validateLoaded());
+
+  Hyphenator::setResultCache(nullptr);
+}
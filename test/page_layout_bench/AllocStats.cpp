@@ -0,0 +1,89 @@
+#include "AllocStats.h"
+
+#include <malloc.h>
+
+#include <cerrno>
+
+// glibc allows the malloc family to be replaced by the executable; forward to
+// the real allocator and count on the way through. Sizes come from
+// malloc_usable_size() so frees can be attributed without a header.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+constexpr uint32_t SIMULATED_FREE_HEAP = 160 * 1024;
+
+uint64_t allocCount = 0;
+size_t liveBytes = 0;
+size_t peakBytes = 0;
+
+void track(void* ptr) {
+  if (!ptr) return;
+  allocCount++;
+  liveBytes += malloc_usable_size(ptr);
+  if (liveBytes > peakBytes) peakBytes = liveBytes;
+}
+
+void untrack(void* ptr) {
+  if (!ptr) return;
+  const size_t size = malloc_usable_size(ptr);
+  liveBytes = size > liveBytes ? 0 : liveBytes - size;
+}
+}  // namespace
+
+extern "C" {
+void* malloc(const size_t size) {
+  void* ptr = __libc_malloc(size);
+  track(ptr);
+  return ptr;
+}
+
+void* calloc(const size_t count, const size_t size) {
+  void* ptr = __libc_calloc(count, size);
+  track(ptr);
+  return ptr;
+}
+
+void* realloc(void* ptr, const size_t size) {
+  untrack(ptr);
+  void* result = __libc_realloc(ptr, size);
+  // On failure the original block is still live
+  track(result ? result : (size == 0 ? nullptr : ptr));
+  return result;
+}
+
+void* memalign(const size_t alignment, const size_t size) {
+  void* ptr = __libc_memalign(alignment, size);
+  track(ptr);
+  return ptr;
+}
+
+void* aligned_alloc(const size_t alignment, const size_t size) { return memalign(alignment, size); }
+
+int posix_memalign(void** out, const size_t alignment, const size_t size) {
+  void* ptr = memalign(alignment, size);
+  if (!ptr) return ENOMEM;
+  *out = ptr;
+  return 0;
+}
+
+void free(void* ptr) {
+  untrack(ptr);
+  __libc_free(ptr);
+}
+}
+
+namespace AllocStats {
+
+Snapshot snapshot() { return {allocCount, liveBytes, peakBytes}; }
+
+void resetPeak() { peakBytes = liveBytes; }
+
+uint32_t simulatedFreeHeap() { return SIMULATED_FREE_HEAP; }
+
+}  // namespace AllocStats
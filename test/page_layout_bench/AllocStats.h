@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Process-wide heap accounting for the page-layout benchmark. Every malloc/free
+// (and therefore every operator new/delete) in the process is counted, so the
+// numbers cover expat, uzlib, the STL and the layout code alike.
+namespace AllocStats {
+
+struct Snapshot {
+  uint64_t allocCount;
+  size_t liveBytes;
+  size_t peakBytes;
+};
+
+Snapshot snapshot();
+
+// Start a new measurement window: the peak is reset to the current live size.
+void resetPeak();
+
+// Free heap reported through ESP.getFreeHeap(). Fixed and comfortably above
+// every heap guard in the pipeline so the host always takes the normal paths.
+uint32_t simulatedFreeHeap();
+
+}  // namespace AllocStats
@@ -0,0 +1,355 @@
+// Host implementations of the HAL pieces the EPUB layout pipeline touches:
+// HalStorage/HalFile on top of stdio + std::filesystem (paths are used as-is,
+// so callers pass absolute host paths), a framebuffer-only HalDisplay, and the
+// handful of Arduino core globals referenced by the libraries. Reads are
+// reported to SdLatencyModel.
+
+#include <Arduino.h>
+#include <HalDisplay.h>
+#include <HalStorage.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+#include "AllocStats.h"
+#include "SdLatencyModel.h"
+
+namespace fs = std::filesystem;
+
+HWCDC Serial;
+EspClass ESP;
+HalDisplay display;
+
+namespace {
+const auto startTime = std::chrono::steady_clock::now();
+}
+
+unsigned long millis() {
+  return static_cast<unsigned long>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+unsigned long micros() {
+  return static_cast<unsigned long>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+// Retry back-offs in the parsers are there for SD card timing; skip them on the host.
+void delay(unsigned long) {}
+
+uint32_t EspClass::getFreeHeap() { return AllocStats::simulatedFreeHeap(); }
+
+// ---------------------------------------------------------------------------
+// HalDisplay: a plain in-memory framebuffer, no panel.
+
+namespace {
+uint8_t hostFrameBuffer[HalDisplay::BUFFER_SIZE];
+}
+
+HalDisplay::HalDisplay() = default;
+HalDisplay::~HalDisplay() = default;
+void HalDisplay::begin(bool) {}
+void HalDisplay::clearScreen(const uint8_t color) const { memset(hostFrameBuffer, color, sizeof(hostFrameBuffer)); }
+void HalDisplay::drawImage(const uint8_t*, uint16_t, uint16_t, uint16_t, uint16_t, bool) const {}
+void HalDisplay::drawImageTransparent(const uint8_t*, uint16_t, uint16_t, uint16_t, uint16_t, bool) const {}
+void HalDisplay::displayBuffer(RefreshMode, bool) {}
+void HalDisplay::refreshDisplay(RefreshMode, bool) {}
+void HalDisplay::deepSleep() {}
+uint8_t* HalDisplay::getFrameBuffer() const { return hostFrameBuffer; }
+void HalDisplay::preconditionGrayscale() {}
+void HalDisplay::preconditionGrayscale(uint16_t, uint16_t, uint16_t, uint16_t) {}
+void HalDisplay::displayGrayscaleBase(RefreshMode, bool) {}
+void HalDisplay::copyGrayscaleBuffers(const uint8_t*, const uint8_t*) {}
+void HalDisplay::copyGrayscaleLsbBuffers(const uint8_t*) {}
+void HalDisplay::copyGrayscaleMsbBuffers(const uint8_t*) {}
+void HalDisplay::cleanupGrayscaleBuffers(const uint8_t*) {}
+void HalDisplay::displayGrayBuffer(bool) {}
+void HalDisplay::writeGrayscalePlaneStrip(bool, const uint8_t*, uint16_t, uint16_t) {}
+bool HalDisplay::supportsStripGrayscale() const { return false; }
+uint16_t HalDisplay::getDisplayWidth() const { return DISPLAY_WIDTH; }
+uint16_t HalDisplay::getDisplayHeight() const { return DISPLAY_HEIGHT; }
+uint16_t HalDisplay::getDisplayWidthBytes() const { return DISPLAY_WIDTH_BYTES; }
+uint32_t HalDisplay::getBufferSize() const { return BUFFER_SIZE; }
+
+// ---------------------------------------------------------------------------
+// HalStorage / HalFile
+
+HalStorage HalStorage::instance;
+
+class HalFile::Impl {
+ public:
+  FILE* fp = nullptr;
+  std::string path;
+  bool directory = false;
+  std::vector<std::string> entries;
+  size_t nextEntry = 0;
+  bool lastOpWrite = false;
+
+  ~Impl() {
+    if (fp) fclose(fp);
+  }
+
+  // stdio requires a positioning call between switching from writing to reading and back.
+  void switchMode(const bool write) {
+    if (fp && lastOpWrite != write) fseek(fp, 0, SEEK_CUR);
+    lastOpWrite = write;
+  }
+};
+
+HalStorage::HalStorage() = default;
+bool HalStorage::begin() { return (initialized = true); }
+bool HalStorage::ready() const { return initialized; }
+
+HalFile HalStorage::open(const char* path, const oflag_t oflag) {
+  auto impl = std::make_unique<HalFile::Impl>();
+  impl->path = path;
+  std::error_code ec;
+  if (fs::is_directory(path, ec)) {
+    impl->directory = true;
+    for (const auto& entry : fs::directory_iterator(path, ec)) {
+      impl->entries.push_back(entry.path().string());
+    }
+    return HalFile(std::move(impl));
+  }
+
+  const int access = oflag & O_ACCMODE;
+  const char* mode = "rb";
+  if (access != O_RDONLY) {
+    if (oflag & O_APPEND) {
+      mode = "a+b";
+    } else if (oflag & O_TRUNC) {
+      mode = "w+b";
+    } else if (fs::exists(path, ec)) {
+      mode = "r+b";
+    } else if (oflag & O_CREAT) {
+      mode = "w+b";
+    }
+  }
+  impl->fp = fopen(path, mode);
+  return HalFile(std::move(impl));
+}
+
+std::vector<String> HalStorage::listFiles(const char* path, const int maxFiles) {
+  std::vector<String> files;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(path, ec)) {
+    if (static_cast<int>(files.size()) >= maxFiles) break;
+    files.emplace_back(entry.path().filename().c_str());
+  }
+  return files;
+}
+
+String HalStorage::readFile(const char* path) {
+  HalFile file = open(path);
+  if (!file) return String();
+  std::string content(file.size(), '\0');
+  const int n = file.read(content.data(), content.size());
+  content.resize(n > 0 ? n : 0);
+  return String(content.c_str());
+}
+
+bool HalStorage::readFileToStream(const char* path, Print& out, const size_t chunkSize) {
+  HalFile file = open(path);
+  if (!file) return false;
+  std::vector<uint8_t> buffer(chunkSize);
+  int n;
+  while ((n = file.read(buffer.data(), buffer.size())) > 0) {
+    out.write(buffer.data(), n);
+  }
+  return true;
+}
+
+size_t HalStorage::readFileToBuffer(const char* path, char* buffer, const size_t bufferSize, const size_t maxBytes) {
+  if (!buffer || bufferSize == 0) return 0;
+  HalFile file = open(path);
+  if (!file) {
+    buffer[0] = '\0';
+    return 0;
+  }
+  size_t toRead = bufferSize - 1;
+  if (maxBytes > 0 && maxBytes < toRead) toRead = maxBytes;
+  const int n = file.read(buffer, toRead);
+  const size_t got = n > 0 ? n : 0;
+  buffer[got] = '\0';
+  return got;
+}
+
+bool HalStorage::writeFile(const char* path, const String& content) {
+  HalFile file;
+  if (!openFileForWrite("HAL", path, file)) return false;
+  return file.write(content.c_str(), content.length()) == content.length();
+}
+
+bool HalStorage::ensureDirectoryExists(const char* path) { return mkdir(path, true); }
+
+bool HalStorage::mkdir(const char* path, const bool pFlag) {
+  std::error_code ec;
+  if (pFlag) {
+    fs::create_directories(path, ec);
+  } else {
+    fs::create_directory(path, ec);
+  }
+  return fs::is_directory(path, ec);
+}
+
+bool HalStorage::exists(const char* path) {
+  std::error_code ec;
+  return fs::exists(path, ec);
+}
+
+bool HalStorage::remove(const char* path) {
+  std::error_code ec;
+  return fs::is_regular_file(path, ec) && fs::remove(path, ec);
+}
+
+bool HalStorage::rename(const char* oldPath, const char* newPath) {
+  std::error_code ec;
+  fs::rename(oldPath, newPath, ec);
+  return !ec;
+}
+
+bool HalStorage::rmdir(const char* path) {
+  std::error_code ec;
+  return fs::is_directory(path, ec) && fs::remove(path, ec);
+}
+
+bool HalStorage::openFileForRead(const char*, const char* path, HalFile& file) {
+  file = open(path, O_RDONLY);
+  return file.isOpen();
+}
+
+bool HalStorage::openFileForRead(const char* moduleName, const std::string& path, HalFile& file) {
+  return openFileForRead(moduleName, path.c_str(), file);
+}
+
+bool HalStorage::openFileForRead(const char* moduleName, const String& path, HalFile& file) {
+  return openFileForRead(moduleName, path.c_str(), file);
+}
+
+bool HalStorage::openFileForWrite(const char*, const char* path, HalFile& file) {
+  file = open(path, O_RDWR | O_CREAT | O_TRUNC);
+  return file.isOpen();
+}
+
+bool HalStorage::openFileForWrite(const char* moduleName, const std::string& path, HalFile& file) {
+  return openFileForWrite(moduleName, path.c_str(), file);
+}
+
+bool HalStorage::openFileForWrite(const char* moduleName, const String& path, HalFile& file) {
+  return openFileForWrite(moduleName, path.c_str(), file);
+}
+
+bool HalStorage::removeDir(const char* path) {
+  std::error_code ec;
+  fs::remove_all(path, ec);
+  return !ec;
+}
+
+HalFile::HalFile() = default;
+HalFile::HalFile(std::unique_ptr<Impl> impl) : impl(std::move(impl)) {}
+HalFile::~HalFile() = default;
+HalFile::HalFile(HalFile&&) = default;
+HalFile& HalFile::operator=(HalFile&&) = default;
+
+void HalFile::flush() {
+  if (impl && impl->fp) fflush(impl->fp);
+}
+
+size_t HalFile::getName(char* name, const size_t len) {
+  if (!impl || len == 0) return 0;
+  const std::string base = fs::path(impl->path).filename().string();
+  const size_t n = std::min(base.size(), len - 1);
+  memcpy(name, base.data(), n);
+  name[n] = '\0';
+  return n;
+}
+
+size_t HalFile::size() {
+  if (!impl || !impl->fp) return 0;
+  const long pos = ftell(impl->fp);
+  fseek(impl->fp, 0, SEEK_END);
+  const long end = ftell(impl->fp);
+  fseek(impl->fp, pos, SEEK_SET);
+  return end > 0 ? static_cast<size_t>(end) : 0;
+}
+
+size_t HalFile::fileSize() { return size(); }
+uint64_t HalFile::fileSize64() { return size(); }
+
+bool HalFile::seek(const size_t pos) { return seekSet(pos); }
+bool HalFile::seek64(const uint64_t pos) { return seekSet(static_cast<size_t>(pos)); }
+
+bool HalFile::seekCur(const int64_t offset) {
+  return impl && impl->fp && fseek(impl->fp, static_cast<long>(offset), SEEK_CUR) == 0;
+}
+
+bool HalFile::seekSet(const size_t offset) {
+  return impl && impl->fp && fseek(impl->fp, static_cast<long>(offset), SEEK_SET) == 0;
+}
+
+int HalFile::available() const {
+  if (!impl || !impl->fp) return 0;
+  const long pos = ftell(impl->fp);
+  fseek(impl->fp, 0, SEEK_END);
+  const long end = ftell(impl->fp);
+  fseek(impl->fp, pos, SEEK_SET);
+  return end > pos ? static_cast<int>(end - pos) : 0;
+}
+
+size_t HalFile::position() const {
+  if (!impl || !impl->fp) return 0;
+  const long pos = ftell(impl->fp);
+  return pos > 0 ? static_cast<size_t>(pos) : 0;
+}
+
+int HalFile::read(void* buf, const size_t count) {
+  if (!impl || !impl->fp) return -1;
+  impl->switchMode(false);
+  const long pos = ftell(impl->fp);
+  const size_t n = fread(buf, 1, count, impl->fp);
+  SdLatencyModel::onRead(impl->path, pos > 0 ? static_cast<size_t>(pos) : 0, n);
+  return static_cast<int>(n);
+}
+
+int HalFile::read() {
+  uint8_t b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+size_t HalFile::write(const void* buf, const size_t count) {
+  if (!impl || !impl->fp) return 0;
+  impl->switchMode(true);
+  return fwrite(buf, 1, count, impl->fp);
+}
+
+size_t HalFile::write(const uint8_t b) { return write(&b, 1); }
+
+bool HalFile::rename(const char* newPath) {
+  if (!impl) return false;
+  std::error_code ec;
+  fs::rename(impl->path, newPath, ec);
+  if (ec) return false;
+  impl->path = newPath;
+  return true;
+}
+
+bool HalFile::isDirectory() const { return impl && impl->directory; }
+
+void HalFile::rewindDirectory() {
+  if (impl) impl->nextEntry = 0;
+}
+
+bool HalFile::close() {
+  if (!impl) return false;
+  impl.reset();
+  return true;
+}
+
+HalFile HalFile::openNextFile() {
+  if (!impl || !impl->directory || impl->nextEntry >= impl->entries.size()) return HalFile();
+  return Storage.open(impl->entries[impl->nextEntry++].c_str());
+}
+
+bool HalFile::isOpen() const { return impl != nullptr && (impl->fp != nullptr || impl->directory); }
+HalFile::operator bool() const { return isOpen(); }
@@ -0,0 +1,94 @@
+// Host replacements for the image pipeline. Layout only needs image
+// dimensions, so the JPEGDEC/PNGdec-backed decoders are swapped for a header
+// sniffer, and cover/thumbnail BMP conversion is reported as unsupported.
+
+#include <HalStorage.h>
+#include <JpegToBmpConverter.h>
+#include <PngToBmpConverter.h>
+
+#include <cctype>
+#include <string>
+
+#include "Epub/converters/ImageDecoderFactory.h"
+
+namespace {
+
+class HeaderDimensionsDecoder final : public ImageToFramebufferDecoder {
+ public:
+  explicit HeaderDimensionsDecoder(const bool png) : png(png) {}
+
+  bool decodeToFramebuffer(const std::string&, GfxRenderer&, const RenderConfig&) override { return false; }
+
+  bool getDimensions(const std::string& imagePath, ImageDimensions& dims) const override {
+    HalFile file;
+    if (!Storage.openFileForRead("DEC", imagePath, file)) return false;
+    return png ? readPng(file, dims) : readJpeg(file, dims);
+  }
+
+  const char* getFormatName() const override { return png ? "PNG" : "JPEG"; }
+
+ private:
+  bool png;
+
+  static uint16_t be16(const uint8_t* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+  static uint32_t be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+  }
+
+  // Signature (8) + IHDR length/type (8) + width/height (8)
+  static bool readPng(HalFile& file, ImageDimensions& dims) {
+    uint8_t header[24];
+    if (file.read(header, sizeof(header)) != sizeof(header) || memcmp(header + 12, "IHDR", 4) != 0) return false;
+    dims.width = static_cast<int16_t>(be32(header + 16));
+    dims.height = static_cast<int16_t>(be32(header + 20));
+    return true;
+  }
+
+  // Walk the marker segments until the first start-of-frame.
+  static bool readJpeg(HalFile& file, ImageDimensions& dims) {
+    uint8_t buf[9];
+    if (file.read(buf, 2) != 2 || buf[0] != 0xFF || buf[1] != 0xD8) return false;
+    while (file.read(buf, 4) == 4) {
+      if (buf[0] != 0xFF) return false;
+      const uint8_t marker = buf[1];
+      const uint16_t length = be16(buf + 2);
+      const bool isSof = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+      if (isSof) {
+        if (file.read(buf, 5) != 5) return false;
+        dims.height = static_cast<int16_t>(be16(buf + 1));
+        dims.width = static_cast<int16_t>(be16(buf + 3));
+        return true;
+      }
+      if (length < 2 || !file.seekCur(length - 2)) return false;
+    }
+    return false;
+  }
+};
+
+HeaderDimensionsDecoder jpegHeaderDecoder(false);
+HeaderDimensionsDecoder pngHeaderDecoder(true);
+
+}  // namespace
+
+ImageToFramebufferDecoder* ImageDecoderFactory::getDecoder(const std::string& imagePath) {
+  std::string ext;
+  const size_t dotPos = imagePath.rfind('.');
+  if (dotPos != std::string::npos) {
+    ext = imagePath.substr(dotPos);
+    for (auto& c : ext) {
+      c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+  }
+  if (ext == ".jpg" || ext == ".jpeg") return &jpegHeaderDecoder;
+  if (ext == ".png") return &pngHeaderDecoder;
+  return nullptr;
+}
+
+bool ImageDecoderFactory::isFormatSupported(const std::string& imagePath) { return getDecoder(imagePath) != nullptr; }
+
+bool JpegToBmpConverter::jpegFileToBmpStream(HalFile&, Print&, bool) { return false; }
+bool JpegToBmpConverter::jpegFileToBmpStreamWithSize(HalFile&, Print&, int, int) { return false; }
+bool JpegToBmpConverter::jpegFileTo1BitBmpStreamWithSize(HalFile&, Print&, int, int) { return false; }
+bool PngToBmpConverter::pngFileToBmpStream(HalFile&, Print&, bool) { return false; }
+bool PngToBmpConverter::pngFileToBmpStreamWithSize(HalFile&, Print&, int, int) { return false; }
+bool PngToBmpConverter::pngFileTo1BitBmpStreamWithSize(HalFile&, Print&, int, int) { return false; }
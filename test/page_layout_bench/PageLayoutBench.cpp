@@ -0,0 +1,547 @@
+// Host-side page-layout benchmark.
+//
+// Runs Section::createSectionFile (ChapterHtmlSlimParser -> ParsedText ->
+// Page::serialize) for every spine item of every EPUB given on the command
+// line (default: the bundled test/epubs) and reports, per chapter, layout
+// throughput and heap usage. Pages are then read back through
+// loadPageFromSectionFile to count words and verify the cache round-trips.
+//
+// With --css-resolve it instead times CssParser::resolveStyle over every
+// element of every chapter, once without ancestors (flat selectors only) and
+// once with the open-element stack used for descendant/child selectors.
+//
+// With --sd-font-reads it instead prewarms pages of synthetic CJK text from a
+// generated SD card font at a range of read gap tolerances, and reports seeks,
+// bytes read, and SD time under SdLatencyModel alongside host wall time, then
+// the SD reads of growing a book subset of that font one section at a time.
+//
+// Usage: PageLayoutBench [--iterations N] [--no-hyphenation] [--optimal-breaks] [--no-width-cache]
+//                        [--css-resolve] [--sd-font-reads] [epub-or-dir ...]
+
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/Section.h>
+#include <Epub/css/CssAncestorStack.h>
+#include <Epub/css/CssParser.h>
+#include <FontCacheManager.h>
+#include <FontSubsetCollector.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <HalStorage.h>
+#include <SdCardFont.h>
+#include <Utf8.h>
+#include <builtinFonts/notoserif_14_bold.h>
+#include <builtinFonts/notoserif_14_bolditalic.h>
+#include <builtinFonts/notoserif_14_italic.h>
+#include <builtinFonts/notoserif_14_regular.h>
+#include <expat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AllocStats.h"
+#include "SdLatencyModel.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int BENCH_FONT_ID = 1;
+
+// Reader defaults: portrait panel, NORMAL line spacing, justified, extra paragraph spacing.
+constexpr uint16_t VIEWPORT_WIDTH = 460;
+constexpr uint16_t VIEWPORT_HEIGHT = 760;
+constexpr float LINE_COMPRESSION = 1.0f;
+constexpr bool EXTRA_PARAGRAPH_SPACING = true;
+constexpr uint8_t PARAGRAPH_ALIGNMENT = 0;  // JUSTIFIED
+constexpr bool EMBEDDED_STYLE = true;
+constexpr uint8_t IMAGE_RENDERING = 0;  // IMAGES_DISPLAY
+constexpr bool FOCUS_READING = false;
+
+struct Options {
+  int iterations = 1;
+  bool hyphenation = true;
+  bool optimalBreaks = false;
+  bool widthCache = true;
+  bool cssResolve = false;
+  bool sdFontReads = false;
+  std::vector<fs::path> inputs;
+};
+
+struct ChapterResult {
+  uint32_t pages = 0;
+  uint64_t words = 0;
+  double buildMs = 0;
+  double loadMs = 0;
+  size_t peakHeap = 0;
+  uint64_t allocs = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(const Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double perSecond(const double count, const double ms) { return ms > 0 ? count * 1000.0 / ms : 0; }
+
+bool buildChapter(const std::shared_ptr<Epub>& epub, const int spineIndex, GfxRenderer& renderer,
+                  const Options& options, ChapterResult& result) {
+  for (int i = 0; i < options.iterations; i++) {
+    Section section(epub, spineIndex, renderer);
+    section.clearCache();
+
+    const auto before = AllocStats::snapshot();
+    AllocStats::resetPeak();
+    const auto start = Clock::now();
+    const bool ok = section.createSectionFile(BENCH_FONT_ID, LINE_COMPRESSION, EXTRA_PARAGRAPH_SPACING,
+                                              PARAGRAPH_ALIGNMENT, VIEWPORT_WIDTH, VIEWPORT_HEIGHT,
+                                              options.hyphenation, EMBEDDED_STYLE, IMAGE_RENDERING, FOCUS_READING,
+                                              options.optimalBreaks);
+    result.buildMs += msSince(start);
+    const auto after = AllocStats::snapshot();
+    if (!ok) return false;
+
+    result.pages = section.pageCount;
+    result.allocs = after.allocCount - before.allocCount;
+    result.peakHeap = std::max(result.peakHeap, after.peakBytes - before.liveBytes);
+  }
+
+  Section section(epub, spineIndex, renderer);
+  if (!section.loadSectionFile(BENCH_FONT_ID, LINE_COMPRESSION, EXTRA_PARAGRAPH_SPACING, PARAGRAPH_ALIGNMENT,
+                               VIEWPORT_WIDTH, VIEWPORT_HEIGHT, options.hyphenation, EMBEDDED_STYLE, IMAGE_RENDERING,
+                               FOCUS_READING, options.optimalBreaks)) {
+    return false;
+  }
+  const auto start = Clock::now();
+  for (uint16_t p = 0; p < section.pageCount; p++) {
+    section.currentPage = p;
+    const auto page = section.loadPageFromSectionFile();
+    if (!page) return false;
+    for (const auto& element : page->elements) {
+      if (element->getTag() != TAG_PageLine) continue;
+      result.words += static_cast<const PageLine&>(*element).getBlock().wordCount();
+    }
+  }
+  result.loadMs = msSince(start);
+  return true;
+}
+
+void printRow(const char* label, const ChapterResult& r, const int iterations) {
+  const double buildMs = r.buildMs / iterations;
+  printf("  %-12s %6u %8llu %10.2f %10.0f %10.0f %10.2f %10zu %9llu\n", label, r.pages,
+         static_cast<unsigned long long>(r.words), buildMs, perSecond(r.pages, buildMs), perSecond(r.words, buildMs),
+         r.loadMs, r.peakHeap, static_cast<unsigned long long>(r.allocs));
+}
+
+bool benchBook(const fs::path& epubPath, const fs::path& cacheDir, GfxRenderer& renderer, const Options& options) {
+  printf("%s\n", epubPath.filename().c_str());
+
+  auto epub = std::make_shared<Epub>(epubPath.string(), cacheDir.string());
+  if (!epub->load(true)) {
+    printf("  failed to load\n");
+    return false;
+  }
+
+  printf("  %-12s %6s %8s %10s %10s %10s %10s %10s %9s\n", "chapter", "pages", "words", "build_ms", "pages/s",
+         "words/s", "load_ms", "peak_heap", "allocs");
+
+  bool ok = true;
+  ChapterResult total;
+  for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+    ChapterResult r;
+    char label[24];
+    snprintf(label, sizeof(label), "spine %d", i);
+    if (!buildChapter(epub, i, renderer, options, r)) {
+      printf("  %-12s FAILED\n", label);
+      ok = false;
+      continue;
+    }
+    printRow(label, r, options.iterations);
+    total.pages += r.pages;
+    total.words += r.words;
+    total.buildMs += r.buildMs;
+    total.loadMs += r.loadMs;
+    total.peakHeap = std::max(total.peakHeap, r.peakHeap);
+    total.allocs += r.allocs;
+  }
+  printRow("total", total, options.iterations);
+  return ok;
+}
+
+struct StyledElement {
+  std::string tag;
+  std::string classAttr;
+  int depth;
+};
+
+struct ElementCollector {
+  std::vector<StyledElement> elements;
+  int depth = 0;
+};
+
+void XMLCALL collectStart(void* userData, const XML_Char* name, const XML_Char** atts) {
+  auto* collector = static_cast<ElementCollector*>(userData);
+  std::string classAttr;
+  for (int i = 0; atts[i]; i += 2) {
+    if (strcmp(atts[i], "class") == 0) classAttr = atts[i + 1];
+  }
+  collector->elements.push_back({name, std::move(classAttr), collector->depth++});
+}
+
+void XMLCALL collectEnd(void* userData, const XML_Char*) { static_cast<ElementCollector*>(userData)->depth--; }
+
+// Resolves every element as ChapterHtmlSlimParser does and returns the time taken, in ns
+double timeResolve(const CssParser& css, const std::vector<StyledElement>& elements, const bool withAncestors,
+                   const int iterations) {
+  CssAncestorStack ancestors;
+  uint32_t sink = 0;
+  const auto start = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    ancestors.clear();
+    for (const auto& element : elements) {
+      ancestors.setDepth(element.depth);
+      const CssStyle style = css.resolveStyle(element.tag, element.classAttr, withAncestors ? &ancestors : nullptr);
+      ancestors.push(element.tag, element.classAttr);
+      sink += style.defined.fontWeight;
+    }
+  }
+  const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  return sink == UINT32_MAX ? 0 : ns;
+}
+
+bool benchCssResolve(const fs::path& epubPath, const fs::path& cacheDir, const Options& options) {
+  printf("%s\n", epubPath.filename().c_str());
+
+  auto epub = std::make_shared<Epub>(epubPath.string(), cacheDir.string());
+  CssParser* css = epub->load(true) ? epub->getCssParser() : nullptr;
+  if (!css || !css->loadFromCache()) {
+    printf("  failed to load\n");
+    return false;
+  }
+
+  ElementCollector collector;
+  for (int i = 0; i < epub->getSpineItemsCount(); i++) {
+    size_t size = 0;
+    std::unique_ptr<uint8_t[]> html(epub->readItemContentsToBytes(epub->getSpineItem(i).href, &size));
+    if (!html) continue;
+    XML_Parser parser = XML_ParserCreate(nullptr);
+    XML_SetUserData(parser, &collector);
+    XML_SetElementHandler(parser, collectStart, collectEnd);
+    if (XML_Parse(parser, reinterpret_cast<const char*>(html.get()), static_cast<int>(size), XML_TRUE) ==
+        XML_STATUS_ERROR) {
+      printf("  spine %d: %s\n", i, XML_ErrorString(XML_GetErrorCode(parser)));
+    }
+    XML_ParserFree(parser);
+    collector.depth = 0;
+  }
+
+  const auto& elements = collector.elements;
+  const double count = static_cast<double>(elements.size()) * options.iterations;
+  css->beginStyleMemo();
+  const double flatNs = timeResolve(*css, elements, false, options.iterations);
+  css->endStyleMemo();
+  css->beginStyleMemo();
+  const double contextNs = timeResolve(*css, elements, true, options.iterations);
+  css->endStyleMemo();
+  printf("  %zu rules, %zu elements: flat %.0f ns/element, with ancestors %.0f ns/element\n", css->ruleCount(),
+         elements.size(), count > 0 ? flatNs / count : 0, count > 0 ? contextNs / count : 0);
+  css->clear();
+  return true;
+}
+
+// --sd-font-reads: one style of a CJK text face, 2-bit bitmaps of 60-140 bytes
+constexpr uint32_t SYNTH_FIRST_CODEPOINT = 0x4E00;
+constexpr uint32_t SYNTH_GLYPHS = 6000;
+constexpr int SYNTH_PAGES = 100;
+constexpr int SYNTH_PAGE_CHARS = 400;
+constexpr uint32_t READ_GAPS[] = {0, 256, 512, 1024, 1536, 2048, 4096};
+
+uint16_t synthBitmapLength(const uint32_t glyph) { return static_cast<uint16_t>(60 + (glyph * 37) % 81); }
+uint8_t synthBitmapByte(const uint32_t glyph, const uint32_t i) { return static_cast<uint8_t>(glyph * 31 + i * 7); }
+
+void putLe(std::vector<uint8_t>& out, const uint32_t value, const int bytes) {
+  for (int i = 0; i < bytes; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+bool writeSyntheticFont(const std::string& path) {
+  std::vector<uint8_t> data;
+  const char magic[8] = {'C', 'P', 'F', 'O', 'N', 'T', 0, 0};
+  data.insert(data.end(), magic, magic + 8);
+  putLe(data, CPFONT_VERSION, 2);
+  putLe(data, 1, 2);  // 2-bit
+  putLe(data, 1, 1);  // one style
+  data.resize(32);
+  // Style TOC entry: one interval, no kerning or ligatures, data right after the TOC
+  putLe(data, 0, 4);
+  putLe(data, 1, 4);
+  putLe(data, SYNTH_GLYPHS, 4);
+  putLe(data, 30, 1);
+  putLe(data, 24, 2);
+  putLe(data, static_cast<uint16_t>(-6), 2);
+  data.resize(32 + 24);
+  putLe(data, 64, 4);
+  data.resize(64);
+
+  putLe(data, SYNTH_FIRST_CODEPOINT, 4);
+  putLe(data, SYNTH_FIRST_CODEPOINT + SYNTH_GLYPHS - 1, 4);
+  putLe(data, 0, 4);
+  uint32_t bitmapOffset = 0;
+  for (uint32_t g = 0; g < SYNTH_GLYPHS; g++) {
+    putLe(data, 24, 1);
+    putLe(data, 24, 1);
+    putLe(data, 26 << 4, 2);
+    putLe(data, 1, 2);
+    putLe(data, 22, 2);
+    putLe(data, synthBitmapLength(g), 2);
+    putLe(data, 0, 2);
+    putLe(data, bitmapOffset, 4);
+    bitmapOffset += synthBitmapLength(g);
+  }
+  for (uint32_t g = 0; g < SYNTH_GLYPHS; g++) {
+    for (uint32_t i = 0; i < synthBitmapLength(g); i++) data.push_back(synthBitmapByte(g, i));
+  }
+
+  HalFile file;
+  return Storage.openFileForWrite("BENCH", path, file) && file.write(data.data(), data.size()) == data.size();
+}
+
+// Character frequencies follow Zipf's law, and common characters are scattered over the code chart
+std::vector<std::string> synthPages() {
+  std::mt19937 rng(7);
+  std::vector<uint32_t> byRank(SYNTH_GLYPHS);
+  std::iota(byRank.begin(), byRank.end(), 0);
+  std::shuffle(byRank.begin(), byRank.end(), rng);
+  std::vector<double> cumulative(SYNTH_GLYPHS);
+  double sum = 0;
+  for (uint32_t r = 0; r < SYNTH_GLYPHS; r++) cumulative[r] = sum += 1.0 / (r + 1);
+  std::uniform_real_distribution<double> pick(0, sum);
+
+  std::vector<std::string> pages(SYNTH_PAGES);
+  for (auto& text : pages) {
+    for (int i = 0; i < SYNTH_PAGE_CHARS; i++) {
+      const auto rank = std::lower_bound(cumulative.begin(), cumulative.end(), pick(rng)) - cumulative.begin();
+      utf8AppendCodepoint(SYNTH_FIRST_CODEPOINT + byRank[std::min<size_t>(rank, SYNTH_GLYPHS - 1)], text);
+    }
+  }
+  return pages;
+}
+
+bool verifySynthPage(SdCardFont& font, const std::string& text) {
+  const EpdFont* epd = font.getEpdFont(0);
+  const auto* p = reinterpret_cast<const unsigned char*>(text.c_str());
+  while (*p) {
+    const uint32_t glyphIndex = utf8NextCodepoint(&p) - SYNTH_FIRST_CODEPOINT;
+    const EpdGlyph* glyph = epd->getGlyph(SYNTH_FIRST_CODEPOINT + glyphIndex);
+    if (!glyph || font.isOverflowGlyph(glyph) || glyph->dataLength != synthBitmapLength(glyphIndex)) return false;
+    const uint8_t* bitmap = epd->data->bitmap + glyph->dataOffset;
+    for (uint32_t i = 0; i < glyph->dataLength; i++) {
+      if (bitmap[i] != synthBitmapByte(glyphIndex, i)) return false;
+    }
+  }
+  return true;
+}
+
+// Each page stands in for a section build that merges its glyphs into the book's subset; the pages
+// are then prewarmed again with the subset attached.
+bool benchSdFontSubset(const std::string& fontPath, const fs::path& cacheDir, const std::vector<std::string>& pages) {
+  const std::string subsetPath = (cacheDir / "synthetic.subset.cpfont").string();
+  SdCardFont font;
+  if (!font.load(fontPath.c_str())) {
+    printf("  failed to load %s\n", fontPath.c_str());
+    return false;
+  }
+
+  const auto before = SdLatencyModel::snapshot();
+  for (const auto& text : pages) {
+    FontSubsetCollector collector;
+    collector.add(text.c_str(), 0);
+    if (!font.updateSubset(subsetPath, collector.entries())) {
+      printf("  failed to update %s\n", subsetPath.c_str());
+      return false;
+    }
+  }
+  const auto after = SdLatencyModel::snapshot();
+  const double n = static_cast<double>(pages.size());
+  printf("\n  subset updates: %.1f KB read and %.2f sd_ms per section, %.1f KB subset\n",
+         (after.bytes - before.bytes) / n / 1024, (after.simulatedUs - before.simulatedUs) / n / 1000,
+         fs::file_size(subsetPath) / 1024.0);
+
+  bool ok = true;
+  for (const auto& text : pages) {
+    font.clearCache();
+    font.prewarm(text.c_str(), 0x01);
+    if (!verifySynthPage(font, text)) {
+      printf("  subset: glyphs read back wrong\n");
+      ok = false;
+      break;
+    }
+  }
+  return ok;
+}
+
+bool benchSdFontReads(const fs::path& cacheDir, const Options& options) {
+  const std::string fontPath = (cacheDir / "synthetic.cpfont").string();
+  if (!writeSyntheticFont(fontPath)) {
+    printf("failed to write %s\n", fontPath.c_str());
+    return false;
+  }
+  const std::vector<std::string> pages = synthPages();
+  printf("%u glyphs, %d pages of %d characters, %d iteration(s); SD model %.0f us/command + %.0f us/sector + "
+         "%.0f us/read; figures are per page\n\n",
+         SYNTH_GLYPHS, SYNTH_PAGES, SYNTH_PAGE_CHARS, options.iterations, SdLatencyModel::COMMAND_US,
+         SdLatencyModel::SECTOR_US, SdLatencyModel::CALL_US);
+  printf("  %-8s %8s %10s %10s %10s %10s %10s\n", "max_gap", "seeks", "read_kb", "commands", "sectors", "sd_ms",
+         "wall_us");
+
+  bool ok = true;
+  for (const uint32_t gap : READ_GAPS) {
+    uint64_t seeks = 0;
+    uint64_t bytesRead = 0;
+    SdLatencyModel::Snapshot sd = {};
+    double wallUs = 0;
+    for (int it = 0; it < options.iterations; it++) {
+      // A fresh font per pass, so every pass starts with an empty glyph store
+      SdCardFont font;
+      if (!font.load(fontPath.c_str())) {
+        printf("  failed to load %s\n", fontPath.c_str());
+        return false;
+      }
+      font.setReadGapTolerance(gap);
+      for (const auto& text : pages) {
+        font.clearCache();
+        const auto before = SdLatencyModel::snapshot();
+        const auto start = Clock::now();
+        font.prewarm(text.c_str(), 0x01);
+        wallUs += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        const auto after = SdLatencyModel::snapshot();
+        sd.commands += after.commands - before.commands;
+        sd.sectors += after.sectors - before.sectors;
+        sd.simulatedUs += after.simulatedUs - before.simulatedUs;
+        if (!verifySynthPage(font, text)) {
+          printf("  max_gap %u: glyphs read back wrong\n", gap);
+          ok = false;
+        }
+      }
+      seeks += font.getStats().seekCount;
+      bytesRead += font.getStats().bytesRead;
+    }
+    const double n = static_cast<double>(SYNTH_PAGES) * options.iterations;
+    printf("  %-8u %8.1f %10.1f %10.1f %10.1f %10.2f %10.0f\n", gap, seeks / n, bytesRead / n / 1024,
+           sd.commands / n, sd.sectors / n, sd.simulatedUs / n / 1000, wallUs / n);
+  }
+  return benchSdFontSubset(fontPath, cacheDir, pages) && ok;
+}
+
+void collectInputs(const fs::path& input, std::vector<fs::path>& epubs) {
+  if (fs::is_directory(input)) {
+    std::vector<fs::path> found;
+    for (const auto& entry : fs::directory_iterator(input)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".epub") found.push_back(entry.path());
+    }
+    std::sort(found.begin(), found.end());
+    epubs.insert(epubs.end(), found.begin(), found.end());
+  } else if (fs::is_regular_file(input)) {
+    epubs.push_back(input);
+  } else {
+    fprintf(stderr, "Skipping %s: not found\n", input.c_str());
+  }
+}
+
+bool parseArgs(const int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--iterations" && i + 1 < argc) {
+      options.iterations = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--no-hyphenation") {
+      options.hyphenation = false;
+    } else if (arg == "--optimal-breaks") {
+      options.optimalBreaks = true;
+    } else if (arg == "--no-width-cache") {
+      options.widthCache = false;
+    } else if (arg == "--css-resolve") {
+      options.cssResolve = true;
+    } else if (arg == "--sd-font-reads") {
+      options.sdFontReads = true;
+    } else if (arg.rfind("--", 0) == 0) {
+      fprintf(stderr,
+              "Usage: %s [--iterations N] [--no-hyphenation] [--optimal-breaks] [--no-width-cache] "
+              "[--css-resolve] [--sd-font-reads] [epub-or-dir ...]\n",
+              argv[0]);
+      return false;
+    } else {
+      options.inputs.emplace_back(arg);
+    }
+  }
+  if (options.inputs.empty()) options.inputs.emplace_back(BENCH_DEFAULT_EPUB_DIR);
+  return true;
+}
+
+}  // namespace
+
+int main(const int argc, char** argv) {
+  Options options;
+  if (!parseArgs(argc, argv, options)) return 2;
+
+  if (options.sdFontReads) {
+    const fs::path cacheDir = fs::temp_directory_path() / ("crosspoint_bench_" + std::to_string(getpid()));
+    Storage.begin();
+    Storage.mkdir(cacheDir.c_str());
+    const bool ok = benchSdFontReads(cacheDir, options);
+    Storage.removeDir(cacheDir.c_str());
+    return ok ? 0 : 1;
+  }
+
+  std::vector<fs::path> epubs;
+  for (const auto& input : options.inputs) collectInputs(input, epubs);
+  if (epubs.empty()) {
+    fprintf(stderr, "No EPUB files found\n");
+    return 2;
+  }
+
+  const fs::path cacheDir = fs::temp_directory_path() / ("crosspoint_bench_" + std::to_string(getpid()));
+  Storage.begin();
+  Storage.mkdir(cacheDir.c_str());
+
+  if (options.cssResolve) {
+    bool ok = true;
+    for (const auto& epub : epubs) ok &= benchCssResolve(epub, cacheDir, options);
+    Storage.removeDir(cacheDir.c_str());
+    return ok ? 0 : 1;
+  }
+
+  display.begin();
+  GfxRenderer renderer(display);
+  renderer.begin();
+  const EpdFont regular(&notoserif_14_regular);
+  const EpdFont bold(&notoserif_14_bold);
+  const EpdFont italic(&notoserif_14_italic);
+  const EpdFont boldItalic(&notoserif_14_bolditalic);
+  renderer.insertFont(BENCH_FONT_ID, EpdFontFamily(&regular, &bold, &italic, &boldItalic));
+  // Section builds enable the word width cache through the renderer's FontCacheManager, as on device
+  FontCacheManager fontCacheManager(renderer.getFontMap(), renderer.getSdCardFonts());
+  if (options.widthCache) renderer.setFontCacheManager(&fontCacheManager);
+
+  printf("viewport %ux%u, hyphenation %s, %s line breaks, width cache %s, %d iteration(s); build_ms is per "
+         "iteration, peak_heap in bytes\n\n",
+         VIEWPORT_WIDTH, VIEWPORT_HEIGHT, options.hyphenation ? "on" : "off",
+         options.optimalBreaks ? "optimal" : "greedy", options.widthCache ? "on" : "off", options.iterations);
+
+  bool ok = true;
+  for (const auto& epub : epubs) {
+    ok &= benchBook(epub, cacheDir, renderer, options);
+  }
+
+  Storage.removeDir(cacheDir.c_str());
+  return ok ? 0 : 1;
+}
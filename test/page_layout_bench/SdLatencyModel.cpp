@@ -0,0 +1,49 @@
+#include "SdLatencyModel.h"
+
+namespace SdLatencyModel {
+
+namespace {
+Snapshot totals = {};
+// Files are far apart on the card, so a position is a (file, sector) pair
+std::string streamPath;
+uint64_t streamSector = 0;
+bool streaming = false;
+std::string cachedPath;
+uint64_t cachedSector = 0;
+bool cached = false;
+}  // namespace
+
+Snapshot snapshot() { return totals; }
+
+void reset() {
+  totals = {};
+  streaming = false;
+  cached = false;
+}
+
+void onRead(const std::string& path, const size_t offset, const size_t length) {
+  totals.reads++;
+  totals.bytes += length;
+  totals.simulatedUs += CALL_US;
+  if (length == 0) return;
+
+  const uint64_t first = offset / SECTOR_SIZE;
+  const uint64_t last = (offset + length - 1) / SECTOR_SIZE;
+  for (uint64_t sector = first; sector <= last; sector++) {
+    if (cached && sector == cachedSector && path == cachedPath) continue;
+    if (!streaming || sector != streamSector + 1 || path != streamPath) {
+      totals.commands++;
+      totals.simulatedUs += COMMAND_US;
+      streamPath = path;
+      streaming = true;
+    }
+    totals.sectors++;
+    totals.simulatedUs += SECTOR_US;
+    streamSector = sector;
+  }
+  cachedPath = path;
+  cachedSector = last;
+  cached = true;
+}
+
+}  // namespace SdLatencyModel
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Simulated SD card read time for the benchmark. The host HalFile reports every
+// read here; the model charges them as SdFat drives a card over SPI on the
+// device: a read that continues the card's current multi-block transfer only
+// pays for clocking its sectors, anything else first pays a command round trip
+// and the card's access latency. The last sector read stays in SdFat's sector
+// cache, so small reads within it cost only the call itself.
+namespace SdLatencyModel {
+
+constexpr uint32_t SECTOR_SIZE = 512;
+// Start a read at a new address: CMD18 round trip plus card access latency
+constexpr double COMMAND_US = 800;
+// Clock one sector over a 20 MHz SPI bus, plus the data token and CRC
+constexpr double SECTOR_US = 220;
+// FatFile::seekSet() and read() bookkeeping on a 160 MHz core, paid by every read
+constexpr double CALL_US = 20;
+
+struct Snapshot {
+  uint64_t reads;     // HalFile::read calls
+  uint64_t commands;  // reads started at a new address
+  uint64_t sectors;   // sectors transferred from the card
+  uint64_t bytes;     // bytes returned to callers
+  double simulatedUs;
+};
+
+Snapshot snapshot();
+void reset();
+
+void onRead(const std::string& path, size_t offset, size_t length);
+
+}  // namespace SdLatencyModel
@@ -0,0 +1,29 @@
+#pragma once
+// Host stand-in for the Arduino/ESP32 core, providing just enough for the
+// EPUB layout pipeline to compile and run on Linux.
+
+#include <HardwareSerial.h>
+#include <Print.h>
+#include <WString.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+inline void yield() {}
+
+class EspClass {
+ public:
+  // Reports the simulated device heap (see HostHal.cpp) so heap guards such as
+  // CssParser's MIN_FREE_HEAP_FOR_CSS take the same branches as on the device.
+  uint32_t getFreeHeap();
+  uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+};
+
+extern EspClass ESP;
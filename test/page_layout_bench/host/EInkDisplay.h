@@ -0,0 +1,11 @@
+#pragma once
+// Host stand-in for the freeink-sdk panel driver. Only the geometry constants
+// are needed; HalDisplay's methods are implemented in HostHal.cpp.
+
+#include <cstdint>
+
+class EInkDisplay {
+ public:
+  static constexpr uint16_t DISPLAY_WIDTH = 800;
+  static constexpr uint16_t DISPLAY_HEIGHT = 480;
+};
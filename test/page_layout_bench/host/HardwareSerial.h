@@ -0,0 +1,14 @@
+#pragma once
+// Host stand-in for the ESP32 USB CDC serial object referenced by Logging.h.
+
+#include <Print.h>
+
+class HWCDC : public Print {
+ public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t*, size_t size) override { return size; }
+  operator bool() const { return true; }
+};
+
+extern HWCDC Serial;
@@ -0,0 +1,4 @@
+#pragma once
+// Host stand-in for the freeink-sdk button driver (unused by the benchmark).
+
+class InputManager {};
@@ -0,0 +1,26 @@
+#pragma once
+// Host stand-in for the Arduino core Print interface used by HalFile and the
+// streaming XML/CSS parsers.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "WString.h"
+
+class Print {
+ public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+      if (write(*buffer++) == 0) break;
+      n++;
+    }
+    return n;
+  }
+  size_t write(const char* str) { return str ? write(reinterpret_cast<const uint8_t*>(str), strlen(str)) : 0; }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+};
@@ -0,0 +1,17 @@
+#pragma once
+// Host stand-in for the Arduino String class. Only the surface touched by the
+// libraries compiled into the benchmark is provided.
+
+#include <string>
+
+class String {
+  std::string s;
+
+ public:
+  String() = default;
+  String(const char* str) : s(str ? str : "") {}
+  const char* c_str() const { return s.c_str(); }
+  unsigned int length() const { return static_cast<unsigned int>(s.length()); }
+  bool isEmpty() const { return s.empty(); }
+  bool operator==(const String& other) const { return s == other.s; }
+};
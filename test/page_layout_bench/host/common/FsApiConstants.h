@@ -0,0 +1,6 @@
+#pragma once
+// Host stand-in for SdFat's open flags; maps straight onto POSIX fcntl values.
+
+#include <fcntl.h>
+
+typedef int oflag_t;
@@ -0,0 +1,4 @@
+#pragma once
+// Host stand-in for FreeRTOS semaphores. The benchmark is single threaded.
+
+typedef void* SemaphoreHandle_t;
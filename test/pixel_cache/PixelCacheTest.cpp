@@ -0,0 +1,358 @@
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <HalStorage.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Epub/blocks/ImageBlock.h"
+#include "Epub/converters/PixelCache.h"
+#include "SdLatencyModel.h"
+
+extern HalDisplay display;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+std::vector<uint8_t> encode(const std::vector<uint8_t>& src) {
+  std::vector<uint8_t> out(PackBits::maxEncodedSize(src.size()));
+  out.resize(PackBits::encode(src.data(), src.size(), out.data()));
+  return out;
+}
+
+// Encodes, checks the worst-case bound, and decodes back
+void expectRoundTrip(const std::vector<uint8_t>& src) {
+  const auto packed = encode(src);
+  EXPECT_LE(packed.size(), PackBits::maxEncodedSize(src.size()));
+  std::vector<uint8_t> decoded(src.size(), 0x5A);
+  ASSERT_TRUE(PackBits::decode(packed.data(), packed.size(), decoded.data(), decoded.size())) << src.size() << " bytes";
+  EXPECT_TRUE(decoded == src) << src.size() << " bytes";
+}
+
+// No three neighbouring bytes are equal, so the encoder never starts a run
+std::vector<uint8_t> literalBytes(const size_t length) {
+  std::vector<uint8_t> bytes(length);
+  for (size_t i = 0; i < length; i++) bytes[i] = static_cast<uint8_t>(i * 7);
+  return bytes;
+}
+
+TEST(PackBitsTest, SplitsRunsAtTheControlByteLimit) {
+  // {length, encoded size}: a run codes at most 128 bytes; the tail is a run if 3+ bytes long, else a literal
+  const std::pair<size_t, size_t> cases[] = {{3, 2},   {127, 2}, {128, 2}, {129, 4},
+                                             {130, 5}, {131, 4}, {256, 4}, {257, 6}};
+  for (const auto& [length, encodedSize] : cases) {
+    const std::vector<uint8_t> run(length, 0xAA);
+    const auto packed = encode(run);
+    EXPECT_EQ(packed.size(), encodedSize) << length;
+    EXPECT_EQ(packed[0], static_cast<uint8_t>(257 - std::min<size_t>(length, 128))) << length;
+    expectRoundTrip(run);
+  }
+}
+
+TEST(PackBitsTest, SplitsLiteralsAtTheControlByteLimit) {
+  for (const size_t length : {1, 2, 127, 128, 129, 255, 256, 257}) {
+    const auto literal = literalBytes(length);
+    const auto packed = encode(literal);
+    // Incompressible input is the worst case the bound allows for
+    EXPECT_EQ(packed.size(), PackBits::maxEncodedSize(length)) << length;
+    EXPECT_EQ(packed[0], std::min<size_t>(length, 128) - 1) << length;
+    if (length > 128) {
+      EXPECT_EQ(packed[129], std::min<size_t>(length - 128, 128) - 1) << length;
+    }
+    expectRoundTrip(literal);
+  }
+}
+
+TEST(PackBitsTest, KeepsPairsInsideLiterals) {
+  const std::vector<uint8_t> pairs = {1, 2, 2, 3, 3, 4};
+  EXPECT_EQ(encode(pairs).size(), pairs.size() + 1);
+  expectRoundTrip(pairs);
+
+  // A literal stops right before a run of three, at either end
+  const std::vector<uint8_t> mixed = {1, 2, 2, 9, 9, 9, 3, 4, 4, 4};
+  EXPECT_EQ(encode(mixed).size(), 4u + 2u + 2u + 2u);
+  expectRoundTrip(mixed);
+}
+
+TEST(PackBitsTest, RoundTripsMixedData) {
+  expectRoundTrip({});
+  std::mt19937 rng(1234);
+  for (int i = 0; i < 200; i++) {
+    std::vector<uint8_t> data;
+    const size_t length = rng() % 2000;
+    while (data.size() < length) {
+      // Alternate noise with runs of up to 300 bytes over a tiny alphabet, so runs and pairs are common
+      const uint8_t value = static_cast<uint8_t>(rng() % 3);
+      const size_t repeat = (rng() % 4 == 0) ? rng() % 300 : 1;
+      data.insert(data.end(), std::min(repeat, length - data.size()), value);
+    }
+    expectRoundTrip(data);
+  }
+}
+
+TEST(PackBitsTest, RejectsTruncatedAndMismatchedInput) {
+  std::vector<uint8_t> data = literalBytes(200);
+  data.insert(data.end(), 150, 0);
+  const auto packed = encode(data);
+  std::vector<uint8_t> out(data.size() + 1);
+
+  EXPECT_TRUE(PackBits::decode(packed.data(), packed.size(), out.data(), data.size()));
+  // Drop the last run, cut off its value byte, and cut into the first literal
+  EXPECT_FALSE(PackBits::decode(packed.data(), packed.size() - 2, out.data(), data.size()));
+  EXPECT_FALSE(PackBits::decode(packed.data(), packed.size() - 1, out.data(), data.size()));
+  EXPECT_FALSE(PackBits::decode(packed.data(), 100, out.data(), data.size()));
+  // Output shorter or longer than the coded data
+  EXPECT_FALSE(PackBits::decode(packed.data(), packed.size(), out.data(), data.size() - 1));
+  EXPECT_FALSE(PackBits::decode(packed.data(), packed.size(), out.data(), data.size() + 1));
+}
+
+// 2-bit pixel at (x, y): flat bands on the left, noise on the right, so bands pack to very different sizes
+uint8_t pixelAt(const int x, const int y, const int width) {
+  if (x < width / 2) return static_cast<uint8_t>((y / 5) & 3);
+  return static_cast<uint8_t>((x * 31 + y * 17 + (x * y) % 7) & 3);
+}
+
+std::vector<uint8_t> expectedRow(const int y, const int width) {
+  std::vector<uint8_t> row((width + 3) / 4, 0);
+  for (int x = 0; x < width; x++) row[x >> 2] |= pixelAt(x, y, width) << (6 - (x & 3) * 2);
+  return row;
+}
+
+class PixelCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    dir = fs::temp_directory_path() /
+          ("pixel_cache_test_" + std::string(info->test_suite_name()) + "_" + std::string(info->name()));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+  }
+
+  void TearDown() override { fs::remove_all(dir); }
+
+  // Streams the test image through PixelCache the way the decoders do: one block of up to 8 rows at a time
+  static void writeCache(const std::string& path, const int width, const int height, const bool pack) {
+    const int blockRows = std::min(8, height);
+    PixelCache cache;
+    ASSERT_TRUE(cache.begin(path, width, height, 0, 0, blockRows, pack));
+    ASSERT_EQ(cache.packed, pack);
+    for (int top = 0; top < height; top += blockRows) {
+      ASSERT_TRUE(cache.advanceTo(top));
+      for (int y = top; y < top + blockRows && y < height; y++) {
+        const auto row = expectedRow(y, width);
+        memcpy(cache.buffer + (size_t)(y - top) * cache.bytesPerRow, row.data(), row.size());
+      }
+    }
+    ASSERT_TRUE(cache.finalize());
+  }
+
+  fs::path dir;
+};
+
+TEST_F(PixelCacheTest, PackedBandsDecodeToTheWrittenRows) {
+  // {width, height}: a short last band, exact bands, an odd width, a single short band, and one row per band
+  const std::pair<int, int> sizes[] = {{482, 100}, {482, 32}, {481, 77}, {64, 5}, {5000, 7}};
+  for (const auto& [width, height] : sizes) {
+    const std::string path = (dir / "image.pxc").string();
+    ASSERT_NO_FATAL_FAILURE(writeCache(path, width, height, true));
+
+    std::vector<uint8_t> file(fs::file_size(path));
+    HalFile in;
+    ASSERT_TRUE(Storage.openFileForRead("TEST", path, in));
+    ASSERT_EQ(in.read(file.data(), file.size()), static_cast<int>(file.size()));
+    in.close();
+
+    uint16_t header[4];
+    memcpy(header, file.data(), sizeof(header));
+    const int bandRows = PixelCache::packedBandRows(width);
+    const int bandCount = (height + bandRows - 1) / bandRows;
+    EXPECT_EQ(header[0], width | PixelCache::PACKED_FLAG);
+    EXPECT_EQ(header[1], height);
+    ASSERT_EQ(header[2], bandRows) << width;
+    ASSERT_EQ(header[3], bandCount) << width;
+    if (width == 5000) {
+      EXPECT_EQ(bandRows, 1);
+    }
+
+    std::vector<uint32_t> offsets(bandCount + 1);
+    memcpy(offsets.data(), file.data() + PixelCache::PACKED_HEADER_SIZE, offsets.size() * sizeof(uint32_t));
+    const size_t dataStart = PixelCache::PACKED_HEADER_SIZE + offsets.size() * sizeof(uint32_t);
+    EXPECT_EQ(offsets[0], 0u);
+    EXPECT_EQ(dataStart + offsets[bandCount], file.size()) << width << "x" << height;
+
+    const size_t bytesPerRow = (width + 3) / 4;
+    for (int band = 0; band < bandCount; band++) {
+      ASSERT_LT(offsets[band], offsets[band + 1]);
+      const int rows = std::min(bandRows, height - band * bandRows);
+      std::vector<uint8_t> decoded(rows * bytesPerRow);
+      ASSERT_TRUE(PackBits::decode(file.data() + dataStart + offsets[band], offsets[band + 1] - offsets[band],
+                                   decoded.data(), decoded.size()))
+          << width << "x" << height << " band " << band;
+      for (int row = 0; row < rows; row++) {
+        const int y = band * bandRows + row;
+        EXPECT_EQ(memcmp(decoded.data() + row * bytesPerRow, expectedRow(y, width).data(), bytesPerRow), 0)
+            << width << "x" << height << " row " << y;
+      }
+    }
+  }
+}
+
+class PixelCacheRenderTest : public PixelCacheTest {
+ protected:
+  static constexpr int WIDTH = 301;  // 26-row bands, the last one short
+  static constexpr int HEIGHT = 200;
+  static constexpr int X = 37;
+  static constexpr int Y = 23;
+  static constexpr const char* SOURCE_HREF = "OEBPS/images/image.jpg";
+
+  PixelCacheRenderTest() : renderer(display) {}
+
+  // ImageBlock reads the .pxc next to the image path; the image itself is never opened while the cache is valid
+  void SetUp() override {
+    PixelCacheTest::SetUp();
+    display.begin();
+    renderer.begin();
+    image = std::make_unique<ImageBlock>((dir / "image.jpg").string(), SOURCE_HREF, WIDTH, HEIGHT);
+  }
+
+  void TearDown() override {
+    ImageBlock::setSourceExtractor(nullptr);
+    PixelCacheTest::TearDown();
+  }
+
+  fs::path cachePath() const { return dir / "image.pxc"; }
+  void writeImageCache(const bool pack) const { writeCache(cachePath().string(), WIDTH, HEIGHT, pack); }
+
+  static uint8_t clearColor(const GfxRenderer::RenderMode mode) { return mode == GfxRenderer::BW ? 0xFF : 0x00; }
+
+  std::vector<uint8_t> renderFull(const GfxRenderer::RenderMode mode) {
+    renderer.setRenderMode(mode);
+    renderer.clearScreen(clearColor(mode));
+    image->render(renderer, X, Y);
+    renderer.setRenderMode(GfxRenderer::BW);
+    return {renderer.getFrameBuffer(), renderer.getFrameBuffer() + renderer.getBufferSize()};
+  }
+
+  // Renders the image strip by strip, as the tiled grayscale passes do, and stitches the strips together
+  std::vector<uint8_t> renderStrips(const GfxRenderer::RenderMode mode, const int stripRows) {
+    const int widthBytes = renderer.getDisplayWidthBytes();
+    const int panelHeight = renderer.getDisplayHeight();
+    std::vector<uint8_t> frame(renderer.getBufferSize());
+    std::vector<uint8_t> scratch((size_t)stripRows * widthBytes);
+    renderer.setRenderMode(mode);
+    for (int y0 = 0; y0 < panelHeight; y0 += stripRows) {
+      const int rows = std::min(stripRows, panelHeight - y0);
+      memset(scratch.data(), clearColor(mode), scratch.size());
+      renderer.beginStripTarget(scratch.data(), y0, rows);
+      image->render(renderer, X, Y);
+      renderer.endStripTarget();
+      memcpy(frame.data() + (size_t)y0 * widthBytes, scratch.data(), (size_t)rows * widthBytes);
+    }
+    renderer.setRenderMode(GfxRenderer::BW);
+    return frame;
+  }
+
+  GfxRenderer renderer;
+  std::unique_ptr<ImageBlock> image;
+};
+
+TEST_F(PixelCacheRenderTest, PackedStripsMatchPlainFullFrame) {
+  for (const auto orientation : {GfxRenderer::Portrait, GfxRenderer::LandscapeClockwise,
+                                 GfxRenderer::PortraitInverted, GfxRenderer::LandscapeCounterClockwise}) {
+    renderer.setOrientation(orientation);
+    for (const auto mode : {GfxRenderer::BW, GfxRenderer::GRAYSCALE_LSB, GfxRenderer::GRAYSCALE_MSB}) {
+      ASSERT_NO_FATAL_FAILURE(writeImageCache(false));
+      const auto expected = renderFull(mode);
+      ASSERT_FALSE(std::all_of(expected.begin(), expected.end(), [&](uint8_t b) { return b == clearColor(mode); }));
+      ASSERT_NO_FATAL_FAILURE(writeImageCache(true));
+      EXPECT_TRUE(renderFull(mode) == expected) << "orientation " << orientation << " mode " << mode;
+      // 69 rows: strip edges land mid-band and the last strip is short
+      for (const int stripRows : {69, 80}) {
+        EXPECT_TRUE(renderStrips(mode, stripRows) == expected)
+            << "orientation " << orientation << " mode " << mode << " strip " << stripRows;
+      }
+    }
+  }
+}
+
+TEST_F(PixelCacheRenderTest, StripReadsOnlyItsBands) {
+  // Strips run along logical rows in landscape, so one strip needs only the bands it crosses
+  renderer.setOrientation(GfxRenderer::LandscapeClockwise);
+  ASSERT_NO_FATAL_FAILURE(writeImageCache(true));
+  const size_t fileSize = fs::file_size(cachePath());
+
+  std::vector<uint8_t> scratch((size_t)40 * renderer.getDisplayWidthBytes());
+  int stripY0 = -1;
+  for (int y0 = 0; y0 + 40 <= renderer.getDisplayHeight(); y0++) {
+    renderer.beginStripTarget(scratch.data(), y0, 40);
+    const bool top = renderer.glyphIntersectsStrip(X, Y, X + WIDTH - 1, Y);
+    const bool middle = renderer.glyphIntersectsStrip(X, Y + HEIGHT / 2, X + WIDTH - 1, Y + HEIGHT / 2);
+    renderer.endStripTarget();
+    if (middle && !top) {
+      stripY0 = y0;
+      break;
+    }
+  }
+  ASSERT_GE(stripY0, 0);
+
+  SdLatencyModel::reset();
+  renderer.beginStripTarget(scratch.data(), stripY0, 40);
+  image->render(renderer, X, Y);
+  renderer.endStripTarget();
+  const auto reads = SdLatencyModel::snapshot();
+  EXPECT_GT(reads.bytes, 0u);
+  EXPECT_LT(reads.bytes, fileSize / 2);
+}
+
+TEST_F(PixelCacheRenderTest, CacheIsValidOnlyWhenComplete) {
+  EXPECT_FALSE(image->cacheIsValid());
+  for (const bool pack : {false, true}) {
+    ASSERT_NO_FATAL_FAILURE(writeImageCache(pack));
+    EXPECT_TRUE(image->cacheIsValid()) << "pack " << pack;
+    // Cut off mid-write
+    fs::resize_file(cachePath(), fs::file_size(cachePath()) - 1);
+    EXPECT_FALSE(image->cacheIsValid()) << "pack " << pack;
+  }
+
+  // Written for another size
+  ASSERT_NO_FATAL_FAILURE(writeCache(cachePath().string(), WIDTH + 2, HEIGHT, true));
+  EXPECT_FALSE(image->cacheIsValid());
+}
+
+TEST_F(PixelCacheRenderTest, MissingCacheExtractsDeletedSourceAgain) {
+  std::vector<std::pair<std::string, std::string>> extracted;
+  ImageBlock::setSourceExtractor([&](const std::string& href, const std::string& path) {
+    extracted.emplace_back(href, path);
+    return false;
+  });
+
+  // A valid cache needs no source
+  ASSERT_NO_FATAL_FAILURE(writeImageCache(true));
+  renderFull(GfxRenderer::BW);
+  EXPECT_TRUE(extracted.empty());
+
+  fs::remove(cachePath());
+  renderFull(GfxRenderer::BW);
+  ASSERT_EQ(extracted.size(), 1u);
+  EXPECT_EQ(extracted[0].first, SOURCE_HREF);
+  EXPECT_EQ(extracted[0].second, image->getImagePath());
+
+  // A source still on the card is decoded as it is
+  {
+    HalFile file;
+    ASSERT_TRUE(Storage.openFileForWrite("TEST", image->getImagePath(), file));
+    file.write("\xFF\xD8", 2);
+  }
+  renderFull(GfxRenderer::BW);
+  EXPECT_EQ(extracted.size(), 1u);
+}
+
+}  // namespace